@@ -415,10 +415,13 @@ class Int16x01 extends FfiBenchmarkBase {
 class Int32x01 extends FfiBenchmarkBase {
   final Function1int f;
 
-  Int32x01()
-      : f = ffiTestFunctions.lookupFunction<NativeFunction1Int32, Function1int>(
-            'Function1Int32'),
-        super('FfiCall.Int32x01');
+  Int32x01({bool isLeaf = false})
+      : f = isLeaf
+            ? ffiTestFunctions.lookupFunction<NativeFunction1Int32,
+                Function1int>('Function1Int32', isLeaf: true)
+            : ffiTestFunctions.lookupFunction<NativeFunction1Int32,
+                Function1int>('Function1Int32'),
+        super('FfiCall.Int32x01${isLeaf ? 'Leaf' : ''}');
 
   @override
   void run() {
@@ -577,10 +580,13 @@ class Int64x10 extends FfiBenchmarkBase {
 class Int64x20 extends FfiBenchmarkBase {
   final Function20int f;
 
-  Int64x20()
-      : f = ffiTestFunctions.lookupFunction<NativeFunction20Int64,
-            Function20int>('Function20Int64'),
-        super('FfiCall.Int64x20');
+  Int64x20({bool isLeaf = false})
+      : f = isLeaf
+            ? ffiTestFunctions.lookupFunction<NativeFunction20Int64,
+                Function20int>('Function20Int64', isLeaf: true)
+            : ffiTestFunctions.lookupFunction<NativeFunction20Int64,
+                Function20int>('Function20Int64'),
+        super('FfiCall.Int64x20${isLeaf ? 'Leaf' : ''}');
 
   @override
   void run() {
@@ -728,10 +734,13 @@ class Floatx20 extends FfiBenchmarkBase {
 class Doublex01 extends FfiBenchmarkBase {
   final Function1double f;
 
-  Doublex01()
-      : f = ffiTestFunctions.lookupFunction<NativeFunction1Double,
-            Function1double>('Function1Double'),
-        super('FfiCall.Doublex01');
+  Doublex01({bool isLeaf = false})
+      : f = isLeaf
+            ? ffiTestFunctions.lookupFunction<NativeFunction1Double,
+                Function1double>('Function1Double', isLeaf: true)
+            : ffiTestFunctions.lookupFunction<NativeFunction1Double,
+                Function1double>('Function1Double'),
+        super('FfiCall.Doublex01${isLeaf ? 'Leaf' : ''}');
 
   @override
   void run() {
@@ -805,10 +814,13 @@ class Doublex10 extends FfiBenchmarkBase {
 class Doublex20 extends FfiBenchmarkBase {
   final Function20double f;
 
-  Doublex20()
-      : f = ffiTestFunctions.lookupFunction<NativeFunction20Double,
-            Function20double>('Function20Double'),
-        super('FfiCall.Doublex20');
+  Doublex20({bool isLeaf = false})
+      : f = isLeaf
+            ? ffiTestFunctions.lookupFunction<NativeFunction20Double,
+                Function20double>('Function20Double', isLeaf: true)
+            : ffiTestFunctions.lookupFunction<NativeFunction20Double,
+                Function20double>('Function20Double'),
+        super('FfiCall.Doublex20${isLeaf ? 'Leaf' : ''}');
 
   @override
   void run() {
@@ -845,10 +857,13 @@ class Doublex20 extends FfiBenchmarkBase {
 class PointerUint8x01 extends FfiBenchmarkBase {
   final Function1PointerUint8 f;
 
-  PointerUint8x01()
-      : f = ffiTestFunctions.lookupFunction<Function1PointerUint8,
-            Function1PointerUint8>('Function1PointerUint8'),
-        super('FfiCall.PointerUint8x01');
+  PointerUint8x01({bool isLeaf = false})
+      : f = isLeaf
+            ? ffiTestFunctions.lookupFunction<Function1PointerUint8,
+                Function1PointerUint8>('Function1PointerUint8', isLeaf: true)
+            : ffiTestFunctions.lookupFunction<Function1PointerUint8,
+                Function1PointerUint8>('Function1PointerUint8'),
+        super('FfiCall.PointerUint8x01${isLeaf ? 'Leaf' : ''}');
 
   Pointer<Uint8> p1 = nullptr;
   @override
@@ -1197,6 +1212,7 @@ void main() {
     () => Int8x01(),
     () => Int16x01(),
     () => Int32x01(),
+    () => Int32x01(isLeaf: true),
     () => Int32x02(),
     () => Int32x04(),
     () => Int32x10(),
@@ -1206,6 +1222,7 @@ void main() {
     () => Int64x04(),
     () => Int64x10(),
     () => Int64x20(),
+    () => Int64x20(isLeaf: true),
     () => Int64Mintx01(),
     () => Floatx01(),
     () => Floatx02(),
@@ -1213,11 +1230,14 @@ void main() {
     () => Floatx10(),
     () => Floatx20(),
     () => Doublex01(),
+    () => Doublex01(isLeaf: true),
     () => Doublex02(),
     () => Doublex04(),
     () => Doublex10(),
     () => Doublex20(),
+    () => Doublex20(isLeaf: true),
     () => PointerUint8x01(),
+    () => PointerUint8x01(isLeaf: true),
     () => PointerUint8x02(),
     () => PointerUint8x04(),
     () => PointerUint8x10(),
@@ -0,0 +1,118 @@
+// Copyright (c) 2021, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+//
+// Benchmark for searching, splitting and comparing strings the way a log
+// processor does.
+
+import 'package:benchmark_harness/benchmark_harness.dart';
+
+const int kLines = 1000;
+
+final List<String> paths = [
+  '/index.html',
+  '/api/v1/users',
+  '/api/v1/orders/12345',
+  '/static/js/app.min.js',
+  '/favicon.ico',
+];
+final List<int> statuses = [200, 200, 200, 304, 404, 500];
+
+String makeLog() {
+  final buffer = StringBuffer();
+  for (int i = 0; i < kLines; i++) {
+    final path = paths[i % paths.length];
+    final status = statuses[i % statuses.length];
+    buffer.write('2021-06-01T12:${(i ~/ 60) % 60}:${i % 60}Z '
+        '10.0.${i % 256}.${(i * 7) % 256} GET $path HTTP/1.1 $status '
+        '${i * 13 % 10000} "Mozilla/5.0 (X11; Linux x86_64)" '
+        'request_id=${i.toRadixString(16).padLeft(8, '0')}\n');
+  }
+  return buffer.toString();
+}
+
+abstract class StringSearchBenchmark extends BenchmarkBase {
+  late String log;
+  late List<String> lines;
+
+  StringSearchBenchmark(String name) : super('StringSearch.$name');
+
+  @override
+  void setup() {
+    log = makeLog();
+    lines = log.split('\n');
+  }
+}
+
+class Split extends StringSearchBenchmark {
+  Split() : super('Split');
+
+  @override
+  void run() {
+    int fields = 0;
+    for (final line in log.split('\n')) {
+      fields += line.split(' ').length;
+    }
+    if (fields < kLines) throw 'Unexpected number of fields: $fields';
+  }
+}
+
+class IndexOf extends StringSearchBenchmark {
+  IndexOf() : super('IndexOf');
+
+  @override
+  void run() {
+    int found = 0;
+    int index = 0;
+    while ((index = log.indexOf('/api/v1/orders', index)) >= 0) {
+      found++;
+      index++;
+    }
+    if (found != kLines ~/ paths.length) {
+      throw 'Unexpected number of matches: $found';
+    }
+  }
+}
+
+class Contains extends StringSearchBenchmark {
+  Contains() : super('Contains');
+
+  @override
+  void run() {
+    int errors = 0;
+    for (final line in lines) {
+      if (line.contains(' HTTP/1.1 500 ')) errors++;
+    }
+    if (errors == 0) throw 'No errors found';
+  }
+}
+
+class Equality extends StringSearchBenchmark {
+  late List<String> copies;
+
+  Equality() : super('Equality');
+
+  @override
+  void setup() {
+    super.setup();
+    // Copies are different objects, so they have to be compared by content.
+    copies = [for (final line in lines) String.fromCharCodes(line.codeUnits)];
+  }
+
+  @override
+  void run() {
+    int equal = 0;
+    for (int i = 0; i < lines.length; i++) {
+      if (lines[i] == copies[i]) equal++;
+      if (lines[i] == copies[(i + 1) % lines.length]) equal--;
+    }
+    if (equal != lines.length) throw 'Unexpected number of equal lines';
+  }
+}
+
+void main() {
+  final benchmarks = [Split(), IndexOf(), Contains(), Equality()];
+  for (final benchmark in benchmarks) {
+    benchmark.report();
+  }
+}
@@ -0,0 +1,108 @@
+// Copyright (c) 2021, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// @dart=2.9
+
+// Measures how many datagrams per second a RawDatagramSocket can receive
+// over the loopback interface.
+//
+// The sender sends datagrams in windows and waits for the receiver to drain
+// each window before sending the next one, so that the kernel does not drop
+// datagrams because the receive buffer overflows. The receiver reads every
+// pending datagram on each read event.
+
+import 'dart:async';
+import 'dart:io';
+import 'dart:typed_data';
+
+// Number of datagrams sent before waiting for the receiver.
+const int window = 64;
+
+// How long to wait for a window before counting missing datagrams as lost.
+const Duration windowTimeout = Duration(milliseconds: 100);
+
+class UdpLoopback {
+  final String name;
+  final int size;
+
+  UdpLoopback(this.name, this.size);
+
+  RawDatagramSocket sender;
+  RawDatagramSocket receiver;
+  StreamSubscription<RawSocketEvent> subscription;
+  Uint8List data;
+
+  int received = 0;
+  int expected = 0;
+  Completer<void> windowDone;
+
+  Future<void> setup() async {
+    data = Uint8List(size);
+    receiver = await RawDatagramSocket.bind(InternetAddress.loopbackIPv4, 0);
+    sender = await RawDatagramSocket.bind(InternetAddress.loopbackIPv4, 0);
+    subscription = receiver.listen((RawSocketEvent event) {
+      if (event != RawSocketEvent.read) return;
+      while (receiver.receive() != null) {
+        received++;
+      }
+      if (received >= expected) {
+        windowDone?.complete();
+        windowDone = null;
+      }
+    });
+  }
+
+  Future<void> teardown() async {
+    await subscription.cancel();
+    sender.close();
+    receiver.close();
+  }
+
+  Future<void> sendWindow() async {
+    for (int i = 0; i < window; i++) {
+      // send() returns 0 if the datagram could not be sent right away.
+      while (sender.send(data, InternetAddress.loopbackIPv4, receiver.port) ==
+          0) {
+        await Future<void>.delayed(Duration.zero);
+      }
+      expected++;
+    }
+    if (received < expected) {
+      final completer = Completer<void>();
+      windowDone = completer;
+      await completer.future.timeout(windowTimeout, onTimeout: () {
+        windowDone = null;
+        // Forget about the datagrams that were dropped.
+        expected = received;
+      });
+    }
+  }
+
+  // Returns the number of datagrams received per second.
+  Future<double> measureFor(int minimumMillis) async {
+    final minimumMicros = minimumMillis * 1000;
+    received = expected = 0;
+    final watch = Stopwatch()..start();
+    int elapsed = 0;
+    while (elapsed < minimumMicros) {
+      await sendWindow();
+      elapsed = watch.elapsedMicroseconds;
+    }
+    return received * 1000000 / elapsed;
+  }
+
+  Future<void> report() async {
+    await setup();
+    await measureFor(500); // warm-up
+    final packetsPerSecond = await measureFor(4000);
+    await teardown();
+    print('$name(Throughput): ${packetsPerSecond.round()} packets/s.');
+  }
+}
+
+Future<void> main() async {
+  for (final size in [64, 1024, 8192]) {
+    await UdpLoopback('UdpLoopback.Receive.$size', size).report();
+  }
+}
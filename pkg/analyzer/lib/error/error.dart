@@ -462,6 +462,7 @@ const List<ErrorCode> errorCodeValues = [
   CompileTimeErrorCode.YIELD_IN_NON_GENERATOR,
   CompileTimeErrorCode.YIELD_OF_INVALID_TYPE,
   FfiCode.ANNOTATION_ON_POINTER_FIELD,
+  FfiCode.ARGUMENT_MUST_BE_A_CONSTANT,
   FfiCode.EMPTY_STRUCT,
   FfiCode.EXTRA_ANNOTATION_ON_STRUCT_FIELD,
   FfiCode.EXTRA_SIZE_ANNOTATION_CARRAY,
@@ -470,6 +471,8 @@ const List<ErrorCode> errorCodeValues = [
   FfiCode.GENERIC_STRUCT_SUBCLASS,
   FfiCode.INVALID_EXCEPTION_VALUE,
   FfiCode.INVALID_FIELD_TYPE_IN_STRUCT,
+  FfiCode.LEAF_CALL_MUST_NOT_RETURN_HANDLE,
+  FfiCode.LEAF_CALL_MUST_NOT_TAKE_HANDLE,
   FfiCode.MISMATCHED_ANNOTATION_ON_STRUCT_FIELD,
   FfiCode.MISSING_ANNOTATION_ON_STRUCT_FIELD,
   FfiCode.MISSING_EXCEPTION_VALUE,
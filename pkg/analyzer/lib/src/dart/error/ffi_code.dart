@@ -21,6 +21,15 @@ class FfiCode extends AnalyzerErrorCode {
           "any annotations.",
       correction: "Try removing the annotation.");
 
+  /**
+   * Parameters:
+   * 0: the name of the argument
+   */
+  static const FfiCode ARGUMENT_MUST_BE_A_CONSTANT = FfiCode(
+      name: 'ARGUMENT_MUST_BE_A_CONSTANT',
+      message: "Argument '{0}' must be a constant.",
+      correction: "Try replacing the value with a literal or const.");
+
   /**
    * Parameters:
    * 0: the name of the struct class
@@ -100,6 +109,23 @@ class FfiCode extends AnalyzerErrorCode {
           "Try using 'int', 'double', 'Array', 'Pointer', or subtype of "
           "'Struct'.");
 
+  /**
+   * No parameters.
+   */
+  static const FfiCode LEAF_CALL_MUST_NOT_RETURN_HANDLE = FfiCode(
+      name: 'LEAF_CALL_MUST_NOT_RETURN_HANDLE',
+      message: "FFI leaf call must not have Handle return type.",
+      correction: "Try changing the return type to primitive or struct.");
+
+  /**
+   * No parameters.
+   */
+  static const FfiCode LEAF_CALL_MUST_NOT_TAKE_HANDLE = FfiCode(
+      name: 'LEAF_CALL_MUST_NOT_TAKE_HANDLE',
+      message: "FFI leaf call must not have Handle argument types.",
+      correction:
+          "Try changing the argument type to primitive, struct or Pointer.");
+
   /**
    * No parameters.
    */
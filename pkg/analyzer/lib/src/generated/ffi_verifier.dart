@@ -20,6 +20,7 @@ class FfiVerifier extends RecursiveAstVisitor<void> {
   static const _allocatorExtensionName = 'AllocatorAlloc';
   static const _arrayClassName = 'Array';
   static const _dartFfiLibraryName = 'dart.ffi';
+  static const _isLeafParamName = 'isLeaf';
   static const _opaqueClassName = 'Opaque';
 
   static const List<String> _primitiveIntegerNativeTypes = [
@@ -449,6 +450,7 @@ class FfiVerifier extends RecursiveAstVisitor<void> {
         _errorReporter.reportErrorForNode(
             FfiCode.MUST_BE_A_SUBTYPE, node, [TPrime, F, 'asFunction']);
       }
+      _validateIsLeaf(node, TPrime);
     }
   }
 
@@ -666,6 +668,56 @@ class FfiVerifier extends RecursiveAstVisitor<void> {
       _errorReporter.reportErrorForNode(
           FfiCode.MUST_BE_A_SUBTYPE, errorNode, [S, F, 'lookupFunction']);
     }
+    _validateIsLeaf(node, S);
+  }
+
+  /// Validate the `isLeaf` argument of `asFunction` and `lookupFunction`.
+  ///
+  /// It must be a constant, and leaf calls of the native function type
+  /// [nativeType] must not pass or return handles.
+  void _validateIsLeaf(MethodInvocation node, DartType nativeType) {
+    for (final argument in node.argumentList.arguments) {
+      if (argument is! NamedExpression ||
+          argument.name.label.name != _isLeafParamName) {
+        continue;
+      }
+      final Expression expression = argument.expression;
+      final bool? isLeaf = _constantBoolValue(expression);
+      if (isLeaf == null) {
+        _errorReporter.reportErrorForNode(FfiCode.ARGUMENT_MUST_BE_A_CONSTANT,
+            expression, [_isLeafParamName]);
+        return;
+      }
+      if (!isLeaf || nativeType is! FunctionType) {
+        return;
+      }
+      if (nativeType.returnType.isHandle) {
+        _errorReporter.reportErrorForNode(
+            FfiCode.LEAF_CALL_MUST_NOT_RETURN_HANDLE, node.methodName);
+      }
+      if (nativeType.parameters.any((p) => p.type.isHandle)) {
+        _errorReporter.reportErrorForNode(
+            FfiCode.LEAF_CALL_MUST_NOT_TAKE_HANDLE, node.methodName);
+      }
+    }
+  }
+
+  /// Return the value of [expression] if it is a boolean literal or a
+  /// reference to a constant variable, otherwise `null`.
+  bool? _constantBoolValue(Expression expression) {
+    if (expression is BooleanLiteral) {
+      return expression.value;
+    }
+    if (expression is Identifier) {
+      var element = expression.staticElement;
+      if (element is PropertyAccessorElement) {
+        element = element.variable;
+      }
+      if (element is VariableElement && element.isConst) {
+        return element.computeConstantValue()?.toBoolValue();
+      }
+    }
+    return null;
   }
 
   /// Validate that none of the [annotations] are from `dart:ffi`.
@@ -662,6 +662,8 @@ class Double extends NativeType {
   const Double();
 }
 
+abstract class Handle extends NativeType {}
+
 class Pointer<T extends NativeType> extends NativeType {
   external factory Pointer.fromAddress(int ptr);
 
@@ -672,7 +674,7 @@ class Pointer<T extends NativeType> extends NativeType {
 
 extension NativeFunctionPointer<NF extends Function>
     on Pointer<NativeFunction<NF>> {
-  external DF asFunction<DF extends Function>();
+  external DF asFunction<DF extends Function>({bool isLeaf = false});
 }
 
 class Struct extends NativeType {}
@@ -687,7 +689,8 @@ abstract class DynamicLibrary {}
 
 extension DynamicLibraryExtension on DynamicLibrary {
   external F lookupFunction<T extends Function, F extends Function>(
-      String symbolName);
+      String symbolName,
+      {bool isLeaf = false});
 }
 
 abstract class NativeFunction<T extends Function> extends NativeType {}
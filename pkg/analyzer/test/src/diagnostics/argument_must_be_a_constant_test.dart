@@ -0,0 +1,62 @@
+// Copyright (c) 2021, the Dart project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+import 'package:analyzer/src/dart/error/ffi_code.dart';
+import 'package:test_reflective_loader/test_reflective_loader.dart';
+
+import '../dart/resolution/context_collection_resolution.dart';
+
+main() {
+  defineReflectiveSuite(() {
+    defineReflectiveTests(ArgumentMustBeAConstantTest);
+  });
+}
+
+@reflectiveTest
+class ArgumentMustBeAConstantTest extends PubPackageResolutionTest {
+  test_asFunction_isLeaf() async {
+    await assertErrorsInCode(r'''
+import 'dart:ffi';
+typedef T = Int8 Function(Int8);
+void f(Pointer<NativeFunction<T>> p, bool isLeaf) {
+  p.asFunction<int Function(int)>(isLeaf: isLeaf);
+}
+''', [
+      error(FfiCode.ARGUMENT_MUST_BE_A_CONSTANT, 146, 6),
+    ]);
+  }
+
+  test_asFunction_isLeaf_const() async {
+    await assertNoErrorsInCode(r'''
+import 'dart:ffi';
+typedef T = Int8 Function(Int8);
+const isLeaf = true;
+void f(Pointer<NativeFunction<T>> p) {
+  p.asFunction<int Function(int)>(isLeaf: isLeaf);
+}
+''');
+  }
+
+  test_lookupFunction_isLeaf() async {
+    await assertErrorsInCode(r'''
+import 'dart:ffi';
+typedef T = Int8 Function(Int8);
+void f(DynamicLibrary lib, bool isLeaf) {
+  lib.lookupFunction<T, int Function(int)>('g', isLeaf: isLeaf);
+}
+''', [
+      error(FfiCode.ARGUMENT_MUST_BE_A_CONSTANT, 150, 6),
+    ]);
+  }
+
+  test_lookupFunction_isLeaf_literal() async {
+    await assertNoErrorsInCode(r'''
+import 'dart:ffi';
+typedef T = Int8 Function(Int8);
+void f(DynamicLibrary lib) {
+  lib.lookupFunction<T, int Function(int)>('g', isLeaf: true);
+}
+''');
+  }
+}
@@ -0,0 +1,51 @@
+// Copyright (c) 2021, the Dart project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+import 'package:analyzer/src/dart/error/ffi_code.dart';
+import 'package:test_reflective_loader/test_reflective_loader.dart';
+
+import '../dart/resolution/context_collection_resolution.dart';
+
+main() {
+  defineReflectiveSuite(() {
+    defineReflectiveTests(LeafCallMustNotReturnHandleTest);
+  });
+}
+
+@reflectiveTest
+class LeafCallMustNotReturnHandleTest extends PubPackageResolutionTest {
+  test_asFunction() async {
+    await assertErrorsInCode(r'''
+import 'dart:ffi';
+typedef T = Handle Function();
+void f(Pointer<NativeFunction<T>> p) {
+  p.asFunction<Object Function()>(isLeaf: true);
+}
+''', [
+      error(FfiCode.LEAF_CALL_MUST_NOT_RETURN_HANDLE, 93, 10),
+    ]);
+  }
+
+  test_asFunction_notLeaf() async {
+    await assertNoErrorsInCode(r'''
+import 'dart:ffi';
+typedef T = Handle Function();
+void f(Pointer<NativeFunction<T>> p) {
+  p.asFunction<Object Function()>(isLeaf: false);
+}
+''');
+  }
+
+  test_lookupFunction() async {
+    await assertErrorsInCode(r'''
+import 'dart:ffi';
+typedef T = Handle Function();
+void f(DynamicLibrary lib) {
+  lib.lookupFunction<T, Object Function()>('g', isLeaf: true);
+}
+''', [
+      error(FfiCode.LEAF_CALL_MUST_NOT_RETURN_HANDLE, 85, 14),
+    ]);
+  }
+}
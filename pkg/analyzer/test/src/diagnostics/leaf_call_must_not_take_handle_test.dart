@@ -0,0 +1,51 @@
+// Copyright (c) 2021, the Dart project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+import 'package:analyzer/src/dart/error/ffi_code.dart';
+import 'package:test_reflective_loader/test_reflective_loader.dart';
+
+import '../dart/resolution/context_collection_resolution.dart';
+
+main() {
+  defineReflectiveSuite(() {
+    defineReflectiveTests(LeafCallMustNotTakeHandleTest);
+  });
+}
+
+@reflectiveTest
+class LeafCallMustNotTakeHandleTest extends PubPackageResolutionTest {
+  test_asFunction() async {
+    await assertErrorsInCode(r'''
+import 'dart:ffi';
+typedef T = Void Function(Handle);
+void f(Pointer<NativeFunction<T>> p) {
+  p.asFunction<void Function(Object)>(isLeaf: true);
+}
+''', [
+      error(FfiCode.LEAF_CALL_MUST_NOT_TAKE_HANDLE, 97, 10),
+    ]);
+  }
+
+  test_lookupFunction() async {
+    await assertErrorsInCode(r'''
+import 'dart:ffi';
+typedef T = Void Function(Handle);
+void f(DynamicLibrary lib) {
+  lib.lookupFunction<T, void Function(Object)>('g', isLeaf: true);
+}
+''', [
+      error(FfiCode.LEAF_CALL_MUST_NOT_TAKE_HANDLE, 89, 14),
+    ]);
+  }
+
+  test_lookupFunction_notLeaf() async {
+    await assertNoErrorsInCode(r'''
+import 'dart:ffi';
+typedef T = Void Function(Handle);
+void f(DynamicLibrary lib) {
+  lib.lookupFunction<T, void Function(Object)>('g');
+}
+''');
+  }
+}
@@ -17,6 +17,7 @@ import 'ambiguous_import_test.dart' as ambiguous_import;
 import 'ambiguous_set_or_map_literal_test.dart' as ambiguous_set_or_map_literal;
 import 'annotation_on_pointer_field_test.dart' as annotation_on_pointer_field;
 import 'annotation_syntax_test.dart' as annotation_syntax;
+import 'argument_must_be_a_constant_test.dart' as argument_must_be_a_constant;
 import 'argument_type_not_assignable_test.dart' as argument_type_not_assignable;
 import 'argument_type_not_assignable_to_error_handler_test.dart'
     as argument_type_not_assignable_to_error_handler;
@@ -355,6 +356,10 @@ import 'late_final_field_with_const_constructor_test.dart'
     as late_final_field_with_const_constructor;
 import 'late_final_local_already_assigned_test.dart'
     as late_final_local_already_assigned;
+import 'leaf_call_must_not_return_handle_test.dart'
+    as leaf_call_must_not_return_handle;
+import 'leaf_call_must_not_take_handle_test.dart'
+    as leaf_call_must_not_take_handle;
 import 'list_element_type_not_assignable_test.dart'
     as list_element_type_not_assignable;
 import 'main_first_positional_parameter_type_test.dart'
@@ -696,6 +701,7 @@ main() {
     ambiguous_set_or_map_literal.main();
     annotation_on_pointer_field.main();
     annotation_syntax.main();
+    argument_must_be_a_constant.main();
     argument_type_not_assignable.main();
     argument_type_not_assignable_to_error_handler.main();
     assert_in_redirecting_constructor.main();
@@ -916,6 +922,8 @@ main() {
     label_undefined.main();
     late_final_field_with_const_constructor.main();
     late_final_local_already_assigned.main();
+    leaf_call_must_not_return_handle.main();
+    leaf_call_must_not_take_handle.main();
     list_element_type_not_assignable.main();
     main_first_positional_parameter_type.main();
     main_has_required_named_parameters.main();
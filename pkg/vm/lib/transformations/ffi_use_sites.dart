@@ -8,8 +8,11 @@ import 'package:front_end/src/api_unstable/vm.dart'
     show
         messageFfiExceptionalReturnNull,
         messageFfiExpectedConstant,
+        messageFfiLeafCallMustNotReturnHandle,
+        messageFfiLeafCallMustNotTakeHandle,
         templateFfiDartTypeMismatch,
         templateFfiEmptyStruct,
+        templateFfiExpectedConstantArg,
         templateFfiExpectedExceptionalReturn,
         templateFfiExpectedNoExceptionalReturn,
         templateFfiExtendsOrImplementsSealedClass,
@@ -225,7 +228,11 @@ class _FfiUseSiteTransformer extends FfiTransformer {
         _ensureNativeTypeValid(nativeType, node);
         _ensureNativeTypeToDartType(nativeType, dartType, node);
         _ensureNoEmptyStructs(dartType, node);
-        return _replaceLookupFunction(node);
+        final bool isLeaf = _isLeafCall(node);
+        if (isLeaf) {
+          _ensureLeafCallDoesNotUseHandles(nativeType, node);
+        }
+        return _replaceLookupFunction(node, isLeaf);
       } else if (target == asFunctionMethod) {
         final DartType dartType = node.arguments.types[1];
         final DartType nativeType = InterfaceType(
@@ -234,13 +241,17 @@ class _FfiUseSiteTransformer extends FfiTransformer {
         _ensureNativeTypeValid(nativeType, node);
         _ensureNativeTypeToDartType(nativeType, dartType, node);
         _ensureNoEmptyStructs(dartType, node);
+        final bool isLeaf = _isLeafCall(node);
+        if (isLeaf) {
+          _ensureLeafCallDoesNotUseHandles(nativeType, node);
+        }
 
         final DartType nativeSignature =
             (nativeType as InterfaceType).typeArguments[0];
         // Inline function body to make all type arguments instatiated.
         return StaticInvocation(
             asFunctionInternal,
-            Arguments([node.arguments.positional[0]],
+            Arguments([node.arguments.positional[0], BoolLiteral(isLeaf)],
                 types: [dartType, nativeSignature]));
       } else if (target == fromFunctionMethod) {
         final DartType nativeType = InterfaceType(
@@ -391,10 +402,11 @@ class _FfiUseSiteTransformer extends FfiTransformer {
   // Above, in 'visitStaticInvocation', we ensure that the type arguments to
   // 'lookupFunction' are constants, so by inlining the call to 'asFunction' at
   // the call-site, we ensure that there are no generic calls to 'asFunction'.
-  Expression _replaceLookupFunction(StaticInvocation node) {
+  Expression _replaceLookupFunction(StaticInvocation node, bool isLeaf) {
     // The generated code looks like:
     //
-    // _asFunctionInternal<DS, NS>(lookup<NativeFunction<NS>>(symbolName))
+    // _asFunctionInternal<DS, NS>(lookup<NativeFunction<NS>>(symbolName),
+    //     isLeaf)
 
     final DartType nativeSignature = node.arguments.types[0];
     final DartType dartSignature = node.arguments.types[1];
@@ -411,8 +423,10 @@ class _FfiUseSiteTransformer extends FfiTransformer {
         args,
         libraryLookupMethod);
 
-    return StaticInvocation(asFunctionInternal,
-        Arguments([lookupResult], types: [dartSignature, nativeSignature]));
+    return StaticInvocation(
+        asFunctionInternal,
+        Arguments([lookupResult, BoolLiteral(isLeaf)],
+            types: [dartSignature, nativeSignature]));
   }
 
   // We need to rewrite calls to 'fromFunction' into two calls, representing the
@@ -753,6 +767,53 @@ class _FfiUseSiteTransformer extends FfiTransformer {
         null;
   }
 
+  /// Reads the `isLeaf` argument of `asFunction` and `lookupFunction`.
+  ///
+  /// It must be a constant, because leaf and non-leaf calls are compiled to
+  /// different trampolines.
+  bool _isLeafCall(StaticInvocation node) {
+    for (final NamedExpression named in node.arguments.named) {
+      if (named.name != 'isLeaf') continue;
+      final Expression value = named.value;
+      if (value is BoolLiteral) {
+        return value.value;
+      }
+      if (value is ConstantExpression && value.constant is BoolConstant) {
+        return (value.constant as BoolConstant).value;
+      }
+      diagnosticReporter.report(
+          templateFfiExpectedConstantArg.withArguments('isLeaf'),
+          node.fileOffset,
+          1,
+          node.location.file);
+      throw _FfiStaticTypeError();
+    }
+    return false;
+  }
+
+  /// Leaf calls do not leave generated code, so the callee cannot touch
+  /// handles.
+  void _ensureLeafCallDoesNotUseHandles(DartType nativeType, Expression node) {
+    final DartType functionType =
+        (nativeType as InterfaceType).typeArguments[0];
+    if (functionType is! FunctionType) return;
+    final FunctionType signature = functionType;
+    if (_isHandleType(signature.returnType)) {
+      diagnosticReporter.report(messageFfiLeafCallMustNotReturnHandle,
+          node.fileOffset, 1, node.location.file);
+      throw _FfiStaticTypeError();
+    }
+    if (signature.positionalParameters.any(_isHandleType)) {
+      diagnosticReporter.report(messageFfiLeafCallMustNotTakeHandle,
+          node.fileOffset, 1, node.location.file);
+      throw _FfiStaticTypeError();
+    }
+  }
+
+  bool _isHandleType(DartType type) =>
+      type is InterfaceType &&
+      type.classNode == nativeTypesClasses[NativeType.kHandle.index];
+
   void _ensureIsStaticFunction(Expression node) {
     if ((node is StaticGet && node.target is Procedure) ||
         (node is ConstantExpression && node.constant is TearOffConstant)) {
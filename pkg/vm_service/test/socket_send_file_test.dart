@@ -0,0 +1,99 @@
+// Copyright (c) 2021, the Dart project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// Checks that Socket.addStream sends a file without reading it into Dart
+// where the platform supports it.
+
+import 'dart:async';
+import 'dart:convert';
+import 'dart:developer';
+import 'dart:io' as io;
+import 'dart:typed_data';
+
+import 'package:test/test.dart';
+import 'package:vm_service/vm_service.dart';
+
+import 'common/test_helper.dart';
+
+const String localhost = '127.0.0.1';
+const String fileName = 'send_file_data';
+// Larger than the socket buffers, so the send stalls until it is read.
+const int fileSize = 32 * 1024 * 1024;
+
+Future<void> setup() async {
+  late io.Directory dir;
+  late io.ServerSocket server;
+  late io.Socket client;
+  late Future<io.Socket> accepted;
+  late Future sent;
+
+  Future<ServiceExtensionResponse> start(ignored_a, ignored_b) async {
+    dir = await io.Directory.systemTemp.createTemp('socket_send_file');
+    final file = io.File(dir.path + io.Platform.pathSeparator + fileName);
+    await file.writeAsBytes(Uint8List(fileSize));
+    server = await io.ServerSocket.bind(localhost, 0);
+    accepted = server.first;
+    client = await io.Socket.connect(localhost, server.port);
+    // Nothing reads from the server side until [finish], so the file stays
+    // open while part of it has been sent.
+    sent = client.addStream(file.openRead());
+    final result = jsonEncode({'type': 'foobar'});
+    return ServiceExtensionResponse.result(result);
+  }
+
+  Future<ServiceExtensionResponse> finish(ignored_a, ignored_b) async {
+    final socket = await accepted;
+    final received = socket.fold<int>(0, (n, data) => n + data.length);
+    await sent;
+    await client.close();
+    final result = jsonEncode({'type': 'foobar', 'received': await received});
+    await server.close();
+    await dir.delete(recursive: true);
+    return ServiceExtensionResponse.result(result);
+  }
+
+  registerExtension('ext.dart.io.startSendFile', start);
+  registerExtension('ext.dart.io.finishSendFile', finish);
+}
+
+var tests = <IsolateTest>[
+  (VmService service, IsolateRef isolateRef) async {
+    final isolateId = isolateRef.id!;
+    await service.socketProfilingEnabled(isolateId, true);
+    await service.callServiceExtension(
+      'ext.dart.io.startSendFile',
+      isolateId: isolateId,
+    );
+
+    // Wait until some of the file has been written to the socket.
+    while (true) {
+      final profile = await service.getSocketProfile(isolateId);
+      if (profile.sockets.any((s) => s.writeBytes > 0)) break;
+      await Future.delayed(const Duration(milliseconds: 10));
+    }
+
+    final files = await service.getOpenFiles(isolateId);
+    final ref = files.files.singleWhere((f) => f.name.endsWith(fileName));
+    final file = await service.getOpenFileById(isolateId, ref.id);
+    if (io.Platform.isLinux || io.Platform.isAndroid || io.Platform.isMacOS) {
+      // Sent with sendfile, so no bytes were read through the file.
+      expect(file.readCount, 0);
+      expect(file.readBytes, 0);
+    }
+
+    final result = await service.callServiceExtension(
+      'ext.dart.io.finishSendFile',
+      isolateId: isolateId,
+    );
+    expect(result.json!['received'], fileSize);
+    await service.socketProfilingEnabled(isolateId, false);
+  },
+];
+
+main([args = const <String>[]]) async => runIsolateTests(
+      args,
+      tests,
+      'socket_send_file_test.dart',
+      testeeBefore: setup,
+    );
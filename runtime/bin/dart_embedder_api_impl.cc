@@ -6,6 +6,7 @@
 
 #include "bin/dartutils.h"
 #include "bin/eventhandler.h"
+#include "bin/io_uring_linux.h"
 #include "bin/isolate_data.h"
 #include "bin/process.h"
 #include "bin/secure_socket_filter.h"
@@ -40,6 +41,9 @@ bool InitOnce(char** error) {
   }
   bin::TimerUtils::InitOnce();
   bin::Process::Init();
+#if defined(HOST_OS_LINUX)
+  bin::IOUring::Init();
+#endif
 #if !defined(DART_IO_SECURE_SOCKET_DISABLED)
   bin::SSLFilter::Init();
 #endif
@@ -51,6 +55,9 @@ void Cleanup() {
   bin::Process::ClearAllSignalHandlers();
 
   bin::EventHandler::Stop();
+#if defined(HOST_OS_LINUX)
+  bin::IOUring::Cleanup();
+#endif
 #if !defined(DART_IO_SECURE_SOCKET_DISABLED)
   bin::SSLFilter::Cleanup();
 #endif
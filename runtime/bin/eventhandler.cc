@@ -18,6 +18,8 @@ namespace bin {
 static EventHandler* event_handler = NULL;
 static Monitor* shutdown_monitor = NULL;
 
+intptr_t EventHandler::thread_count_ = 1;
+
 void EventHandler::Start() {
   // Initialize global socket registry.
   ListeningSocketRegistry::Initialize();
@@ -626,10 +626,21 @@ class EventHandler {
 
   static void SendFromNative(intptr_t id, Dart_Port port, int64_t data);
 
+  // The number of threads polling for I/O events. Must be set before the
+  // event-handler is started. Only the Linux implementation currently runs
+  // more than one thread; other platforms ignore this setting.
+  static intptr_t thread_count() { return thread_count_; }
+  static void set_thread_count(intptr_t thread_count) {
+    ASSERT(thread_count >= 1);
+    thread_count_ = thread_count;
+  }
+
  private:
   friend class EventHandlerImplementation;
   EventHandlerImplementation delegate_;
 
+  static intptr_t thread_count_;
+
   DISALLOW_COPY_AND_ASSIGN(EventHandler);
 };
 
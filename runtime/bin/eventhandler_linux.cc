@@ -68,8 +68,11 @@ static void AddToEpollInstance(intptr_t epoll_fd_, DescriptorInfo* di) {
   }
 }
 
-EventHandlerImplementation::EventHandlerImplementation()
-    : socket_map_(&SimpleHashMap::SamePointerValue, 16) {
+EventHandlerShard::EventHandlerShard(EventHandlerImplementation* owner,
+                                     intptr_t index)
+    : owner_(owner),
+      index_(index),
+      socket_map_(&SimpleHashMap::SamePointerValue, 16) {
   intptr_t result;
   result = NO_RETRY_EXPECTED(pipe(interrupt_fds_));
   if (result != 0) {
@@ -125,7 +128,7 @@ static void DeleteDescriptorInfo(void* info) {
   delete di;
 }
 
-EventHandlerImplementation::~EventHandlerImplementation() {
+EventHandlerShard::~EventHandlerShard() {
   socket_map_.Clear(DeleteDescriptorInfo);
   close(epoll_fd_);
   close(timer_fd_);
@@ -133,8 +136,8 @@ EventHandlerImplementation::~EventHandlerImplementation() {
   close(interrupt_fds_[1]);
 }
 
-void EventHandlerImplementation::UpdateEpollInstance(intptr_t old_mask,
-                                                     DescriptorInfo* di) {
+void EventHandlerShard::UpdateEpollInstance(intptr_t old_mask,
+                                            DescriptorInfo* di) {
   intptr_t new_mask = di->Mask();
   if ((old_mask != 0) && (new_mask == 0)) {
     RemoveFromEpollInstance(epoll_fd_, di);
@@ -147,9 +150,8 @@ void EventHandlerImplementation::UpdateEpollInstance(intptr_t old_mask,
   }
 }
 
-DescriptorInfo* EventHandlerImplementation::GetDescriptorInfo(
-    intptr_t fd,
-    bool is_listening) {
+DescriptorInfo* EventHandlerShard::GetDescriptorInfo(intptr_t fd,
+                                                     bool is_listening) {
   ASSERT(fd >= 0);
   SimpleHashMap::Entry* entry = socket_map_.Lookup(
       GetHashmapKeyFromFd(fd), GetHashmapHashFromFd(fd), true);
@@ -169,9 +171,9 @@ DescriptorInfo* EventHandlerImplementation::GetDescriptorInfo(
   return di;
 }
 
-void EventHandlerImplementation::WakeupHandler(intptr_t id,
-                                               Dart_Port dart_port,
-                                               int64_t data) {
+void EventHandlerShard::WakeupHandler(intptr_t id,
+                                      Dart_Port dart_port,
+                                      int64_t data) {
   InterruptMessage msg;
   msg.id = id;
   msg.dart_port = dart_port;
@@ -190,7 +192,7 @@ void EventHandlerImplementation::WakeupHandler(intptr_t id,
   }
 }
 
-void EventHandlerImplementation::HandleInterruptFd() {
+void EventHandlerShard::HandleInterruptFd() {
   const intptr_t MAX_MESSAGES = kInterruptMessageSize;
   InterruptMessage msg[MAX_MESSAGES];
   ssize_t bytes = TEMP_FAILURE_RETRY_NO_SIGNAL_BLOCKER(
@@ -276,7 +278,7 @@ void EventHandlerImplementation::HandleInterruptFd() {
   }
 }
 
-void EventHandlerImplementation::UpdateTimerFd() {
+void EventHandlerShard::UpdateTimerFd() {
   struct itimerspec it;
   memset(&it, 0, sizeof(it));
   if (timeout_queue_.HasTimeout()) {
@@ -320,8 +322,8 @@ static void PrintEventMask(intptr_t fd, intptr_t events) {
 }
 #endif
 
-intptr_t EventHandlerImplementation::GetPollEvents(intptr_t events,
-                                                   DescriptorInfo* di) {
+intptr_t EventHandlerShard::GetPollEvents(intptr_t events,
+                                          DescriptorInfo* di) {
 #ifdef DEBUG_POLL
   PrintEventMask(di->fd(), events);
 #endif
@@ -342,8 +344,7 @@ intptr_t EventHandlerImplementation::GetPollEvents(intptr_t events,
   return event_mask;
 }
 
-void EventHandlerImplementation::HandleEvents(struct epoll_event* events,
-                                              int size) {
+void EventHandlerShard::HandleEvents(struct epoll_event* events, int size) {
   bool interrupt_seen = false;
   for (int i = 0; i < size; i++) {
     if (events[i].data.ptr == NULL) {
@@ -380,55 +381,111 @@ void EventHandlerImplementation::HandleEvents(struct epoll_event* events,
   }
 }
 
-void EventHandlerImplementation::Poll(uword args) {
+void EventHandlerShard::Poll(uword args) {
   ThreadSignalBlocker signal_blocker(SIGPROF);
-  static const intptr_t kMaxEvents = 16;
-  struct epoll_event events[kMaxEvents];
-  EventHandler* handler = reinterpret_cast<EventHandler*>(args);
-  EventHandlerImplementation* handler_impl = &handler->delegate_;
-  ASSERT(handler_impl != NULL);
+  EventHandlerShard* shard = reinterpret_cast<EventHandlerShard*>(args);
+  ASSERT(shard != NULL);
+  struct epoll_event* events = new struct epoll_event[kMaxEvents];
+  intptr_t max_events = kMinEvents;
 
-  while (!handler_impl->shutdown_) {
+  while (!shard->shutdown_) {
     intptr_t result = TEMP_FAILURE_RETRY_NO_SIGNAL_BLOCKER(
-        epoll_wait(handler_impl->epoll_fd_, events, kMaxEvents, -1));
+        epoll_wait(shard->epoll_fd_, events, max_events, -1));
     ASSERT(EAGAIN == EWOULDBLOCK);
     if (result <= 0) {
       if (errno != EWOULDBLOCK) {
         perror("Poll failed");
       }
     } else {
-      handler_impl->HandleEvents(events, result);
+      shard->HandleEvents(events, result);
+      // A full batch means more events are likely pending, so drain more of
+      // them per wakeup. Shrink again once the shard is mostly idle.
+      if ((result == max_events) && (max_events < kMaxEvents)) {
+        max_events *= 2;
+      } else if ((result < (max_events / 4)) && (max_events > kMinEvents)) {
+        max_events /= 2;
+      }
     }
   }
-  DEBUG_ASSERT(ReferenceCounted<Socket>::instances() == 0);
-  handler->NotifyShutdownDone();
+  delete[] events;
+  shard->owner_->NotifyShardShutdownDone();
 }
 
-void EventHandlerImplementation::Start(EventHandler* handler) {
-  int result =
-      Thread::Start("dart:io EventHandler", &EventHandlerImplementation::Poll,
-                    reinterpret_cast<uword>(handler));
+void EventHandlerShard::Start() {
+  int result = Thread::Start("dart:io EventHandler", &EventHandlerShard::Poll,
+                             reinterpret_cast<uword>(this));
   if (result != 0) {
     FATAL1("Failed to start event handler thread %d", result);
   }
 }
 
+EventHandlerImplementation::EventHandlerImplementation()
+    : handler_(NULL),
+      shards_(NULL),
+      shard_count_(EventHandler::thread_count()),
+      running_shards_(0) {
+  ASSERT(shard_count_ >= 1);
+  shards_ = new EventHandlerShard*[shard_count_];
+  for (intptr_t i = 0; i < shard_count_; i++) {
+    shards_[i] = new EventHandlerShard(this, i);
+  }
+}
+
+EventHandlerImplementation::~EventHandlerImplementation() {
+  for (intptr_t i = 0; i < shard_count_; i++) {
+    delete shards_[i];
+  }
+  delete[] shards_;
+}
+
+void EventHandlerImplementation::Start(EventHandler* handler) {
+  handler_ = handler;
+  running_shards_ = shard_count_;
+  for (intptr_t i = 0; i < shard_count_; i++) {
+    shards_[i]->Start();
+  }
+}
+
 void EventHandlerImplementation::Shutdown() {
-  SendData(kShutdownId, 0, 0);
+  for (intptr_t i = 0; i < shard_count_; i++) {
+    shards_[i]->WakeupHandler(kShutdownId, 0, 0);
+  }
+}
+
+void EventHandlerImplementation::NotifyShardShutdownDone() {
+  if (running_shards_.fetch_sub(1) == 1) {
+    DEBUG_ASSERT(ReferenceCounted<Socket>::instances() == 0);
+    handler_->NotifyShutdownDone();
+  }
+}
+
+EventHandlerShard* EventHandlerImplementation::ShardFor(intptr_t id,
+                                                        Dart_Port dart_port) {
+  if (shard_count_ == 1) {
+    return shards_[0];
+  }
+  if (id == kTimerId) {
+    return shards_[dart::Utils::WordHash(dart_port) % shard_count_];
+  }
+  ASSERT(id != kShutdownId);
+  // A socket whose fd is already closed is ignored by whichever shard
+  // receives the message.
+  const intptr_t fd = reinterpret_cast<Socket*>(id)->fd();
+  return shards_[(fd < 0) ? 0 : (fd % shard_count_)];
 }
 
 void EventHandlerImplementation::SendData(intptr_t id,
                                           Dart_Port dart_port,
                                           int64_t data) {
-  WakeupHandler(id, dart_port, data);
+  ShardFor(id, dart_port)->WakeupHandler(id, dart_port, data);
 }
 
-void* EventHandlerImplementation::GetHashmapKeyFromFd(intptr_t fd) {
+void* EventHandlerShard::GetHashmapKeyFromFd(intptr_t fd) {
   // The hashmap does not support keys with value 0.
   return reinterpret_cast<void*>(fd + 1);
 }
 
-uint32_t EventHandlerImplementation::GetHashmapHashFromFd(intptr_t fd) {
+uint32_t EventHandlerShard::GetHashmapHashFromFd(intptr_t fd) {
   // The hashmap does not support keys with value 0.
   return dart::Utils::WordHash(fd + 1);
 }
@@ -14,6 +14,8 @@
 #include <sys/socket.h>
 #include <unistd.h>
 
+#include <atomic>
+
 #include "platform/hashmap.h"
 #include "platform/signal_blocker.h"
 
@@ -58,31 +60,42 @@ class DescriptorInfoMultiple
   DISALLOW_COPY_AND_ASSIGN(DescriptorInfoMultiple);
 };
 
-class EventHandlerImplementation {
+class EventHandlerImplementation;
+
+// A single epoll instance together with its own timerfd, interrupt pipe and
+// descriptor table. Each shard is served by its own poll thread.
+class EventHandlerShard {
  public:
-  EventHandlerImplementation();
-  ~EventHandlerImplementation();
+  EventHandlerShard(EventHandlerImplementation* owner, intptr_t index);
+  ~EventHandlerShard();
 
   void UpdateEpollInstance(intptr_t old_mask, DescriptorInfo* di);
 
   // Gets the socket data structure for a given file
   // descriptor. Creates a new one if one is not found.
   DescriptorInfo* GetDescriptorInfo(intptr_t fd, bool is_listening);
-  void SendData(intptr_t id, Dart_Port dart_port, int64_t data);
-  void Start(EventHandler* handler);
-  void Shutdown();
+  void WakeupHandler(intptr_t id, Dart_Port dart_port, int64_t data);
+  void Start();
+
+  intptr_t index() const { return index_; }
+
+  // Bounds for the number of epoll events drained per wakeup. The batch size
+  // grows while epoll_wait keeps returning full batches and shrinks again
+  // once the load goes down.
+  static const intptr_t kMinEvents = 16;
+  static const intptr_t kMaxEvents = 1024;
 
  private:
   void HandleEvents(struct epoll_event* events, int size);
   static void Poll(uword args);
-  void WakeupHandler(intptr_t id, Dart_Port dart_port, int64_t data);
   void HandleInterruptFd();
   void UpdateTimerFd();
-  void SetPort(intptr_t fd, Dart_Port dart_port, intptr_t mask);
   intptr_t GetPollEvents(intptr_t events, DescriptorInfo* di);
   static void* GetHashmapKeyFromFd(intptr_t fd);
   static uint32_t GetHashmapHashFromFd(intptr_t fd);
 
+  EventHandlerImplementation* owner_;
+  const intptr_t index_;
   SimpleHashMap socket_map_;
   TimeoutQueue timeout_queue_;
   bool shutdown_;
@@ -90,6 +103,36 @@ class EventHandlerImplementation {
   int epoll_fd_;
   int timer_fd_;
 
+  DISALLOW_COPY_AND_ASSIGN(EventHandlerShard);
+};
+
+class EventHandlerImplementation {
+ public:
+  EventHandlerImplementation();
+  ~EventHandlerImplementation();
+
+  void SendData(intptr_t id, Dart_Port dart_port, int64_t data);
+  void Start(EventHandler* handler);
+  void Shutdown();
+
+  intptr_t shard_count() const { return shard_count_; }
+
+ private:
+  friend class EventHandlerShard;
+
+  // Descriptors are sharded by fd so that all messages for a descriptor, and
+  // any later descriptor reusing the same fd, are handled in order by the same
+  // poll thread. Timers are sharded by their port.
+  EventHandlerShard* ShardFor(intptr_t id, Dart_Port dart_port);
+
+  // Called by each shard once its poll thread has exited.
+  void NotifyShardShutdownDone();
+
+  EventHandler* handler_;
+  EventHandlerShard** shards_;
+  intptr_t shard_count_;
+  std::atomic<intptr_t> running_shards_;
+
   DISALLOW_COPY_AND_ASSIGN(EventHandlerImplementation);
 };
 
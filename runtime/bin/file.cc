@@ -35,13 +35,18 @@ static bool IsFile(Dart_Handle file_obj) {
 // The file pointer has been passed into Dart as an intptr_t and it is safe
 // to pull it out of Dart as a 64-bit integer, cast it to an intptr_t and
 // from there to a File pointer.
-static File* GetFile(Dart_NativeArguments args) {
+File* File::GetFileNativeField(Dart_Handle file_obj) {
   File* file;
-  Dart_Handle dart_this = ThrowIfError(Dart_GetNativeArgument(args, 0));
-  DEBUG_ASSERT(IsFile(dart_this));
+  DEBUG_ASSERT(IsFile(file_obj));
   Dart_Handle result = Dart_GetNativeInstanceField(
-      dart_this, kFileNativeFieldIndex, reinterpret_cast<intptr_t*>(&file));
+      file_obj, kFileNativeFieldIndex, reinterpret_cast<intptr_t*>(&file));
   ASSERT(!Dart_IsError(result));
+  return file;
+}
+
+static File* GetFile(Dart_NativeArguments args) {
+  Dart_Handle dart_this = ThrowIfError(Dart_GetNativeArgument(args, 0));
+  File* file = File::GetFileNativeField(dart_this);
   if (file == NULL) {
     Dart_PropagateError(Dart_NewUnhandledExceptionError(
         DartUtils::NewInternalError("No native peer")));
@@ -108,6 +108,10 @@ class File : public ReferenceCounted<File> {
 
   intptr_t GetFD();
 
+  // Returns the File wrapped by a _RandomAccessFileOpsImpl object, or NULL if
+  // it has been closed.
+  static File* GetFileNativeField(Dart_Handle file_obj);
+
   enum MapType {
     kReadOnly = 0,
     kReadExecute = 1,
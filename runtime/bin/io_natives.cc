@@ -155,10 +155,15 @@ namespace bin {
   V(Socket_LeaveMulticast, 4)                                                  \
   V(Socket_Read, 2)                                                            \
   V(Socket_RecvFrom, 1)                                                        \
+  V(Socket_SendFile, 4)                                                        \
   V(Socket_SendTo, 6)                                                          \
   V(Socket_SetOption, 4)                                                       \
   V(Socket_SetRawOption, 4)                                                    \
   V(Socket_SetSocketId, 3)                                                     \
+  V(Socket_UringAvailable, 0)                                                  \
+  V(Socket_UringCancelReceive, 1)                                              \
+  V(Socket_UringReceive, 2)                                                    \
+  V(Socket_UringSend, 5)                                                       \
   V(Socket_WriteList, 4)                                                       \
   V(Stdin_ReadByte, 1)                                                         \
   V(Stdin_GetEchoMode, 1)                                                      \
@@ -0,0 +1,1014 @@
+// Copyright (c) 2021, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "platform/globals.h"
+#if defined(HOST_OS_LINUX)
+
+#include "bin/io_uring_linux.h"
+
+#include <errno.h>        // NOLINT
+#include <string.h>       // NOLINT
+#include <sys/mman.h>     // NOLINT
+#include <sys/socket.h>   // NOLINT
+#include <sys/syscall.h>  // NOLINT
+#include <unistd.h>       // NOLINT
+
+#if defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>  // NOLINT
+#endif
+#endif
+
+#include "bin/file.h"
+#include "bin/io_buffer.h"
+#include "bin/lockers.h"
+#include "bin/socket.h"
+#include "bin/utils.h"
+#include "platform/signal_blocker.h"
+#include "platform/syslog.h"
+
+#if defined(DART_IO_SECURE_SOCKET_DISABLED)
+#include "bin/io_service_no_ssl.h"
+#else
+#include "bin/io_service.h"
+#endif
+
+// The sysroot used for some builds predates io_uring. In that case the
+// IOService always uses the synchronous implementation, and sockets always
+// use readiness events.
+#if defined(IORING_OFF_SQ_RING) && defined(IORING_FEAT_RW_CUR_POS) &&         \
+    defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter)
+#define DART_IO_URING_SUPPORTED
+#endif
+
+namespace dart {
+namespace bin {
+
+bool IOUring::enabled_ = false;
+IOUring* IOUring::instance_ = nullptr;
+Mutex* IOUring::instance_mutex_ = nullptr;
+bool IOUring::setup_failed_ = false;
+
+void IOUring::Init() {
+  ASSERT(instance_mutex_ == nullptr);
+  instance_mutex_ = new Mutex();
+}
+
+void IOUring::Cleanup() {
+  if (instance_mutex_ == nullptr) {
+    return;
+  }
+  {
+    MutexLocker ml(instance_mutex_);
+    if (instance_ != nullptr) {
+      if (instance_->Shutdown()) {
+        delete instance_;
+      } else {
+        // The completion thread is stuck and may still touch the rings.
+        Syslog::PrintErr("Timed out stopping the io_uring completion thread\n");
+      }
+      instance_ = nullptr;
+    }
+    setup_failed_ = false;
+  }
+  delete instance_mutex_;
+  instance_mutex_ = nullptr;
+}
+
+IOUring* IOUring::Get() {
+  if (!enabled_ || (instance_mutex_ == nullptr)) {
+    return nullptr;
+  }
+  MutexLocker ml(instance_mutex_);
+  if ((instance_ == nullptr) && !setup_failed_) {
+    IOUring* uring = new IOUring();
+    if (uring->Setup()) {
+      instance_ = uring;
+    } else {
+      delete uring;
+      setup_failed_ = true;
+    }
+  }
+  return instance_;
+}
+
+void IOUring::NotifyCompletionThreadDone() {
+  MonitorLocker ml(&monitor_);
+  completion_thread_done_ = true;
+  ml.NotifyAll();
+}
+
+void IOUring::CompletionThreadMain(uword args) {
+  IOUring* uring = reinterpret_cast<IOUring*>(args);
+  uring->HandleCompletions();
+  uring->NotifyCompletionThreadDone();
+}
+
+#if defined(DART_IO_URING_SUPPORTED)
+
+// The number of submission queue entries.
+static const uint32_t kRingEntries = 256;
+
+// The number of completion queue entries asked for. The operations in flight
+// are bounded by half of the completion queue, which leaves room for the
+// completions of cancelling each of them.
+static const uint32_t kCompletionEntries = 4096;
+
+// The user_data of the NOP used to stop the completion thread, and of the
+// requests cancelling operations. Neither is a PendingOp address.
+static const uint64_t kShutdownUserData = 0;
+static const uint64_t kCancelUserData = 1;
+
+// How often io_uring_enter is retried when the kernel is temporarily out of
+// resources, before giving up on the ring.
+static const intptr_t kMaxEnterRetries = 100;
+
+// The longest the completion thread backs off after io_uring_enter failed.
+static const int64_t kMaxBackoffMillis = 100;
+
+// How long Cleanup waits for the operations in flight to be cancelled.
+static const int64_t kShutdownTimeoutMillis = 1000;
+
+// The size of the buffers sockets receive into.
+static const intptr_t kSocketReceiveSize = 64 * KB;
+
+struct IOUring::PendingOp {
+  enum Kind {
+    kFileRead,
+    kFileWrite,
+    kSocketReceive,
+    kSocketSend,
+  };
+
+  PendingOp* prev;
+  PendingOp* next;
+  Kind kind;
+  int fd;
+  // Exactly one of these is set. The file is retained by the Dart side for
+  // each IOService request; the socket is retained on submission.
+  File* file;
+  Socket* socket;
+  uint8_t* data;
+  int64_t length;
+  // The number of bytes written or sent so far.
+  int64_t done;
+  bool read_into;
+  Dart_Port reply_port;
+  int32_t message_id;
+};
+
+// The reply `[code, message]` describing an error, assembled from stack
+// allocated objects, since the completion thread has no API scope to
+// allocate CObjects in. Dart_PostCObject copies it.
+class ErrorValues {
+ public:
+  explicit ErrorValues(int code) {
+    os_error_.SetCodeAndMessage(OSError::kSystem, code);
+    code_.type = Dart_CObject_kInt32;
+    code_.value.as_int32 = os_error_.code();
+    message_.type = Dart_CObject_kString;
+    message_.value.as_string = os_error_.message();
+  }
+
+  Dart_CObject* code() { return &code_; }
+  Dart_CObject* message() { return &message_; }
+
+ private:
+  OSError os_error_;
+  Dart_CObject code_;
+  Dart_CObject message_;
+
+  DISALLOW_COPY_AND_ASSIGN(ErrorValues);
+};
+
+static int64_t CObjectInt32OrInt64ToInt64(CObject* cobject) {
+  ASSERT(cobject->IsInt32OrInt64());
+  int64_t result;
+  if (cobject->IsInt32()) {
+    CObjectInt32 value(cobject);
+    result = value.Value();
+  } else {
+    CObjectInt64 value(cobject);
+    result = value.Value();
+  }
+  return result;
+}
+
+static File* CObjectToFilePointer(CObject* cobject) {
+  CObjectIntptr value(cobject);
+  return reinterpret_cast<File*>(value.Value());
+}
+
+bool IOUring::IsAvailable() {
+  IOUring* uring = Get();
+  if (uring == nullptr) {
+    return false;
+  }
+  MonitorLocker ml(&uring->monitor_);
+  return uring->CanSubmitLocked();
+}
+
+bool IOUring::SubmitRequest(intptr_t request_id,
+                            Dart_Port reply_port,
+                            int32_t message_id,
+                            const CObjectArray& request) {
+  const bool read_into = request_id == IOService::kFileReadIntoRequest;
+  const bool read = read_into || (request_id == IOService::kFileReadRequest);
+  if (!read && (request_id != IOService::kFileWriteFromRequest)) {
+    return false;
+  }
+  // Malformed requests, closed files and writes of anything but byte data
+  // are handled by the synchronous implementation.
+  if ((request.Length() < 1) || !request[0]->IsIntptr()) {
+    return false;
+  }
+  int64_t start = 0;
+  int64_t length;
+  if (read) {
+    if ((request.Length() != 2) || !request[1]->IsInt32OrInt64()) {
+      return false;
+    }
+    length = CObjectInt32OrInt64ToInt64(request[1]);
+  } else {
+    if ((request.Length() != 4) || !request[1]->IsTypedData() ||
+        !request[2]->IsInt32OrInt64() || !request[3]->IsInt32OrInt64()) {
+      return false;
+    }
+    CObjectTypedData typed_data(request[1]);
+    const Dart_TypedData_Type type = typed_data.Type();
+    if ((type != Dart_TypedData_kUint8) && (type != Dart_TypedData_kInt8) &&
+        (type != Dart_TypedData_kUint8Clamped)) {
+      return false;
+    }
+    start = CObjectInt32OrInt64ToInt64(request[2]);
+    const int64_t end = CObjectInt32OrInt64ToInt64(request[3]);
+    if ((start < 0) || (end > typed_data.Length())) {
+      return false;
+    }
+    length = end - start;
+  }
+  if ((length <= 0) || (length > kMaxInt32)) {
+    return false;
+  }
+  File* file = CObjectToFilePointer(request[0]);
+  if (file->IsClosed()) {
+    return false;
+  }
+  IOUring* uring = Get();
+  if (uring == nullptr) {
+    return false;
+  }
+  // The request is freed once this returns, so written data is copied.
+  uint8_t* data = IOBuffer::Allocate(static_cast<intptr_t>(length));
+  if (data == nullptr) {
+    return false;
+  }
+  if (!read) {
+    CObjectTypedData typed_data(request[1]);
+    memmove(data, typed_data.Buffer() + start, length);
+  }
+  PendingOp* op = new PendingOp();
+  op->kind = read ? PendingOp::kFileRead : PendingOp::kFileWrite;
+  op->fd = file->GetFD();
+  op->file = file;
+  op->data = data;
+  op->length = length;
+  op->read_into = read_into;
+  op->reply_port = reply_port;
+  op->message_id = message_id;
+  if (!uring->Submit(op)) {
+    IOBuffer::Free(data);
+    delete op;
+    return false;
+  }
+  return true;
+}
+
+bool IOUring::SubmitSocketReceive(Socket* socket, Dart_Port port) {
+  IOUring* uring = Get();
+  if ((uring == nullptr) || (socket->fd() < 0)) {
+    return false;
+  }
+  uint8_t* data = IOBuffer::Allocate(kSocketReceiveSize);
+  if (data == nullptr) {
+    return false;
+  }
+  PendingOp* op = new PendingOp();
+  op->kind = PendingOp::kSocketReceive;
+  op->fd = socket->fd();
+  op->socket = socket;
+  op->data = data;
+  op->length = kSocketReceiveSize;
+  op->reply_port = port;
+  socket->Retain();
+  if (!uring->Submit(op)) {
+    socket->Release();
+    IOBuffer::Free(data);
+    delete op;
+    return false;
+  }
+  return true;
+}
+
+bool IOUring::SubmitSocketSend(Socket* socket,
+                               const uint8_t* data,
+                               intptr_t length,
+                               Dart_Port port) {
+  if ((length <= 0) || (length > kMaxInt32)) {
+    return false;
+  }
+  IOUring* uring = Get();
+  if ((uring == nullptr) || (socket->fd() < 0)) {
+    return false;
+  }
+  uint8_t* copy = IOBuffer::Allocate(length);
+  if (copy == nullptr) {
+    return false;
+  }
+  memmove(copy, data, length);
+  PendingOp* op = new PendingOp();
+  op->kind = PendingOp::kSocketSend;
+  op->fd = socket->fd();
+  op->socket = socket;
+  op->data = copy;
+  op->length = length;
+  op->reply_port = port;
+  socket->Retain();
+  if (!uring->Submit(op)) {
+    socket->Release();
+    IOBuffer::Free(copy);
+    delete op;
+    return false;
+  }
+  return true;
+}
+
+void IOUring::CancelSocketReceive(Socket* socket) {
+  IOUring* uring = Get();
+  if (uring == nullptr) {
+    return;
+  }
+  MonitorLocker ml(&uring->monitor_);
+  if (uring->shutting_down_) {
+    return;
+  }
+  for (PendingOp* op = uring->pending_ops_; op != nullptr; op = op->next) {
+    if ((op->kind == PendingOp::kSocketReceive) && (op->socket == socket)) {
+      // The ring holds its own reference to the socket, so closing the file
+      // descriptor does not end the receive. If the cancel cannot be
+      // submitted, the receive ends when the peer sends or closes, or when
+      // the ring is torn down.
+      uint64_t sequence;
+      if (uring->QueueLocked(IORING_OP_ASYNC_CANCEL, -1,
+                             reinterpret_cast<uint64_t>(op), 0,
+                             kCancelUserData, &sequence)) {
+        uring->FlushLocked(sequence);
+      }
+      return;
+    }
+  }
+}
+
+IOUring::IOUring()
+    : ring_fd_(-1),
+      sq_entries_(0),
+      cq_entries_(0),
+      sq_ring_(MAP_FAILED),
+      sq_ring_size_(0),
+      cq_ring_(MAP_FAILED),
+      cq_ring_size_(0),
+      sqes_(MAP_FAILED),
+      sqes_size_(0),
+      sq_head_(nullptr),
+      sq_tail_(nullptr),
+      sq_mask_(nullptr),
+      sq_array_(nullptr),
+      cq_head_(nullptr),
+      cq_tail_(nullptr),
+      cq_mask_(nullptr),
+      cqes_(nullptr),
+      pending_ops_(nullptr),
+      in_flight_(0),
+      max_in_flight_(0),
+      queued_(0),
+      submitted_(0),
+      resolved_(0),
+      flushing_(false),
+      failed_(false),
+      shutting_down_(false),
+      completion_thread_done_(true) {}
+
+IOUring::~IOUring() {
+  ASSERT(completion_thread_done_);
+  if (sqes_ != MAP_FAILED) {
+    munmap(sqes_, sqes_size_);
+  }
+  if (cq_ring_ != MAP_FAILED) {
+    munmap(cq_ring_, cq_ring_size_);
+  }
+  if (sq_ring_ != MAP_FAILED) {
+    munmap(sq_ring_, sq_ring_size_);
+  }
+  if (ring_fd_ != -1) {
+    close(ring_fd_);
+  }
+}
+
+bool IOUring::Setup() {
+  struct io_uring_params params;
+  memset(&params, 0, sizeof(params));
+#if defined(IORING_SETUP_CQSIZE)
+  params.flags = IORING_SETUP_CQSIZE;
+  params.cq_entries = kCompletionEntries;
+  ring_fd_ = NO_RETRY_EXPECTED(
+      syscall(__NR_io_uring_setup, kRingEntries, &params));
+  if ((ring_fd_ < 0) && (errno == EINVAL)) {
+    // Kernels before 5.5 do not support sizing the completion queue.
+    memset(&params, 0, sizeof(params));
+    ring_fd_ = NO_RETRY_EXPECTED(
+        syscall(__NR_io_uring_setup, kRingEntries, &params));
+  }
+#else
+  ring_fd_ = NO_RETRY_EXPECTED(
+      syscall(__NR_io_uring_setup, kRingEntries, &params));
+#endif
+  if (ring_fd_ < 0) {
+    // ENOSYS on kernels without io_uring, EPERM when it is disabled by a
+    // seccomp policy.
+    ring_fd_ = -1;
+    return false;
+  }
+  // Reads and writes are issued at the current file position (offset -1),
+  // just like the read() and write() done by the synchronous implementation.
+  if ((params.features & IORING_FEAT_RW_CUR_POS) == 0) {
+    return false;
+  }
+  sq_entries_ = params.sq_entries;
+  cq_entries_ = params.cq_entries;
+  max_in_flight_ = cq_entries_ / 2 - 1;
+
+  sq_ring_size_ = params.sq_off.array + sq_entries_ * sizeof(uint32_t);
+  sq_ring_ = mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE,
+                  MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQ_RING);
+  if (sq_ring_ == MAP_FAILED) {
+    return false;
+  }
+  cq_ring_size_ =
+      params.cq_off.cqes + cq_entries_ * sizeof(struct io_uring_cqe);
+  cq_ring_ = mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE,
+                  MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_CQ_RING);
+  if (cq_ring_ == MAP_FAILED) {
+    return false;
+  }
+  sqes_size_ = sq_entries_ * sizeof(struct io_uring_sqe);
+  sqes_ = mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE,
+               MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQES);
+  if (sqes_ == MAP_FAILED) {
+    return false;
+  }
+
+  uint8_t* sq = reinterpret_cast<uint8_t*>(sq_ring_);
+  sq_head_ = reinterpret_cast<uint32_t*>(sq + params.sq_off.head);
+  sq_tail_ = reinterpret_cast<uint32_t*>(sq + params.sq_off.tail);
+  sq_mask_ = reinterpret_cast<uint32_t*>(sq + params.sq_off.ring_mask);
+  sq_array_ = reinterpret_cast<uint32_t*>(sq + params.sq_off.array);
+  uint8_t* cq = reinterpret_cast<uint8_t*>(cq_ring_);
+  cq_head_ = reinterpret_cast<uint32_t*>(cq + params.cq_off.head);
+  cq_tail_ = reinterpret_cast<uint32_t*>(cq + params.cq_off.tail);
+  cq_mask_ = reinterpret_cast<uint32_t*>(cq + params.cq_off.ring_mask);
+  cqes_ = cq + params.cq_off.cqes;
+
+  completion_thread_done_ = false;
+  int result = Thread::Start("dart:io io_uring", &CompletionThreadMain,
+                             reinterpret_cast<uword>(this));
+  if (result != 0) {
+    completion_thread_done_ = true;
+    return false;
+  }
+  return true;
+}
+
+bool IOUring::Shutdown() {
+  MonitorLocker ml(&monitor_);
+  shutting_down_ = true;
+  if (completion_thread_done_) {
+    return true;
+  }
+  // Socket receives and reads from pipes or devices may never complete on
+  // their own. The completion thread waits for all operations, so that their
+  // buffers and references are released. The targets are collected first,
+  // since queueing may wait for a flush and let operations complete.
+  const intptr_t count = in_flight_;
+  uint64_t* targets =
+      reinterpret_cast<uint64_t*>(malloc(count * sizeof(uint64_t)));
+  intptr_t i = 0;
+  for (PendingOp* op = pending_ops_; op != nullptr; op = op->next) {
+    targets[i++] = reinterpret_cast<uint64_t>(op);
+  }
+  ASSERT(i == count);
+  bool stopping = true;
+  uint64_t sequence;
+  for (i = 0; stopping && (i < count); i++) {
+    stopping = QueueLocked(IORING_OP_ASYNC_CANCEL, -1, targets[i], 0,
+                           kCancelUserData, &sequence);
+  }
+  free(targets);
+  stopping = stopping &&
+             QueueLocked(IORING_OP_NOP, -1, 0, 0, kShutdownUserData,
+                         &sequence) &&
+             FlushLocked(sequence);
+  if (!stopping) {
+    return false;
+  }
+  const int64_t deadline =
+      TimerUtils::GetCurrentMonotonicMillis() + kShutdownTimeoutMillis;
+  while (!completion_thread_done_) {
+    const int64_t remaining =
+        deadline - TimerUtils::GetCurrentMonotonicMillis();
+    if (remaining <= 0) {
+      break;
+    }
+    ml.Wait(remaining);
+  }
+  return completion_thread_done_;
+}
+
+bool IOUring::CanSubmitLocked() const {
+  return !failed_ && !shutting_down_ && (in_flight_ < max_in_flight_);
+}
+
+void IOUring::LinkLocked(PendingOp* op) {
+  op->prev = nullptr;
+  op->next = pending_ops_;
+  if (pending_ops_ != nullptr) {
+    pending_ops_->prev = op;
+  }
+  pending_ops_ = op;
+  in_flight_++;
+}
+
+void IOUring::UnlinkLocked(PendingOp* op) {
+  if (op->prev != nullptr) {
+    op->prev->next = op->next;
+  } else {
+    pending_ops_ = op->next;
+  }
+  if (op->next != nullptr) {
+    op->next->prev = op->prev;
+  }
+  in_flight_--;
+}
+
+bool IOUring::Submit(PendingOp* op) {
+  MonitorLocker ml(&monitor_);
+  if (!CanSubmitLocked()) {
+    return false;
+  }
+  LinkLocked(op);
+  uint64_t sequence;
+  if (QueueLocked(op, &sequence) && FlushLocked(sequence)) {
+    // `op` may already be completed and freed by the completion thread.
+    return true;
+  }
+  // The kernel never saw the SQE, so the completion thread cannot know `op`.
+  UnlinkLocked(op);
+  return false;
+}
+
+bool IOUring::QueueLocked(uint8_t opcode,
+                          int fd,
+                          uint64_t addr,
+                          uint32_t length,
+                          uint64_t user_data,
+                          uint64_t* sequence) {
+  // Make room by submitting what is queued already.
+  while (!failed_ &&
+         ((*sq_tail_ - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE)) >=
+          sq_entries_)) {
+    FlushLocked(queued_ - 1);
+  }
+  if (failed_) {
+    return false;
+  }
+  // Only threads holding monitor_ write the submission queue tail.
+  const uint32_t tail = *sq_tail_;
+  const uint32_t index = tail & *sq_mask_;
+  struct io_uring_sqe* sqe =
+      reinterpret_cast<struct io_uring_sqe*>(sqes_) + index;
+  memset(sqe, 0, sizeof(*sqe));
+  sqe->opcode = opcode;
+  sqe->fd = fd;
+  // File reads and writes use the current file position. Other requests
+  // must not have an offset.
+  const bool positioned =
+      (opcode == IORING_OP_READ) || (opcode == IORING_OP_WRITE);
+  sqe->off = positioned ? static_cast<uint64_t>(-1) : 0;
+  sqe->addr = addr;
+  sqe->len = length;
+  if (opcode == IORING_OP_SEND) {
+    sqe->msg_flags = MSG_NOSIGNAL;
+  }
+  sqe->user_data = user_data;
+  sq_array_[index] = index;
+  __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+  *sequence = queued_++;
+  return true;
+}
+
+bool IOUring::QueueLocked(PendingOp* op, uint64_t* sequence) {
+  uint8_t opcode;
+  switch (op->kind) {
+    case PendingOp::kFileRead:
+      opcode = IORING_OP_READ;
+      break;
+    case PendingOp::kFileWrite:
+      opcode = IORING_OP_WRITE;
+      break;
+    case PendingOp::kSocketReceive:
+      opcode = IORING_OP_RECV;
+      break;
+    case PendingOp::kSocketSend:
+      opcode = IORING_OP_SEND;
+      break;
+    default:
+      UNREACHABLE();
+      return false;
+  }
+  return QueueLocked(opcode, op->fd,
+                     reinterpret_cast<uint64_t>(op->data + op->done),
+                     static_cast<uint32_t>(op->length - op->done),
+                     reinterpret_cast<uint64_t>(op), sequence);
+}
+
+bool IOUring::FlushLocked(uint64_t sequence) {
+  while (sequence >= resolved_) {
+    if (flushing_) {
+      // Another thread is in io_uring_enter and submits this SQE as well, or
+      // leaves it to the next flush.
+      monitor_.Wait(Monitor::kNoTimeout);
+      continue;
+    }
+    flushing_ = true;
+    intptr_t retries = 0;
+    while (!failed_ && (submitted_ < queued_)) {
+      const uint32_t to_submit = static_cast<uint32_t>(queued_ - submitted_);
+      monitor_.Exit();
+      const intptr_t result = syscall(__NR_io_uring_enter, ring_fd_,
+                                      to_submit, 0, 0, nullptr, 0);
+      const int error = errno;
+      monitor_.Enter();
+      if (result > 0) {
+        submitted_ += result;
+        retries = 0;
+      } else if ((result < 0) && (error == EINTR)) {
+        continue;
+      } else if (((result == 0) || (error == EAGAIN) || (error == EBUSY)) &&
+                 (++retries <= kMaxEnterRetries)) {
+        // The kernel is short of resources for now.
+        monitor_.Exit();
+        TimerUtils::Sleep(1);
+        monitor_.Enter();
+      } else {
+        Syslog::PrintErr(
+            "io_uring_enter failed (%d), falling back to blocking I/O\n",
+            (result < 0) ? error : 0);
+        failed_ = true;
+      }
+    }
+    if (failed_) {
+      // Take back the SQEs the kernel has not consumed. Their submitters fall
+      // back to the synchronous implementation.
+      __atomic_store_n(sq_tail_, __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE),
+                       __ATOMIC_RELEASE);
+      queued_ = submitted_;
+      resolved_ = kMaxUint64;
+    } else {
+      resolved_ = submitted_;
+    }
+    flushing_ = false;
+    monitor_.NotifyAll();
+  }
+  return sequence < submitted_;
+}
+
+void IOUring::Complete(PendingOp* op, int32_t result) {
+  const bool streaming = (op->kind == PendingOp::kFileWrite) ||
+                         (op->kind == PendingOp::kSocketSend);
+  if (streaming && (result > 0)) {
+    op->done += result;
+  }
+  bool shutting_down;
+  {
+    MonitorLocker ml(&monitor_);
+    if (streaming && (result > 0) && (op->done < op->length) &&
+        !shutting_down_) {
+      // Write the rest, like write() and send() are repeated by the
+      // synchronous implementations.
+      uint64_t sequence;
+      if (QueueLocked(op, &sequence) && FlushLocked(sequence)) {
+        return;
+      }
+    }
+    UnlinkLocked(op);
+    shutting_down = shutting_down_;
+  }
+  if (shutting_down) {
+    // The ports may be gone already.
+    Discard(op);
+    return;
+  }
+  switch (op->kind) {
+    case PendingOp::kFileRead:
+      CompleteFileRead(op, result);
+      break;
+    case PendingOp::kFileWrite:
+      CompleteFileWrite(op, result);
+      break;
+    case PendingOp::kSocketReceive:
+      CompleteSocketReceive(op, result);
+      break;
+    case PendingOp::kSocketSend:
+      CompleteSocketSend(op, result);
+      break;
+  }
+}
+
+static void PostReply(Dart_Port reply_port,
+                      int32_t message_id,
+                      Dart_CObject* response) {
+  Dart_CObject id;
+  id.type = Dart_CObject_kInt32;
+  id.value.as_int32 = message_id;
+  Dart_CObject* reply_values[2] = {&id, response};
+  Dart_CObject reply;
+  reply.type = Dart_CObject_kArray;
+  reply.value.as_array.length = 2;
+  reply.value.as_array.values = reply_values;
+  Dart_PostCObject(reply_port, &reply);
+}
+
+static void PostOSErrorReply(Dart_Port reply_port,
+                             int32_t message_id,
+                             int code) {
+  ErrorValues error(code);
+  Dart_CObject status;
+  status.type = Dart_CObject_kInt32;
+  status.value.as_int32 = CObject::kOSError;
+  Dart_CObject* response_values[3] = {&status, error.code(),
+                                      error.message()};
+  Dart_CObject response;
+  response.type = Dart_CObject_kArray;
+  response.value.as_array.length = 3;
+  response.value.as_array.values = response_values;
+  PostReply(reply_port, message_id, &response);
+}
+
+void IOUring::CompleteFileRead(PendingOp* op, int32_t result) {
+  if (result < 0) {
+    IOBuffer::Free(op->data);
+    PostOSErrorReply(op->reply_port, op->message_id, -result);
+  } else {
+    Dart_CObject status;
+    status.type = Dart_CObject_kInt32;
+    status.value.as_int32 = CObject::kSuccess;
+    Dart_CObject data;
+    data.type = Dart_CObject_kExternalTypedData;
+    data.value.as_external_typed_data.type = Dart_TypedData_kUint8;
+    data.value.as_external_typed_data.length = op->length;
+    data.value.as_external_typed_data.data = op->data;
+    data.value.as_external_typed_data.peer = op->data;
+    data.value.as_external_typed_data.callback = IOBuffer::Finalizer;
+    CObject::ShrinkIOBuffer(&data, result);
+    Dart_CObject bytes_read;
+    bytes_read.type = Dart_CObject_kInt64;
+    bytes_read.value.as_int64 = result;
+    Dart_CObject* response_values[3];
+    Dart_CObject response;
+    response.type = Dart_CObject_kArray;
+    response.value.as_array.values = response_values;
+    response_values[0] = &status;
+    if (op->read_into) {
+      response_values[1] = &bytes_read;
+      response_values[2] = &data;
+      response.value.as_array.length = 3;
+    } else {
+      response_values[1] = &data;
+      response.value.as_array.length = 2;
+    }
+    // Frees the data through the finalizer if posting fails.
+    PostReply(op->reply_port, op->message_id, &response);
+  }
+  // Balances the retain done by the Dart side before issuing the request.
+  op->file->Release();
+  delete op;
+}
+
+void IOUring::CompleteFileWrite(PendingOp* op, int32_t result) {
+  int error = (result < 0) ? -result : 0;
+  if ((error == 0) && (op->done < op->length)) {
+    // The write made no progress or could not be resubmitted. Write the rest
+    // here, like the synchronous implementation would.
+    if (!op->file->WriteFully(op->data + op->done, op->length - op->done)) {
+      error = errno;
+    }
+  }
+  if (error != 0) {
+    PostOSErrorReply(op->reply_port, op->message_id, error);
+  } else {
+    Dart_CObject length;
+    length.type = Dart_CObject_kInt64;
+    length.value.as_int64 = op->length;
+    PostReply(op->reply_port, op->message_id, &length);
+  }
+  IOBuffer::Free(op->data);
+  op->file->Release();
+  delete op;
+}
+
+void IOUring::CompleteSocketReceive(PendingOp* op, int32_t result) {
+  if (result == -ECANCELED) {
+    // Cancelled by CancelSocketReceive; the socket is being closed.
+    Discard(op);
+    return;
+  }
+  Dart_CObject tag;
+  tag.type = Dart_CObject_kInt32;
+  tag.value.as_int32 = kSocketReceived;
+  Dart_CObject payload;
+  Dart_CObject* message_values[2] = {&tag, &payload};
+  Dart_CObject message;
+  message.type = Dart_CObject_kArray;
+  message.value.as_array.length = 2;
+  message.value.as_array.values = message_values;
+  if (result > 0) {
+    payload.type = Dart_CObject_kExternalTypedData;
+    payload.value.as_external_typed_data.type = Dart_TypedData_kUint8;
+    payload.value.as_external_typed_data.length = op->length;
+    payload.value.as_external_typed_data.data = op->data;
+    payload.value.as_external_typed_data.peer = op->data;
+    payload.value.as_external_typed_data.callback = IOBuffer::Finalizer;
+    CObject::ShrinkIOBuffer(&payload, result);
+    Dart_PostCObject(op->reply_port, &message);
+  } else {
+    IOBuffer::Free(op->data);
+    if (result == 0) {
+      payload.type = Dart_CObject_kNull;
+      Dart_PostCObject(op->reply_port, &message);
+    } else {
+      ErrorValues error(-result);
+      Dart_CObject* error_values[2] = {error.code(), error.message()};
+      payload.type = Dart_CObject_kArray;
+      payload.value.as_array.length = 2;
+      payload.value.as_array.values = error_values;
+      Dart_PostCObject(op->reply_port, &message);
+    }
+  }
+  op->socket->Release();
+  delete op;
+}
+
+void IOUring::CompleteSocketSend(PendingOp* op, int32_t result) {
+  Dart_CObject tag;
+  tag.type = Dart_CObject_kInt32;
+  tag.value.as_int32 = kSocketSent;
+  Dart_CObject payload;
+  Dart_CObject* message_values[2] = {&tag, &payload};
+  Dart_CObject message;
+  message.type = Dart_CObject_kArray;
+  message.value.as_array.length = 2;
+  message.value.as_array.values = message_values;
+  int error = (result < 0) ? -result : 0;
+  if ((error == 0) && (op->done < op->length)) {
+    // The send made no progress or the rest could not be resubmitted.
+    error = EIO;
+  }
+  if (error == 0) {
+    payload.type = Dart_CObject_kNull;
+    Dart_PostCObject(op->reply_port, &message);
+  } else {
+    ErrorValues error_values(error);
+    Dart_CObject* values[2] = {error_values.code(), error_values.message()};
+    payload.type = Dart_CObject_kArray;
+    payload.value.as_array.length = 2;
+    payload.value.as_array.values = values;
+    Dart_PostCObject(op->reply_port, &message);
+  }
+  IOBuffer::Free(op->data);
+  op->socket->Release();
+  delete op;
+}
+
+void IOUring::Discard(PendingOp* op) {
+  IOBuffer::Free(op->data);
+  if (op->file != nullptr) {
+    op->file->Release();
+  } else {
+    op->socket->Release();
+  }
+  delete op;
+}
+
+void IOUring::HandleCompletions() {
+  bool stopping = false;
+  int64_t backoff = 0;
+  while (true) {
+    {
+      MonitorLocker ml(&monitor_);
+      if (stopping && (in_flight_ == 0)) {
+        break;
+      }
+    }
+    const intptr_t result = syscall(__NR_io_uring_enter, ring_fd_, 0, 1,
+                                    IORING_ENTER_GETEVENTS, nullptr, 0);
+    if ((result < 0) && (errno != EINTR)) {
+      const int error = errno;
+      if ((error != EAGAIN) && (error != EBUSY)) {
+        // The ring is unusable. Stop submitting, but keep reaping: the
+        // operations in flight own buffers and references.
+        MonitorLocker ml(&monitor_);
+        if (!failed_) {
+          Syslog::PrintErr("io_uring_enter failed (%d) waiting for events\n",
+                           error);
+          failed_ = true;
+        }
+      }
+      backoff = Utils::Minimum(backoff + 1, kMaxBackoffMillis);
+      TimerUtils::Sleep(backoff);
+    } else {
+      backoff = 0;
+    }
+    uint32_t head = *cq_head_;
+    const uint32_t tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+    while (head != tail) {
+      struct io_uring_cqe* cqe =
+          reinterpret_cast<struct io_uring_cqe*>(cqes_) + (head & *cq_mask_);
+      const uint64_t user_data = cqe->user_data;
+      const int32_t res = cqe->res;
+      // Release the entry first, since completing may submit more.
+      head++;
+      __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+      if (user_data == kShutdownUserData) {
+        stopping = true;
+      } else if (user_data != kCancelUserData) {
+        Complete(reinterpret_cast<PendingOp*>(user_data), res);
+      }
+    }
+  }
+}
+
+#else  // defined(DART_IO_URING_SUPPORTED)
+
+struct IOUring::PendingOp {};
+
+bool IOUring::IsAvailable() {
+  return false;
+}
+
+bool IOUring::SubmitRequest(intptr_t request_id,
+                            Dart_Port reply_port,
+                            int32_t message_id,
+                            const CObjectArray& request) {
+  return false;
+}
+
+bool IOUring::SubmitSocketReceive(Socket* socket, Dart_Port port) {
+  return false;
+}
+
+bool IOUring::SubmitSocketSend(Socket* socket,
+                               const uint8_t* data,
+                               intptr_t length,
+                               Dart_Port port) {
+  return false;
+}
+
+void IOUring::CancelSocketReceive(Socket* socket) {}
+
+IOUring::IOUring()
+    : ring_fd_(-1),
+      pending_ops_(nullptr),
+      in_flight_(0),
+      shutting_down_(false),
+      completion_thread_done_(true) {}
+
+IOUring::~IOUring() {}
+
+bool IOUring::Setup() {
+  return false;
+}
+
+bool IOUring::Shutdown() {
+  return true;
+}
+
+void IOUring::HandleCompletions() {
+  UNREACHABLE();
+}
+
+#endif  // defined(DART_IO_URING_SUPPORTED)
+
+}  // namespace bin
+}  // namespace dart
+
+#endif  // defined(HOST_OS_LINUX)
@@ -0,0 +1,195 @@
+// Copyright (c) 2021, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef RUNTIME_BIN_IO_URING_LINUX_H_
+#define RUNTIME_BIN_IO_URING_LINUX_H_
+
+#include "platform/globals.h"
+#if defined(HOST_OS_LINUX)
+
+#include "bin/builtin.h"
+#include "bin/dartutils.h"
+#include "bin/thread.h"
+
+namespace dart {
+namespace bin {
+
+class File;
+class Socket;
+
+// An io_uring instance used to complete I/O without blocking a thread on each
+// operation:
+//
+//  * File reads and writes issued through the IOService are submitted as SQEs
+//    from the IOService callback instead of blocking a thread-pool thread.
+//  * TCP sockets receive into a buffer owned by the ring instead of reading
+//    after a readiness event, and hand the part of a write that did not fit
+//    into the socket buffer to the ring instead of waiting for the socket to
+//    become writable.
+//
+// A dedicated completion thread posts the results straight to the Dart ports.
+//
+// SQEs are queued under a lock and submitted together: a thread that finds
+// another thread already in io_uring_enter leaves its SQEs to that thread and
+// waits until the kernel has consumed them.
+//
+// When io_uring is disabled, the running kernel does not support it, the ring
+// is full or io_uring_enter fails, the operations fall back to the
+// synchronous IOService implementation and to epoll readiness events.
+class IOUring {
+ public:
+  // The first element of the messages posted to a socket's port. They are
+  // followed by:
+  //  * kSocketReceived: the received data, null at the end of the stream, or
+  //    [error code, error message].
+  //  * kSocketSent: null, or [error code, error message].
+  enum SocketMessage {
+    kSocketReceived = 0,
+    kSocketSent = 1,
+  };
+
+  // Whether io_uring should be used. Must be set before the first IOService
+  // request is made.
+  static bool enabled() { return enabled_; }
+  static void set_enabled(bool enabled) { enabled_ = enabled; }
+
+  // Returns true if io_uring is enabled and usable.
+  static bool IsAvailable();
+
+  // Tries to handle the IOService request `request_id` asynchronously. On
+  // success the reply `[message_id, result]` is posted to `reply_port` once
+  // the operation completes and true is returned. Returns false if the request
+  // must be handled synchronously instead.
+  static bool SubmitRequest(intptr_t request_id,
+                            Dart_Port reply_port,
+                            int32_t message_id,
+                            const CObjectArray& request);
+
+  // Starts receiving from `socket`. The result is posted to `port` as a
+  // kSocketReceived message. Returns false if the socket must be read after
+  // readiness events instead.
+  static bool SubmitSocketReceive(Socket* socket, Dart_Port port);
+
+  // Starts sending a copy of `length` bytes from `data` to `socket`. Once all
+  // of them have been sent, or sending failed, a kSocketSent message is posted
+  // to `port`. Returns false if nothing was submitted.
+  static bool SubmitSocketSend(Socket* socket,
+                               const uint8_t* data,
+                               intptr_t length,
+                               Dart_Port port);
+
+  // Cancels a receive started by SubmitSocketReceive. Its result is dropped.
+  static void CancelSocketReceive(Socket* socket);
+
+  static void Init();
+  static void Cleanup();
+
+ private:
+  struct PendingOp;
+
+  IOUring();
+  ~IOUring();
+
+  // Returns the process-wide instance, creating it on first use. Returns NULL
+  // if io_uring is not available.
+  static IOUring* Get();
+
+  bool Setup();
+
+  // Stops the completion thread after cancelling the operations in flight.
+  // Returns false if the thread did not stop in time, in which case the
+  // instance must be leaked.
+  bool Shutdown();
+
+  // Queues `op` and submits it, along with the SQEs queued by other threads
+  // in the meantime. Returns false if the kernel did not take it, in which
+  // case the caller still owns `op`.
+  bool Submit(PendingOp* op);
+
+  // The following are called with `monitor_` held.
+  bool CanSubmitLocked() const;
+  void LinkLocked(PendingOp* op);
+  void UnlinkLocked(PendingOp* op);
+  // Adds an SQE to the submission queue and sets `sequence` to its number.
+  // Returns false if nothing can be submitted anymore.
+  bool QueueLocked(uint8_t opcode,
+                   int fd,
+                   uint64_t addr,
+                   uint32_t length,
+                   uint64_t user_data,
+                   uint64_t* sequence);
+  bool QueueLocked(PendingOp* op, uint64_t* sequence);
+  // Makes sure the SQE queued as number `sequence` has been submitted or
+  // rejected. Returns true if the kernel consumed it.
+  bool FlushLocked(uint64_t sequence);
+
+  void Complete(PendingOp* op, int32_t result);
+  void CompleteFileRead(PendingOp* op, int32_t result);
+  void CompleteFileWrite(PendingOp* op, int32_t result);
+  void CompleteSocketReceive(PendingOp* op, int32_t result);
+  void CompleteSocketSend(PendingOp* op, int32_t result);
+  static void Discard(PendingOp* op);
+  void HandleCompletions();
+  void NotifyCompletionThreadDone();
+  static void CompletionThreadMain(uword args);
+
+  static bool enabled_;
+  static IOUring* instance_;
+  static Mutex* instance_mutex_;
+  static bool setup_failed_;
+
+  int ring_fd_;
+  uint32_t sq_entries_;
+  uint32_t cq_entries_;
+
+  // The mmap()ed submission and completion rings.
+  void* sq_ring_;
+  size_t sq_ring_size_;
+  void* cq_ring_;
+  size_t cq_ring_size_;
+  void* sqes_;
+  size_t sqes_size_;
+
+  uint32_t* sq_head_;
+  uint32_t* sq_tail_;
+  uint32_t* sq_mask_;
+  uint32_t* sq_array_;
+  uint32_t* cq_head_;
+  uint32_t* cq_tail_;
+  uint32_t* cq_mask_;
+  void* cqes_;
+
+  // Guards all of the fields below.
+  Monitor monitor_;
+  // The operations submitted and not yet completed.
+  PendingOp* pending_ops_;
+  intptr_t in_flight_;
+  // Bounds `in_flight_`, so that the completions of all of them and of their
+  // cancellation fit into the completion queue.
+  intptr_t max_in_flight_;
+  // The number of SQEs queued, submitted to the kernel, and submitted or
+  // rejected so far.
+  uint64_t queued_;
+  uint64_t submitted_;
+  uint64_t resolved_;
+  // Whether a thread is submitting the queued SQEs.
+  bool flushing_;
+  // Set when io_uring_enter failed. Nothing is submitted anymore, and the
+  // operations that are not in flight yet fall back to the synchronous
+  // implementations.
+  bool failed_;
+  // Set once the ring is being torn down. Nothing is submitted anymore, and
+  // the operations in flight are cancelled and their results dropped.
+  bool shutting_down_;
+  bool completion_thread_done_;
+
+  DISALLOW_COPY_AND_ASSIGN(IOUring);
+};
+
+}  // namespace bin
+}  // namespace dart
+
+#endif  // defined(HOST_OS_LINUX)
+
+#endif  // RUNTIME_BIN_IO_URING_LINUX_H_
@@ -10,6 +10,8 @@
 
 #include "bin/dartdev_isolate.h"
 #include "bin/error_exit.h"
+#include "bin/eventhandler.h"
+#include "bin/io_uring_linux.h"
 #include "bin/options.h"
 #include "bin/platform.h"
 #include "bin/utils.h"
@@ -125,6 +127,23 @@ static void hot_reload_rollback_test_mode_callback(
 DEFINE_BOOL_OPTION_CB(hot_reload_rollback_test_mode,
                       hot_reload_rollback_test_mode_callback);
 
+static void io_event_handler_threads_callback(const char* value) {
+  char* end = NULL;
+  const intptr_t threads = strtol(value, &end, 10);
+  if ((*end != '\0') || (threads < 1)) {
+    Syslog::PrintErr("Invalid value for io_event_handler_threads: %s\n",
+                     value);
+    return;
+  }
+  // More polling threads than processors cannot help.
+  const intptr_t max_threads =
+      Utils::Maximum<intptr_t>(Platform::NumberOfProcessors(), 1);
+  EventHandler::set_thread_count(Utils::Minimum(threads, max_threads));
+}
+
+DEFINE_STRING_OPTION_CB(io_event_handler_threads,
+                        { io_event_handler_threads_callback(value); });
+
 void Options::PrintVersion() {
   Syslog::PrintErr("Dart SDK version: %s\n", Dart_VersionString());
 }
@@ -229,6 +248,15 @@ void Options::PrintUsage() {
 "  The path to a directory that dart:io calls will treat as the root of the\n"
 "  filesystem.\n"
 #endif  // defined(HOST_OS_LINUX) || defined(HOST_OS_ANDROID)
+#if defined(HOST_OS_LINUX)
+"--io-event-handler-threads=<n>\n"
+"  The number of threads polling for dart:io socket, pipe and timer events\n"
+"  (default 1, at most the number of processors). Descriptors are\n"
+"  distributed across the threads by fd.\n"
+"--use-io-uring\n"
+"  Complete asynchronous file reads and writes, and TCP socket receives\n"
+"  and sends, through io_uring when the kernel supports it.\n"
+#endif  // defined(HOST_OS_LINUX)
 "\n"
 "The following options are only used for VM development and may\n"
 "be changed in any future version:\n");
@@ -465,6 +493,9 @@ bool Options::ParseArguments(int argc,
 
   Socket::set_short_socket_read(Options::short_socket_read());
   Socket::set_short_socket_write(Options::short_socket_write());
+#if defined(HOST_OS_LINUX)
+  IOUring::set_enabled(Options::use_io_uring());
+#endif  // defined(HOST_OS_LINUX)
 #if !defined(DART_IO_SECURE_SOCKET_DISABLED)
   SSLCertContext::set_root_certs_file(Options::root_certs_file());
   SSLCertContext::set_root_certs_cache(Options::root_certs_cache());
@@ -10,9 +10,12 @@
 #include <errno.h>         // NOLINT
 #include <fcntl.h>         // NOLINT
 #include <poll.h>          // NOLINT
+#include <sched.h>         // NOLINT
+#include <signal.h>        // NOLINT
 #include <stdio.h>         // NOLINT
 #include <stdlib.h>        // NOLINT
 #include <string.h>        // NOLINT
+#include <sys/mman.h>      // NOLINT
 #include <sys/resource.h>  // NOLINT
 #include <sys/wait.h>      // NOLINT
 #include <unistd.h>        // NOLINT
@@ -73,6 +76,14 @@ class ProcessInfoList {
 
   static void AddProcess(pid_t pid, intptr_t fd) {
     MutexLocker locker(mutex_);
+    AddProcessLocked(pid, fd);
+  }
+
+  // The exit code handler looks up processes with mutex() held, so a process
+  // started and added while holding it cannot be reaped before it is added.
+  static Mutex* mutex() { return mutex_; }
+
+  static void AddProcessLocked(pid_t pid, intptr_t fd) {
     ProcessInfo* info = new ProcessInfo(pid, fd);
     info->set_next(active_processes_);
     active_processes_ = info;
@@ -312,6 +323,10 @@ class ProcessStarter {
       return err;
     }
 
+    if (Process::ModeIsAttached(mode_) && Namespace::IsDefault(namespc_)) {
+      return StartWithClone();
+    }
+
     // Fork to create the new process.
     pid_t pid = TEMP_FAILURE_RETRY(fork());
     if (pid < 0) {
@@ -345,6 +360,80 @@ class ProcessStarter {
       return CleanupAndReturnError();
     }
 
+    return FinishStart(pid);
+  }
+
+ private:
+  static constexpr int kErrorBufferSize = 1024;
+
+  // Large enough for the PATH search in ExecWithPathSearch, which builds each
+  // candidate path on the stack. Only the pages used are committed.
+  static constexpr intptr_t kCloneStackSize = 256 * KB;
+
+  // Starts an attached process without fork(), which copies the page tables
+  // of this process and gets slow once the heap is large. The child shares the
+  // memory of this process and runs on its own stack until it calls exec,
+  // while the calling thread is suspended. Until then the child must not
+  // allocate or change any state it shares with this process, which is why
+  // this path is only taken for the default namespace.
+  int StartWithClone() {
+    int event_fds[2];
+    if (TEMP_FAILURE_RETRY(pipe2(event_fds, O_CLOEXEC)) < 0) {
+      return CleanupAndReturnError();
+    }
+    void* stack =
+        mmap(nullptr, kCloneStackSize, PROT_READ | PROT_WRITE,
+             MAP_PRIVATE | MAP_ANONYMOUS | MAP_STACK | MAP_NORESERVE, -1, 0);
+    if (stack == MAP_FAILED) {
+      int saved_errno = errno;
+      close(event_fds[0]);
+      close(event_fds[1]);
+      errno = saved_errno;
+      return CleanupAndReturnError();
+    }
+
+    // Signal handlers of this process must not run in the child before it
+    // has reset them, see ExecClonedProcess.
+    sigset_t all_signals;
+    sigfillset(&all_signals);
+    pthread_sigmask(SIG_SETMASK, &all_signals, &signal_mask_);
+    pid_t pid;
+    {
+      // Unlike the fork() path, the child cannot wait for this process to
+      // register it, so it is registered before the exit code handler can
+      // look it up.
+      MutexLocker locker(ProcessInfoList::mutex());
+      pid = clone(CloneEntry,
+                  reinterpret_cast<uint8_t*>(stack) + kCloneStackSize,
+                  CLONE_VM | CLONE_VFORK | SIGCHLD, this);
+      if (pid > 0) {
+        ExitCodeHandler::ProcessStarted();
+        ProcessInfoList::AddProcessLocked(pid, event_fds[1]);
+      }
+    }
+    int saved_errno = errno;
+    pthread_sigmask(SIG_SETMASK, &signal_mask_, nullptr);
+    munmap(stack, kCloneStackSize);
+    if (pid < 0) {
+      close(event_fds[0]);
+      close(event_fds[1]);
+      errno = saved_errno;
+      return CleanupAndReturnError();
+    }
+    *exit_event_ = event_fds[0];
+    FDUtils::SetNonBlocking(event_fds[0]);
+
+    // The child has either called exec or reported an error by now.
+    return FinishStart(pid);
+  }
+
+  static int CloneEntry(void* starter) {
+    reinterpret_cast<ProcessStarter*>(starter)->ExecClonedProcess();
+    return 1;
+  }
+
+  int FinishStart(pid_t pid) {
+    int err;
     // Read the result of executing the child process.
     close(exec_control_[1]);
     exec_control_[1] = -1;
@@ -398,9 +487,6 @@ class ProcessStarter {
     return 0;
   }
 
- private:
-  static constexpr int kErrorBufferSize = 1024;
-
   int CreatePipes() {
     int result;
     result = TEMP_FAILURE_RETRY(pipe2(exec_control_, O_CLOEXEC));
@@ -479,7 +565,7 @@ class ProcessStarter {
     return true;
   }
 
-  void ExecProcess() {
+  void ConnectStdio() {
     if (mode_ == kNormal) {
       if (TEMP_FAILURE_RETRY(dup2(write_out_[0], STDIN_FILENO)) == -1) {
         ReportChildError();
@@ -495,6 +581,10 @@ class ProcessStarter {
     } else {
       ASSERT(mode_ == kInheritStdio);
     }
+  }
+
+  void ExecProcess() {
+    ConnectStdio();
 
     if (working_directory_ != NULL &&
         !Directory::SetCurrent(namespc_, working_directory_)) {
@@ -514,6 +604,96 @@ class ProcessStarter {
     ReportChildError();
   }
 
+  // Runs in the child started by StartWithClone, which shares the memory of
+  // the parent. Assigning environ or calling malloc here would affect the
+  // parent.
+  void ExecClonedProcess() {
+    // A signal handler of the parent would run on the memory of the parent.
+    for (int sig = 1; sig < NSIG; sig++) {
+      struct sigaction action;
+      if ((sigaction(sig, NULL, &action) == 0) &&
+          (action.sa_handler != SIG_DFL) && (action.sa_handler != SIG_IGN)) {
+        action.sa_handler = SIG_DFL;
+        action.sa_flags = 0;
+        sigemptyset(&action.sa_mask);
+        sigaction(sig, &action, NULL);
+      }
+    }
+    pthread_sigmask(SIG_SETMASK, &signal_mask_, NULL);
+
+    ConnectStdio();
+
+    if ((working_directory_ != NULL) &&
+        (NO_RETRY_EXPECTED(chdir(working_directory_)) != 0)) {
+      ReportChildError();
+    }
+
+    char realpath[PATH_MAX];
+    if (!FindPathInNamespace(realpath, PATH_MAX)) {
+      ReportChildError();
+    }
+    ExecWithPathSearch(
+        realpath, const_cast<char* const*>(program_arguments_),
+        (program_environment_ != NULL) ? program_environment_ : environ);
+    ReportChildError();
+  }
+
+  // Executes [file] like execvp does after the fork() path has assigned
+  // environ: a file without a slash is searched for on the PATH of
+  // [environment]. glibc's execvpe would search the PATH of this process
+  // instead. Returns only on failure, with errno set.
+  static void ExecWithPathSearch(const char* file,
+                                 char* const argv[],
+                                 char* const environment[]) {
+    // With a slash in [file], execvpe does not search PATH. It is still used
+    // for running scripts without #! through /bin/sh, as execvp does.
+    if (strchr(file, '/') != NULL) {
+      execvpe(file, argv, environment);
+      return;
+    }
+    // The default search path of execvp.
+    const char* search_path = "/bin:/usr/bin";
+    for (char* const* entry = environment; *entry != NULL; entry++) {
+      if (strncmp(*entry, "PATH=", 5) == 0) {
+        search_path = *entry + 5;
+        break;
+      }
+    }
+    const intptr_t file_length = strlen(file);
+    bool got_eacces = false;
+    char candidate[PATH_MAX];
+    const char* dir = search_path;
+    while (true) {
+      const char* dir_end = strchrnul(dir, ':');
+      intptr_t dir_length = dir_end - dir;
+      if (dir_length == 0) {
+        // An empty entry stands for the current directory.
+        dir = ".";
+        dir_length = 1;
+      }
+      if (dir_length + file_length + 2 <= PATH_MAX) {
+        memmove(candidate, dir, dir_length);
+        candidate[dir_length] = '/';
+        memmove(candidate + dir_length + 1, file, file_length + 1);
+        execvpe(candidate, argv, environment);
+        // Like execvp, go on with the next entry unless the file was found
+        // and failed to execute for another reason than its permissions.
+        if (errno == EACCES) {
+          got_eacces = true;
+        } else if ((errno != ENOENT) && (errno != ESTALE) &&
+                   (errno != ENOTDIR) && (errno != ENODEV) &&
+                   (errno != ETIMEDOUT)) {
+          return;
+        }
+      }
+      if (*dir_end == '\0') {
+        break;
+      }
+      dir = dir_end + 1;
+    }
+    errno = got_eacces ? EACCES : ENOENT;
+  }
+
   void ExecDetachedProcess() {
     if (mode_ == kDetached) {
       ASSERT(write_out_[0] == -1);
@@ -777,6 +957,9 @@ class ProcessStarter {
   char** program_arguments_;
   char** program_environment_;
 
+  // Signal mask of the thread calling StartWithClone.
+  sigset_t signal_mask_;
+
   Namespace* namespc_;
   const char* path_;
   const char* working_directory_;
@@ -33,6 +33,7 @@ bool SSLFilter::library_initialized_ = false;
 Mutex* SSLFilter::mutex_ = nullptr;
 int SSLFilter::filter_ssl_index;
 int SSLFilter::ssl_cert_context_index;
+BIO_METHOD* SSLFilter::bio_method_ = NULL;
 
 void SSLFilter::Init() {
   ASSERT(SSLFilter::mutex_ == nullptr);
@@ -279,70 +280,90 @@ bool SSLFilter::ProcessAllBuffers(int starts[kNumBuffers],
                                   int ends[kNumBuffers],
                                   bool in_handshake) {
   for (int i = 0; i < kNumBuffers; ++i) {
-    if (in_handshake && (i == kReadPlaintext || i == kWritePlaintext)) continue;
-    int start = starts[i];
-    int end = ends[i];
     int size = IsBufferEncrypted(i) ? encrypted_buffer_size_ : buffer_size_;
-    if (start < 0 || end < 0 || start >= size || end >= size) {
+    if (starts[i] < 0 || ends[i] < 0 || starts[i] >= size || ends[i] >= size) {
       FATAL("Out-of-bounds internal buffer access in dart:io SecureSocket");
     }
-    switch (i) {
-      case kReadPlaintext:
-      case kWriteEncrypted:
-        // Write data to the circular buffer's free space.  If the buffer
-        // is full, neither if statement is executed and nothing happens.
-        if (start <= end) {
-          // If the free space may be split into two segments,
-          // then the first is [end, size), unless start == 0.
-          // Then, since the last free byte is at position start - 2,
-          // the interval is [end, size - 1).
-          int buffer_end = (start == 0) ? size - 1 : size;
-          int bytes = (i == kReadPlaintext)
-                          ? ProcessReadPlaintextBuffer(end, buffer_end)
-                          : ProcessWriteEncryptedBuffer(end, buffer_end);
-          if (bytes < 0) return false;
-          end += bytes;
-          ASSERT(end <= size);
-          if (end == size) end = 0;
-        }
-        if (start > end + 1) {
-          int bytes = (i == kReadPlaintext)
-                          ? ProcessReadPlaintextBuffer(end, start - 1)
-                          : ProcessWriteEncryptedBuffer(end, start - 1);
-          if (bytes < 0) return false;
-          end += bytes;
-          ASSERT(end < start);
-        }
-        ends[i] = end;
-        break;
-      case kReadEncrypted:
-      case kWritePlaintext:
-        // Read/Write data from circular buffer.  If the buffer is empty,
-        // neither if statement's condition is true.
-        if (end < start) {
-          // Data may be split into two segments.  In this case,
-          // the first is [start, size).
-          int bytes = (i == kReadEncrypted)
-                          ? ProcessReadEncryptedBuffer(start, size)
-                          : ProcessWritePlaintextBuffer(start, size);
-          if (bytes < 0) return false;
-          start += bytes;
-          ASSERT(start <= size);
-          if (start == size) start = 0;
-        }
-        if (start < end) {
-          int bytes = (i == kReadEncrypted)
-                          ? ProcessReadEncryptedBuffer(start, end)
-                          : ProcessWritePlaintextBuffer(start, end);
-          if (bytes < 0) return false;
-          start += bytes;
-          ASSERT(start <= end);
-        }
-        starts[i] = start;
-        break;
-      default:
-        UNREACHABLE();
-    }
+  }
+  // SSL_read and SSL_write move encrypted data through the circular buffers
+  // while they run, see ReadEncrypted and WriteEncrypted.
+  starts_ = starts;
+  ends_ = ends;
+  bool result = true;
+  for (int i = 0; (i < kNumBuffers) && result; ++i) {
+    if (in_handshake && (i == kReadPlaintext || i == kWritePlaintext)) continue;
+    // Outside of a handshake, SSL_read has already consumed the encrypted
+    // data it could use. The rest is left in the buffer.
+    if (!in_handshake && (i == kReadEncrypted)) continue;
+    result = ProcessBuffer(i, starts, ends);
+  }
+  starts_ = NULL;
+  ends_ = NULL;
+  return result;
+}
+
+bool SSLFilter::ProcessBuffer(int i,
+                              int starts[kNumBuffers],
+                              int ends[kNumBuffers]) {
+  int start = starts[i];
+  int end = ends[i];
+  int size = IsBufferEncrypted(i) ? encrypted_buffer_size_ : buffer_size_;
+  switch (i) {
+    case kReadPlaintext:
+    case kWriteEncrypted:
+      // Write data to the circular buffer's free space.  If the buffer
+      // is full, neither if statement is executed and nothing happens.
+      if (start <= end) {
+        // If the free space may be split into two segments,
+        // then the first is [end, size), unless start == 0.
+        // Then, since the last free byte is at position start - 2,
+        // the interval is [end, size - 1).
+        int buffer_end = (start == 0) ? size - 1 : size;
+        int bytes = (i == kReadPlaintext)
+                        ? ProcessReadPlaintextBuffer(end, buffer_end)
+                        : ProcessWriteEncryptedBuffer(end, buffer_end);
+        if (bytes < 0) return false;
+        end += bytes;
+        ASSERT(end <= size);
+        if (end == size) end = 0;
+      }
+      if (start > end + 1) {
+        int bytes = (i == kReadPlaintext)
+                        ? ProcessReadPlaintextBuffer(end, start - 1)
+                        : ProcessWriteEncryptedBuffer(end, start - 1);
+        if (bytes < 0) return false;
+        end += bytes;
+        ASSERT(end < start);
+      }
+      ends[i] = end;
+      break;
+    case kReadEncrypted:
+    case kWritePlaintext:
+      // Read/Write data from circular buffer.  If the buffer is empty,
+      // neither if statement's condition is true.
+      if (end < start) {
+        // Data may be split into two segments.  In this case,
+        // the first is [start, size).
+        int bytes = (i == kReadEncrypted)
+                        ? ProcessReadEncryptedBuffer(start, size)
+                        : ProcessWritePlaintextBuffer(start, size);
+        if (bytes < 0) return false;
+        start += bytes;
+        ASSERT(start <= size);
+        if (start == size) start = 0;
+      }
+      if (start < end) {
+        int bytes = (i == kReadEncrypted)
+                        ? ProcessReadEncryptedBuffer(start, end)
+                        : ProcessWritePlaintextBuffer(start, end);
+        if (bytes < 0) return false;
+        start += bytes;
+        ASSERT(start <= end);
+      }
+      starts[i] = start;
+      break;
+    default:
+      UNREACHABLE();
   }
   return true;
 }
@@ -473,6 +494,11 @@ void SSLFilter::InitializeLibrary() {
     ASSERT(filter_ssl_index >= 0);
     ssl_cert_context_index = SSL_get_ex_new_index(0, NULL, NULL, NULL, NULL);
     ASSERT(ssl_cert_context_index >= 0);
+    bio_method_ = BIO_meth_new(BIO_TYPE_SOURCE_SINK, "dart:io SSLFilter");
+    ASSERT(bio_method_ != NULL);
+    BIO_meth_set_read(bio_method_, BIORead);
+    BIO_meth_set_write(bio_method_, BIOWrite);
+    BIO_meth_set_ctrl(bio_method_, BIOControl);
     library_initialized_ = true;
   }
 }
@@ -490,16 +516,20 @@ void SSLFilter::Connect(const char* hostname,
 
   int status;
   int error;
-  BIO* ssl_side;
-  status = BIO_new_bio_pair(&ssl_side, kInternalBIOSize, &socket_side_,
-                            kInternalBIOSize);
-  SecureSocketUtils::CheckStatusSSL(status, "TlsException", "BIO_new_bio_pair",
-                                    ssl_);
+  // The encrypted data is passed between SSL and the buffers shared with Dart
+  // without an intermediate BIO pair, see ReadEncrypted and WriteEncrypted.
+  BIO* bio = BIO_new(bio_method_);
+  SecureSocketUtils::CheckStatusSSL(bio != NULL ? 1 : 0, "TlsException",
+                                    "BIO_new", ssl_);
+  BIO_set_data(bio, this);
+  BIO_set_init(bio, 1);
+  staged_input_ = new uint8_t[kInternalBIOSize];
+  staged_output_ = new uint8_t[kInternalBIOSize];
 
   ASSERT(context != NULL);
   ASSERT(context->context() != NULL);
   ssl_ = SSL_new(context->context());
-  SSL_set_bio(ssl_, ssl_side, ssl_side);
+  SSL_set_bio(ssl_, bio, bio);
   SSL_set_mode(ssl_, SSL_MODE_AUTO_RETRY);  // TODO(whesse): Is this right?
   SSL_set_ex_data(ssl_, filter_ssl_index, this);
   context->RegisterCallbacks(ssl_);
@@ -661,9 +691,13 @@ void SSLFilter::FreeResources() {
     SSL_free(ssl_);
     ssl_ = NULL;
   }
-  if (socket_side_ != NULL) {
-    BIO_free(socket_side_);
-    socket_side_ = NULL;
+  if (staged_input_ != NULL) {
+    delete[] staged_input_;
+    staged_input_ = NULL;
+  }
+  if (staged_output_ != NULL) {
+    delete[] staged_output_;
+    staged_output_ = NULL;
   }
   if (hostname_ != NULL) {
     free(hostname_);
@@ -759,27 +793,19 @@ int SSLFilter::ProcessWritePlaintextBuffer(int start, int end) {
   return bytes_processed;
 }
 
-/* Read encrypted data from the circular buffer to the filter */
+/* Stage encrypted data from the circular buffer for SSL_do_handshake */
 int SSLFilter::ProcessReadEncryptedBuffer(int start, int end) {
   int length = end - start;
   if (SSL_LOG_DATA) {
     Syslog::Print("Entering ProcessReadEncryptedBuffer with %d bytes\n",
                   length);
   }
-  int bytes_processed = 0;
-  if (length > 0) {
-    bytes_processed =
-        BIO_write(socket_side_, buffers_[kReadEncrypted] + start, length);
-    if (bytes_processed <= 0) {
-      bool retry = BIO_should_retry(socket_side_) != 0;
-      if (!retry) {
-        if (SSL_LOG_DATA) {
-          Syslog::Print("BIO_write failed in ReadEncryptedBuffer\n");
-        }
-      }
-      bytes_processed = 0;
-    }
-  }
+  int bytes_processed =
+      Utils::Minimum(length, static_cast<int>(kInternalBIOSize) -
+                                 staged_input_length_);
+  memmove(staged_input_ + staged_input_length_,
+          buffers_[kReadEncrypted] + start, bytes_processed);
+  staged_input_length_ += bytes_processed;
   if (SSL_LOG_DATA) {
     Syslog::Print("Leaving ProcessReadEncryptedBuffer read %d bytes\n",
                   bytes_processed);
@@ -787,32 +813,117 @@ int SSLFilter::ProcessReadEncryptedBuffer(int start, int end) {
   return bytes_processed;
 }
 
+/* Write staged encrypted data to the circular buffer */
 int SSLFilter::ProcessWriteEncryptedBuffer(int start, int end) {
   int length = end - start;
-  int bytes_processed = 0;
   if (SSL_LOG_DATA) {
     Syslog::Print("Entering ProcessWriteEncryptedBuffer with %d bytes\n",
                   length);
   }
-  if (length > 0) {
-    bytes_processed =
-        BIO_read(socket_side_, buffers_[kWriteEncrypted] + start, length);
-    if (bytes_processed < 0) {
-      if (SSL_LOG_DATA) {
-        Syslog::Print("WriteEncrypted BIO_read returned error %d\n",
-                      bytes_processed);
-      }
-      return 0;
-    } else {
-      if (SSL_LOG_DATA) {
-        Syslog::Print("WriteEncrypted  BIO_read wrote %d bytes\n",
-                      bytes_processed);
-      }
-    }
+  int bytes_processed = Utils::Minimum(length, staged_output_length_);
+  memmove(buffers_[kWriteEncrypted] + start, staged_output_,
+          bytes_processed);
+  staged_output_length_ -= bytes_processed;
+  memmove(staged_output_, staged_output_ + bytes_processed,
+          staged_output_length_);
+  if (SSL_LOG_DATA) {
+    Syslog::Print("WriteEncrypted wrote %d bytes\n", bytes_processed);
   }
   return bytes_processed;
 }
 
+// Reads encrypted data for SSL_read or SSL_do_handshake, from the staged
+// input first and then directly from the circular buffer of ProcessAllBuffers.
+int SSLFilter::ReadEncrypted(uint8_t* data, int length) {
+  if (staged_input_length_ > 0) {
+    int bytes = Utils::Minimum(length, staged_input_length_);
+    memmove(data, staged_input_, bytes);
+    staged_input_length_ -= bytes;
+    memmove(staged_input_, staged_input_ + bytes, staged_input_length_);
+    return bytes;
+  }
+  if (starts_ == NULL) {
+    return 0;
+  }
+  const int size = encrypted_buffer_size_;
+  const int end = ends_[kReadEncrypted];
+  int start = starts_[kReadEncrypted];
+  int bytes = 0;
+  while ((bytes < length) && (start != end)) {
+    int available = (start < end) ? end - start : size - start;
+    int chunk = Utils::Minimum(available, length - bytes);
+    memmove(data + bytes, buffers_[kReadEncrypted] + start, chunk);
+    bytes += chunk;
+    start += chunk;
+    if (start == size) start = 0;
+  }
+  starts_[kReadEncrypted] = start;
+  return bytes;
+}
+
+// Writes encrypted data from SSL_write, SSL_read or SSL_do_handshake directly
+// to the free space of the circular buffer of ProcessAllBuffers, and stages
+// what does not fit. Staged data is written out first to keep the order.
+int SSLFilter::WriteEncrypted(const uint8_t* data, int length) {
+  int bytes = 0;
+  if ((staged_output_length_ == 0) && (ends_ != NULL)) {
+    const int size = encrypted_buffer_size_;
+    const int start = starts_[kWriteEncrypted];
+    int end = ends_[kWriteEncrypted];
+    while (bytes < length) {
+      // The byte before start is never written, see ProcessBuffer.
+      int available = (start <= end)
+                          ? ((start == 0) ? size - 1 : size) - end
+                          : start - 1 - end;
+      if (available <= 0) break;
+      int chunk = Utils::Minimum(available, length - bytes);
+      memmove(buffers_[kWriteEncrypted] + end, data + bytes, chunk);
+      bytes += chunk;
+      end += chunk;
+      if (end == size) end = 0;
+    }
+    ends_[kWriteEncrypted] = end;
+  }
+  int staged =
+      Utils::Minimum(length - bytes, static_cast<int>(kInternalBIOSize) -
+                                         staged_output_length_);
+  memmove(staged_output_ + staged_output_length_, data + bytes, staged);
+  staged_output_length_ += staged;
+  return bytes + staged;
+}
+
+int SSLFilter::BIORead(BIO* bio, char* data, int length) {
+  SSLFilter* filter = reinterpret_cast<SSLFilter*>(BIO_get_data(bio));
+  BIO_clear_retry_flags(bio);
+  int bytes = filter->ReadEncrypted(reinterpret_cast<uint8_t*>(data), length);
+  if (bytes == 0) {
+    BIO_set_retry_read(bio);
+    return -1;
+  }
+  return bytes;
+}
+
+int SSLFilter::BIOWrite(BIO* bio, const char* data, int length) {
+  SSLFilter* filter = reinterpret_cast<SSLFilter*>(BIO_get_data(bio));
+  BIO_clear_retry_flags(bio);
+  int bytes =
+      filter->WriteEncrypted(reinterpret_cast<const uint8_t*>(data), length);
+  if (bytes == 0) {
+    BIO_set_retry_write(bio);
+    return -1;
+  }
+  return bytes;
+}
+
+long SSLFilter::BIOControl(BIO* bio,  // NOLINT
+                           int command,
+                           long arg,  // NOLINT
+                           void* ptr) {
+  // Written data is already visible to the filter, so flushing succeeds
+  // trivially. Other controls are not used by the SSL library.
+  return (command == BIO_CTRL_FLUSH) ? 1 : 0;
+}
+
 }  // namespace bin
 }  // namespace dart
 
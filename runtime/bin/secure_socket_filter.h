@@ -59,7 +59,12 @@ class SSLFilter : public ReferenceCounted<SSLFilter> {
   SSLFilter()
       : callback_error(NULL),
         ssl_(NULL),
-        socket_side_(NULL),
+        staged_input_(NULL),
+        staged_input_length_(0),
+        staged_output_(NULL),
+        staged_output_length_(0),
+        starts_(NULL),
+        ends_(NULL),
         string_start_(NULL),
         string_length_(NULL),
         handshake_complete_(NULL),
@@ -100,6 +105,7 @@ class SSLFilter : public ReferenceCounted<SSLFilter> {
   bool ProcessAllBuffers(int starts[kNumBuffers],
                          int ends[kNumBuffers],
                          bool in_handshake);
+  bool ProcessBuffer(int i, int starts[kNumBuffers], int ends[kNumBuffers]);
   Dart_Handle PeerCertificate();
   static void InitializeLibrary();
   Dart_Handle callback_error;
@@ -124,9 +130,21 @@ class SSLFilter : public ReferenceCounted<SSLFilter> {
   static const intptr_t kInternalBIOSize;
   static bool library_initialized_;
   static Mutex* mutex_;  // To protect library initialization.
+  static BIO_METHOD* bio_method_;
 
   SSL* ssl_;
-  BIO* socket_side_;
+  // Encrypted data that could not be passed through the circular buffers
+  // directly, because SSL_do_handshake runs outside of ProcessAllBuffers or
+  // because a buffer was full. kInternalBIOSize bytes each.
+  uint8_t* staged_input_;
+  int staged_input_length_;
+  uint8_t* staged_output_;
+  int staged_output_length_;
+  // The buffer positions passed to ProcessAllBuffers while it runs, NULL
+  // otherwise. The BIO of ssl_ reads and writes encrypted data directly
+  // through them.
+  int* starts_;
+  int* ends_;
   // Currently only one(root) certificate is evaluated via
   // TrustEvaluate mechanism.
   std::unique_ptr<X509TrustState> certificate_trust_state_;
@@ -152,6 +170,12 @@ class SSLFilter : public ReferenceCounted<SSLFilter> {
   Dart_Handle InitializeBuffers(Dart_Handle dart_this);
   void InitializePlatformData();
 
+  int ReadEncrypted(uint8_t* data, int length);
+  int WriteEncrypted(const uint8_t* data, int length);
+  static int BIORead(BIO* bio, char* data, int length);
+  static int BIOWrite(BIO* bio, const char* data, int length);
+  static long BIOControl(BIO* bio, int command, long arg, void* ptr);  // NOLINT
+
   DISALLOW_COPY_AND_ASSIGN(SSLFilter);
 };
 
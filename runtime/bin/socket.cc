@@ -8,6 +8,9 @@
 #include "bin/eventhandler.h"
 #include "bin/file.h"
 #include "bin/io_buffer.h"
+#if defined(HOST_OS_LINUX)
+#include "bin/io_uring_linux.h"
+#endif
 #include "bin/isolate_data.h"
 #include "bin/lockers.h"
 #include "bin/process.h"
@@ -567,32 +570,34 @@ void FUNCTION_NAME(Socket_Read)(Dart_NativeArguments args) {
 }
 
 void FUNCTION_NAME(Socket_RecvFrom)(Dart_NativeArguments args) {
-  // TODO(sgjesse): Use a MTU value here. Only the loopback adapter can
-  // handle 64k datagrams.
-  const int kReceiveBufferLen = 65536;
   Socket* socket =
       Socket::GetSocketIdNativeField(Dart_GetNativeArgument(args, 0));
 
-  // Ensure that a receive buffer for the UDP socket exists.
+  // Ensure that a receive batch for the UDP socket exists.
   ASSERT(socket != nullptr);
-  uint8_t* recv_buffer = socket->udp_receive_buffer();
-  if (recv_buffer == nullptr) {
-    recv_buffer = reinterpret_cast<uint8_t*>(malloc(kReceiveBufferLen));
-    socket->set_udp_receive_buffer(recv_buffer);
+  DatagramBatch* batch = socket->udp_receive_batch();
+  if (batch == nullptr) {
+    batch = new DatagramBatch();
+    socket->set_udp_receive_batch(batch);
+  }
+
+  // Only go to the OS once all datagrams read by the previous call have been
+  // handed out.
+  if (batch->IsEmpty()) {
+    batch->GrowIfFull();
+    const intptr_t count = SocketBase::RecvMultiple(socket->fd(), batch);
+    if (count == 0) {
+      Dart_SetReturnValue(args, Dart_Null());
+      return;
+    }
+    if (count < 0) {
+      ASSERT(count == -1);
+      Dart_ThrowException(DartUtils::NewDartOSError());
+    }
   }
-
-  // Read data into the buffer.
   RawAddr addr;
-  const intptr_t bytes_read = SocketBase::RecvFrom(
-      socket->fd(), recv_buffer, kReceiveBufferLen, &addr, SocketBase::kAsync);
-  if (bytes_read == 0) {
-    Dart_SetReturnValue(args, Dart_Null());
-    return;
-  }
-  if (bytes_read < 0) {
-    ASSERT(bytes_read == -1);
-    Dart_ThrowException(DartUtils::NewDartOSError());
-  }
+  intptr_t bytes_read;
+  uint8_t* recv_buffer = batch->Next(&bytes_read, &addr);
 
   // Datagram data read. Copy into buffer of the exact size,
   ASSERT(bytes_read >= 0);
@@ -701,6 +706,97 @@ void FUNCTION_NAME(Socket_WriteList)(Dart_NativeArguments args) {
   }
 }
 
+// sendfile runs on the mutator thread and can block it while the file is read
+// from disk, so each call sends at most as much as one read of a File.openRead
+// stream.
+static const int64_t kMaxSendFileBytes = 64 * KB;
+
+void FUNCTION_NAME(Socket_SendFile)(Dart_NativeArguments args) {
+  Socket* socket =
+      Socket::GetSocketIdNativeField(Dart_GetNativeArgument(args, 0));
+  File* file = File::GetFileNativeField(Dart_GetNativeArgument(args, 1));
+  if (file == NULL) {
+    Dart_PropagateError(Dart_NewUnhandledExceptionError(
+        DartUtils::NewInternalError("No native peer")));
+  }
+  int64_t offset = DartUtils::GetInt64ValueCheckRange(
+      Dart_GetNativeArgument(args, 2), 0, kMaxInt64);
+  int64_t length = DartUtils::GetInt64ValueCheckRange(
+      Dart_GetNativeArgument(args, 3), 0, kMaxInt64);
+  length = Utils::Minimum(length, kMaxSendFileBytes);
+  intptr_t bytes_sent =
+      SocketBase::SendFile(socket->fd(), file->GetFD(), offset, length);
+  if ((bytes_sent >= 0) || (bytes_sent == SocketBase::kSendFileUnavailable)) {
+    Dart_SetIntegerReturnValue(args, bytes_sent);
+  } else {
+    Dart_ThrowException(DartUtils::NewDartOSError());
+  }
+}
+
+void FUNCTION_NAME(Socket_UringAvailable)(Dart_NativeArguments args) {
+#if defined(HOST_OS_LINUX)
+  Dart_SetBooleanReturnValue(args, IOUring::IsAvailable());
+#else
+  Dart_SetBooleanReturnValue(args, false);
+#endif
+}
+
+void FUNCTION_NAME(Socket_UringReceive)(Dart_NativeArguments args) {
+#if defined(HOST_OS_LINUX)
+  Socket* socket =
+      Socket::GetSocketIdNativeField(Dart_GetNativeArgument(args, 0));
+  Dart_Port port;
+  Dart_Handle result =
+      Dart_SendPortGetId(Dart_GetNativeArgument(args, 1), &port);
+  if (Dart_IsError(result)) {
+    Dart_PropagateError(result);
+  }
+  Dart_SetBooleanReturnValue(args, IOUring::SubmitSocketReceive(socket, port));
+#else
+  Dart_SetBooleanReturnValue(args, false);
+#endif
+}
+
+void FUNCTION_NAME(Socket_UringSend)(Dart_NativeArguments args) {
+#if defined(HOST_OS_LINUX)
+  Socket* socket =
+      Socket::GetSocketIdNativeField(Dart_GetNativeArgument(args, 0));
+  Dart_Handle buffer_obj = Dart_GetNativeArgument(args, 1);
+  intptr_t offset = DartUtils::GetIntptrValue(Dart_GetNativeArgument(args, 2));
+  intptr_t length = DartUtils::GetIntptrValue(Dart_GetNativeArgument(args, 3));
+  Dart_Port port;
+  Dart_Handle result =
+      Dart_SendPortGetId(Dart_GetNativeArgument(args, 4), &port);
+  if (Dart_IsError(result)) {
+    Dart_PropagateError(result);
+  }
+  Dart_TypedData_Type type;
+  uint8_t* buffer = nullptr;
+  intptr_t len;
+  result = Dart_TypedDataAcquireData(
+      buffer_obj, &type, reinterpret_cast<void**>(&buffer), &len);
+  if (Dart_IsError(result)) {
+    Dart_PropagateError(result);
+  }
+  ASSERT((offset + length) <= len);
+  // The data is copied, so the buffer can be released right away.
+  const bool submitted =
+      IOUring::SubmitSocketSend(socket, buffer + offset, length, port);
+  Dart_TypedDataReleaseData(buffer_obj);
+  Dart_SetBooleanReturnValue(args, submitted);
+#else
+  Dart_SetBooleanReturnValue(args, false);
+#endif
+}
+
+void FUNCTION_NAME(Socket_UringCancelReceive)(Dart_NativeArguments args) {
+#if defined(HOST_OS_LINUX)
+  Socket* socket =
+      Socket::GetSocketIdNativeField(Dart_GetNativeArgument(args, 0));
+  IOUring::CancelSocketReceive(socket);
+#endif
+}
+
 void FUNCTION_NAME(Socket_SendTo)(Dart_NativeArguments args) {
   Socket* socket =
       Socket::GetSocketIdNativeField(Dart_GetNativeArgument(args, 0));
@@ -1250,6 +1346,12 @@ void FUNCTION_NAME(Socket_AvailableDatagram)(Dart_NativeArguments args) {
   Socket* socket =
       Socket::GetSocketIdNativeField(Dart_GetNativeArgument(args, 0));
   ASSERT(socket != nullptr);
+  // Datagrams left over from the last batch read are available right away.
+  DatagramBatch* batch = socket->udp_receive_batch();
+  if ((batch != nullptr) && !batch->IsEmpty()) {
+    Dart_SetBooleanReturnValue(args, true);
+    return;
+  }
   // Ensure that a receive buffer for peeking the UDP socket exists.
   uint8_t recv_buffer[kReceiveBufferLen];
   bool available = SocketBase::AvailableDatagram(socket->fd(), recv_buffer,
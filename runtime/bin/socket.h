@@ -63,8 +63,10 @@ class Socket : public ReferenceCounted<Socket> {
   Dart_Port port() const { return port_; }
   void set_port(Dart_Port port) { port_ = port; }
 
-  uint8_t* udp_receive_buffer() const { return udp_receive_buffer_; }
-  void set_udp_receive_buffer(uint8_t* buffer) { udp_receive_buffer_ = buffer; }
+  DatagramBatch* udp_receive_batch() const { return udp_receive_batch_; }
+  void set_udp_receive_batch(DatagramBatch* batch) {
+    udp_receive_batch_ = batch;
+  }
 
   static bool Initialize();
 
@@ -115,8 +117,8 @@ class Socket : public ReferenceCounted<Socket> {
  private:
   ~Socket() {
     ASSERT(fd_ == kClosedFd);
-    free(udp_receive_buffer_);
-    udp_receive_buffer_ = NULL;
+    delete udp_receive_batch_;
+    udp_receive_batch_ = NULL;
   }
 
   static const int kClosedFd = -1;
@@ -127,7 +129,7 @@ class Socket : public ReferenceCounted<Socket> {
   intptr_t fd_;
   Dart_Port isolate_port_;
   Dart_Port port_;
-  uint8_t* udp_receive_buffer_;
+  DatagramBatch* udp_receive_batch_;
 
   friend class ReferenceCounted<Socket>;
   DISALLOW_COPY_AND_ASSIGN(Socket);
@@ -40,6 +40,80 @@ union RawAddr {
   struct sockaddr addr;
 };
 
+// Datagrams read from a socket in one go by SocketBase::RecvMultiple, and
+// handed out to Dart one at a time.
+//
+// A batch starts out with room for a single datagram, and only grows when
+// reads keep filling all of its slots, so that quiet sockets do not hold on
+// to kMaxCapacity * kSlotSize bytes.
+class DatagramBatch {
+ public:
+#if defined(HOST_OS_LINUX) ||                                                  \
+    (defined(HOST_OS_ANDROID) && (__ANDROID_API__ >= 21))
+  // Read up to this many datagrams with a single recvmmsg() call.
+  static const intptr_t kMaxCapacity = 8;
+#else
+  static const intptr_t kMaxCapacity = 1;
+#endif
+  // TODO(sgjesse): Use a MTU value here. Only the loopback adapter can
+  // handle 64k datagrams.
+  static const intptr_t kSlotSize = 65536;
+
+  DatagramBatch()
+      : buffer_(reinterpret_cast<uint8_t*>(malloc(kSlotSize))),
+        capacity_(1),
+        count_(0),
+        next_(0) {}
+  ~DatagramBatch() { free(buffer_); }
+
+  bool IsEmpty() const { return next_ >= count_; }
+
+  // Doubles the number of slots if the last read filled all of them. Only
+  // called once all datagrams of the last read have been handed out.
+  void GrowIfFull() {
+    ASSERT(IsEmpty());
+    if ((count_ == capacity_) && (capacity_ < kMaxCapacity)) {
+      capacity_ *= 2;
+      buffer_ = reinterpret_cast<uint8_t*>(
+          realloc(buffer_, capacity_ * kSlotSize));
+    }
+  }
+
+  intptr_t capacity() const { return capacity_; }
+  uint8_t* slot(intptr_t i) const {
+    ASSERT((i >= 0) && (i < capacity_));
+    return buffer_ + i * kSlotSize;
+  }
+  intptr_t* lengths() { return lengths_; }
+  RawAddr* addresses() { return addresses_; }
+
+  // Marks the first [count] slots as holding unread datagrams.
+  void set_count(intptr_t count) {
+    ASSERT((count >= 0) && (count <= capacity_));
+    count_ = count;
+    next_ = 0;
+  }
+
+  // Returns the data of the next unread datagram, and its length and sender.
+  uint8_t* Next(intptr_t* length, RawAddr* addr) {
+    ASSERT(!IsEmpty());
+    const intptr_t i = next_++;
+    *length = lengths_[i];
+    *addr = addresses_[i];
+    return slot(i);
+  }
+
+ private:
+  uint8_t* buffer_;
+  intptr_t capacity_;
+  intptr_t lengths_[kMaxCapacity];
+  RawAddr addresses_[kMaxCapacity];
+  intptr_t count_;
+  intptr_t next_;
+
+  DISALLOW_COPY_AND_ASSIGN(DatagramBatch);
+};
+
 class SocketAddress {
  public:
   enum {
@@ -185,7 +259,21 @@ class SocketBase : public AllStatic {
                            intptr_t num_bytes,
                            RawAddr* addr,
                            SocketOpKind sync);
+  // Reads as many pending datagrams as fit into [batch] without blocking.
+  // Returns the number of datagrams read, 0 if none were pending or -1 on
+  // error.
+  static intptr_t RecvMultiple(intptr_t fd, DatagramBatch* batch);
   static bool AvailableDatagram(intptr_t fd, void* buffer, intptr_t num_bytes);
+  // Sends up to [length] bytes of the file [file_fd], starting at [offset],
+  // without copying them through user space. Returns the number of bytes
+  // sent, 0 if the socket would block or -1 on error. Returns
+  // kSendFileUnavailable if the file cannot be sent this way, including when
+  // [offset] is at or past the end of the file.
+  static const intptr_t kSendFileUnavailable = -2;
+  static intptr_t SendFile(intptr_t fd,
+                           intptr_t file_fd,
+                           int64_t offset,
+                           int64_t length);
   // Returns true if the given error-number is because the system was not able
   // to bind the socket to a specific IP.
   static bool IsBindError(intptr_t error_number);
@@ -7,15 +7,16 @@
 
 #include "bin/socket_base.h"
 
-#include <errno.h>        // NOLINT
-#include <ifaddrs.h>      // NOLINT
-#include <net/if.h>       // NOLINT
-#include <netinet/tcp.h>  // NOLINT
-#include <stdio.h>        // NOLINT
-#include <stdlib.h>       // NOLINT
-#include <string.h>       // NOLINT
-#include <sys/stat.h>     // NOLINT
-#include <unistd.h>       // NOLINT
+#include <errno.h>         // NOLINT
+#include <ifaddrs.h>       // NOLINT
+#include <net/if.h>        // NOLINT
+#include <netinet/tcp.h>   // NOLINT
+#include <stdio.h>         // NOLINT
+#include <stdlib.h>        // NOLINT
+#include <string.h>        // NOLINT
+#include <sys/sendfile.h>  // NOLINT
+#include <sys/stat.h>      // NOLINT
+#include <unistd.h>        // NOLINT
 
 #include "bin/fdutils.h"
 #include "bin/file.h"
@@ -98,6 +99,36 @@ intptr_t SocketBase::RecvFrom(intptr_t fd,
   return read_bytes;
 }
 
+intptr_t SocketBase::RecvMultiple(intptr_t fd, DatagramBatch* batch) {
+  ASSERT(fd >= 0);
+  struct mmsghdr messages[DatagramBatch::kMaxCapacity];
+  struct iovec iovs[DatagramBatch::kMaxCapacity];
+  RawAddr* addresses = batch->addresses();
+  const intptr_t capacity = batch->capacity();
+  for (intptr_t i = 0; i < capacity; i++) {
+    iovs[i].iov_base = batch->slot(i);
+    iovs[i].iov_len = DatagramBatch::kSlotSize;
+    memset(&messages[i].msg_hdr, 0, sizeof(messages[i].msg_hdr));
+    messages[i].msg_hdr.msg_name = &addresses[i].addr;
+    messages[i].msg_hdr.msg_namelen = sizeof(addresses[i].ss);
+    messages[i].msg_hdr.msg_iov = &iovs[i];
+    messages[i].msg_hdr.msg_iovlen = 1;
+  }
+  int count = TEMP_FAILURE_RETRY(
+      recvmmsg(fd, messages, capacity, MSG_DONTWAIT, NULL));
+  if (count == -1) {
+    // Nothing to read yet, return 0 so that the caller retries once the
+    // socket becomes readable.
+    return (errno == EWOULDBLOCK) ? 0 : -1;
+  }
+  intptr_t* lengths = batch->lengths();
+  for (int i = 0; i < count; i++) {
+    lengths[i] = messages[i].msg_len;
+  }
+  batch->set_count(count);
+  return count;
+}
+
 bool SocketBase::AvailableDatagram(intptr_t fd,
                                    void* buffer,
                                    intptr_t num_bytes) {
@@ -122,6 +153,25 @@ intptr_t SocketBase::Write(intptr_t fd,
   return written_bytes;
 }
 
+intptr_t SocketBase::SendFile(intptr_t fd,
+                              intptr_t file_fd,
+                              int64_t offset,
+                              int64_t length) {
+  ASSERT(fd >= 0);
+  off64_t position = offset;
+  ssize_t sent_bytes = TEMP_FAILURE_RETRY(sendfile64(
+      fd, file_fd, &position, Utils::Minimum<int64_t>(length, kMaxInt32)));
+  if (sent_bytes == -1) {
+    if (errno == EWOULDBLOCK) {
+      return 0;
+    }
+    // The file does not support mmap-like operations, e.g. it is a pipe.
+    return ((errno == EINVAL) || (errno == ENOSYS)) ? kSendFileUnavailable
+                                                    : -1;
+  }
+  return (sent_bytes == 0) ? kSendFileUnavailable : sent_bytes;
+}
+
 intptr_t SocketBase::SendTo(intptr_t fd,
                             const void* buffer,
                             intptr_t num_bytes,
@@ -15,6 +15,7 @@
 #include <stdlib.h>       // NOLINT
 #include <string.h>       // NOLINT
 #include <sys/stat.h>     // NOLINT
+#include <sys/uio.h>      // NOLINT
 #include <unistd.h>       // NOLINT
 
 #include "bin/fdutils.h"
@@ -97,6 +98,19 @@ intptr_t SocketBase::RecvFrom(intptr_t fd,
   return read_bytes;
 }
 
+intptr_t SocketBase::RecvMultiple(intptr_t fd, DatagramBatch* batch) {
+  // Only one datagram is read at a time on this platform.
+  const intptr_t bytes_read =
+      RecvFrom(fd, batch->slot(0), DatagramBatch::kSlotSize,
+               &batch->addresses()[0], kAsync);
+  if (bytes_read <= 0) {
+    return bytes_read;
+  }
+  batch->lengths()[0] = bytes_read;
+  batch->set_count(1);
+  return 1;
+}
+
 bool SocketBase::AvailableDatagram(intptr_t fd,
                                    void* buffer,
                                    intptr_t num_bytes) {
@@ -121,6 +135,30 @@ intptr_t SocketBase::Write(intptr_t fd,
   return written_bytes;
 }
 
+intptr_t SocketBase::SendFile(intptr_t fd,
+                              intptr_t file_fd,
+                              int64_t offset,
+                              int64_t length) {
+  ASSERT(fd >= 0);
+  off_t sent_bytes;
+  int result;
+  do {
+    sent_bytes = Utils::Minimum<int64_t>(length, kMaxInt32);
+    result = sendfile(file_fd, fd, offset, &sent_bytes, NULL, 0);
+  } while ((result == -1) && (errno == EINTR) && (sent_bytes == 0));
+  if (result == -1) {
+    // A partial send also fails with EAGAIN or EINTR, and reports the number
+    // of bytes sent before that.
+    if ((errno == EAGAIN) || (errno == EINTR)) {
+      return sent_bytes;
+    }
+    return ((errno == ENOTSUP) || (errno == ENOTSOCK) || (errno == EINVAL))
+               ? kSendFileUnavailable
+               : -1;
+  }
+  return (sent_bytes == 0) ? kSendFileUnavailable : sent_bytes;
+}
+
 intptr_t SocketBase::SendTo(intptr_t fd,
                             const void* buffer,
                             intptr_t num_bytes,
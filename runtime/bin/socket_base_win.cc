@@ -99,6 +99,19 @@ intptr_t SocketBase::RecvFrom(intptr_t fd,
   return handle->RecvFrom(buffer, num_bytes, &addr->addr, addr_len);
 }
 
+intptr_t SocketBase::RecvMultiple(intptr_t fd, DatagramBatch* batch) {
+  // Only one datagram is read at a time on this platform.
+  const intptr_t bytes_read =
+      RecvFrom(fd, batch->slot(0), DatagramBatch::kSlotSize,
+               &batch->addresses()[0], kAsync);
+  if (bytes_read <= 0) {
+    return bytes_read;
+  }
+  batch->lengths()[0] = bytes_read;
+  batch->set_count(1);
+  return 1;
+}
+
 bool SocketBase::AvailableDatagram(intptr_t fd,
                                    void* buffer,
                                    intptr_t num_bytes) {
@@ -114,6 +127,14 @@ intptr_t SocketBase::Write(intptr_t fd,
   return handle->Write(buffer, num_bytes);
 }
 
+intptr_t SocketBase::SendFile(intptr_t fd,
+                              intptr_t file_fd,
+                              int64_t offset,
+                              int64_t length) {
+  // Files are sent by copying them through a buffer instead.
+  return kSendFileUnavailable;
+}
+
 intptr_t SocketBase::SendTo(intptr_t fd,
                             const void* buffer,
                             intptr_t num_bytes,
@@ -19,6 +19,7 @@
 #include "vm/lockers.h"
 #include "vm/longjump.h"
 #include "vm/message_handler.h"
+#include "vm/message_snapshot.h"
 #include "vm/object.h"
 #include "vm/object_store.h"
 #include "vm/port.h"
@@ -99,6 +100,45 @@ DEFINE_NATIVE_ENTRY(SendPortImpl_get_hashcode, 0, 1) {
   return Smi::New(hash);
 }
 
+// Whether nothing reachable from |obj| can ever be mutated, so that it can be
+// shared with other isolates of the same group instead of being copied.
+static bool IsDeeplyImmutable(ObjectPtr obj) {
+  NoSafepointScope no_safepoint;
+  MallocGrowableArray<ObjectPtr> working_set;
+  std::unique_ptr<WeakTable> visited;
+  working_set.Add(obj);
+  while (!working_set.is_empty()) {
+    ObjectPtr raw = working_set.RemoveLast();
+    if (!raw->IsHeapObject() || raw->untag()->IsCanonical()) {
+      continue;
+    }
+    const intptr_t cid = raw->GetClassId();
+    if (IsStringClassId(cid) || cid == kMintCid || cid == kDoubleCid) {
+      continue;
+    }
+    // Unmodifiable typed data views are not included: the underlying typed
+    // data can still be changed through another view.
+    if (cid != kImmutableArrayCid) {
+      return false;
+    }
+    // Elements of an immutable array may be shared, so avoid visiting them
+    // more than once.
+    if (visited == nullptr) {
+      visited.reset(new WeakTable());
+    }
+    if (visited->GetValueExclusive(raw) == 1) {
+      continue;
+    }
+    visited->SetValueExclusive(raw, 1);
+    ArrayPtr array = static_cast<ArrayPtr>(raw);
+    const intptr_t length = Smi::Value(array->untag()->length());
+    for (intptr_t i = 0; i < length; i++) {
+      working_set.Add(array->untag()->element(i));
+    }
+  }
+  return true;
+}
+
 DEFINE_NATIVE_ENTRY(SendPortImpl_sendInternal_, 0, 2) {
   GET_NON_NULL_NATIVE_ARGUMENT(SendPort, port, arguments->NativeArgAt(0));
   // TODO(iposva): Allow for arbitrary messages to be sent.
@@ -110,11 +150,35 @@ DEFINE_NATIVE_ENTRY(SendPortImpl_sendInternal_, 0, 2) {
   if (ApiObjectConverter::CanConvert(obj.ptr())) {
     PortMap::PostMessage(
         Message::New(destination_port_id, obj.ptr(), Message::kNormalPriority));
+    return Object::null();
+  }
+
+  const bool same_group = PortMap::IsReceiverInThisIsolateGroup(
+      destination_port_id, isolate->group());
+  if (same_group && IsDeeplyImmutable(obj.ptr())) {
+    // The receiver shares our heap, so pass the object by reference.
+    PersistentHandle* handle =
+        isolate->group()->api_state()->AllocatePersistentHandle();
+    handle->set_ptr(obj);
+    PortMap::PostMessage(Message::New(
+        destination_port_id,
+        new Bequest(isolate->group(), handle, destination_port_id),
+        Message::kNormalPriority));
   } else {
-    MessageWriter writer(can_send_any_object);
-    // TODO(turnidge): Throw an exception when the return value is false?
-    PortMap::PostMessage(writer.WriteMessage(obj, destination_port_id,
-                                             Message::kNormalPriority));
+    std::unique_ptr<Message> message;
+    if (same_group) {
+      // Returns nullptr if the message contains objects the clustered format
+      // does not support.
+      message = WriteClusteredMessage(thread, obj, destination_port_id,
+                                      Message::kNormalPriority);
+    }
+    if (message == nullptr) {
+      MessageWriter writer(can_send_any_object);
+      // TODO(turnidge): Throw an exception when the return value is false?
+      message = writer.WriteMessage(obj, destination_port_id,
+                                    Message::kNormalPriority);
+    }
+    PortMap::PostMessage(std::move(message));
   }
   return Object::null();
 }
@@ -292,7 +356,8 @@ DEFINE_NATIVE_ENTRY(SendPortImpl_sendAndExitInternal_, 0, 2) {
   PersistentHandle* handle =
       isolate->group()->api_state()->AllocatePersistentHandle();
   handle->set_ptr(msg_obj);
-  isolate->bequeath(std::unique_ptr<Bequest>(new Bequest(handle, port.Id())));
+  isolate->bequeath(std::unique_ptr<Bequest>(
+      new Bequest(isolate->group(), handle, port.Id())));
   // TODO(aam): Ensure there are no dart api calls after this point as we want
   // to ensure that validated message won't get tampered with.
   Isolate::KillIfExists(isolate, Isolate::LibMsgId::kKillMsg);
@@ -555,6 +620,11 @@ static InstancePtr DeserializeMessage(Thread* thread, Message* message) {
   Zone* zone = thread->zone();
   if (message->IsRaw()) {
     return Instance::RawCast(message->raw_obj());
+  } else if (message->IsClustered()) {
+    const Object& obj =
+        Object::Handle(zone, ReadClusteredMessage(thread, message));
+    ASSERT(!obj.IsError());
+    return Instance::RawCast(obj.ptr());
   } else {
     MessageSnapshotReader reader(message, thread);
     const Object& obj = Object::Handle(zone, reader.ReadObject());
@@ -269,16 +269,16 @@ DEFINE_NATIVE_ENTRY(OneByteString_splitWithCharCode, 0, 2) {
       zone, GrowableObjectArray::New(16, Heap::kNew));
   String& str = String::Handle(zone);
   intptr_t start = 0;
-  intptr_t i = 0;
-  for (; i < len; i++) {
-    if (split_code == OneByteString::CharAt(receiver, i)) {
+  if ((split_code >= 0) && (split_code <= 0xFF)) {
+    intptr_t i;
+    while ((i = receiver.IndexOfCodeUnit(split_code, start)) >= 0) {
       str = OneByteString::SubStringUnchecked(receiver, start, (i - start),
                                               Heap::kNew);
       result.Add(str);
       start = i + 1;
     }
   }
-  str = OneByteString::SubStringUnchecked(receiver, start, (i - start),
+  str = OneByteString::SubStringUnchecked(receiver, start, (len - start),
                                           Heap::kNew);
   result.Add(str);
   result.SetTypeArguments(TypeArguments::Handle(
@@ -546,6 +546,15 @@ DEFINE_NATIVE_ENTRY(String_codeUnitAt, 0, 2) {
   return Smi::New(static_cast<intptr_t>(value));
 }
 
+DEFINE_NATIVE_ENTRY(String_indexOf, 0, 3) {
+  const String& receiver =
+      String::CheckedHandle(zone, arguments->NativeArgAt(0));
+  GET_NON_NULL_NATIVE_ARGUMENT(String, pattern, arguments->NativeArgAt(1));
+  GET_NON_NULL_NATIVE_ARGUMENT(Smi, start, arguments->NativeArgAt(2));
+  ASSERT((start.Value() >= 0) && (start.Value() <= receiver.Length()));
+  return Smi::New(receiver.IndexOf(pattern, start.Value()));
+}
+
 DEFINE_NATIVE_ENTRY(String_concat, 0, 2) {
   const String& receiver =
       String::CheckedHandle(zone, arguments->NativeArgAt(0));
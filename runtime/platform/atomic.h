@@ -96,6 +96,9 @@ class AcqRelAtomic {
   T fetch_and(T arg, std::memory_order order = std::memory_order_acq_rel) {
     return value_.fetch_and(arg, order);
   }
+  T exchange(T arg, std::memory_order order = std::memory_order_acq_rel) {
+    return value_.exchange(arg, order);
+  }
 
   bool compare_exchange_weak(
       T& expected,  // NOLINT
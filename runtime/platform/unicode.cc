@@ -7,6 +7,7 @@
 #include "platform/allocation.h"
 #include "platform/globals.h"
 #include "platform/syslog.h"
+#include "platform/utils.h"
 
 namespace dart {
 
@@ -40,6 +41,31 @@ const uint32_t Utf8::kOverlongMinimum[7] = {0,  // Padding.
                                             0x0,     0x80,       0x800,
                                             0x10000, 0xFFFFFFFF, 0xFFFFFFFF};
 
+// Most text is largely ASCII, so all of the loops below skip over runs of
+// ASCII characters a word at a time before looking at single bytes.
+static const uint64_t kAsciiWordMask = 0x8080808080808080ULL;
+
+static inline bool IsAsciiWord(const uint8_t* utf8_array) {
+  uint64_t word;
+  memcpy(&word, utf8_array, sizeof(word));
+  return (word & kAsciiWordMask) == 0;
+}
+
+// Returns the number of ASCII characters 'utf8_array' starts with, looking at
+// no more than 'array_len' bytes.
+static inline intptr_t AsciiPrefixLength(const uint8_t* utf8_array,
+                                         intptr_t array_len) {
+  intptr_t i = 0;
+  while (((i + static_cast<intptr_t>(sizeof(uint64_t))) <= array_len) &&
+         IsAsciiWord(&utf8_array[i])) {
+    i += sizeof(uint64_t);
+  }
+  while ((i < array_len) && (utf8_array[i] <= Utf8::kMaxOneByteChar)) {
+    i++;
+  }
+  return i;
+}
+
 // Returns the most restricted coding form in which the sequence of utf8
 // characters in 'utf8_array' can be represented in, and the number of
 // code units needed in that form.
@@ -49,6 +75,12 @@ intptr_t Utf8::CodeUnitCount(const uint8_t* utf8_array,
   intptr_t len = 0;
   Type char_type = kLatin1;
   for (intptr_t i = 0; i < array_len; i++) {
+    if (((i + static_cast<intptr_t>(sizeof(uint64_t))) <= array_len) &&
+        IsAsciiWord(&utf8_array[i])) {
+      len += sizeof(uint64_t);
+      i += sizeof(uint64_t) - 1;
+      continue;
+    }
     uint8_t code_unit = utf8_array[i];
     if (!IsTrailByte(code_unit)) {
       ++len;
@@ -70,6 +102,10 @@ intptr_t Utf8::CodeUnitCount(const uint8_t* utf8_array,
 bool Utf8::IsValid(const uint8_t* utf8_array, intptr_t array_len) {
   intptr_t i = 0;
   while (i < array_len) {
+    i += AsciiPrefixLength(&utf8_array[i], array_len - i);
+    if (i == array_len) {
+      break;
+    }
     uint32_t ch = utf8_array[i] & 0xFF;
     intptr_t j = 1;
     if (ch >= 0x80) {
@@ -199,6 +235,16 @@ bool Utf8::DecodeToLatin1(const uint8_t* utf8_array,
   intptr_t j = 0;
   intptr_t num_bytes;
   for (; (i < array_len) && (j < len); i += num_bytes, ++j) {
+    const intptr_t ascii_len = AsciiPrefixLength(
+        &utf8_array[i], Utils::Minimum(array_len - i, len - j));
+    if (ascii_len > 0) {
+      memcpy(&dst[j], &utf8_array[i], ascii_len);
+      i += ascii_len;
+      j += ascii_len;
+      if ((i == array_len) || (j == len)) {
+        break;
+      }
+    }
     int32_t ch;
     ASSERT(IsLatin1SequenceStart(utf8_array[i]));
     num_bytes = Utf8::Decode(&utf8_array[i], (array_len - i), &ch);
@@ -222,6 +268,18 @@ bool Utf8::DecodeToUTF16(const uint8_t* utf8_array,
   intptr_t j = 0;
   intptr_t num_bytes;
   for (; (i < array_len) && (j < len); i += num_bytes, ++j) {
+    const intptr_t ascii_len = AsciiPrefixLength(
+        &utf8_array[i], Utils::Minimum(array_len - i, len - j));
+    if (ascii_len > 0) {
+      for (intptr_t k = 0; k < ascii_len; k++) {
+        dst[j + k] = utf8_array[i + k];
+      }
+      i += ascii_len;
+      j += ascii_len;
+      if ((i == array_len) || (j == len)) {
+        break;
+      }
+    }
     int32_t ch;
     bool is_supplementary = IsSupplementarySequenceStart(utf8_array[i]);
     num_bytes = Utf8::Decode(&utf8_array[i], (array_len - i), &ch);
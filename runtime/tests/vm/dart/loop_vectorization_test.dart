@@ -0,0 +1,144 @@
+// Copyright (c) 2021, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// Checks that loops over typed data compute the same results whether or not
+// they are vectorized or unrolled, including the elements left over after
+// the vector loop, overlapping arrays and out-of-range indices.
+
+// VMOptions=
+// VMOptions=--loop_unroll_factor=1
+// VMOptions=--no-loop_vectorization
+
+import 'dart:typed_data';
+
+import 'package:expect/expect.dart';
+
+@pragma('vm:never-inline')
+void axpy(Float64List a, Float64List b, double c, int start, int end) {
+  for (int i = start; i < end; i++) {
+    a[i] = a[i] * c + b[i];
+  }
+}
+
+@pragma('vm:never-inline')
+void scale(Float32List a, Float32List b, double c) {
+  for (int i = 0; i < a.length; i++) {
+    a[i] = b[i] * c;
+  }
+}
+
+@pragma('vm:never-inline')
+void mix(Int32List a, Int32List b) {
+  for (int i = 0; i < a.length; i++) {
+    a[i] = (a[i] ^ b[i]) + (b[i] & 0xff);
+  }
+}
+
+@pragma('vm:never-inline')
+int sum(Uint32List a, int start) {
+  int result = 0;
+  for (int i = start; i < a.length; i++) {
+    result += a[i];
+  }
+  return result;
+}
+
+void testLengths() {
+  // Lengths from 0 to 3 vectors and an unrolled iteration past them, so
+  // every number of leftover elements is covered.
+  for (int length = 0; length < 20; length++) {
+    for (int start = 0; start <= length && start < 5; start++) {
+      final a = new Float64List(length);
+      final b = new Float64List(length);
+      final expected = new List<double>.filled(length, 0.0);
+      for (int i = 0; i < length; i++) {
+        a[i] = i + 0.5;
+        b[i] = 1.0 / (i + 1);
+        expected[i] = (i >= start) ? (i + 0.5) * 3.0 + 1.0 / (i + 1) : a[i];
+      }
+      axpy(a, b, 3.0, start, length);
+      Expect.listEquals(expected, a);
+
+      final f = new Float32List(length);
+      final g = new Float32List(length);
+      for (int i = 0; i < length; i++) {
+        g[i] = i / 3.0;
+      }
+      scale(f, g, 1.5);
+      for (int i = 0; i < length; i++) {
+        Expect.equals(new Float32List.fromList([g[i] * 1.5])[0], f[i]);
+      }
+
+      final x = new Int32List(length);
+      final y = new Int32List(length);
+      for (int i = 0; i < length; i++) {
+        x[i] = 0x7fffffff - i;
+        y[i] = i * 0x10001;
+      }
+      mix(x, y);
+      for (int i = 0; i < length; i++) {
+        final value = ((0x7fffffff - i) ^ y[i]) + (y[i] & 0xff);
+        Expect.equals(value.toSigned(32), x[i]);
+      }
+
+      final u = new Uint32List(length);
+      int total = 0;
+      for (int i = 0; i < length; i++) {
+        u[i] = 0xffffffff - i;
+        if (i >= start) total += 0xffffffff - i;
+      }
+      Expect.equals(total, sum(u, start));
+    }
+  }
+}
+
+void testOverlap() {
+  // Views of one buffer that overlap within a vector must not be vectorized,
+  // because the scalar loop reads elements that earlier iterations wrote.
+  const length = 17;
+  for (int offset = -3; offset <= 3; offset++) {
+    final buffer = new Float64List(length + 6);
+    final expected = new List<double>.filled(buffer.length, 0.0);
+    for (int i = 0; i < buffer.length; i++) {
+      buffer[i] = i.toDouble();
+      expected[i] = i.toDouble();
+    }
+    final a = new Float64List.view(buffer.buffer, 3 * 8, length);
+    final b = new Float64List.view(buffer.buffer, (3 + offset) * 8, length);
+    for (int i = 0; i < length; i++) {
+      expected[3 + i] = expected[3 + i] * 2.0 + expected[3 + offset + i];
+    }
+    axpy(a, b, 2.0, 0, length);
+    Expect.listEquals(expected, buffer);
+  }
+}
+
+void testOutOfRange() {
+  // The loop must throw at the first index past the end of the shorter
+  // array, after all earlier elements were updated.
+  for (int length = 0; length < 12; length++) {
+    final a = new Float64List(length + 5);
+    final b = new Float64List(length);
+    for (int i = 0; i < b.length; i++) {
+      b[i] = 1.0;
+    }
+    try {
+      axpy(a, b, 1.0, 0, a.length);
+      Expect.fail('Expected a RangeError');
+    } on RangeError catch (e) {
+      Expect.equals(length, e.invalidValue);
+    }
+    for (int i = 0; i < a.length; i++) {
+      Expect.equals(i < length ? 1.0 : 0.0, a[i]);
+    }
+  }
+}
+
+main() {
+  for (int i = 0; i < 3; i++) {
+    testLengths();
+    testOverlap();
+    testOutOfRange();
+  }
+}
@@ -0,0 +1,98 @@
+// Copyright (c) 2021, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// A program with polymorphic call sites, used by aot_profile_test.dart to
+// train and then run an AOT snapshot compiled with --aot_profile.
+//
+// Shape has more implementations than the AOT compiler tests for without
+// feedback, so only the profile can turn shape.area into class checks.
+
+abstract class Shape {
+  double get area;
+}
+
+class Square extends Shape {
+  final double side;
+  Square(this.side);
+  double get area => side * side;
+}
+
+class Circle extends Shape {
+  final double radius;
+  Circle(this.radius);
+  double get area => 3.0 * radius * radius;
+}
+
+class Rectangle extends Shape {
+  final double width;
+  final double height;
+  Rectangle(this.width, this.height);
+  double get area => width * height;
+}
+
+class Triangle extends Shape {
+  final double base;
+  final double height;
+  Triangle(this.base, this.height);
+  double get area => 0.5 * base * height;
+}
+
+class Ellipse extends Shape {
+  final double a;
+  final double b;
+  Ellipse(this.a, this.b);
+  double get area => 3.0 * a * b;
+}
+
+class Rhombus extends Shape {
+  final double p;
+  final double q;
+  Rhombus(this.p, this.q);
+  double get area => 0.5 * p * q;
+}
+
+class Hexagon extends Shape {
+  final double side;
+  Hexagon(this.side);
+  double get area => 2.5 * side * side;
+}
+
+@pragma('vm:never-inline')
+double totalArea(List<Shape> shapes) {
+  double total = 0.0;
+  for (final shape in shapes) {
+    total += shape.area;
+  }
+  return total;
+}
+
+// Never runs, so it is placed after the code that ran in training.
+@pragma('vm:never-inline')
+double largestArea(List<Shape> shapes) {
+  double largest = 0.0;
+  for (final shape in shapes) {
+    if (shape.area > largest) largest = shape.area;
+  }
+  return largest;
+}
+
+void main(List<String> args) {
+  final shapes = <Shape>[];
+  for (int i = 0; i < 1000; i++) {
+    shapes.add(i % 10 == 0 ? Circle(1.0) : Square(2.0));
+  }
+  shapes.add(Rectangle(1.0, 2.0));
+  shapes.add(Triangle(1.0, 2.0));
+  shapes.add(Ellipse(1.0, 2.0));
+  shapes.add(Rhombus(1.0, 2.0));
+  shapes.add(Hexagon(1.0));
+  double total = 0.0;
+  for (int i = 0; i < 1000; i++) {
+    total += totalArea(shapes);
+  }
+  print(total);
+  if (args.contains('--largest')) {
+    print(largestArea(shapes));
+  }
+}
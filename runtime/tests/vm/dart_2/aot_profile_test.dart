@@ -0,0 +1,97 @@
+// Copyright (c) 2021, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// This test ensures that type feedback saved by a JIT training run can be
+// used to guide AOT compilation with --aot-profile, and that the resulting
+// snapshot behaves like the JIT.
+
+// OtherResources=aot_profile_program.dart
+
+import "dart:convert";
+import "dart:io";
+
+import 'package:expect/expect.dart';
+import 'package:path/path.dart' as path;
+
+import 'use_flag_test_helper.dart';
+
+final dart = path.join(buildDir, 'dart' + (Platform.isWindows ? '.exe' : ''));
+
+main(List<String> args) async {
+  if (!isAOTRuntime) {
+    return; // Running in JIT: AOT binaries not available.
+  }
+
+  if (Platform.isAndroid) {
+    return; // SDK tree and dart_bootstrap not available on the test device.
+  }
+
+  // These are the tools we need to be available to run on a given platform:
+  if (!await testExecutable(dart)) {
+    throw "Cannot run test as $dart not available";
+  }
+  if (!await testExecutable(genSnapshot)) {
+    throw "Cannot run test as $genSnapshot not available";
+  }
+  if (!await testExecutable(aotRuntime)) {
+    throw "Cannot run test as $aotRuntime not available";
+  }
+  if (!File(platformDill).existsSync()) {
+    throw "Cannot run test as $platformDill does not exist";
+  }
+
+  await withTempDir('aot-profile-test', (String tempDir) async {
+    final cwDir = path.dirname(Platform.script.toFilePath());
+    final script = path.join(cwDir, 'aot_profile_program.dart');
+    final scriptDill = path.join(tempDir, 'aot_profile_program.dill');
+    final feedback = path.join(tempDir, 'type_feedback.bin');
+    final snapshot = path.join(tempDir, 'snapshot.so');
+    final sizes = path.join(tempDir, 'sizes.json');
+
+    // Train in the JIT.
+    final jitOutput = await runOutput(dart, <String>[
+      '--save-type-feedback=$feedback',
+      script,
+    ]);
+
+    // Compile script to Kernel IR.
+    await run(genKernel, <String>[
+      '--aot',
+      '--platform=$platformDill',
+      '-o',
+      scriptDill,
+      script,
+    ]);
+
+    final genSnapshotOutput = await runOutput(genSnapshot, <String>[
+      '--aot-profile=$feedback',
+      '--trace-aot-profile',
+      '--print-instructions-sizes-to=$sizes',
+      '--snapshot-kind=app-aot-elf',
+      '--elf=$snapshot',
+      scriptDill,
+    ]);
+    Expect.isTrue(
+        genSnapshotOutput.any((line) => line.startsWith('Loaded feedback')),
+        'feedback was not loaded');
+    // Without feedback, shape.area has too many targets for class checks.
+    const areaCall = 'Profiled polymorphic call get:area';
+    Expect.isTrue(genSnapshotOutput.any((line) => line.startsWith(areaCall)),
+        'feedback did not make shape.area a polymorphic call');
+
+    // Code that ran in training is placed before code that did not.
+    final List<dynamic> entries = jsonDecode(File(sizes).readAsStringSync());
+    int indexOf(String name) => entries.indexWhere((entry) =>
+        entry['n'] == name &&
+        (entry['l'] as String ?? '').endsWith('aot_profile_program.dart'));
+    final hot = indexOf('totalArea');
+    final cold = indexOf('largestArea');
+    Expect.isTrue(hot >= 0, 'totalArea not found in $sizes');
+    Expect.isTrue(cold >= 0, 'largestArea not found in $sizes');
+    Expect.isTrue(hot < cold, 'totalArea is not placed before largestArea');
+
+    final aotOutput = await runOutput(aotRuntime, <String>[snapshot]);
+    Expect.listEquals(jitOutput, aotOutput);
+  });
+}
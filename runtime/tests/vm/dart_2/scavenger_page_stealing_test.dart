@@ -0,0 +1,58 @@
+// Copyright (c) 2021, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// VMOptions=--scavenger_tasks=4
+// VMOptions=--scavenger_tasks=4 --verify_after_gc
+// VMOptions=--scavenger_tasks=8
+
+import "package:expect/expect.dart";
+
+// A single long chain of objects is found by only one scavenger worker. The
+// other workers can only help by stealing the to-space pages it has filled
+// but not yet scanned.
+class Node {
+  final int value;
+  final Node next;
+  final List<int> payload;
+  Node(this.value, this.next) : payload = new List<int>.filled(4, value);
+}
+
+Node buildChain(int length) {
+  Node head = null;
+  for (int i = 0; i < length; i++) {
+    head = new Node(i, head);
+  }
+  return head;
+}
+
+void checkChain(Node head, int length) {
+  int expected = length - 1;
+  while (head != null) {
+    Expect.equals(expected, head.value);
+    for (int i = 0; i < head.payload.length; i++) {
+      Expect.equals(expected, head.payload[i]);
+    }
+    expected--;
+    head = head.next;
+  }
+  Expect.equals(-1, expected);
+}
+
+// Fills new space so that the chain is scavenged a few times.
+int allocateGarbage() {
+  int sum = 0;
+  for (int i = 0; i < 200000; i++) {
+    sum += new List<int>.filled(8, i).length;
+  }
+  return sum;
+}
+
+main() {
+  const length = 200000;
+  for (int i = 0; i < 5; i++) {
+    final head = buildChain(length);
+    Expect.equals(200000 * 8, allocateGarbage());
+    checkChain(head, length);
+  }
+}
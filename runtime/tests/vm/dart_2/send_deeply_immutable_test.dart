@@ -0,0 +1,73 @@
+// Copyright (c) 2021, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+//
+// VMOptions=--enable-isolate-groups --experimental-enable-isolate-groups-jit
+// VMOptions=--no-enable-isolate-groups
+//
+// Validates that deeply immutable messages are passed by reference within an
+// isolate group, and arrive intact otherwise.
+
+import 'dart:async';
+import 'dart:io';
+import 'dart:isolate';
+
+import "package:expect/expect.dart";
+
+const constMap = {
+  'a': [1, 2, 3],
+  'b': 'c'
+};
+
+final bool isolateGroupsEnabled =
+    Platform.executableArguments.contains('--enable-isolate-groups');
+
+final unmodifiableList = List<Object>.unmodifiable([
+  'x' * 1000,
+  List<String>.unmodifiable(['y', 'z']),
+  1 << 40,
+  3.14,
+  constMap,
+]);
+
+echo(SendPort sendPort) {
+  final receivePort = ReceivePort();
+  sendPort.send(receivePort.sendPort);
+  receivePort.listen((message) {
+    sendPort.send(message);
+  });
+}
+
+main() async {
+  final receivePort = ReceivePort();
+  final isolate = await Isolate.spawn(echo, receivePort.sendPort);
+  final messages = StreamIterator(receivePort);
+
+  Expect.isTrue(await messages.moveNext());
+  final SendPort sendPort = messages.current;
+
+  for (final message in [
+    'hello' * 100,
+    constMap,
+    unmodifiableList,
+  ]) {
+    sendPort.send(message);
+    Expect.isTrue(await messages.moveNext());
+    Expect.equals(message.toString(), messages.current.toString());
+    if (isolateGroupsEnabled) {
+      // The echo isolate sent back the object it received.
+      Expect.isTrue(identical(message, messages.current));
+    }
+  }
+
+  // A mutable list nested in an unmodifiable one is still copied.
+  final mutable = [1, 2, 3];
+  sendPort.send(List<Object>.unmodifiable([mutable]));
+  Expect.isTrue(await messages.moveNext());
+  final List received = messages.current;
+  Expect.isFalse(identical(mutable, received[0]));
+  Expect.listEquals(mutable, received[0]);
+
+  isolate.kill();
+  receivePort.close();
+}
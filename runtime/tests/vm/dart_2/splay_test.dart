@@ -19,10 +19,13 @@
 // VMOptions=--no_concurrent_mark --concurrent_sweep
 // VMOptions=--no_concurrent_mark --use_compactor
 // VMOptions=--no_concurrent_mark --use_compactor --force_evacuation
+// VMOptions=--no_concurrent_mark --use_compactor --compactor_sparse_threshold=50
 // VMOptions=--concurrent_mark --no_concurrent_sweep
 // VMOptions=--concurrent_mark --concurrent_sweep
 // VMOptions=--concurrent_mark --use_compactor
 // VMOptions=--concurrent_mark --use_compactor --force_evacuation
+// VMOptions=--concurrent_mark --use_compactor --compactor_sparse_threshold=50
+// VMOptions=--concurrent_mark --use_compactor --compactor_sparse_threshold=50 --no_concurrent_sweep --verify_after_gc
 // VMOptions=--scavenger_tasks=0
 // VMOptions=--scavenger_tasks=1
 // VMOptions=--scavenger_tasks=2
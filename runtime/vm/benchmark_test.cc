@@ -612,6 +612,108 @@ BENCHMARK(LargeMap) {
   benchmark->set_score(elapsed_time);
 }
 
+BENCHMARK(PortFanIn) {
+  // Many ports forward messages to a single sink port.
+  const char* kScript =
+      "import 'dart:isolate';\n"
+      "const int kNumPorts = 1000;\n"
+      "const int kMessagesPerPort = 100;\n"
+      "void benchmark() {\n"
+      "  final sources = <RawReceivePort>[];\n"
+      "  final sink = new RawReceivePort();\n"
+      "  int received = 0;\n"
+      "  sink.handler = (message) {\n"
+      "    if (++received == kNumPorts * kMessagesPerPort) {\n"
+      "      sink.close();\n"
+      "      for (final source in sources) source.close();\n"
+      "    }\n"
+      "  };\n"
+      "  for (int i = 0; i < kNumPorts; i++) {\n"
+      "    final source = new RawReceivePort();\n"
+      "    source.handler = (message) => sink.sendPort.send(message);\n"
+      "    sources.add(source);\n"
+      "  }\n"
+      "  for (int i = 0; i < kMessagesPerPort; i++) {\n"
+      "    for (final source in sources) source.sendPort.send(i);\n"
+      "  }\n"
+      "}\n";
+  Dart_Handle lib = TestCase::LoadTestScript(kScript, NULL);
+  EXPECT_VALID(lib);
+
+  Timer timer(true, "Port fan-in");
+  timer.Start();
+  Dart_Handle result = Dart_Invoke(lib, NewString("benchmark"), 0, NULL);
+  EXPECT_VALID(result);
+  result = Dart_RunLoop();
+  EXPECT_VALID(result);
+  timer.Stop();
+  int64_t elapsed_time = timer.TotalElapsedTime();
+  benchmark->set_score(elapsed_time);
+}
+
+struct ZoneWorkerState {
+  IsolateGroup* isolate_group = nullptr;
+  Monitor* monitor = nullptr;
+  ThreadJoinId join_id = OSThread::kInvalidThreadJoinId;
+};
+
+// Mimics the zone usage of a background compilation: many short-lived zones
+// that grow by a few segments and the occasional large allocation.
+static void ZoneWorker(uword arg) {
+  auto state = reinterpret_cast<ZoneWorkerState*>(arg);
+  {
+    MonitorLocker ml(state->monitor);
+    state->join_id = OSThread::GetCurrentThreadJoinId(OSThread::Current());
+    ml.Notify();
+  }
+
+  const bool kBypassSafepoint = false;
+  Thread::EnterIsolateGroupAsHelper(state->isolate_group, Thread::kUnknownTask,
+                                    kBypassSafepoint);
+  {
+    Thread* thread = Thread::Current();
+    const intptr_t kLoopCount = 10000;
+    for (intptr_t i = 0; i < kLoopCount; i++) {
+      StackZone zone(thread);
+      for (intptr_t j = 0; j < 64; j++) {
+        zone.GetZone()->Alloc<uint8_t>(4 * KB);
+      }
+      zone.GetZone()->Alloc<uint8_t>(200 * KB);
+    }
+  }
+  Thread::ExitIsolateGroupAsHelper(kBypassSafepoint);
+}
+
+BENCHMARK(ParallelZoneAllocation) {
+  const intptr_t kNumThreads = 8;
+  Monitor monitor;
+  ZoneWorkerState states[kNumThreads];
+  Timer timer(true, "Parallel Zone Allocation");
+  timer.Start();
+  for (intptr_t i = 0; i < kNumThreads; i++) {
+    states[i].isolate_group = thread->isolate_group();
+    states[i].monitor = &monitor;
+    if (OSThread::Start("ZoneWorker", &ZoneWorker,
+                        reinterpret_cast<uword>(&states[i])) != 0) {
+      FATAL("Could not start worker thread");
+    }
+  }
+  for (intptr_t i = 0; i < kNumThreads; i++) {
+    ThreadJoinId join_id;
+    {
+      MonitorLocker ml(&monitor);
+      while (states[i].join_id == OSThread::kInvalidThreadJoinId) {
+        ml.Wait();
+      }
+      join_id = states[i].join_id;
+    }
+    OSThread::Join(join_id);
+  }
+  timer.Stop();
+  int64_t elapsed_time = timer.TotalElapsedTime();
+  benchmark->set_score(elapsed_time);
+}
+
 BENCHMARK_MEMORY(InitialRSS) {
   benchmark->set_score(bin::Process::MaxRSS());
 }
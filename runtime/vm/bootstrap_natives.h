@@ -137,6 +137,7 @@ namespace dart {
   V(String_getLength, 1)                                                       \
   V(String_charAt, 2)                                                          \
   V(String_codeUnitAt, 2)                                                      \
+  V(String_indexOf, 3)                                                         \
   V(String_concat, 2)                                                          \
   V(String_fromEnvironment, 3)                                                 \
   V(String_toLowerCase, 1)                                                     \
@@ -405,7 +406,7 @@ namespace dart {
   V(Ffi_storePointer, 3)                                                       \
   V(Ffi_address, 1)                                                            \
   V(Ffi_fromAddress, 1)                                                        \
-  V(Ffi_asFunctionInternal, 1)                                                 \
+  V(Ffi_asFunctionInternal, 2)                                                 \
   V(Ffi_nativeCallbackFunction, 2)                                             \
   V(Ffi_pointerFromFunction, 1)                                                \
   V(Ffi_dl_open, 1)                                                            \
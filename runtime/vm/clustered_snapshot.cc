@@ -26,6 +26,8 @@
 #include "vm/program_visitor.h"
 #include "vm/stub_code.h"
 #include "vm/symbols.h"
+#include "vm/thread_barrier.h"
+#include "vm/thread_pool.h"
 #include "vm/timeline.h"
 #include "vm/version.h"
 #include "vm/zone_text_buffer.h"
@@ -45,6 +47,12 @@ DEFINE_FLAG(bool,
             "Print information about clusters written to snapshot");
 #endif
 
+DEFINE_FLAG(int,
+            deserialization_tasks,
+            1,
+            "The number of threads used to fill in objects when reading a "
+            "full snapshot. 0 means one per available processor.");
+
 #if defined(DART_PRECOMPILER)
 DEFINE_FLAG(charp,
             write_v8_snapshot_profile_to,
@@ -762,6 +770,8 @@ class TypeArgumentsDeserializationCluster
     BuildCanonicalSetFromLayout(d, stamp_canonical);
   }
 
+  bool CanFillInParallel() const { return true; }
+
   void ReadFill(Deserializer* d, bool stamp_canonical) {
     for (intptr_t id = start_index_; id < stop_index_; id++) {
       TypeArgumentsPtr type_args = static_cast<TypeArgumentsPtr>(d->Ref(id));
@@ -854,6 +864,8 @@ class PatchClassDeserializationCluster : public DeserializationCluster {
     stop_index_ = d->next_index();
   }
 
+  bool CanFillInParallel() const { return true; }
+
   void ReadFill(Deserializer* d, bool stamp_canonical) {
     ASSERT(!stamp_canonical);  // Never canonical.
     for (intptr_t id = start_index_; id < stop_index_; id++) {
@@ -965,6 +977,8 @@ class FunctionDeserializationCluster : public DeserializationCluster {
     stop_index_ = d->next_index();
   }
 
+  bool CanFillInParallel() const { return true; }
+
   void ReadFill(Deserializer* d, bool stamp_canonical) {
     ASSERT(!stamp_canonical);  // Never canonical.
     Snapshot::Kind kind = d->kind();
@@ -1118,6 +1132,8 @@ class ClosureDataDeserializationCluster : public DeserializationCluster {
     stop_index_ = d->next_index();
   }
 
+  bool CanFillInParallel() const { return true; }
+
   void ReadFill(Deserializer* d, bool stamp_canonical) {
     ASSERT(!stamp_canonical);  // Never canonical.
     for (intptr_t id = start_index_; id < stop_index_; id++) {
@@ -1177,6 +1193,7 @@ class FfiTrampolineDataSerializationCluster : public SerializationCluster {
         // FFI callbacks can only be written to AOT snapshots.
         ASSERT(data->untag()->callback_target() == Object::null());
       }
+      s->Write<bool>(data->untag()->is_leaf_);
     }
   }
 
@@ -1211,6 +1228,7 @@ class FfiTrampolineDataDeserializationCluster : public DeserializationCluster {
       ReadFromTo(data);
       data->untag()->callback_id_ =
           d->kind() == Snapshot::kFullAOT ? d->ReadUnsigned() : 0;
+      data->untag()->is_leaf_ = d->Read<bool>();
     }
   }
 };
@@ -1467,6 +1485,8 @@ class ScriptDeserializationCluster : public DeserializationCluster {
     stop_index_ = d->next_index();
   }
 
+  bool CanFillInParallel() const { return true; }
+
   void ReadFill(Deserializer* d, bool stamp_canonical) {
     ASSERT(!stamp_canonical);  // Never canonical.
     for (intptr_t id = start_index_; id < stop_index_; id++) {
@@ -1804,6 +1824,7 @@ class CodeSerializationCluster : public SerializationCluster {
     CodePtr code;
     intptr_t order;
     intptr_t original_index;
+    intptr_t usage;
   };
 
   // We sort code objects in such a way that code objects with the same
@@ -1812,8 +1833,15 @@ class CodeSerializationCluster : public SerializationCluster {
   // this helps to stabilize output of --print-instructions-sizes-to which uses
   // the name of the first code object (among those pointing to the same
   // instruction objects).
+  //
+  // When the precompiler was given a training profile (see --aot_profile),
+  // the usage counters of the functions that ran are set from it and code
+  // that ran is placed first, most used first, so that the hot code of the
+  // program is packed into as few pages as possible.
   static int CompareCodeOrderInfo(CodeOrderInfo const* a,
                                   CodeOrderInfo const* b) {
+    if (a->usage > b->usage) return -1;
+    if (a->usage < b->usage) return 1;
     if (a->order < b->order) return -1;
     if (a->order > b->order) return 1;
     if (a->original_index < b->original_index) return -1;
@@ -1838,15 +1866,54 @@ class CodeSerializationCluster : public SerializationCluster {
     info.code = code;
     info.order = order;
     info.original_index = original_index;
+    info.usage = 0;
     order_list->Add(info);
   }
 
+  static intptr_t UsageOf(CodePtr code) {
+#if defined(DART_PRECOMPILER)
+    if (!FLAG_precompiled_mode) {
+      return 0;
+    }
+    ObjectPtr owner =
+        WeakSerializationReference::Unwrap(code->untag()->owner());
+    if (!owner->IsHeapObject() || !owner->IsFunction()) {
+      return 0;
+    }
+    const Function& function =
+        Function::Handle(static_cast<FunctionPtr>(owner));
+    // Functions which cannot be optimized have a negative usage counter.
+    return Utils::Maximum<intptr_t>(0, function.usage_counter());
+#else
+    return 0;
+#endif
+  }
+
+  // Code objects sharing instructions must stay together, so they all get the
+  // highest usage among them.
+  static void ComputeUsage(GrowableArray<CodeOrderInfo>* order_list) {
+    IntMap<intptr_t> usage_map;
+    for (const auto& info : *order_list) {
+      const intptr_t usage = UsageOf(info.code);
+      auto* pair = usage_map.LookupPair(info.order);
+      if (pair == nullptr) {
+        usage_map.Insert(info.order, usage);
+      } else if (usage > pair->value) {
+        pair->value = usage;
+      }
+    }
+    for (auto& info : *order_list) {
+      info.usage = usage_map.Lookup(info.order);
+    }
+  }
+
   static void Sort(GrowableArray<CodePtr>* codes) {
     GrowableArray<CodeOrderInfo> order_list;
     IntMap<intptr_t> order_map;
     for (intptr_t i = 0; i < codes->length(); i++) {
       Insert(&order_list, &order_map, (*codes)[i], i);
     }
+    ComputeUsage(&order_list);
     order_list.Sort(CompareCodeOrderInfo);
     ASSERT(order_list.length() == codes->length());
     for (intptr_t i = 0; i < order_list.length(); i++) {
@@ -1860,6 +1927,7 @@ class CodeSerializationCluster : public SerializationCluster {
     for (intptr_t i = 0; i < codes->length(); i++) {
       Insert(&order_list, &order_map, (*codes)[i]->ptr(), i);
     }
+    ComputeUsage(&order_list);
     order_list.Sort(CompareCodeOrderInfo);
     ASSERT(order_list.length() == codes->length());
     for (intptr_t i = 0; i < order_list.length(); i++) {
@@ -2296,6 +2364,8 @@ class ObjectPoolDeserializationCluster : public DeserializationCluster {
     stop_index_ = d->next_index();
   }
 
+  bool CanFillInParallel() const { return true; }
+
   void ReadFill(Deserializer* d, bool stamp_canonical) {
     ASSERT(!stamp_canonical);  // Never canonical.
     fill_position_ = d->position();
@@ -3676,6 +3746,8 @@ class InstanceDeserializationCluster
     stop_index_ = d->next_index();
   }
 
+  bool CanFillInParallel() const { return true; }
+
   void ReadFill(Deserializer* d, bool stamp_canonical) {
     intptr_t next_field_offset = next_field_offset_in_words_ << kWordSizeLog2;
     intptr_t instance_size =
@@ -3902,6 +3974,8 @@ class TypeDeserializationCluster
     BuildCanonicalSetFromLayout(d, stamp_canonical);
   }
 
+  bool CanFillInParallel() const { return true; }
+
   void ReadFill(Deserializer* d, bool stamp_canonical) {
     for (intptr_t id = start_index_; id < stop_index_; id++) {
       TypePtr type = static_cast<TypePtr>(d->Ref(id));
@@ -4029,6 +4103,8 @@ class FunctionTypeDeserializationCluster
     BuildCanonicalSetFromLayout(d, stamp_canonical);
   }
 
+  bool CanFillInParallel() const { return true; }
+
   void ReadFill(Deserializer* d, bool stamp_canonical) {
     for (intptr_t id = start_index_; id < stop_index_; id++) {
       FunctionTypePtr type = static_cast<FunctionTypePtr>(d->Ref(id));
@@ -4130,6 +4206,8 @@ class TypeRefDeserializationCluster : public DeserializationCluster {
     stop_index_ = d->next_index();
   }
 
+  bool CanFillInParallel() const { return true; }
+
   void ReadFill(Deserializer* d, bool stamp_canonical) {
     for (intptr_t id = start_index_; id < stop_index_; id++) {
       TypeRefPtr type = static_cast<TypeRefPtr>(d->Ref(id));
@@ -4249,6 +4327,8 @@ class TypeParameterDeserializationCluster
     BuildCanonicalSetFromLayout(d, stamp_canonical);
   }
 
+  bool CanFillInParallel() const { return true; }
+
   void ReadFill(Deserializer* d, bool stamp_canonical) {
     for (intptr_t id = start_index_; id < stop_index_; id++) {
       TypeParameterPtr type = static_cast<TypeParameterPtr>(d->Ref(id));
@@ -4355,6 +4435,8 @@ class ClosureDeserializationCluster
     stop_index_ = d->next_index();
   }
 
+  bool CanFillInParallel() const { return true; }
+
   void ReadFill(Deserializer* d, bool stamp_canonical) {
     for (intptr_t id = start_index_; id < stop_index_; id++) {
       ClosurePtr closure = static_cast<ClosurePtr>(d->Ref(id));
@@ -4434,6 +4516,8 @@ class MintDeserializationCluster : public DeserializationCluster {
     stop_index_ = d->next_index();
   }
 
+  bool CanFillInParallel() const { return true; }
+
   void ReadFill(Deserializer* d, bool stamp_canonical) {}
 
   void PostLoad(Deserializer* d, const Array& refs, bool canonicalize) {
@@ -4512,6 +4596,8 @@ class DoubleDeserializationCluster : public DeserializationCluster {
     stop_index_ = d->next_index();
   }
 
+  bool CanFillInParallel() const { return true; }
+
   void ReadFill(Deserializer* d, bool stamp_canonical) {
     for (intptr_t id = start_index_; id < stop_index_; id++) {
       DoublePtr dbl = static_cast<DoublePtr>(d->Ref(id));
@@ -4601,6 +4687,8 @@ class GrowableObjectArrayDeserializationCluster
     stop_index_ = d->next_index();
   }
 
+  bool CanFillInParallel() const { return true; }
+
   void ReadFill(Deserializer* d, bool stamp_canonical) {
     for (intptr_t id = start_index_; id < stop_index_; id++) {
       GrowableObjectArrayPtr list =
@@ -4679,6 +4767,8 @@ class TypedDataDeserializationCluster : public DeserializationCluster {
     stop_index_ = d->next_index();
   }
 
+  bool CanFillInParallel() const { return true; }
+
   void ReadFill(Deserializer* d, bool stamp_canonical) {
     ASSERT(!stamp_canonical);  // Never canonical.
     intptr_t element_size = TypedData::ElementSizeInBytes(cid_);
@@ -5265,6 +5355,8 @@ class ArrayDeserializationCluster
     stop_index_ = d->next_index();
   }
 
+  bool CanFillInParallel() const { return true; }
+
   void ReadFill(Deserializer* d, bool stamp_canonical) {
     for (intptr_t id = start_index_; id < stop_index_; id++) {
       ArrayPtr array = static_cast<ArrayPtr>(d->Ref(id));
@@ -5375,6 +5467,8 @@ class OneByteStringDeserializationCluster
     stop_index_ = d->next_index();
   }
 
+  bool CanFillInParallel() const { return true; }
+
   void ReadFill(Deserializer* d, bool stamp_canonical) {
     for (intptr_t id = start_index_; id < stop_index_; id++) {
       OneByteStringPtr str = static_cast<OneByteStringPtr>(d->Ref(id));
@@ -5457,6 +5551,8 @@ class TwoByteStringDeserializationCluster
     stop_index_ = d->next_index();
   }
 
+  bool CanFillInParallel() const { return true; }
+
   void ReadFill(Deserializer* d, bool stamp_canonical) {
     for (intptr_t id = start_index_; id < stop_index_; id++) {
       TwoByteStringPtr str = static_cast<TwoByteStringPtr>(d->Ref(id));
@@ -6827,18 +6923,40 @@ ZoneGrowableArray<Object*>* Serializer::Serialize(SerializationRoots* roots) {
   }
 #endif
 
+  // The size of each cluster's fill section, so the deserializer can read them
+  // out of order. Patched in once the fill sections are written.
+  const intptr_t num_fill_sections =
+      canonical_clusters.length() + clusters.length();
+  const intptr_t fill_sizes_position = stream_->Position();
+  for (intptr_t i = 0; i < num_fill_sections; i++) {
+    stream_->WriteFixed<uint32_t>(0);
+  }
+  GrowableArray<intptr_t> fill_sizes(num_fill_sections);
   for (SerializationCluster* cluster : canonical_clusters) {
+    const intptr_t start = bytes_written();
     cluster->WriteAndMeasureFill(this);
 #if defined(DEBUG)
     Write<int32_t>(kSectionMarker);
 #endif
+    fill_sizes.Add(bytes_written() - start);
   }
   for (SerializationCluster* cluster : clusters) {
+    const intptr_t start = bytes_written();
     cluster->WriteAndMeasureFill(this);
 #if defined(DEBUG)
     Write<int32_t>(kSectionMarker);
 #endif
+    fill_sizes.Add(bytes_written() - start);
+  }
+  const intptr_t fill_end_position = stream_->Position();
+  stream_->SetPosition(fill_sizes_position);
+  for (intptr_t i = 0; i < num_fill_sections; i++) {
+    if (!Utils::IsUint(32, fill_sizes[i])) {
+      FATAL("Fill section overflow");
+    }
+    stream_->WriteFixed<uint32_t>(fill_sizes[i]);
   }
+  stream_->SetPosition(fill_end_position);
 
   roots->WriteRoots(this);
 
@@ -7534,6 +7652,164 @@ class HeapLocker : public StackResource {
   FreeList* freelist_;
 };
 
+// Fills in the clusters of a FillSection array, taking sections in turn from
+// a counter shared with the other tasks.
+class DeserializationFillTask : public ThreadPool::Task {
+ public:
+  DeserializationFillTask(Deserializer* parent,
+                          IsolateGroup* isolate_group,
+                          Deserializer::FillSection* sections,
+                          intptr_t num_sections,
+                          RelaxedAtomic<intptr_t>* next_section,
+                          ThreadBarrier* barrier)
+      : parent_(parent),
+        isolate_group_(isolate_group),
+        sections_(sections),
+        num_sections_(num_sections),
+        next_section_(next_section),
+        barrier_(barrier) {}
+
+  virtual void Run() {
+    // The deserializing thread holds a NoSafepointScope for the whole fill.
+    bool result = Thread::EnterIsolateGroupAsHelper(
+        isolate_group_, Thread::kUnknownTask, /*bypass_safepoint=*/true);
+    ASSERT(result);
+    {
+      Deserializer deserializer(Thread::Current(), *parent_);
+      FillSections(&deserializer);
+    }
+    Thread::ExitIsolateGroupAsHelper(/*bypass_safepoint=*/true);
+
+    // This task is done. Notify the original thread.
+    barrier_->Exit();
+  }
+
+  void FillSections(Deserializer* deserializer) {
+    for (;;) {
+      const intptr_t i = next_section_->fetch_add(1);
+      if (i >= num_sections_) {
+        break;
+      }
+      deserializer->ReadFillSection(sections_[i]);
+    }
+  }
+
+ private:
+  Deserializer* parent_;
+  IsolateGroup* isolate_group_;
+  Deserializer::FillSection* sections_;
+  intptr_t num_sections_;
+  RelaxedAtomic<intptr_t>* next_section_;
+  ThreadBarrier* barrier_;
+
+  DISALLOW_COPY_AND_ASSIGN(DeserializationFillTask);
+};
+
+Deserializer::Deserializer(Thread* thread, const Deserializer& parent)
+    : ThreadStackResource(thread),
+      heap_(parent.heap_),
+      zone_(nullptr),
+      kind_(parent.kind_),
+      stream_(parent.CurrentBufferAddress() - parent.position(),
+              parent.position() + parent.stream_.PendingBytes()),
+      image_reader_(nullptr),
+      num_base_objects_(parent.num_base_objects_),
+      num_objects_(parent.num_objects_),
+      num_canonical_clusters_(0),
+      num_clusters_(0),
+      refs_(parent.refs_),
+      next_ref_index_(parent.next_ref_index_),
+      previous_text_offset_(0),
+      canonical_clusters_(nullptr),
+      clusters_(nullptr),
+      initial_field_table_(parent.initial_field_table_),
+      is_non_root_unit_(parent.is_non_root_unit_) {}
+
+void Deserializer::ReadFillSection(const FillSection& section) {
+  TIMELINE_DURATION(thread(), Isolate, section.cluster->name());
+  set_position(section.start);
+  section.cluster->ReadFill(this, section.stamp_canonical);
+#if defined(DEBUG)
+  int32_t section_marker = Read<int32_t>();
+  ASSERT(section_marker == kSectionMarker);
+#endif
+  ASSERT(position() == section.stop);
+}
+
+void Deserializer::ReadFill(bool primary) {
+  const intptr_t num_sections = num_canonical_clusters_ + num_clusters_;
+  FillSection* sections = zone_->Alloc<FillSection>(num_sections);
+  intptr_t start = position() + num_sections * sizeof(uint32_t);
+  for (intptr_t i = 0; i < num_sections; i++) {
+    uint32_t size;
+    ReadBytes(reinterpret_cast<uint8_t*>(&size), sizeof(size));
+    const bool is_canonical = i < num_canonical_clusters_;
+    sections[i].cluster = is_canonical
+                              ? canonical_clusters_[i]
+                              : clusters_[i - num_canonical_clusters_];
+    sections[i].start = start;
+    sections[i].stop = start + size;
+    sections[i].stamp_canonical = is_canonical && primary;
+    start += size;
+  }
+  const intptr_t fill_end = start;
+
+  // Clusters that can be filled in on helper threads are moved to the front.
+  // The others keep their relative order and are filled in afterwards on this
+  // thread, so they see fully initialized objects from the parallel clusters.
+  intptr_t num_parallel_sections = 0;
+  intptr_t num_tasks = FLAG_deserialization_tasks;
+  if (num_tasks == 0) {
+    num_tasks = OS::NumberOfAvailableProcessors();
+  }
+  if (num_tasks > 1 && Dart::thread_pool() != nullptr &&
+      isolate_group() != Dart::vm_isolate_group()) {
+    for (intptr_t i = 0; i < num_sections; i++) {
+      if (sections[i].cluster->CanFillInParallel()) {
+        FillSection section = sections[i];
+        for (intptr_t j = i; j > num_parallel_sections; j--) {
+          sections[j] = sections[j - 1];
+        }
+        sections[num_parallel_sections++] = section;
+      }
+    }
+  }
+  if (num_parallel_sections > 1) {
+    ReadFillSectionsInParallel(
+        sections, num_parallel_sections,
+        Utils::Minimum(num_tasks, num_parallel_sections));
+  } else {
+    num_parallel_sections = 0;
+  }
+  for (intptr_t i = num_parallel_sections; i < num_sections; i++) {
+    ReadFillSection(sections[i]);
+  }
+  set_position(fill_end);
+}
+
+void Deserializer::ReadFillSectionsInParallel(FillSection* sections,
+                                              intptr_t num_sections,
+                                              intptr_t num_tasks) {
+  Monitor monitor;
+  Monitor done_monitor;
+  ThreadBarrier barrier(num_tasks, &monitor, &done_monitor);
+  RelaxedAtomic<intptr_t> next_section(0);
+  for (intptr_t i = 0; i < num_tasks - 1; i++) {
+    if (!Dart::thread_pool()->Run<DeserializationFillTask>(
+            this, isolate_group(), sections, num_sections, &next_section,
+            &barrier)) {
+      // The remaining tasks pick up its sections.
+      barrier.Exit();
+    }
+  }
+  // The last task runs on this thread.
+  DeserializationFillTask task(this, isolate_group(), sections, num_sections,
+                               &next_section, &barrier);
+  task.FillSections(this);
+  barrier.Exit();
+  // The barrier's destructor waits for the helpers to finish.
+}
+
 void Deserializer::Deserialize(DeserializationRoots* roots) {
   Array& refs = Array::Handle(zone_);
   num_base_objects_ = ReadUnsigned();
@@ -7603,23 +7879,7 @@ void Deserializer::Deserialize(DeserializationRoots* roots) {
 
     {
       TIMELINE_DURATION(thread(), Isolate, "ReadFill");
-      for (intptr_t i = 0; i < num_canonical_clusters_; i++) {
-        TIMELINE_DURATION(thread(), Isolate, canonical_clusters_[i]->name());
-        bool stamp_canonical = primary;
-        canonical_clusters_[i]->ReadFill(this, stamp_canonical);
-#if defined(DEBUG)
-        int32_t section_marker = Read<int32_t>();
-        ASSERT(section_marker == kSectionMarker);
-#endif
-      }
-      for (intptr_t i = 0; i < num_clusters_; i++) {
-        TIMELINE_DURATION(thread(), Isolate, clusters_[i]->name());
-        clusters_[i]->ReadFill(this, /*stamp_canonical*/ false);
-#if defined(DEBUG)
-        int32_t section_marker = Read<int32_t>();
-        ASSERT(section_marker == kSectionMarker);
-#endif
-      }
+      ReadFill(primary);
     }
 
     roots->ReadRoots(this);
@@ -137,6 +137,11 @@ class DeserializationCluster : public ZoneAllocated {
   // Initialize the cluster's objects. Do not touch the memory of other objects.
   virtual void ReadFill(Deserializer* deserializer, bool stamp_canonical) = 0;
 
+  // Whether ReadFill only reads the stream and the ref array, so that it can
+  // run on a helper thread concurrently with the fill of other clusters. Such
+  // clusters must not allocate or use the deserializer's zone or image reader.
+  virtual bool CanFillInParallel() const { return false; }
+
   // Complete any action that requires the full graph to be deserialized, such
   // as rehashing.
   virtual void PostLoad(Deserializer* deserializer,
@@ -673,6 +678,26 @@ class Deserializer : public ThreadStackResource {
   bool is_non_root_unit() const { return is_non_root_unit_; }
 
  private:
+  friend class DeserializationFillTask;
+
+  // The part of the stream holding the fill data of one cluster.
+  struct FillSection {
+    DeserializationCluster* cluster;
+    intptr_t start;
+    intptr_t stop;
+    bool stamp_canonical;
+  };
+
+  // Creates a deserializer for filling in clusters of [parent] on another
+  // thread. It shares [parent]'s stream buffer and ref array.
+  Deserializer(Thread* thread, const Deserializer& parent);
+
+  void ReadFill(bool primary);
+  void ReadFillSection(const FillSection& section);
+  void ReadFillSectionsInParallel(FillSection* sections,
+                                  intptr_t num_sections,
+                                  intptr_t num_tasks);
+
   Heap* heap_;
   Zone* zone_;
   Snapshot::Kind kind_;
@@ -5,6 +5,7 @@
 #include "vm/compiler/aot/aot_call_specializer.h"
 
 #include "vm/bit_vector.h"
+#include "vm/compiler/aot/aot_profile.h"
 #include "vm/compiler/aot/precompiler.h"
 #include "vm/compiler/backend/branch_optimizer.h"
 #include "vm/compiler/backend/flow_graph_compiler.h"
@@ -37,6 +38,8 @@ DEFINE_FLAG(int,
             "If a call receiver is known to be of at most this many classes, "
             "generate exhaustive class tests instead of a megamorphic call");
 
+DECLARE_FLAG(bool, trace_aot_profile);
+
 // Quick access to the current isolate and zone.
 #define IG (isolate_group())
 #define Z (zone())
@@ -956,6 +959,67 @@ void AotCallSpecializer::VisitInstanceCall(InstanceCallInstr* instr) {
     instr->ReplaceWith(call, current_iterator());
     return;
   }
+
+  if (TryReplaceWithProfiledPolymorphicCall(instr)) {
+    return;
+  }
+}
+
+bool AotCallSpecializer::TryReplaceWithProfiledPolymorphicCall(
+    InstanceCallInstr* instr) {
+  const AotProfile* profile =
+      (precompiler_ != nullptr) ? precompiler_->profile() : nullptr;
+  if ((profile == nullptr) || !instr->HasICData()) {
+    return false;
+  }
+  // The call may have been inlined, so look up the feedback of the function
+  // it originally belonged to.
+  const Function& caller = Function::Handle(Z, instr->ic_data()->Owner());
+  const AotProfile::ReceiverCounts* receivers =
+      profile->ReceiversAt(caller, instr->function_name());
+  if (receivers == nullptr) {
+    return false;
+  }
+
+  const Array& args_desc_array =
+      Array::Handle(Z, instr->GetArgumentsDescriptor());
+  const ICData& ic_data = ICData::Handle(
+      Z, ICData::New(flow_graph()->function(), instr->function_name(),
+                     args_desc_array, DeoptId::kNone,
+                     /* args_tested = */ 1, ICData::kOptimized));
+  Class& cls = Class::Handle(Z);
+  Function& target = Function::Handle(Z);
+  for (const AotProfile::ReceiverCount& receiver : *receivers) {
+    if (ic_data.NumberOfChecks() >= FLAG_max_polymorphic_checks) {
+      break;
+    }
+    cls = IG->class_table()->At(receiver.cid);
+    if (cls.IsNull() || !cls.is_finalized()) {
+      continue;
+    }
+    target = instr->ResolveForReceiverClass(cls, /*allow_add=*/false);
+    if (target.IsNull()) {
+      continue;
+    }
+    ic_data.AddReceiverCheck(receiver.cid, target, receiver.count);
+  }
+  if (ic_data.NumberOfChecksIs(0)) {
+    return false;
+  }
+
+  // The targets are only a guess, so the call falls back to a regular
+  // instance call for other receivers.
+  const CallTargets* targets = CallTargets::Create(Z, ic_data);
+  if (FLAG_trace_aot_profile) {
+    THR_Print("Profiled polymorphic call %s in %s with %" Pd " checks\n",
+              instr->function_name().ToCString(),
+              flow_graph()->function().ToFullyQualifiedCString(),
+              ic_data.NumberOfChecks());
+  }
+  PolymorphicInstanceCallInstr* call = PolymorphicInstanceCallInstr::FromCall(
+      Z, instr, *targets, /* complete = */ false);
+  instr->ReplaceWith(call, current_iterator());
+  return true;
 }
 
 void AotCallSpecializer::VisitStaticCall(StaticCallInstr* instr) {
@@ -38,6 +38,10 @@ class AotCallSpecializer : public CallSpecializer {
 
   bool TryCreateICDataForUniqueTarget(InstanceCallInstr* call);
 
+  // Replaces [call] with a polymorphic call which checks for the receiver
+  // classes seen in the training run given by --aot_profile.
+  bool TryReplaceWithProfiledPolymorphicCall(InstanceCallInstr* call);
+
   bool RecognizeRuntimeTypeGetter(InstanceCallInstr* call);
   bool TryReplaceWithHaveSameRuntimeType(TemplateDartCall<0>* call);
 
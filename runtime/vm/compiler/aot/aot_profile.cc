@@ -0,0 +1,355 @@
+// Copyright (c) 2021, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/compiler/aot/aot_profile.h"
+
+#include "vm/dart.h"
+#include "vm/datastream.h"
+#include "vm/flags.h"
+#include "vm/log.h"
+#include "vm/symbols.h"
+#include "vm/version.h"
+
+namespace dart {
+
+#if defined(DART_PRECOMPILER)
+
+DEFINE_FLAG(charp,
+            aot_profile,
+            nullptr,
+            "Guide AOT compilation with the type feedback saved by a JIT "
+            "training run (see --save_type_feedback).");
+DEFINE_FLAG(bool,
+            trace_aot_profile,
+            false,
+            "Trace loading and uses of --aot_profile.");
+
+AotProfile* AotProfile::LoadIfRequested(Thread* thread) {
+  if (FLAG_aot_profile == nullptr) {
+    return nullptr;
+  }
+  const auto file_open = Dart::file_open_callback();
+  const auto file_read = Dart::file_read_callback();
+  const auto file_close = Dart::file_close_callback();
+  if ((file_open == nullptr) || (file_read == nullptr) ||
+      (file_close == nullptr)) {
+    OS::PrintErr("Cannot read %s: no file callbacks\n", FLAG_aot_profile);
+    return nullptr;
+  }
+  void* file = file_open(FLAG_aot_profile, /*write=*/false);
+  if (file == nullptr) {
+    OS::PrintErr("Failed to open file %s\n", FLAG_aot_profile);
+    return nullptr;
+  }
+  uint8_t* buffer = nullptr;
+  intptr_t length = -1;
+  file_read(&buffer, &length, file);
+  file_close(file);
+  if ((buffer == nullptr) || (length < 0)) {
+    OS::PrintErr("Failed to read file %s\n", FLAG_aot_profile);
+    return nullptr;
+  }
+
+  ReadStream stream(buffer, length);
+  AotProfile* profile = new (thread->zone()) AotProfile(thread, &stream);
+  const char* error = profile->Read();
+  free(buffer);
+  if (error != nullptr) {
+    OS::PrintErr("Ignoring %s: %s\n", FLAG_aot_profile, error);
+    return nullptr;
+  }
+  if (FLAG_trace_aot_profile) {
+    THR_Print("Loaded feedback for %" Pd " functions from %s\n",
+              profile->NumFunctions(), FLAG_aot_profile);
+  }
+  return profile;
+}
+
+AotProfile::AotProfile(Thread* thread, ReadStream* stream)
+    : thread_(thread),
+      zone_(thread->zone()),
+      stream_(stream),
+      num_cids_(0),
+      cid_map_(nullptr),
+      functions_(thread->zone()) {}
+
+intptr_t AotProfile::UsageCount(const Function& function) const {
+  FunctionProfile* profile = Lookup(function);
+  return (profile == nullptr) ? 0 : profile->usage;
+}
+
+void AotProfile::ApplyUsageCounters() const {
+  auto it = functions_.GetIterator();
+  while (FunctionProfile** kv = it.Next()) {
+    const FunctionProfile* profile = *kv;
+    profile->function->set_usage_counter(
+        Utils::Minimum<intptr_t>(profile->usage, kMaxInt32));
+  }
+}
+
+const AotProfile::ReceiverCounts* AotProfile::ReceiversAt(
+    const Function& function,
+    const String& selector) const {
+  FunctionProfile* profile = Lookup(function);
+  if (profile == nullptr) {
+    return nullptr;
+  }
+  for (CallSiteProfile* site : *profile->call_sites) {
+    if (String::EqualsIgnoringPrivateKey(*site->selector, selector)) {
+      return site->receivers;
+    }
+  }
+  return nullptr;
+}
+
+AotProfile::FunctionProfile* AotProfile::Lookup(
+    const Function& function) const {
+  FunctionProfile** kv = functions_.Lookup(&function);
+  return (kv == nullptr) ? nullptr : *kv;
+}
+
+const char* AotProfile::Read() {
+  const char* error = ReadHeader();
+  if (error == nullptr) error = ReadClasses();
+  if (error == nullptr) error = ReadFields();
+  while ((error == nullptr) && (stream_->PendingBytes() > 0)) {
+    error = ReadFunction();
+  }
+  // The stream and the class id map are only needed while reading.
+  stream_ = nullptr;
+  cid_map_ = nullptr;
+  return error;
+}
+
+const char* AotProfile::ReadHeader() {
+  const char* expected_version = Version::SnapshotString();
+  const intptr_t version_len = strlen(expected_version);
+  if ((stream_->PendingBytes() < version_len) ||
+      (strncmp(reinterpret_cast<const char*>(
+                   stream_->AddressOfCurrentPosition()),
+               expected_version, version_len) != 0)) {
+    return "wrong snapshot version";
+  }
+  stream_->Advance(version_len);
+
+  // The JIT compiler flags that affect deopt ids follow. They do not matter
+  // here, since call sites are not matched by deopt id.
+  const char* features =
+      reinterpret_cast<const char*>(stream_->AddressOfCurrentPosition());
+  const intptr_t features_len =
+      Utils::StrNLen(features, stream_->PendingBytes());
+  if (features_len == stream_->PendingBytes()) {
+    return "truncated header";
+  }
+  stream_->Advance(features_len + 1);
+  return nullptr;
+}
+
+const char* AotProfile::ReadClasses() {
+  num_cids_ = ReadInt();
+  if (num_cids_ < kNumPredefinedCids) {
+    return "invalid class count";
+  }
+  cid_map_ = zone_->Alloc<intptr_t>(num_cids_);
+  for (intptr_t cid = 0; cid < num_cids_; cid++) {
+    cid_map_[cid] = kIllegalCid;
+  }
+  for (intptr_t cid = kInstanceCid; cid < kNumPredefinedCids; cid++) {
+    cid_map_[cid] = cid;
+  }
+  Class& cls = Class::Handle(zone_);
+  for (intptr_t cid = kNumPredefinedCids; cid < num_cids_; cid++) {
+    cls = ReadClassByName();
+    if (!cls.IsNull()) {
+      cid_map_[cid] = cls.id();
+    }
+  }
+  return nullptr;
+}
+
+const char* AotProfile::ReadFields() {
+  // Field guards are not used in AOT, so the field feedback is skipped.
+  for (intptr_t cid = kNumPredefinedCids; cid < num_cids_; cid++) {
+    ReadString();  // Library.
+    ReadString();  // Class.
+    const intptr_t num_fields = ReadInt();
+    for (intptr_t i = 0; i < num_fields; i++) {
+      ReadString();  // Name.
+      ReadInt();     // Guarded cid.
+      ReadInt();     // Nullability.
+    }
+  }
+  return nullptr;
+}
+
+const char* AotProfile::ReadFunction() {
+  const Class& cls = Class::Handle(zone_, ReadClassByName());
+  const String& name = String::Handle(zone_, ReadString());
+  const auto kind = static_cast<UntaggedFunction::Kind>(ReadInt());
+  ReadInt();  // Token position.
+  const intptr_t usage = ReadInt();
+  ReadInt();  // Inlining depth.
+  const intptr_t num_call_sites = ReadInt();
+  if (num_call_sites < 0) {
+    return "invalid call site count";
+  }
+
+  FunctionProfile* profile = nullptr;
+  if (!cls.IsNull()) {
+    const Function& function =
+        Function::ZoneHandle(zone_, FindFunction(cls, name, kind));
+    if (!function.IsNull()) {
+      profile = Lookup(function);
+      if (profile == nullptr) {
+        profile = new (zone_) FunctionProfile();
+        profile->function = &function;
+        profile->usage = 0;
+        profile->call_sites = new (zone_) ZoneGrowableArray<CallSiteProfile*>();
+        functions_.Insert(profile);
+      }
+      profile->usage += usage;
+    } else if (FLAG_trace_aot_profile) {
+      THR_Print("Missing function %s %s\n", name.ToCString(),
+                Function::KindToCString(kind));
+    }
+  }
+
+  String& selector = String::Handle(zone_);
+  GrowableArray<ReceiverCount> receivers;
+  for (intptr_t i = 0; i < num_call_sites; i++) {
+    ReadInt();  // Deopt id.
+    ReadInt();  // Rebind rule.
+    selector = ReadString();
+    const intptr_t num_checked_arguments = ReadInt();
+    const intptr_t num_entries = ReadInt();
+    if ((num_checked_arguments < 0) || (num_entries < 0)) {
+      return "invalid call site";
+    }
+
+    receivers.Clear();
+    for (intptr_t entry = 0; entry < num_entries; entry++) {
+      const intptr_t count = ReadInt();
+      for (intptr_t arg = 0; arg < num_checked_arguments; arg++) {
+        const intptr_t cid = ReadCid();
+        // Only the receiver's class is used.
+        if ((arg == 0) && (cid != kIllegalCid) && (count > 0)) {
+          receivers.Add({cid, count});
+        }
+      }
+    }
+    if ((profile != nullptr) && (num_checked_arguments > 0) &&
+        !receivers.is_empty()) {
+      AddCallSite(profile, selector, receivers);
+    }
+  }
+  return nullptr;
+}
+
+void AotProfile::AddCallSite(FunctionProfile* profile,
+                             const String& selector,
+                             const GrowableArray<ReceiverCount>& receivers) {
+  // All call sites with the same selector in a function share their feedback.
+  CallSiteProfile* site = nullptr;
+  for (CallSiteProfile* existing : *profile->call_sites) {
+    if (existing->selector->Equals(selector)) {
+      site = existing;
+      break;
+    }
+  }
+  if (site == nullptr) {
+    site = new (zone_) CallSiteProfile();
+    site->selector = &String::ZoneHandle(zone_, selector.ptr());
+    site->receivers = new (zone_) ReceiverCounts();
+    profile->call_sites->Add(site);
+  }
+  for (const ReceiverCount& receiver : receivers) {
+    bool found = false;
+    for (ReceiverCount& existing : *site->receivers) {
+      if (existing.cid == receiver.cid) {
+        existing.count += receiver.count;
+        found = true;
+        break;
+      }
+    }
+    if (!found) {
+      site->receivers->Add(receiver);
+    }
+  }
+  site->receivers->Sort([](const ReceiverCount* a, const ReceiverCount* b) {
+    return (a->count > b->count) ? -1 : ((a->count < b->count) ? 1 : 0);
+  });
+}
+
+FunctionPtr AotProfile::FindFunction(const Class& cls,
+                                     const String& name,
+                                     UntaggedFunction::Kind kind) {
+  Function& function =
+      Function::Handle(zone_, cls.LookupFunctionAllowPrivate(name));
+  if (function.IsNull()) {
+    return Function::null();
+  }
+  if (kind == UntaggedFunction::kImplicitClosureFunction) {
+    // Only use implicit closures which already exist, so that reading the
+    // profile does not change the program.
+    if (!function.HasImplicitClosureFunction()) {
+      return Function::null();
+    }
+    function = function.ImplicitClosureFunction();
+  }
+  if (function.is_abstract() || (function.kind() != kind)) {
+    return Function::null();
+  }
+  return function.ptr();
+}
+
+ClassPtr AotProfile::ReadClassByName() {
+  const String& uri = String::Handle(zone_, ReadString());
+  const String& name = String::Handle(zone_, ReadString());
+
+  const Library& lib =
+      Library::Handle(zone_, Library::LookupLibrary(thread_, uri));
+  if (lib.IsNull()) {
+    return Class::null();
+  }
+  const Class& cls = Class::Handle(
+      zone_, name.Equals(Symbols::TopLevel())
+                 ? lib.toplevel_class()
+                 : lib.SlowLookupClassAllowMultiPartPrivate(name));
+  if (cls.IsNull() || !cls.is_finalized()) {
+    return Class::null();
+  }
+  return cls.ptr();
+}
+
+StringPtr AotProfile::ReadString() {
+  if (stream_->PendingBytes() == 0) {
+    return Symbols::Empty().ptr();
+  }
+  const intptr_t len = stream_->ReadUnsigned();
+  if ((len < 0) || (len > stream_->PendingBytes())) {
+    return Symbols::Empty().ptr();
+  }
+  const uint8_t* bytes = stream_->AddressOfCurrentPosition();
+  stream_->Advance(len);
+  return String::FromUTF8(bytes, len, Heap::kOld);
+}
+
+intptr_t AotProfile::ReadInt() {
+  if (stream_->PendingBytes() == 0) {
+    return -1;
+  }
+  return stream_->Read<int32_t>();
+}
+
+intptr_t AotProfile::ReadCid() {
+  const intptr_t cid = ReadInt();
+  if ((cid < 0) || (cid >= num_cids_)) {
+    return kIllegalCid;
+  }
+  return cid_map_[cid];
+}
+
+#endif  // defined(DART_PRECOMPILER)
+
+}  // namespace dart
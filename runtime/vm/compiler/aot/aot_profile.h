@@ -0,0 +1,126 @@
+// Copyright (c) 2021, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef RUNTIME_VM_COMPILER_AOT_AOT_PROFILE_H_
+#define RUNTIME_VM_COMPILER_AOT_AOT_PROFILE_H_
+
+#if defined(DART_PRECOMPILED_RUNTIME)
+#error "AOT runtime should not use compiler sources (including header files)"
+#endif  // defined(DART_PRECOMPILED_RUNTIME)
+
+#include "vm/allocation.h"
+#include "vm/growable_array.h"
+#include "vm/hash_map.h"
+#include "vm/object.h"
+
+namespace dart {
+
+class ReadStream;
+
+#if defined(DART_PRECOMPILER)
+
+// Type feedback collected by a JIT training run, used to guide AOT
+// compilation.
+//
+// The profile is read from the file written by `dart --save_type_feedback`
+// (see TypeFeedbackSaver). Classes and functions are matched by name, so the
+// profile stays usable as long as the program has not changed much since the
+// training run. Unlike TypeFeedbackLoader, call sites are matched by caller
+// and selector instead of deopt id, because the AOT flow graph builder does
+// not assign the same deopt ids as the JIT.
+class AotProfile : public ZoneAllocated {
+ public:
+  // Reads the profile named by --aot_profile. Returns nullptr if no profile
+  // was requested or if it could not be read.
+  static AotProfile* LoadIfRequested(Thread* thread);
+
+  struct ReceiverCount {
+    intptr_t cid;
+    intptr_t count;
+  };
+  typedef ZoneGrowableArray<ReceiverCount> ReceiverCounts;
+
+  // Whether [function] was executed during the training run.
+  bool WasExecuted(const Function& function) const {
+    return Lookup(function) != nullptr;
+  }
+
+  // The usage counter [function] reached during the training run, or 0 if it
+  // never ran.
+  intptr_t UsageCount(const Function& function) const;
+
+  // The receiver classes seen by instance calls of [selector] in [function],
+  // most frequent first. Returns nullptr if there is no feedback for them.
+  const ReceiverCounts* ReceiversAt(const Function& function,
+                                    const String& selector) const;
+
+  intptr_t NumFunctions() const { return functions_.Length(); }
+
+  // Sets the usage counters of the functions that ran during the training run
+  // to the values they reached there. The snapshot writer uses them to place
+  // hot code together.
+  void ApplyUsageCounters() const;
+
+ private:
+  struct CallSiteProfile : public ZoneAllocated {
+    const String* selector;
+    ReceiverCounts* receivers;
+  };
+
+  struct FunctionProfile : public ZoneAllocated {
+    const Function* function;
+    intptr_t usage;
+    ZoneGrowableArray<CallSiteProfile*>* call_sites;
+  };
+
+  class FunctionProfileTrait {
+   public:
+    typedef const Function* Key;
+    typedef FunctionProfile* Value;
+    typedef FunctionProfile* Pair;
+
+    static Key KeyOf(Pair kv) { return kv->function; }
+    static Value ValueOf(Pair kv) { return kv; }
+    static inline intptr_t Hashcode(Key key) { return key->Hash(); }
+    static inline bool IsKeyEqual(Pair kv, Key key) {
+      return kv->function->ptr() == key->ptr();
+    }
+  };
+
+  AotProfile(Thread* thread, ReadStream* stream);
+
+  const char* Read();
+  const char* ReadHeader();
+  const char* ReadClasses();
+  const char* ReadFields();
+  const char* ReadFunction();
+
+  ClassPtr ReadClassByName();
+  StringPtr ReadString();
+  intptr_t ReadInt();
+  intptr_t ReadCid();
+
+  FunctionProfile* Lookup(const Function& function) const;
+  FunctionPtr FindFunction(const Class& cls,
+                           const String& name,
+                           UntaggedFunction::Kind kind);
+  void AddCallSite(FunctionProfile* profile,
+                   const String& selector,
+                   const GrowableArray<ReceiverCount>& receivers);
+
+  Thread* thread_;
+  Zone* zone_;
+  ReadStream* stream_;
+  intptr_t num_cids_;
+  intptr_t* cid_map_;
+  DirectChainedHashMap<FunctionProfileTrait> functions_;
+
+  DISALLOW_COPY_AND_ASSIGN(AotProfile);
+};
+
+#endif  // defined(DART_PRECOMPILER)
+
+}  // namespace dart
+
+#endif  // RUNTIME_VM_COMPILER_AOT_AOT_PROFILE_H_
@@ -11,6 +11,7 @@
 #include "vm/closure_functions_cache.h"
 #include "vm/code_patcher.h"
 #include "vm/compiler/aot/aot_call_specializer.h"
+#include "vm/compiler/aot/aot_profile.h"
 #include "vm/compiler/aot/precompiler_tracer.h"
 #include "vm/compiler/assembler/assembler.h"
 #include "vm/compiler/assembler/disassembler.h"
@@ -448,6 +449,7 @@ void Precompiler::DoCompileAll() {
           /*including_nonchanging_cids=*/FLAG_use_bare_instructions);
 
       tracer_ = PrecompilerTracer::StartTracingIfRequested(this);
+      profile_ = AotProfile::LoadIfRequested(T);
 
       // All stubs have already been generated, all of them share the same pool.
       // We use that pool to initialize our global object pool, to guarantee
@@ -530,6 +532,10 @@ void Precompiler::DoCompileAll() {
         tracer_->Finalize();
         tracer_ = nullptr;
       }
+      if (profile_ != nullptr) {
+        profile_->ApplyUsageCounters();
+        profile_ = nullptr;
+      }
 
       TraceForRetainedFunctions();
       FinalizeDispatchTable();
@@ -20,6 +20,7 @@
 namespace dart {
 
 // Forward declarations.
+class AotProfile;
 class Class;
 class Error;
 class Field;
@@ -267,6 +268,9 @@ class Precompiler : public ValueObject {
 
   bool is_tracing() const { return is_tracing_; }
 
+  // Feedback from a JIT training run, or nullptr if there is none.
+  const AotProfile* profile() const { return profile_; }
+
  private:
   static Precompiler* singleton_;
 
@@ -395,6 +399,7 @@ class Precompiler : public ValueObject {
 
   Phase phase_ = Phase::kPreparation;
   PrecompilerTracer* tracer_ = nullptr;
+  AotProfile* profile_ = nullptr;
   RetainedReasonsWriter* retained_reasons_writer_ = nullptr;
   bool is_tracing_ = false;
 };
@@ -1850,7 +1850,7 @@ void AsmIntrinsifier::AllocateTwoByteString(Assembler* assembler,
 static void StringEquality(Assembler* assembler,
                            Label* normal_ir_body,
                            intptr_t string_cid) {
-  Label is_true, is_false, loop;
+  Label is_true, is_false;
   __ movq(RAX, Address(RSP, +2 * target::kWordSize));  // This.
   __ movq(RCX, Address(RSP, +1 * target::kWordSize));  // Other.
 
@@ -1870,28 +1870,36 @@ static void StringEquality(Assembler* assembler,
   __ j(NOT_EQUAL, &is_false, Assembler::kNearJump);
 
   // Check contents, no fall-through possible.
-  // TODO(srdjan): write a faster check.
+  ASSERT((string_cid == kOneByteStringCid) ||
+         (string_cid == kTwoByteStringCid));
+  const intptr_t offset = (string_cid == kOneByteStringCid)
+                              ? target::OneByteString::data_offset()
+                              : target::TwoByteString::data_offset();
+  // Compare the contents from the end, eight bytes at a time, then compare
+  // the remaining bytes at the start one by one.
+  Label word_loop, byte_loop;
   __ SmiUntag(RDI);
-  __ Bind(&loop);
+  if (string_cid == kTwoByteStringCid) {
+    __ shlq(RDI, Immediate(1));  // Length in bytes.
+  }
+  __ Bind(&word_loop);
+  __ cmpq(RDI, Immediate(target::kWordSize));
+  __ j(LESS, &byte_loop, Assembler::kNearJump);
+  __ subq(RDI, Immediate(target::kWordSize));
+  __ movq(RBX, FieldAddress(RAX, RDI, TIMES_1, offset));
+  __ cmpq(RBX, FieldAddress(RCX, RDI, TIMES_1, offset));
+  __ j(NOT_EQUAL, &is_false);
+  __ jmp(&word_loop, Assembler::kNearJump);
+
+  __ Bind(&byte_loop);
   __ decq(RDI);
   __ cmpq(RDI, Immediate(0));
   __ j(LESS, &is_true, Assembler::kNearJump);
-  if (string_cid == kOneByteStringCid) {
-    __ movzxb(RBX, FieldAddress(RAX, RDI, TIMES_1,
-                                target::OneByteString::data_offset()));
-    __ movzxb(RDX, FieldAddress(RCX, RDI, TIMES_1,
-                                target::OneByteString::data_offset()));
-  } else if (string_cid == kTwoByteStringCid) {
-    __ movzxw(RBX, FieldAddress(RAX, RDI, TIMES_2,
-                                target::TwoByteString::data_offset()));
-    __ movzxw(RDX, FieldAddress(RCX, RDI, TIMES_2,
-                                target::TwoByteString::data_offset()));
-  } else {
-    UNIMPLEMENTED();
-  }
+  __ movzxb(RBX, FieldAddress(RAX, RDI, TIMES_1, offset));
+  __ movzxb(RDX, FieldAddress(RCX, RDI, TIMES_1, offset));
   __ cmpq(RBX, RDX);
-  __ j(NOT_EQUAL, &is_false, Assembler::kNearJump);
-  __ jmp(&loop, Assembler::kNearJump);
+  __ j(NOT_EQUAL, &is_false);
+  __ jmp(&byte_loop, Assembler::kNearJump);
 
   __ Bind(&is_true);
   __ LoadObject(RAX, CastHandle<Object>(TrueObject()));
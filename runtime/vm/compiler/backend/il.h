@@ -5105,12 +5105,14 @@ class FfiCallInstr : public Definition {
  public:
   FfiCallInstr(Zone* zone,
                intptr_t deopt_id,
-               const compiler::ffi::CallMarshaller& marshaller)
+               const compiler::ffi::CallMarshaller& marshaller,
+               bool is_leaf)
       : Definition(deopt_id),
         zone_(zone),
         marshaller_(marshaller),
         inputs_(marshaller.NumDefinitions() + 1 +
-                (marshaller.PassTypedData() ? 1 : 0)) {
+                (marshaller.PassTypedData() ? 1 : 0)),
+        is_leaf_(is_leaf) {
     inputs_.FillWith(
         nullptr, 0,
         marshaller.NumDefinitions() + 1 + (marshaller.PassTypedData() ? 1 : 0));
@@ -5129,14 +5131,19 @@ class FfiCallInstr : public Definition {
 
   virtual intptr_t InputCount() const { return inputs_.length(); }
   virtual Value* InputAt(intptr_t i) const { return inputs_[i]; }
+  // Leaf calls stay in generated code: they neither transition to native
+  // nor enter a safepoint, so the C code they call must not call back into
+  // the VM.
+  bool is_leaf() const { return is_leaf_; }
+
   virtual bool MayThrow() const {
     // By Dart_PropagateError.
-    return true;
+    return !is_leaf_;
   }
 
   // FfiCallInstr calls C code, which can call back into Dart.
   virtual bool ComputeCanDeoptimize() const {
-    return !CompilerState::Current().is_aot();
+    return !is_leaf_ && !CompilerState::Current().is_aot();
   }
 
   virtual bool HasUnknownSideEffects() const { return true; }
@@ -5168,6 +5175,7 @@ class FfiCallInstr : public Definition {
   const compiler::ffi::CallMarshaller& marshaller_;
 
   GrowableArray<Value*> inputs_;
+  const bool is_leaf_;
 
   DISALLOW_COPY_AND_ASSIGN(FfiCallInstr);
 };
@@ -5645,6 +5653,7 @@ class LoadIndexedInstr : public TemplateDefinition<2, NoThrow> {
 
   Value* array() const { return inputs_[0]; }
   Value* index() const { return inputs_[1]; }
+  bool index_unboxed() const { return index_unboxed_; }
   intptr_t index_scale() const { return index_scale_; }
   intptr_t class_id() const { return class_id_; }
   bool aligned() const { return alignment_ == kAlignedAccess; }
@@ -5921,6 +5930,7 @@ class StoreIndexedInstr : public TemplateInstruction<3, NoThrow> {
   Value* index() const { return inputs_[kIndexPos]; }
   Value* value() const { return inputs_[kValuePos]; }
 
+  bool index_unboxed() const { return index_unboxed_; }
   intptr_t index_scale() const { return index_scale_; }
   intptr_t class_id() const { return class_id_; }
   bool aligned() const { return alignment_ == kAlignedAccess; }
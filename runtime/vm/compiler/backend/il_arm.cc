@@ -1327,8 +1327,17 @@ void FfiCallInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
   compiler->EmitCallsiteMetadata(InstructionSource(), deopt_id(),
                                  UntaggedPcDescriptors::Kind::kOther, locs());
 
-  // Update information in the thread object and enter a safepoint.
-  if (CanExecuteGeneratedCodeInSafepoint()) {
+  if (is_leaf_) {
+    // Leaf calls stay in generated code, so only the VM tag is updated for the
+    // profiler.
+    __ StoreToOffset(branch, THR, compiler::target::Thread::vm_tag_offset());
+
+    __ blx(branch);
+
+    __ LoadImmediate(temp, compiler::target::Thread::vm_tag_dart_id());
+    __ StoreToOffset(temp, THR, compiler::target::Thread::vm_tag_offset());
+  } else if (CanExecuteGeneratedCodeInSafepoint()) {
+    // Update information in the thread object and enter a safepoint.
     __ LoadImmediate(temp, compiler::target::Thread::exit_through_ffi());
     __ TransitionGeneratedToNative(branch, FPREG, temp, saved_fp,
                                    /*enter_safepoint=*/true);
@@ -1210,7 +1210,25 @@ void FfiCallInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
 
   __ StoreToOffset(temp, FPREG, kSavedCallerPcSlotFromFp * kWordSize);
 
-  if (CanExecuteGeneratedCodeInSafepoint()) {
+  if (is_leaf_) {
+    // Leaf calls stay in generated code, so only the VM tag is updated for the
+    // profiler.
+    __ StoreToOffset(branch, THR, compiler::target::Thread::vm_tag_offset());
+
+    // We are entering runtime code, so the C stack pointer must be restored
+    // from the stack limit to the top of the stack.
+    __ mov(R25, CSP);
+    __ mov(CSP, SP);
+
+    __ blr(branch);
+
+    // Restore the Dart stack pointer.
+    __ mov(SP, CSP);
+    __ mov(CSP, R25);
+
+    __ LoadImmediate(temp, compiler::target::Thread::vm_tag_dart_id());
+    __ StoreToOffset(temp, THR, compiler::target::Thread::vm_tag_offset());
+  } else if (CanExecuteGeneratedCodeInSafepoint()) {
     // Update information in the thread object and enter a safepoint.
     __ LoadImmediate(temp, compiler::target::Thread::exit_through_ffi());
     __ TransitionGeneratedToNative(branch, FPREG, temp,
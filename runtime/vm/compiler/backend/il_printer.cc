@@ -1087,6 +1087,9 @@ void FfiCallInstr::PrintOperandsTo(BaseTextBuffer* f) const {
     arg_location.PrintTo(f);
     f->AddString(")");
   }
+  if (is_leaf_) {
+    f->AddString(", leaf");
+  }
 }
 
 void EnterHandleScopeInstr::PrintOperandsTo(BaseTextBuffer* f) const {
@@ -1164,7 +1164,14 @@ void FfiCallInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
                                  UntaggedPcDescriptors::Kind::kOther, locs());
   __ movq(compiler::Address(FPREG, kSavedCallerPcSlotFromFp * kWordSize), TMP);
 
-  if (CanExecuteGeneratedCodeInSafepoint()) {
+  if (is_leaf_) {
+    // Leaf calls stay in generated code, so only the VM tag is updated for the
+    // profiler.
+    __ movq(compiler::Assembler::VMTagAddress(), target_address);
+    __ CallCFunction(target_address, /*restore_rsp=*/true);
+    __ movq(compiler::Assembler::VMTagAddress(),
+            compiler::Immediate(compiler::target::Thread::vm_tag_dart_id()));
+  } else if (CanExecuteGeneratedCodeInSafepoint()) {
     // Update information in the thread object and enter a safepoint.
     __ movq(TMP,
             compiler::Immediate(compiler::target::Thread::exit_through_ffi()));
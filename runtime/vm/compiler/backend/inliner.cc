@@ -5,6 +5,7 @@
 #include "vm/compiler/backend/inliner.h"
 
 #include "vm/compiler/aot/aot_call_specializer.h"
+#include "vm/compiler/aot/aot_profile.h"
 #include "vm/compiler/aot/precompiler.h"
 #include "vm/compiler/backend/block_scheduler.h"
 #include "vm/compiler/backend/branch_optimizer.h"
@@ -1402,6 +1403,31 @@ class CallSiteInliner : public ValueObject {
     return parsed_function;
   }
 
+  // Under AOT, calls outside loops may pass our regular heuristics due
+  // to a relatively high ratio. So, unless we are optimizing solely for
+  // speed, such call sites are subject to subsequent stricter heuristic
+  // to limit code size increase.
+  bool UseStricterHeuristic(const Function& target, intptr_t nesting_depth) {
+    if (!CompilerState::Current().is_aot() || inliner_->AlwaysInline(target) ||
+        (FLAG_optimization_level > 2)) {
+      return false;
+    }
+    if (nesting_depth == 0) {
+      return true;
+    }
+#if defined(DART_PRECOMPILER)
+    // With feedback from a training run, calls in loops of functions that
+    // never ran are subject to the stricter heuristic as well.
+    const AotProfile* profile = (inliner_->precompiler_ != nullptr)
+                                    ? inliner_->precompiler_->profile()
+                                    : nullptr;
+    if (profile != nullptr) {
+      return !profile->WasExecuted(inliner_->flow_graph()->function());
+    }
+#endif  // defined(DART_PRECOMPILER)
+    return false;
+  }
+
   bool InlineStaticCalls() {
     bool inlined = false;
     const GrowableArray<CallSites::StaticCallInfo>& call_info =
@@ -1439,14 +1465,8 @@ class CallSiteInliner : public ValueObject {
           call, Array::ZoneHandle(Z, call->GetArgumentsDescriptor()),
           call->FirstArgIndex(), &arguments, call_info[call_idx].caller());
 
-      // Under AOT, calls outside loops may pass our regular heuristics due
-      // to a relatively high ratio. So, unless we are optimizing solely for
-      // speed, such call sites are subject to subsequent stricter heuristic
-      // to limit code size increase.
-      bool stricter_heuristic = CompilerState::Current().is_aot() &&
-                                FLAG_optimization_level <= 2 &&
-                                !inliner_->AlwaysInline(target) &&
-                                call_info[call_idx].nesting_depth == 0;
+      const bool stricter_heuristic =
+          UseStricterHeuristic(target, call_info[call_idx].nesting_depth);
       if (TryInlining(call->function(), call->argument_names(), &call_data,
                       stricter_heuristic)) {
         InlineCall(&call_data);
@@ -0,0 +1,1024 @@
+// Copyright (c) 2021, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/compiler/backend/loop_vectorizer.h"
+
+#include "vm/bit_vector.h"
+#include "vm/compiler/backend/flow_graph.h"
+#include "vm/compiler/backend/flow_graph_compiler.h"
+#include "vm/compiler/backend/il.h"
+#include "vm/compiler/backend/loops.h"
+#include "vm/compiler/backend/range_analysis.h"
+#include "vm/flags.h"
+#include "vm/log.h"
+
+namespace dart {
+
+DEFINE_FLAG(bool,
+            loop_vectorization,
+            true,
+            "Vectorize simple loops over typed data.");
+DEFINE_FLAG(int,
+            loop_unroll_factor,
+            4,
+            "Unroll factor of simple counted loops, 1 disables unrolling.");
+DEFINE_FLAG(bool,
+            trace_loop_vectorization,
+            false,
+            "Trace loop vectorization and unrolling.");
+
+// Largest number of instructions in the body of an unrolled loop.
+static constexpr intptr_t kMaxUnrolledBodySize = 64;
+
+// Largest number of pairs of arrays tested for overlap before entering a
+// vectorized loop.
+static constexpr intptr_t kMaxAliasChecks = 6;
+
+// Size of a SIMD vector in bytes.
+static constexpr intptr_t kVectorSize = 16;
+
+// Whether [instr] can be copied by LoopTransformer::Copy.
+static bool CanCopy(Instruction* instr) {
+  if ((instr->env() != nullptr) || instr->ComputeCanDeoptimize()) {
+    return false;
+  }
+  if (instr->IsLoadUntagged() || instr->IsLoadIndexed() ||
+      instr->IsGenericCheckBound() || instr->IsBinaryDoubleOp() ||
+      instr->IsFloatToDouble() || instr->IsDoubleToFloat() ||
+      instr->IsIntConverter() || instr->IsBox() || instr->IsUnbox()) {
+    return true;
+  }
+  if (auto store = instr->AsStoreIndexed()) {
+    return !store->ShouldEmitStoreBarrier();
+  }
+  if (auto op = instr->AsBinaryIntegerOp()) {
+    if (op->representation() == kTagged) {
+      return false;
+    }
+    switch (op->op_kind()) {
+      case Token::kADD:
+      case Token::kSUB:
+      case Token::kMUL:
+      case Token::kBIT_AND:
+      case Token::kBIT_OR:
+      case Token::kBIT_XOR:
+        return true;
+      default:
+        return false;
+    }
+  }
+  return false;
+}
+
+// Vector operations for the elements of a typed data class.
+struct VectorShape {
+  intptr_t element_cid;  // Typed data class of the elements.
+  intptr_t array_cid;    // Typed data class of the vectors.
+  intptr_t simd_cid;     // Class of the vector values.
+  intptr_t lanes;
+};
+
+static const VectorShape* VectorShapeFor(intptr_t cid) {
+  static const VectorShape kFloat64 = {
+      kTypedDataFloat64ArrayCid, kTypedDataFloat64x2ArrayCid, kFloat64x2Cid, 2};
+  static const VectorShape kFloat32 = {
+      kTypedDataFloat32ArrayCid, kTypedDataFloat32x4ArrayCid, kFloat32x4Cid, 4};
+  static const VectorShape kInt32 = {
+      kTypedDataInt32ArrayCid, kTypedDataInt32x4ArrayCid, kInt32x4Cid, 4};
+  switch (cid) {
+    case kTypedDataFloat64ArrayCid:
+      return &kFloat64;
+    case kTypedDataFloat32ArrayCid:
+      return &kFloat32;
+    case kTypedDataInt32ArrayCid:
+    case kTypedDataUint32ArrayCid:
+      // Only the low 32 bits of the results are stored, so signedness
+      // does not matter.
+      return &kInt32;
+    default:
+      return nullptr;
+  }
+}
+
+// Rewrites a counted loop, see loop_vectorizer.h.
+//
+//      preheader                     preheader
+//          |                             |
+//   +-> header: i = phi(i0, i + 1)  +-> header': v = phi(i0, v + step)
+//   |   if (i < U) ------+          |   if (v < U - (step - 1)) --+
+//   |      |             |          |      |                      |
+//   +--- body           exit        +--- body'                    |
+//                                                                 |
+//                                   +-> header: i = phi(v, i + 1) <+
+//                                   |   ...
+//
+// All other phis of the header are carried around the new loop like i.
+class LoopTransformer : public ValueObject {
+ public:
+  LoopTransformer(FlowGraph* flow_graph, LoopInfo* loop)
+      : flow_graph_(flow_graph),
+        zone_(flow_graph->zone()),
+        loop_(loop),
+        header_(nullptr),
+        preheader_(nullptr),
+        body_(nullptr),
+        branch_(nullptr),
+        check_(nullptr),
+        index_(nullptr),
+        limit_(nullptr),
+        back_edge_index_(-1),
+        body_size_(0),
+        renamed_(flow_graph->current_ssa_temp_index()),
+        phis_(),
+        new_phis_(),
+        new_header_(nullptr),
+        new_body_(nullptr),
+        new_exit_(nullptr),
+        limit_value_(nullptr),
+        guard_(nullptr) {
+    for (intptr_t i = 0, n = flow_graph->current_ssa_temp_index(); i < n;
+         ++i) {
+      renamed_.Add(nullptr);
+    }
+  }
+
+  // Whether the loop has the shape described above.
+  bool Analyze();
+
+  // Vectorizes the loop if its body only performs element-wise operations
+  // on typed data. Returns false if the loop was not changed.
+  bool TryVectorize();
+
+  // Unrolls the loop [factor] times if its body is small enough. Returns
+  // false if the loop was not changed.
+  bool TryUnroll(intptr_t factor);
+
+ private:
+  struct Access {
+    Definition* base;  // Typed data object, or its untagged data pointer.
+    intptr_t offset;   // Offset of the data pointer in base, or -1.
+    bool is_store;
+  };
+
+  bool IsInvariant(Definition* def) const {
+    return !loop_->Contains(def->GetBlock());
+  }
+
+  Definition* Lookup(Definition* def) const {
+    const intptr_t index = def->ssa_temp_index();
+    if ((index >= 0) && (index < renamed_.length()) &&
+        (renamed_[index] != nullptr)) {
+      return renamed_[index];
+    }
+    return def;
+  }
+
+  void Map(Definition* from, Definition* to) {
+    renamed_[from->ssa_temp_index()] = to;
+  }
+
+  Value* Rename(Value* value) const {
+    return new (zone_) Value(Lookup(value->definition()));
+  }
+
+  Instruction* Copy(Instruction* instr);
+
+  Definition* Constant(int64_t value);
+  Definition* EmitInPreheader(Definition* def);
+  Definition* EmitInt64Op(Token::Kind op_kind,
+                          Definition* left,
+                          Definition* right);
+  Definition* EmitLimit();
+  Definition* EmitDataAddress(const Access& access);
+
+  void BuildNewLoop(intptr_t step);
+  void FinishNewLoop(Instruction* last,
+                     const GrowableArray<Definition*>& next_values);
+
+  FlowGraph* flow_graph_;
+  Zone* zone_;
+  LoopInfo* loop_;
+
+  // The original loop.
+  JoinEntryInstr* header_;
+  BlockEntryInstr* preheader_;
+  TargetEntryInstr* body_;
+  BranchInstr* branch_;
+  CheckStackOverflowInstr* check_;
+  PhiInstr* index_;
+  InductionVar* limit_;
+  intptr_t back_edge_index_;
+  intptr_t body_size_;
+
+  // Copies of the original definitions, indexed by ssa temp index.
+  GrowableArray<Definition*> renamed_;
+
+  // The new loop.
+  GrowableArray<PhiInstr*> phis_;
+  GrowableArray<PhiInstr*> new_phis_;
+  JoinEntryInstr* new_header_;
+  TargetEntryInstr* new_body_;
+  TargetEntryInstr* new_exit_;
+  Definition* limit_value_;
+
+  // Non-negative if the new loop may be entered.
+  Definition* guard_;
+
+  DISALLOW_COPY_AND_ASSIGN(LoopTransformer);
+};
+
+bool LoopTransformer::Analyze() {
+  if ((loop_->inner() != nullptr) || (loop_->back_edges().length() != 1)) {
+    return false;
+  }
+  header_ = loop_->header()->AsJoinEntry();
+  if ((header_ == nullptr) || (header_->PredecessorCount() != 2) ||
+      header_->InsideTryBlock()) {
+    return false;
+  }
+
+  // The header only tests the induction and the back edge comes straight
+  // from the body, so the loop is made of exactly these two blocks.
+  branch_ = header_->last_instruction()->AsBranch();
+  body_ = loop_->back_edges()[0]->AsTargetEntry();
+  if ((branch_ == nullptr) || (body_ == nullptr) ||
+      (body_->PredecessorAt(0) != header_)) {
+    return false;
+  }
+  TargetEntryInstr* exit = (branch_->true_successor() == body_)
+                               ? branch_->false_successor()
+                               : branch_->true_successor();
+  if (loop_->Contains(exit)) {
+    return false;
+  }
+  for (ForwardInstructionIterator it(header_); !it.Done(); it.Advance()) {
+    Instruction* current = it.Current();
+    if (current == branch_) {
+      break;
+    }
+    if (current->IsCheckStackOverflow() && (check_ == nullptr)) {
+      check_ = current->AsCheckStackOverflow();
+      continue;
+    }
+    return false;
+  }
+  back_edge_index_ = header_->IndexOfPredecessor(body_);
+  preheader_ = header_->PredecessorAt(1 - back_edge_index_);
+  if (!preheader_->last_instruction()->IsGoto()) {
+    return false;
+  }
+
+  // The header branch must be the loop condition i < U (i++), where U is
+  // either a constant or a small invariant value plus a constant, so that
+  // U - step can be computed without overflow.
+  InductionVar* control = loop_->control();
+  int64_t stride = 0;
+  if (!InductionVar::IsLinear(control, &stride) || (stride != 1)) {
+    return false;
+  }
+  for (const InductionVar::Bound& bound : control->bounds()) {
+    if (bound.branch_ == branch_) {
+      limit_ = bound.limit_;
+    }
+  }
+  if (!InductionVar::IsInvariant(limit_) || !Utils::IsInt(32, limit_->offset())) {
+    return false;
+  }
+  if (limit_->mult() != 0) {
+    Definition* def = limit_->def();
+    if ((limit_->mult() != 1) ||
+        !(RangeUtils::Fits(def->range(), RangeBoundary::kRangeBoundarySmi) ||
+          (def->Type()->ToCid() == kSmiCid))) {
+      return false;
+    }
+  }
+  for (PhiIterator it(header_); !it.Done(); it.Advance()) {
+    PhiInstr* phi = it.Current();
+    if (loop_->LookupInduction(phi) == control) {
+      index_ = phi;
+    }
+    phis_.Add(phi);
+  }
+  if ((index_ == nullptr) || (index_->representation() != kUnboxedInt64)) {
+    return false;
+  }
+
+  // The values computed by the body do not escape it, other than through
+  // the phis of the header.
+  for (ForwardInstructionIterator it(body_); !it.Done(); it.Advance()) {
+    Instruction* current = it.Current();
+    if (current->IsGoto()) {
+      break;
+    }
+    if (!CanCopy(current)) {
+      return false;
+    }
+    ++body_size_;
+    if (Definition* def = current->AsDefinition()) {
+      if (def->env_use_list() != nullptr) {
+        return false;
+      }
+      for (Value::Iterator use_it(def->input_use_list()); !use_it.Done();
+           use_it.Advance()) {
+        Instruction* use = use_it.Current()->instruction();
+        if ((use->GetBlock() != body_) &&
+            !(use->IsPhi() && (use->GetBlock() == header_))) {
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+Instruction* LoopTransformer::Copy(Instruction* instr) {
+  Definition* copy = nullptr;
+  if (auto load = instr->AsLoadUntagged()) {
+    copy = new (zone_) LoadUntaggedInstr(Rename(load->object()), load->offset());
+  } else if (auto load = instr->AsLoadIndexed()) {
+    copy = new (zone_) LoadIndexedInstr(
+        Rename(load->array()), Rename(load->index()), load->index_unboxed(),
+        load->index_scale(), load->class_id(),
+        load->aligned() ? kAlignedAccess : kUnalignedAccess, DeoptId::kNone,
+        load->source());
+  } else if (auto store = instr->AsStoreIndexed()) {
+    return new (zone_) StoreIndexedInstr(
+        Rename(store->array()), Rename(store->index()), Rename(store->value()),
+        kNoStoreBarrier, store->index_unboxed(), store->index_scale(),
+        store->class_id(), store->aligned() ? kAlignedAccess : kUnalignedAccess,
+        DeoptId::kNone, store->source(), store->SpeculativeModeOfInput(0));
+  } else if (auto check = instr->AsGenericCheckBound()) {
+    copy = new (zone_) GenericCheckBoundInstr(
+        Rename(check->length()), Rename(check->index()), DeoptId::kNone);
+  } else if (auto op = instr->AsBinaryDoubleOp()) {
+    copy = new (zone_) BinaryDoubleOpInstr(
+        op->op_kind(), Rename(op->left()), Rename(op->right()), DeoptId::kNone,
+        op->source(), op->SpeculativeModeOfInput(0));
+  } else if (auto op = instr->AsBinaryIntegerOp()) {
+    copy = BinaryIntegerOpInstr::Make(
+        op->representation(), op->op_kind(), Rename(op->left()),
+        Rename(op->right()), DeoptId::kNone, op->can_overflow(),
+        op->is_truncating(), /*range=*/nullptr, op->SpeculativeModeOfInput(0));
+  } else if (auto conv = instr->AsFloatToDouble()) {
+    copy = new (zone_) FloatToDoubleInstr(Rename(conv->value()), DeoptId::kNone);
+  } else if (auto conv = instr->AsDoubleToFloat()) {
+    copy = new (zone_) DoubleToFloatInstr(Rename(conv->value()), DeoptId::kNone,
+                                          conv->SpeculativeModeOfInput(0));
+  } else if (auto conv = instr->AsIntConverter()) {
+    auto converter = new (zone_) IntConverterInstr(
+        conv->from(), conv->to(), Rename(conv->value()), DeoptId::kNone);
+    if (conv->is_truncating()) {
+      converter->mark_truncating();
+    }
+    copy = converter;
+  } else if (auto box = instr->AsBox()) {
+    copy = BoxInstr::Create(box->from_representation(), Rename(box->value()));
+  } else if (auto unbox = instr->AsUnbox()) {
+    UnboxInstr* unboxed =
+        UnboxInstr::Create(unbox->representation(), Rename(unbox->value()),
+                           DeoptId::kNone, unbox->SpeculativeModeOfInput(0));
+    if ((unbox->AsUnboxInteger() != nullptr) &&
+        unbox->AsUnboxInteger()->is_truncating()) {
+      unboxed->AsUnboxInteger()->mark_truncating();
+    }
+    copy = unboxed;
+  } else {
+    UNREACHABLE();
+  }
+  // The copy computes a value of an iteration of the original loop.
+  Definition* def = instr->AsDefinition();
+  if (def->range() != nullptr) {
+    copy->set_range(*def->range());
+  }
+  return copy;
+}
+
+Definition* LoopTransformer::Constant(int64_t value) {
+  ASSERT(Utils::IsInt(32, value));
+  return flow_graph_->GetConstant(
+      Smi::ZoneHandle(zone_, Smi::New(static_cast<intptr_t>(value))));
+}
+
+Definition* LoopTransformer::EmitInPreheader(Definition* def) {
+  flow_graph_->InsertBefore(preheader_->last_instruction(), def, nullptr,
+                            FlowGraph::kValue);
+  return def;
+}
+
+Definition* LoopTransformer::EmitInt64Op(Token::Kind op_kind,
+                                         Definition* left,
+                                         Definition* right) {
+  return EmitInPreheader(new (zone_) BinaryInt64OpInstr(
+      op_kind, new (zone_) Value(left), new (zone_) Value(right),
+      DeoptId::kNone, Instruction::kNotSpeculative));
+}
+
+Definition* LoopTransformer::EmitLimit() {
+  if (limit_->mult() == 0) {
+    return Constant(limit_->offset());
+  }
+  if (limit_->offset() == 0) {
+    return limit_->def();
+  }
+  return EmitInt64Op(Token::kADD, limit_->def(), Constant(limit_->offset()));
+}
+
+Definition* LoopTransformer::EmitDataAddress(const Access& access) {
+  Definition* data = access.base;
+  if (access.offset >= 0) {
+    data = EmitInPreheader(new (zone_) LoadUntaggedInstr(
+        new (zone_) Value(access.base), access.offset));
+  }
+  return EmitInPreheader(new (zone_) IntConverterInstr(
+      kUntagged, kUnboxedIntPtr, new (zone_) Value(data), DeoptId::kNone));
+}
+
+void LoopTransformer::BuildNewLoop(intptr_t step) {
+  const intptr_t try_index = header_->try_index();
+  new_header_ = new (zone_) JoinEntryInstr(flow_graph_->allocate_block_id(),
+                                           try_index, DeoptId::kNone);
+  new_body_ = new (zone_) TargetEntryInstr(flow_graph_->allocate_block_id(),
+                                           try_index, DeoptId::kNone);
+  new_exit_ = new (zone_) TargetEntryInstr(flow_graph_->allocate_block_id(),
+                                           try_index, DeoptId::kNone);
+
+  // The inputs of the phis are set once the new loop is linked in.
+  PhiInstr* index = nullptr;
+  for (PhiInstr* phi : phis_) {
+    PhiInstr* copy = new (zone_) PhiInstr(new_header_, 2);
+    flow_graph_->AllocateSSAIndexes(copy);
+    copy->mark_alive();
+    copy->set_representation(phi->representation());
+    if (phi->range() != nullptr) {
+      copy->set_range(*phi->range());
+    }
+    new_header_->InsertPhi(copy);
+    new_phis_.Add(copy);
+    if (phi == index_) {
+      index = copy;
+    }
+  }
+
+  // The new loop runs while all [step] iterations are left: i + step - 1 < U.
+  limit_value_ = EmitLimit();
+  Definition* new_limit =
+      (limit_->mult() == 0)
+          ? Constant(limit_->offset() - (step - 1))
+          : EmitInt64Op(Token::kSUB, limit_value_, Constant(step - 1));
+
+  Instruction* cursor = new_header_;
+  if (check_ != nullptr) {
+    cursor = flow_graph_->AppendTo(
+        cursor,
+        new (zone_) CheckStackOverflowInstr(
+            check_->source(), check_->stack_depth(), check_->loop_depth(),
+            DeoptId::kNone, CheckStackOverflowInstr::kOsrAndPreemption),
+        nullptr, FlowGraph::kEffect);
+  }
+  auto compare = new (zone_) RelationalOpInstr(
+      branch_->source(), Token::kLT, new (zone_) Value(index),
+      new (zone_) Value(new_limit), kMintCid, DeoptId::kNone,
+      Instruction::kNotSpeculative);
+  auto branch = new (zone_) BranchInstr(compare, DeoptId::kNone);
+  flow_graph_->AppendTo(cursor, branch, nullptr, FlowGraph::kEffect);
+  new_header_->set_last_instruction(branch);
+  *branch->true_successor_address() = new_body_;
+  *branch->false_successor_address() = new_exit_;
+}
+
+static void SetPhiInput(PhiInstr* phi, intptr_t index, Definition* def) {
+  Value* input = new Value(def);
+  phi->SetInputAt(index, input);
+  def->AddInputUse(input);
+}
+
+void LoopTransformer::FinishNewLoop(
+    Instruction* last,
+    const GrowableArray<Definition*>& next_values) {
+  auto back_edge = new (zone_) GotoInstr(new_header_, DeoptId::kNone);
+  flow_graph_->AppendTo(last, back_edge, nullptr, FlowGraph::kEffect);
+  new_body_->set_last_instruction(back_edge);
+
+  // Without a guard, the preheader falls into the new loop, which exits into
+  // the original loop. Otherwise both the new loop and the path skipping it
+  // join before the original loop.
+  const intptr_t try_index = header_->try_index();
+  Instruction* preheader_exit = preheader_->last_instruction();
+  BlockEntryInstr* entry = preheader_;
+  TargetEntryInstr* skip = nullptr;
+  JoinEntryInstr* merge = nullptr;
+  JoinEntryInstr* exit_target = header_;
+  if (guard_ == nullptr) {
+    preheader_exit->AsGoto()->set_successor(new_header_);
+  } else {
+    auto enter = new (zone_) TargetEntryInstr(flow_graph_->allocate_block_id(),
+                                              try_index, DeoptId::kNone);
+    skip = new (zone_) TargetEntryInstr(flow_graph_->allocate_block_id(),
+                                        try_index, DeoptId::kNone);
+    merge = new (zone_) JoinEntryInstr(flow_graph_->allocate_block_id(),
+                                       try_index, DeoptId::kNone);
+    auto compare = new (zone_) RelationalOpInstr(
+        branch_->source(), Token::kGTE, new (zone_) Value(guard_),
+        new (zone_) Value(Constant(0)), kMintCid, DeoptId::kNone,
+        Instruction::kNotSpeculative);
+    auto branch = new (zone_) BranchInstr(compare, DeoptId::kNone);
+    flow_graph_->AppendTo(preheader_exit->previous(), branch, nullptr,
+                          FlowGraph::kEffect);
+    preheader_->set_last_instruction(branch);
+    *branch->true_successor_address() = enter;
+    *branch->false_successor_address() = skip;
+
+    auto goto_loop = new (zone_) GotoInstr(new_header_, DeoptId::kNone);
+    flow_graph_->AppendTo(enter, goto_loop, nullptr, FlowGraph::kEffect);
+    enter->set_last_instruction(goto_loop);
+    auto goto_merge = new (zone_) GotoInstr(merge, DeoptId::kNone);
+    flow_graph_->AppendTo(skip, goto_merge, nullptr, FlowGraph::kEffect);
+    skip->set_last_instruction(goto_merge);
+    auto goto_header = new (zone_) GotoInstr(header_, DeoptId::kNone);
+    flow_graph_->AppendTo(merge, goto_header, nullptr, FlowGraph::kEffect);
+    merge->set_last_instruction(goto_header);
+    entry = enter;
+    exit_target = merge;
+  }
+  auto exit = new (zone_) GotoInstr(exit_target, DeoptId::kNone);
+  flow_graph_->AppendTo(new_exit_, exit, nullptr, FlowGraph::kEffect);
+  new_exit_->set_last_instruction(exit);
+
+  // Rebuild the predecessors, which determine the order of phi inputs.
+  flow_graph_->DiscoverBlocks();
+
+  BlockEntryInstr* header_entry = new_exit_;
+  if (merge != nullptr) {
+    header_entry = merge;
+  }
+  const intptr_t back_edge_index = header_->IndexOfPredecessor(body_);
+  const intptr_t entry_index = header_->IndexOfPredecessor(header_entry);
+  for (intptr_t i = 0; i < phis_.length(); ++i) {
+    PhiInstr* phi = phis_[i];
+    PhiInstr* new_phi = new_phis_[i];
+    Definition* initial = phi->InputAt(1 - back_edge_index_)->definition();
+    Definition* next = phi->InputAt(back_edge_index_)->definition();
+
+    SetPhiInput(new_phi, new_header_->IndexOfPredecessor(entry), initial);
+    SetPhiInput(new_phi, new_header_->IndexOfPredecessor(new_body_),
+                next_values[i]);
+
+    Definition* incoming = new_phi;
+    if (merge != nullptr) {
+      PhiInstr* merge_phi = new (zone_) PhiInstr(merge, 2);
+      flow_graph_->AllocateSSAIndexes(merge_phi);
+      merge_phi->mark_alive();
+      merge_phi->set_representation(phi->representation());
+      if (phi->range() != nullptr) {
+        merge_phi->set_range(*phi->range());
+      }
+      merge->InsertPhi(merge_phi);
+      SetPhiInput(merge_phi, merge->IndexOfPredecessor(new_exit_), new_phi);
+      SetPhiInput(merge_phi, merge->IndexOfPredecessor(skip), initial);
+      incoming = merge_phi;
+    }
+
+    phi->InputAt(0)->RemoveFromUseList();
+    phi->InputAt(1)->RemoveFromUseList();
+    SetPhiInput(phi, entry_index, incoming);
+    SetPhiInput(phi, back_edge_index, next);
+  }
+
+  GrowableArray<BitVector*> dominance_frontier;
+  flow_graph_->ComputeDominators(&dominance_frontier);
+}
+
+bool LoopTransformer::TryUnroll(intptr_t factor) {
+  if ((factor < 2) || (body_size_ * factor > kMaxUnrolledBodySize)) {
+    return false;
+  }
+
+  BuildNewLoop(factor);
+
+  // Copy the body [factor] times, feeding each copy with the values the
+  // previous one computed for the next iteration.
+  GrowableArray<Definition*> values(phis_.length());
+  GrowableArray<Definition*> next_values(phis_.length());
+  for (PhiInstr* phi : new_phis_) {
+    values.Add(phi);
+  }
+  Instruction* cursor = new_body_;
+  for (intptr_t k = 0; k < factor; ++k) {
+    for (intptr_t i = 0; i < phis_.length(); ++i) {
+      Map(phis_[i], values[i]);
+    }
+    for (ForwardInstructionIterator it(body_); !it.Done(); it.Advance()) {
+      Instruction* current = it.Current();
+      if (current->IsGoto()) {
+        break;
+      }
+      Instruction* copy = Copy(current);
+      if (copy->IsDefinition()) {
+        cursor = flow_graph_->AppendTo(cursor, copy, nullptr, FlowGraph::kValue);
+        Map(current->AsDefinition(), copy->AsDefinition());
+      } else {
+        cursor =
+            flow_graph_->AppendTo(cursor, copy, nullptr, FlowGraph::kEffect);
+      }
+    }
+    next_values.Clear();
+    for (PhiInstr* phi : phis_) {
+      next_values.Add(Lookup(phi->InputAt(back_edge_index_)->definition()));
+    }
+    values.Clear();
+    values.AddArray(next_values);
+  }
+
+  FinishNewLoop(cursor, values);
+  return true;
+}
+
+bool LoopTransformer::TryVectorize() {
+  if (!FLAG_loop_vectorization ||
+      !FlowGraphCompiler::SupportsUnboxedSimd128() || (phis_.length() != 1)) {
+    return false;
+  }
+  ASSERT(phis_[0] == index_);
+  Definition* next_index = index_->InputAt(back_edge_index_)->definition();
+  if (IsInvariant(next_index) || !next_index->HasOnlyUse(
+                                     index_->InputAt(back_edge_index_))) {
+    return false;
+  }
+
+  const VectorShape* shape = nullptr;
+  GrowableArray<Instruction*> code;       // The new body.
+  GrowableArray<Definition*> splats;      // Hoisted into the preheader.
+  GrowableArray<Definition*> lengths;     // Of the dropped bounds checks.
+  GrowableArray<Access> accesses;
+  BitVector* indices = new (zone_) BitVector(zone_, renamed_.length());
+  BitVector* vectors = new (zone_) BitVector(zone_, renamed_.length());
+  indices->Add(index_->ssa_temp_index());
+
+  auto is_index = [&](Value* value) {
+    return indices->Contains(value->definition()->ssa_temp_index());
+  };
+  auto is_vector = [&](Value* value) {
+    return vectors->Contains(value->definition()->ssa_temp_index());
+  };
+  // Returns the vector for [value], or nullptr.
+  auto vector_operand = [&](Value* value) -> Definition* {
+    Definition* def = value->definition();
+    if (is_vector(value)) {
+      return Lookup(def);
+    }
+    // Invariant doubles are broadcast to all lanes. Float32 lanes would not
+    // round like the scalar code, which computes in double precision.
+    if ((shape->simd_cid == kFloat64x2Cid) && IsInvariant(def) &&
+        (def->representation() == kUnboxedDouble)) {
+      for (intptr_t i = 0; i < splats.length(); ++i) {
+        if (splats[i]->InputAt(0)->definition() == def) {
+          return splats[i];
+        }
+      }
+      Definition* splat = SimdOpInstr::Create(MethodRecognizer::kFloat64x2Splat,
+                                              new (zone_) Value(def),
+                                              DeoptId::kNone);
+      splats.Add(splat);
+      return splat;
+    }
+    return nullptr;
+  };
+  // Returns the array accessed by a LoadIndexed or StoreIndexed in the new
+  // body and records the access, or returns nullptr.
+  auto array_operand = [&](Value* array, bool is_store) -> Definition* {
+    Definition* def = array->definition();
+    if (IsInvariant(def) && (def->representation() == kUntagged)) {
+      accesses.Add({def, -1, is_store});
+      return def;
+    }
+    auto load = def->AsLoadUntagged();
+    if ((load == nullptr) || IsInvariant(load)) {
+      return nullptr;
+    }
+    accesses.Add({load->object()->definition(), load->offset(), is_store});
+    return Lookup(load);
+  };
+  // Whether the accessed elements match the vector shape.
+  auto match_shape = [&](intptr_t class_id) {
+    const VectorShape* element_shape = VectorShapeFor(class_id);
+    if (element_shape == nullptr) {
+      return false;
+    }
+    if (shape == nullptr) {
+      shape = element_shape;
+    }
+    return shape == element_shape;
+  };
+  auto add_vector = [&](Definition* def, Definition* vector) {
+    Map(def, vector);
+    vectors->Add(def->ssa_temp_index());
+  };
+
+  for (ForwardInstructionIterator it(body_); !it.Done(); it.Advance()) {
+    Instruction* current = it.Current();
+    if (current->IsGoto()) {
+      break;
+    }
+    if (current == next_index) {
+      continue;
+    }
+
+    // Conversions and bounds checks of the index. Bounds checks which range
+    // analysis could not remove are replaced by a test before the loop.
+    if (current->IsBox() || current->IsUnbox() || current->IsIntConverter() ||
+        current->IsGenericCheckBound()) {
+      Definition* def = current->AsDefinition();
+      if (auto check = current->AsGenericCheckBound()) {
+        if (is_index(check->index())) {
+          if (!IsInvariant(check->length()->definition())) {
+            return false;
+          }
+          lengths.Add(check->length()->definition());
+          indices->Add(def->ssa_temp_index());
+          Map(def, Lookup(check->index()->definition()));
+          continue;
+        }
+        return false;
+      }
+      if (is_index(def->InputAt(0))) {
+        Instruction* copy = Copy(current);
+        code.Add(copy);
+        Map(def, copy->AsDefinition());
+        indices->Add(def->ssa_temp_index());
+        continue;
+      }
+      // Other conversions only change the width of 32-bit lanes.
+      if ((shape != nullptr) && (shape->simd_cid == kInt32x4Cid) &&
+          !current->IsGenericCheckBound() && is_vector(def->InputAt(0))) {
+        add_vector(def, Lookup(def->InputAt(0)->definition()));
+        continue;
+      }
+      return false;
+    }
+
+    if (auto load = current->AsLoadUntagged()) {
+      if (!IsInvariant(load->object()->definition())) {
+        return false;
+      }
+      Instruction* copy = Copy(current);
+      code.Add(copy);
+      Map(load, copy->AsDefinition());
+      continue;
+    }
+
+    if (auto load = current->AsLoadIndexed()) {
+      if (!match_shape(load->class_id()) || !is_index(load->index())) {
+        return false;
+      }
+      Definition* array = array_operand(load->array(), /*is_store=*/false);
+      if (array == nullptr) {
+        return false;
+      }
+      auto vector = new (zone_) LoadIndexedInstr(
+          new (zone_) Value(array), Rename(load->index()),
+          load->index_unboxed(), load->index_scale(), shape->array_cid,
+          kUnalignedAccess, DeoptId::kNone, load->source());
+      code.Add(vector);
+      add_vector(load, vector);
+      continue;
+    }
+
+    if (auto store = current->AsStoreIndexed()) {
+      if (!match_shape(store->class_id()) || !is_index(store->index()) ||
+          !is_vector(store->value())) {
+        return false;
+      }
+      Definition* array = array_operand(store->array(), /*is_store=*/true);
+      if (array == nullptr) {
+        return false;
+      }
+      code.Add(new (zone_) StoreIndexedInstr(
+          new (zone_) Value(array), Rename(store->index()),
+          Rename(store->value()), kNoStoreBarrier, store->index_unboxed(),
+          store->index_scale(), shape->array_cid, kUnalignedAccess,
+          DeoptId::kNone, store->source(), Instruction::kNotSpeculative));
+      continue;
+    }
+
+    if (current->IsFloatToDouble() || current->IsDoubleToFloat()) {
+      Definition* def = current->AsDefinition();
+      if ((shape == nullptr) || (shape->simd_cid != kFloat32x4Cid) ||
+          !is_vector(def->InputAt(0))) {
+        return false;
+      }
+      add_vector(def, Lookup(def->InputAt(0)->definition()));
+      continue;
+    }
+
+    if (auto op = current->AsBinaryDoubleOp()) {
+      if ((shape == nullptr) || (shape->simd_cid == kInt32x4Cid)) {
+        return false;
+      }
+      if (shape->simd_cid == kFloat32x4Cid) {
+        // A single float operation computed in double precision rounds like
+        // the same operation in single precision. This does not hold for
+        // several operations in a row.
+        for (intptr_t i = 0; i < 2; ++i) {
+          auto widen = op->InputAt(i)->definition()->AsFloatToDouble();
+          if ((widen == nullptr) ||
+              !widen->value()->definition()->IsLoadIndexed()) {
+            return false;
+          }
+        }
+        for (Value::Iterator use_it(op->input_use_list()); !use_it.Done();
+             use_it.Advance()) {
+          if (!use_it.Current()->instruction()->IsDoubleToFloat()) {
+            return false;
+          }
+        }
+      }
+      switch (op->op_kind()) {
+        case Token::kADD:
+        case Token::kSUB:
+        case Token::kMUL:
+        case Token::kDIV:
+          break;
+        default:
+          return false;
+      }
+      Definition* left = vector_operand(op->left());
+      Definition* right = vector_operand(op->right());
+      if ((left == nullptr) || (right == nullptr)) {
+        return false;
+      }
+      auto vector = SimdOpInstr::Create(
+          SimdOpInstr::KindForOperator(shape->simd_cid, op->op_kind()),
+          new (zone_) Value(left), new (zone_) Value(right), DeoptId::kNone);
+      code.Add(vector);
+      add_vector(op, vector);
+      continue;
+    }
+
+    if (auto op = current->AsBinaryIntegerOp()) {
+      if ((shape == nullptr) || (shape->simd_cid != kInt32x4Cid) ||
+          (op->op_kind() == Token::kMUL) || !is_vector(op->left()) ||
+          !is_vector(op->right())) {
+        return false;
+      }
+      // The low 32 bits of these operations only depend on the low 32 bits
+      // of their inputs.
+      auto vector = SimdOpInstr::Create(
+          SimdOpInstr::KindForOperator(kInt32x4Cid, op->op_kind()),
+          Rename(op->left()), Rename(op->right()), DeoptId::kNone);
+      code.Add(vector);
+      add_vector(op, vector);
+      continue;
+    }
+
+    return false;
+  }
+  if (shape == nullptr) {
+    return false;
+  }
+
+  // Iterations of the new loop perform the accesses of several iterations of
+  // the original loop in a different order. For an access X before an access
+  // Y in the body, the original loop performs Y at iteration k before X at
+  // iteration j > k, while the new loop performs X first if j and k are
+  // processed together. If one of them is a store, this is only safe if they
+  // cannot touch the same bytes, which is the case unless
+  // 0 < address(Y) - address(X) < kVectorSize.
+  GrowableArray<Access> checked;
+  for (intptr_t y = 0; y < accesses.length(); ++y) {
+    for (intptr_t x = 0; x < y; ++x) {
+      const Access& first = accesses[x];
+      const Access& second = accesses[y];
+      if ((first.base == second.base) ||
+          (!first.is_store && !second.is_store)) {
+        continue;
+      }
+      bool found = false;
+      for (intptr_t i = 0; i < checked.length(); i += 2) {
+        if ((checked[i].base == first.base) &&
+            (checked[i + 1].base == second.base)) {
+          found = true;
+        }
+      }
+      if (!found) {
+        checked.Add(first);
+        checked.Add(second);
+      }
+    }
+  }
+  if (checked.length() > 2 * kMaxAliasChecks) {
+    return false;
+  }
+
+  BuildNewLoop(shape->lanes);
+
+  // The new body indexes the vectors with the new induction.
+  PhiInstr* new_index = new_phis_[0];
+  for (Instruction* instr : code) {
+    for (intptr_t i = 0; i < instr->InputCount(); ++i) {
+      if (instr->InputAt(i)->definition() == index_) {
+        instr->InputAt(i)->set_definition(new_index);
+      }
+    }
+  }
+  for (Definition* splat : splats) {
+    EmitInPreheader(splat);
+  }
+  Instruction* cursor = new_body_;
+  for (Instruction* instr : code) {
+    cursor = flow_graph_->AppendTo(
+        cursor, instr, nullptr,
+        instr->IsDefinition() ? FlowGraph::kValue : FlowGraph::kEffect);
+  }
+  auto next = new (zone_) BinaryInt64OpInstr(
+      Token::kADD, new (zone_) Value(new_index),
+      new (zone_) Value(Constant(shape->lanes)), DeoptId::kNone,
+      Instruction::kNotSpeculative);
+  cursor = flow_graph_->AppendTo(cursor, next, nullptr, FlowGraph::kValue);
+
+  // The new loop is entered if none of the conditions below is negative.
+  GrowableArray<Definition*> conditions;
+  if (!lengths.is_empty()) {
+    // All iterations of the original loop are in bounds, so the bounds
+    // checks can be dropped. Otherwise the original loop throws at the
+    // right iteration.
+    Definition* initial = index_->InputAt(1 - back_edge_index_)->definition();
+    if (!RangeUtils::IsPositive(initial->range())) {
+      conditions.Add(initial);
+    }
+    for (Definition* length : lengths) {
+      if ((limit_->mult() == 1) && (limit_->offset() <= 0) &&
+          (length->OriginalDefinitionIgnoreBoxingAndConstraints() ==
+           limit_->def()->OriginalDefinitionIgnoreBoxingAndConstraints())) {
+        continue;
+      }
+      conditions.Add(EmitInt64Op(Token::kSUB, length, limit_value_));
+    }
+  }
+  for (intptr_t i = 0; i < checked.length(); i += 2) {
+    Definition* delta = EmitInt64Op(Token::kSUB, EmitDataAddress(checked[i + 1]),
+                                    EmitDataAddress(checked[i]));
+    // 0 < delta < kVectorSize iff delta - 1 is non-negative while
+    // delta - kVectorSize is negative.
+    conditions.Add(
+        EmitInt64Op(Token::kBIT_XOR,
+                    EmitInt64Op(Token::kSUB, delta, Constant(1)),
+                    EmitInt64Op(Token::kSUB, delta, Constant(kVectorSize))));
+  }
+  for (Definition* condition : conditions) {
+    guard_ = (guard_ == nullptr)
+                 ? condition
+                 : EmitInt64Op(Token::kBIT_OR, guard_, condition);
+  }
+
+  GrowableArray<Definition*> next_values;
+  next_values.Add(next);
+  FinishNewLoop(cursor, next_values);
+  return true;
+}
+
+void LoopVectorizer::Optimize(FlowGraph* flow_graph) {
+#if defined(TARGET_ARCH_IS_64_BIT)
+  if (!FLAG_loop_vectorization && (FLAG_loop_unroll_factor < 2)) {
+    return;
+  }
+  // Transforming a loop invalidates the loop hierarchy, which is recomputed
+  // before looking for the next candidate. The new loops are not candidates.
+  const intptr_t max_block_id = flow_graph->max_block_id();
+  BitVector* visited = new (flow_graph->zone())
+      BitVector(flow_graph->zone(), max_block_id + 1);
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    const LoopHierarchy& loops = flow_graph->GetLoopHierarchy();
+    loops.ComputeInduction();
+    for (BlockEntryInstr* header : loops.headers()) {
+      const intptr_t block_id = header->block_id();
+      if ((block_id > max_block_id) || visited->Contains(block_id)) {
+        continue;
+      }
+      visited->Add(block_id);
+      LoopTransformer transformer(flow_graph, header->loop_info());
+      if (!transformer.Analyze()) {
+        continue;
+      }
+      const char* transformation = nullptr;
+      if (transformer.TryVectorize()) {
+        transformation = "Vectorized";
+      } else if (transformer.TryUnroll(FLAG_loop_unroll_factor)) {
+        transformation = "Unrolled";
+      } else {
+        continue;
+      }
+      if (FLAG_trace_loop_vectorization) {
+        THR_Print("%s loop B%" Pd " in %s\n", transformation, block_id,
+                  flow_graph->function().ToFullyQualifiedCString());
+      }
+      changed = true;
+      break;
+    }
+  }
+#endif  // defined(TARGET_ARCH_IS_64_BIT)
+}
+
+}  // namespace dart
@@ -0,0 +1,40 @@
+// Copyright (c) 2021, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef RUNTIME_VM_COMPILER_BACKEND_LOOP_VECTORIZER_H_
+#define RUNTIME_VM_COMPILER_BACKEND_LOOP_VECTORIZER_H_
+
+#if defined(DART_PRECOMPILED_RUNTIME)
+#error "AOT runtime should not use compiler sources (including header files)"
+#endif  // defined(DART_PRECOMPILED_RUNTIME)
+
+#include "vm/allocation.h"
+
+namespace dart {
+
+class FlowGraph;
+
+// Vectorizes and unrolls simple counted loops.
+//
+// A loop is a candidate if it is an innermost loop made of a header, which
+// only tests the control induction i < U (i++), and a single body block
+// without calls or control flow. Such a loop is preceded by a copy of itself
+// which performs several iterations of the original loop each time around,
+// as long as that many iterations are left. The original loop then runs the
+// remaining iterations.
+//
+// If the body only performs element-wise operations on typed data indexed by
+// i, the copy uses SIMD operations on a vector of consecutive elements
+// instead. Otherwise the copy repeats the body --loop_unroll_factor times.
+//
+// Must run after range analysis, which removes the bounds checks proven
+// redundant, and after environments were eliminated (AOT only).
+class LoopVectorizer : public AllStatic {
+ public:
+  static void Optimize(FlowGraph* flow_graph);
+};
+
+}  // namespace dart
+
+#endif  // RUNTIME_VM_COMPILER_BACKEND_LOOP_VECTORIZER_H_
@@ -0,0 +1,112 @@
+// Copyright (c) 2021, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/compiler/backend/flow_graph_compiler.h"
+#include "vm/compiler/backend/il_test_helper.h"
+#include "vm/compiler/compiler_pass.h"
+#include "vm/object.h"
+#include "vm/unit_test.h"
+
+namespace dart {
+
+#if defined(DART_PRECOMPILER) && defined(TARGET_ARCH_IS_64_BIT)
+
+DECLARE_FLAG(int, loop_unroll_factor);
+
+static intptr_t CountSimdOps(FlowGraph* flow_graph, SimdOpInstr::Kind kind) {
+  intptr_t count = 0;
+  for (BlockIterator block_it = flow_graph->reverse_postorder_iterator();
+       !block_it.Done(); block_it.Advance()) {
+    for (ForwardInstructionIterator it(block_it.Current()); !it.Done();
+         it.Advance()) {
+      SimdOpInstr* op = it.Current()->AsSimdOp();
+      if ((op != nullptr) && (op->kind() == kind)) {
+        ++count;
+      }
+    }
+  }
+  return count;
+}
+
+static intptr_t CountLoadIndexed(FlowGraph* flow_graph, intptr_t class_id) {
+  intptr_t count = 0;
+  for (BlockIterator block_it = flow_graph->reverse_postorder_iterator();
+       !block_it.Done(); block_it.Advance()) {
+    for (ForwardInstructionIterator it(block_it.Current()); !it.Done();
+         it.Advance()) {
+      LoadIndexedInstr* load = it.Current()->AsLoadIndexed();
+      if ((load != nullptr) && (load->class_id() == class_id)) {
+        ++count;
+      }
+    }
+  }
+  return count;
+}
+
+ISOLATE_UNIT_TEST_CASE(IRTest_LoopVectorizer_Float64) {
+  const char* kScript =
+      R"(
+      import 'dart:typed_data';
+
+      void add(Float64List a, Float64List b, double c) {
+        for (int i = 0; i < a.length; i++) {
+          a[i] = a[i] * c + b[i];
+        }
+      }
+
+      void main() {
+        add(Float64List(8), Float64List(8), 2.0);
+      }
+      )";
+
+  const auto& root_library = Library::Handle(LoadTestScript(kScript));
+  Invoke(root_library, "main");
+  const auto& function = Function::Handle(GetFunction(root_library, "add"));
+
+  TestPipeline pipeline(function, CompilerPass::kAOT);
+  FlowGraph* flow_graph = pipeline.RunPasses({});
+
+  if (FlowGraphCompiler::SupportsUnboxedSimd128()) {
+    EXPECT_EQ(1, CountSimdOps(flow_graph, SimdOpInstr::kFloat64x2Mul));
+    EXPECT_EQ(1, CountSimdOps(flow_graph, SimdOpInstr::kFloat64x2Add));
+    EXPECT_EQ(1, CountSimdOps(flow_graph, SimdOpInstr::kFloat64x2Splat));
+    EXPECT_EQ(2, CountLoadIndexed(flow_graph, kTypedDataFloat64x2ArrayCid));
+  }
+  // The original loop handles the remaining elements.
+  EXPECT_EQ(2, CountLoadIndexed(flow_graph, kTypedDataFloat64ArrayCid));
+}
+
+ISOLATE_UNIT_TEST_CASE(IRTest_LoopVectorizer_Unroll) {
+  const char* kScript =
+      R"(
+      import 'dart:typed_data';
+
+      int sum(Int32List a) {
+        int result = 0;
+        for (int i = 0; i < a.length; i++) {
+          result += a[i];
+        }
+        return result;
+      }
+
+      void main() {
+        sum(Int32List(8));
+      }
+      )";
+
+  const auto& root_library = Library::Handle(LoadTestScript(kScript));
+  Invoke(root_library, "main");
+  const auto& function = Function::Handle(GetFunction(root_library, "sum"));
+
+  TestPipeline pipeline(function, CompilerPass::kAOT);
+  FlowGraph* flow_graph = pipeline.RunPasses({});
+
+  // The sum is carried by a phi, so the loop is unrolled instead.
+  EXPECT_EQ(1 + FLAG_loop_unroll_factor,
+            CountLoadIndexed(flow_graph, kTypedDataInt32ArrayCid));
+}
+
+#endif  // defined(DART_PRECOMPILER) && defined(TARGET_ARCH_IS_64_BIT)
+
+}  // namespace dart
@@ -15,7 +15,8 @@ namespace ffi {
 
 // TODO(dartbug.com/36607): Cache the trampolines.
 FunctionPtr TrampolineFunction(const FunctionType& dart_signature,
-                               const FunctionType& c_signature) {
+                               const FunctionType& c_signature,
+                               bool is_leaf) {
   Thread* thread = Thread::Current();
   Zone* zone = thread->zone();
   String& name = String::Handle(zone, Symbols::New(thread, "FfiTrampoline"));
@@ -51,6 +52,7 @@ FunctionPtr TrampolineFunction(const FunctionType& dart_signature,
   }
   signature.FinalizeNameArrays(function);
   function.SetFfiCSignature(c_signature);
+  function.SetFfiIsLeaf(is_leaf);
   signature ^= ClassFinalizer::FinalizeType(signature);
   function.set_signature(signature);
 
@@ -355,7 +355,10 @@ class BaseFlowGraphBuilder {
   // Builds the graph for an invocation of '_asFunctionInternal'.
   //
   // 'signatures' contains the pair [<dart signature>, <native signature>].
-  Fragment BuildFfiAsFunctionInternalCall(const TypeArguments& signatures);
+  // 'is_leaf' tells whether the call stays in generated code (see
+  // FfiCallInstr).
+  Fragment BuildFfiAsFunctionInternalCall(const TypeArguments& signatures,
+                                          bool is_leaf);
 
   Fragment AllocateObject(TokenPosition position,
                           const Class& klass,
@@ -5020,7 +5020,7 @@ Fragment StreamingFlowGraphBuilder::BuildFunctionNode(
 
 Fragment StreamingFlowGraphBuilder::BuildFfiAsFunctionInternal() {
   const intptr_t argc = ReadUInt();               // read argument count.
-  ASSERT(argc == 1);                              // pointer
+  ASSERT(argc == 2);                              // pointer, isLeaf
   const intptr_t list_length = ReadListLength();  // read types list length.
   ASSERT(list_length == 2);  // dart signature, then native signature
   const TypeArguments& type_arguments =
@@ -5028,12 +5028,22 @@ Fragment StreamingFlowGraphBuilder::BuildFfiAsFunctionInternal() {
   Fragment code;
   const intptr_t positional_count =
       ReadListLength();  // read positional argument count
-  ASSERT(positional_count == 1);
+  ASSERT(positional_count == 2);
   code += BuildExpression();  // build first positional argument (pointer)
+
+  // Read second positional argument (isLeaf), which the FE guarantees to be
+  // a constant.
+  code += BuildExpression();
+  Definition* is_leaf_def = B->Peek();
+  ASSERT(is_leaf_def->IsConstant());
+  const Bool& is_leaf_value = Bool::Cast(is_leaf_def->AsConstant()->value());
+  const bool is_leaf = is_leaf_value.value();
+  code += Drop();
+
   const intptr_t named_args_len =
       ReadListLength();  // skip (empty) named arguments list
   ASSERT(named_args_len == 0);
-  code += B->BuildFfiAsFunctionInternalCall(type_arguments);
+  code += B->BuildFfiAsFunctionInternalCall(type_arguments, is_leaf);
   return code;
 }
 
@@ -383,11 +383,12 @@ Fragment FlowGraphBuilder::InstanceCall(
 }
 
 Fragment FlowGraphBuilder::FfiCall(
-    const compiler::ffi::CallMarshaller& marshaller) {
+    const compiler::ffi::CallMarshaller& marshaller,
+    bool is_leaf) {
   Fragment body;
 
   FfiCallInstr* const call =
-      new (Z) FfiCallInstr(Z, GetNextDeoptId(), marshaller);
+      new (Z) FfiCallInstr(Z, GetNextDeoptId(), marshaller, is_leaf);
 
   for (intptr_t i = call->InputCount() - 1; i >= 0; --i) {
     call->SetInputAt(i, Pop());
@@ -4154,6 +4155,10 @@ FlowGraph* FlowGraphBuilder::BuildGraphOfFfiNative(const Function& function) {
   const auto& marshaller = *new (Z) compiler::ffi::CallMarshaller(Z, function);
 
   const bool signature_contains_handles = marshaller.ContainsHandles();
+  const bool is_leaf = function.FfiIsLeaf();
+  // The FE rejects leaf calls with handles: handles need a handle scope,
+  // which can only be used outside of generated code.
+  ASSERT(!is_leaf || !signature_contains_handles);
 
   // FFI trampolines are accessed via closures, so non-covariant argument types
   // and type arguments are either statically checked by the type system or
@@ -4234,7 +4239,7 @@ FlowGraph* FlowGraphBuilder::BuildGraphOfFfiNative(const Function& function) {
     body += LoadLocal(typed_data);
   }
 
-  body += FfiCall(marshaller);
+  body += FfiCall(marshaller, is_leaf);
 
   for (intptr_t i = 0; i < marshaller.num_args(); i++) {
     if (marshaller.IsPointer(i)) {
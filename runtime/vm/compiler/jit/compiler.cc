@@ -1112,6 +1112,9 @@ class BackgroundCompilerTask : public ThreadPool::Task {
   virtual ~BackgroundCompilerTask() {}
 
  private:
+  virtual ThreadPool::Priority priority() const {
+    return ThreadPool::kLowPriority;
+  }
   virtual void Run() { background_compiler_->Run(); }
 
   BackgroundCompiler* background_compiler_;
@@ -7803,6 +7803,64 @@ TEST_CASE(DartAPI_NativePortReceiveInteger) {
   EXPECT(Dart_CloseNativePort(port_id1));
 }
 
+void NewNativePort_nativeReceiveImmutable(Dart_Port dest_port_id,
+                                          Dart_CObject* message) {
+  EXPECT_NOTNULL(message);
+
+  if ((message->type == Dart_CObject_kArray) &&
+      (message->value.as_array.length == 1) &&
+      (message->value.as_array.values[0]->type == Dart_CObject_kSendPort)) {
+    // Post integer value.
+    Dart_PostInteger(message->value.as_array.values[0]->value.as_send_port.id,
+                     123);
+  } else if (message->type == Dart_CObject_kString) {
+    EXPECT_STREQ("abcabcabc", message->value.as_string);
+  } else {
+    // Deeply immutable objects are serialized for native ports.
+    EXPECT_EQ(message->type, Dart_CObject_kArray);
+    EXPECT_EQ(2, message->value.as_array.length);
+    EXPECT_EQ(Dart_CObject_kString, message->value.as_array.values[0]->type);
+    EXPECT_STREQ("a", message->value.as_array.values[0]->value.as_string);
+  }
+}
+
+TEST_CASE(DartAPI_NativePortReceiveImmutable) {
+  const char* kScriptChars =
+      "import 'dart:isolate';\n"
+      "void callPort(SendPort port) {\n"
+      "  var receivePort = new RawReceivePort();\n"
+      "  var replyPort = receivePort.sendPort;\n"
+      "  port.send('abc' * 3);\n"
+      "  port.send(const <String>['a', 'b']);\n"
+      "  port.send(<dynamic>[replyPort]);\n"
+      "  receivePort.handler = (message) {\n"
+      "    receivePort.close();\n"
+      "    throw new Exception(message);\n"
+      "  };\n"
+      "}\n";
+  Dart_Handle lib = TestCase::LoadTestScript(kScriptChars, NULL);
+  Dart_EnterScope();
+
+  Dart_Port port_id1 = Dart_NewNativePort(
+      "PortImmutable", NewNativePort_nativeReceiveImmutable, true);
+  Dart_Handle send_port1 = Dart_NewSendPort(port_id1);
+  EXPECT_VALID(send_port1);
+
+  Dart_Handle dart_args[1];
+  dart_args[0] = send_port1;
+  Dart_Handle result = Dart_Invoke(lib, NewString("callPort"), 1, dart_args);
+  EXPECT_VALID(result);
+  result = Dart_RunLoop();
+  EXPECT(Dart_IsError(result));
+  EXPECT(Dart_ErrorHasException(result));
+  EXPECT_SUBSTRING("Exception: 123\n", Dart_GetError(result));
+
+  Dart_ExitScope();
+
+  // Delete the native ports.
+  EXPECT(Dart_CloseNativePort(port_id1));
+}
+
 static Dart_Isolate RunLoopTestCallback(const char* script_name,
                                         const char* main,
                                         const char* package_root,
@@ -135,6 +135,9 @@ constexpr bool FLAG_support_il_printer = false;
     "Ratio of getter/setter usage used for double field unboxing heuristics")  \
   P(guess_icdata_cid, bool, true,                                              \
     "Artificially create type feedback for arithmetic etc. operations")        \
+  P(heap_huge_pages, bool, false,                                              \
+    "Allocate Dart heap pages from mappings the OS is advised to back with "   \
+    "transparent huge pages. Pages smaller than a huge page share one.")       \
   P(huge_method_cutoff_in_tokens, int, 20000,                                  \
     "Huge method cutoff in tokens: Disables optimizations for huge methods.")  \
   P(idle_timeout_micros, int, 1000 * kMicrosecondsPerMillisecond,              \
@@ -151,6 +154,9 @@ constexpr bool FLAG_support_il_printer = false;
   P(marker_tasks, int, 2,                                                      \
     "The number of tasks to spawn during old gen GC marking (0 means "         \
     "perform all marking on main thread).")                                    \
+  P(sweeper_tasks, int, 2,                                                     \
+    "The number of tasks to sweep old gen data pages with (0 means sweep "     \
+    "on a single task).")                                                      \
   P(max_polymorphic_checks, int, 4,                                            \
     "Maximum number of polymorphic check, otherwise it is megamorphic.")       \
   P(max_equality_polymorphic_checks, int, 32,                                  \
@@ -159,6 +165,8 @@ constexpr bool FLAG_support_il_printer = false;
     "Max size of new gen semi space in MB")                                    \
   P(new_gen_semi_initial_size, int, (kWordSize <= 4) ? 1 : 2,                  \
     "Initial size of new gen semi space in MB")                                \
+  P(new_gen_prefault, bool, false,                                             \
+    "Pre-fault the pages of the initial new gen semi-space.")                  \
   P(optimization_counter_threshold, int, 30000,                                \
     "Function's usage-counter value before it is optimized, -1 means never")   \
   R(randomize_optimization_counter, false, bool, false,                        \
@@ -137,6 +137,7 @@ class CompactorTask : public ThreadPool::Task {
         free_current_(0),
         free_end_(0) {}
 
+  ThreadPool::Priority priority() const { return ThreadPool::kHighPriority; }
   void Run();
   void RunEnteredIsolateGroup();
 
@@ -168,10 +169,17 @@ class CompactorTask : public ThreadPool::Task {
 // Free space at the end of a page that is too small for the next block is
 // added to the freelist.
 void GCCompactor::Compact(OldPage* pages,
+                          OldPage* fixed_pages,
                           FreeList* freelist,
                           Mutex* pages_lock) {
   SetupImagePageBoundaries();
 
+  for (OldPage* page = fixed_pages; page != nullptr; page = page->next()) {
+    ASSERT(page->forwarding_page_ != nullptr);
+    fixed_pages_.Add(page);
+    page->forwarding_page_ = nullptr;
+  }
+
   // Divide the heap.
   // TODO(30978): Try to divide based on live bytes or with work stealing.
   intptr_t num_pages = 0;
@@ -299,6 +307,15 @@ void GCCompactor::Compact(OldPage* pages,
 
   heap_->old_space()->VisitRoots(this);
 
+  // Done forwarding. Give the fixed pages their forwarding pages back (see
+  // OldPage::AllocateForwardingPage).
+  for (intptr_t i = 0; i < fixed_pages_.length(); i++) {
+    OldPage* page = fixed_pages_[i];
+    ASSERT(page->forwarding_page_ == nullptr);
+    page->forwarding_page_ =
+        reinterpret_cast<ForwardingPage*>(page->object_end());
+  }
+
   {
     MutexLocker ml(pages_lock);
 
@@ -381,7 +398,8 @@ void CompactorTask::RunEnteredIsolateGroup() {
     }
 
     // Heap: Regular pages already visited during sliding. Code and image pages
-    // have no pointers to forward. Visit large pages and new-space.
+    // have no pointers to forward. Visit large pages, new-space and pages that
+    // are not compacted.
 
     bool more_forwarding_tasks = true;
     while (more_forwarding_tasks) {
@@ -435,6 +453,16 @@ void CompactorTask::RunEnteredIsolateGroup() {
       }
     }
 
+    {
+      TIMELINE_FUNCTION_GC_DURATION(thread, "ForwardFixedPages");
+      const intptr_t num_fixed_pages = compactor_->fixed_pages_.length();
+      intptr_t index;
+      while ((index = compactor_->next_fixed_page_.fetch_add(1)) <
+             num_fixed_pages) {
+        compactor_->ForwardFixedPage(compactor_->fixed_pages_[index]);
+      }
+    }
+
     barrier_->Sync();
   }
 }
@@ -596,6 +624,21 @@ void GCCompactor::SetupImagePageBoundaries() {
   image_page_hi_ = image_page_count - 1;
 }
 
+// Forwards the pointers of the live objects on a page that is not compacted.
+// Dead objects are left for the sweeper.
+void GCCompactor::ForwardFixedPage(OldPage* page) {
+  uword current = page->object_start();
+  const uword end = page->object_end();
+  while (current < end) {
+    ObjectPtr obj = UntaggedObject::FromAddr(current);
+    const intptr_t size = obj->untag()->HeapSize();
+    if (obj->untag()->IsMarked()) {
+      obj->untag()->VisitPointers(this);
+    }
+    current += size;
+  }
+}
+
 DART_FORCE_INLINE
 void GCCompactor::ForwardPointer(ObjectPtr* ptr) {
   ObjectPtr old_target = *ptr;
@@ -5,6 +5,7 @@
 #ifndef RUNTIME_VM_HEAP_COMPACTOR_H_
 #define RUNTIME_VM_HEAP_COMPACTOR_H_
 
+#include "platform/atomic.h"
 #include "platform/growable_array.h"
 
 #include "vm/allocation.h"
@@ -30,12 +31,19 @@ class GCCompactor : public ValueObject,
         heap_(heap) {}
   ~GCCompactor() { free(image_page_ranges_); }
 
-  void Compact(OldPage* pages, FreeList* freelist, Mutex* mutex);
+  // Slides the live objects of [pages] together. The objects on
+  // [fixed_pages] stay where they are, but their pointers are forwarded. They
+  // must still be swept afterwards.
+  void Compact(OldPage* pages,
+               OldPage* fixed_pages,
+               FreeList* freelist,
+               Mutex* mutex);
 
  private:
   friend class CompactorTask;
 
   void SetupImagePageBoundaries();
+  void ForwardFixedPage(OldPage* page);
   void ForwardStackPointers();
   void ForwardPointer(ObjectPtr* ptr);
   void ForwardCompressedPointer(uword heap_base, CompressedObjectPtr* ptr);
@@ -67,6 +75,11 @@ class GCCompactor : public ValueObject,
   intptr_t image_page_hi_ = 0;
   ImagePageRange* image_page_ranges_ = nullptr;
 
+  // Pages whose objects do not move. Their forwarding pages are hidden during
+  // compaction so that pointers to their objects are left alone.
+  MallocGrowableArray<OldPage*> fixed_pages_;
+  RelaxedAtomic<intptr_t> next_fixed_page_ = {0};
+
   // The typed data views whose inner pointer must be updated after sliding is
   // complete.
   Mutex typed_data_view_mutex_;
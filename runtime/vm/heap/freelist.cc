@@ -195,6 +195,44 @@ void FreeList::Reset() {
   }
 }
 
+void FreeList::MergeFrom(FreeList* other) {
+  ASSERT(other != this);
+  // Find the tails before taking the lock, so that allocation from this
+  // freelist is not blocked while walking the other lists.
+  FreeListElement* tails[kNumLists + 1];
+  bool is_empty = true;
+  for (intptr_t i = 0; i < (kNumLists + 1); i++) {
+    FreeListElement* tail = other->free_lists_[i];
+    if (tail != NULL) {
+      while (tail->next() != NULL) {
+        tail = tail->next();
+      }
+      is_empty = false;
+    }
+    tails[i] = tail;
+  }
+  if (is_empty) {
+    return;
+  }
+
+  {
+    MutexLocker ml(&mutex_);
+    for (intptr_t i = 0; i < (kNumLists + 1); i++) {
+      if (tails[i] == NULL) {
+        continue;
+      }
+      if (free_lists_[i] == NULL && i != kNumLists) {
+        free_map_.Set(i, true);
+      }
+      tails[i]->set_next(free_lists_[i]);
+      free_lists_[i] = other->free_lists_[i];
+    }
+    last_free_small_size_ =
+        Utils::Maximum(last_free_small_size_, other->last_free_small_size_);
+  }
+  other->Reset();
+}
+
 void FreeList::EnqueueElement(FreeListElement* element, intptr_t index) {
   FreeListElement* next = free_lists_[index];
   if (next == NULL && index != kNumLists) {
@@ -82,6 +82,11 @@ class FreeList {
 
   void Reset();
 
+  // Moves all elements of 'other' to the front of this freelist and leaves
+  // 'other' empty. 'other' must not be in use by any other thread; this
+  // freelist is only locked while the lists are spliced together.
+  void MergeFrom(FreeList* other);
+
   void Print() const;
 
   Mutex* mutex() { return &mutex_; }
@@ -107,6 +107,45 @@ TEST_CASE(FreeListProtected) {
   delete free_list;
 }
 
+TEST_CASE(FreeListMergeFrom) {
+  FreeList* free_list = new FreeList();
+  FreeList* other = new FreeList();
+  const intptr_t kBlobSize = 64 * KB;
+  const intptr_t kSmallObjectSize = 4 * kWordSize;
+  const intptr_t kLargeObjectSize = 8 * KB;
+  VirtualMemory* region =
+      VirtualMemory::Allocate(kBlobSize, /* is_executable */ false, "test");
+  const uword blob = region->start();
+
+  free_list->Free(blob, kSmallObjectSize);
+  other->Free(blob + kSmallObjectSize, kSmallObjectSize);
+  other->Free(blob + 2 * kSmallObjectSize, kSmallObjectSize);
+  other->Free(blob + KB, kLargeObjectSize);
+
+  free_list->MergeFrom(other);
+
+  // The other freelist is left empty.
+  EXPECT_EQ(0u, other->TryAllocate(kSmallObjectSize, false));
+
+  // The merged elements come first, followed by the existing ones.
+  EXPECT_EQ(blob + 2 * kSmallObjectSize,
+            free_list->TryAllocate(kSmallObjectSize, false));
+  EXPECT_EQ(blob + kSmallObjectSize,
+            free_list->TryAllocate(kSmallObjectSize, false));
+  EXPECT_EQ(blob, free_list->TryAllocate(kSmallObjectSize, false));
+  EXPECT_EQ(blob + KB, free_list->TryAllocate(kLargeObjectSize, false));
+  EXPECT_EQ(0u, free_list->TryAllocate(kSmallObjectSize, false));
+
+  // Merging an empty freelist does nothing.
+  free_list->MergeFrom(other);
+  EXPECT_EQ(0u, free_list->TryAllocate(kSmallObjectSize, false));
+
+  // Delete the memory associated with the test.
+  delete region;
+  delete other;
+  delete free_list;
+}
+
 TEST_CASE(FreeListProtectedTinyObjects) {
   FreeList* free_list = new FreeList();
   const intptr_t kBlobSize = 1 * MB;
@@ -15,6 +15,7 @@
 #include "vm/globals.h"
 #include "vm/heap/become.h"
 #include "vm/heap/heap.h"
+#include "vm/heap/pointer_block.h"
 #include "vm/message_handler.h"
 #include "vm/object_graph.h"
 #include "vm/port.h"
@@ -89,6 +90,59 @@ TEST_CASE(LargeSweep) {
   }
 }
 
+ISOLATE_UNIT_TEST_CASE(LargeArrayMarkedInChunks) {
+  // Large arrays are marked in chunks which may be stolen by other markers.
+  // Make sure every chunk is visited.
+  const intptr_t kLength = 3 * 4 * KB + 17;
+  const Array& array = Array::Handle(Array::New(kLength, Heap::kOld));
+  Double& value = Double::Handle();
+  for (intptr_t i = 0; i < kLength; i++) {
+    value = Double::New(static_cast<double>(i), Heap::kOld);
+    array.SetAt(i, value);
+  }
+  GCTestHelper::CollectOldSpace();
+  GCTestHelper::CollectOldSpace();
+  for (intptr_t i = 0; i < kLength; i++) {
+    value ^= array.At(i);
+    EXPECT_EQ(static_cast<double>(i), value.value());
+  }
+}
+
+VM_UNIT_TEST_CASE(MarkingDeque) {
+  MarkingStack stack;
+  MarkingDeque deque;
+  EXPECT(deque.IsEmpty());
+  EXPECT(deque.Pop() == nullptr);
+  EXPECT(deque.Steal() == nullptr);
+
+  MarkingStackBlock* blocks[3];
+  for (intptr_t i = 0; i < 3; i++) {
+    blocks[i] = stack.PopEmptyBlock();
+    EXPECT(deque.Push(blocks[i]));
+  }
+  EXPECT(!deque.IsEmpty());
+  // The owner pops the most recent block, thieves take the oldest one.
+  EXPECT(deque.Pop() == blocks[2]);
+  EXPECT(deque.Steal() == blocks[0]);
+  EXPECT(deque.Pop() == blocks[1]);
+  EXPECT(deque.IsEmpty());
+
+  MarkingStackBlock* block = stack.PopEmptyBlock();
+  for (intptr_t i = 0; i < MarkingDeque::kCapacity; i++) {
+    EXPECT(deque.Push(block));
+  }
+  EXPECT(!deque.Push(block));
+  for (intptr_t i = 0; i < MarkingDeque::kCapacity; i++) {
+    EXPECT(deque.Steal() == block);
+  }
+  EXPECT(deque.IsEmpty());
+
+  for (intptr_t i = 0; i < 3; i++) {
+    stack.PushBlock(blocks[i]);
+  }
+  stack.PushBlock(block);
+}
+
 #ifndef PRODUCT
 static ClassPtr GetClass(const Library& lib, const char* name) {
   const Class& cls = Class::Handle(
@@ -601,7 +655,8 @@ VM_UNIT_TEST_CASE(CleanupBequestNeverReceived) {
       handle->set_ptr(string.ptr());
 
       reinterpret_cast<Isolate*>(worker)->bequeath(
-          std::unique_ptr<Bequest>(new Bequest(handle, port_id)));
+          std::unique_ptr<Bequest>(new Bequest(
+              Isolate::Current()->group(), handle, port_id)));
     }
   }
   Dart_ShutdownIsolate();
@@ -636,7 +691,8 @@ VM_UNIT_TEST_CASE(ReceivesSendAndExitMessage) {
     handle->set_ptr(string.ptr());
 
     reinterpret_cast<Isolate*>(worker)->bequeath(
-        std::unique_ptr<Bequest>(new Bequest(handle, port_id)));
+        std::unique_ptr<Bequest>(
+            new Bequest(Isolate::Current()->group(), handle, port_id)));
   }
 
   Dart_ShutdownIsolate();
@@ -22,17 +22,145 @@
 
 namespace dart {
 
+// The work list of a single marker. Full blocks are pushed onto the marker's
+// own deque instead of the shared marking stack, so that markers exchange
+// work without taking the marking stack's lock. Markers that run out of work
+// steal blocks from the other markers' deques. The shared marking stack still
+// receives the blocks filled by the write barrier and the blocks that do not
+// fit into a deque.
+class MarkingWorkList : public ValueObject {
+ public:
+  typedef MarkingStack::Block Block;
+
+  MarkingWorkList(MarkingStack* stack,
+                  MarkingDeque* deques,
+                  intptr_t num_deques,
+                  intptr_t index)
+      : stack_(stack),
+        deques_(deques),
+        num_deques_(num_deques),
+        index_(index),
+        steals_(0) {
+    ASSERT((deques_ == nullptr) || ((index_ >= 0) && (index_ < num_deques_)));
+    work_ = stack_->PopEmptyBlock();
+  }
+
+  ~MarkingWorkList() {
+    ASSERT(work_ == nullptr);
+    ASSERT(stack_ == nullptr);
+  }
+
+  // Returns nullptr if no more work was found.
+  ObjectPtr Pop() {
+    ASSERT(work_ != nullptr);
+    if (work_->IsEmpty()) {
+      Block* new_work = PopNonEmptyBlock();
+      if (new_work == nullptr) {
+        return nullptr;
+      }
+      stack_->PushBlock(work_);
+      work_ = new_work;
+      // Generated code appends to marking stacks; tell MemorySanitizer.
+      MSAN_UNPOISON(work_, sizeof(*work_));
+    }
+    return work_->Pop();
+  }
+
+  void Push(ObjectPtr raw_obj) {
+    if (work_->IsFull()) {
+      PushWork();
+    }
+    work_->Push(raw_obj);
+  }
+
+  // Pushes two entries which are kept in the same block, so that they are
+  // popped together even if the block is stolen.
+  void PushPair(ObjectPtr first, ObjectPtr second) {
+    if (work_->Count() > (Block::kSize - 2)) {
+      PushWork();
+    }
+    work_->Push(first);
+    work_->Push(second);
+  }
+
+  void Finalize() {
+    ASSERT(work_->IsEmpty());
+    ASSERT((deque() == nullptr) || deque()->IsEmpty());
+    stack_->PushBlock(work_);
+    work_ = nullptr;
+    // Fail fast on attempts to mark after finalizing.
+    stack_ = nullptr;
+  }
+
+  void AbandonWork() {
+    stack_->PushBlock(work_);
+    work_ = nullptr;
+    if (deque() != nullptr) {
+      Block* block;
+      while ((block = deque()->Pop()) != nullptr) {
+        stack_->PushBlock(block);
+      }
+    }
+    stack_ = nullptr;
+  }
+
+  intptr_t steals() const { return steals_; }
+
+ private:
+  MarkingDeque* deque() const {
+    return (deques_ == nullptr) ? nullptr : &deques_[index_];
+  }
+
+  void PushWork() {
+    if ((deque() == nullptr) || !deque()->Push(work_)) {
+      stack_->PushBlock(work_);
+    }
+    work_ = stack_->PopEmptyBlock();
+  }
+
+  Block* PopNonEmptyBlock() {
+    Block* block = (deque() == nullptr) ? nullptr : deque()->Pop();
+    if (block != nullptr) {
+      return block;
+    }
+    block = stack_->PopNonEmptyBlock();
+    if (block != nullptr) {
+      return block;
+    }
+    for (intptr_t i = 1; i < num_deques_; i++) {
+      block = deques_[(index_ + i) % num_deques_].Steal();
+      if (block != nullptr) {
+        steals_++;
+        return block;
+      }
+    }
+    return nullptr;
+  }
+
+  Block* work_;
+  MarkingStack* stack_;
+  MarkingDeque* deques_;
+  intptr_t num_deques_;
+  intptr_t index_;
+  intptr_t steals_;
+
+  DISALLOW_COPY_AND_ASSIGN(MarkingWorkList);
+};
+
 template <bool sync>
 class MarkingVisitorBase : public ObjectPointerVisitor {
  public:
   MarkingVisitorBase(IsolateGroup* isolate_group,
                      PageSpace* page_space,
                      MarkingStack* marking_stack,
-                     MarkingStack* deferred_marking_stack)
+                     MarkingStack* deferred_marking_stack,
+                     MarkingDeque* deques = nullptr,
+                     intptr_t num_deques = 0,
+                     intptr_t index = 0)
       : ObjectPointerVisitor(isolate_group),
         thread_(Thread::Current()),
         page_space_(page_space),
-        work_list_(marking_stack),
+        work_list_(marking_stack, deques, num_deques, index),
         deferred_work_list_(deferred_marking_stack),
         delayed_weak_properties_(WeakProperty::null()),
         marked_bytes_(0),
@@ -43,6 +171,7 @@ class MarkingVisitorBase : public ObjectPointerVisitor {
 
   uintptr_t marked_bytes() const { return marked_bytes_; }
   int64_t marked_micros() const { return marked_micros_; }
+  intptr_t steals() const { return work_list_.steals(); }
   void AddMicros(int64_t micros) { marked_micros_ += micros; }
 
   bool ProcessPendingWeakProperties() {
@@ -85,10 +214,22 @@ class MarkingVisitorBase : public ObjectPointerVisitor {
     do {
       do {
         // First drain the marking stacks.
+        if (!raw_obj->IsHeapObject()) {
+          // The start of a chunk of a large array, see VisitLargeArray.
+          const intptr_t start = Smi::Value(static_cast<SmiPtr>(raw_obj));
+          VisitArrayChunk(static_cast<ArrayPtr>(work_list_.Pop()), start);
+          raw_obj = work_list_.Pop();
+          continue;
+        }
+
         const intptr_t class_id = raw_obj->GetClassId();
 
         intptr_t size;
-        if (class_id != kWeakPropertyCid) {
+        if (((class_id == kArrayCid) || (class_id == kImmutableArrayCid)) &&
+            (Smi::Value(static_cast<ArrayPtr>(raw_obj)->untag()->length()) >
+             kArrayChunkLength)) {
+          size = VisitLargeArray(static_cast<ArrayPtr>(raw_obj));
+        } else if (class_id != kWeakPropertyCid) {
           size = raw_obj->untag()->VisitPointersNonvirtual(this);
         } else {
           WeakPropertyPtr raw_weak = static_cast<WeakPropertyPtr>(raw_obj);
@@ -218,6 +359,42 @@ class MarkingVisitorBase : public ObjectPointerVisitor {
   }
 
  private:
+  // Large arrays are scanned in chunks of this many elements. All but the
+  // first chunk are pushed onto the work list, so that other markers can
+  // steal them.
+  static const intptr_t kArrayChunkLength = 4 * KB;
+
+  static ObjectPtr* ArrayElementAddress(ArrayPtr raw_array, intptr_t index) {
+    return reinterpret_cast<ObjectPtr*>(UntaggedObject::ToAddr(raw_array) +
+                                        Array::data_offset()) +
+           index;
+  }
+
+  intptr_t VisitLargeArray(ArrayPtr raw_array) {
+    const intptr_t length = Smi::Value(raw_array->untag()->length());
+    for (intptr_t start = kArrayChunkLength; start < length;
+         start += kArrayChunkLength) {
+      work_list_.PushPair(raw_array, Smi::New(start));
+    }
+    // Visit the type arguments and the first chunk.
+    ObjectPtr* type_arguments = reinterpret_cast<ObjectPtr*>(
+        UntaggedObject::ToAddr(raw_array) + Array::type_arguments_offset());
+    VisitPointers(type_arguments,
+                  ArrayElementAddress(raw_array, kArrayChunkLength - 1));
+    return raw_array->untag()->HeapSize();
+  }
+
+  void VisitArrayChunk(ArrayPtr raw_array, intptr_t start) {
+    ASSERT(raw_array->IsArray() || raw_array->IsImmutableArray());
+    // Reload the length in case the array was truncated in the meantime.
+    const intptr_t length = Smi::Value(raw_array->untag()->length());
+    const intptr_t end = Utils::Minimum(start + kArrayChunkLength, length);
+    if (start < end) {
+      VisitPointers(ArrayElementAddress(raw_array, start),
+                    ArrayElementAddress(raw_array, end - 1));
+    }
+  }
+
   void PushMarked(ObjectPtr raw_obj) {
     ASSERT(raw_obj->IsHeapObject());
     ASSERT(raw_obj->IsOldObject());
@@ -282,7 +459,7 @@ class MarkingVisitorBase : public ObjectPointerVisitor {
 
   Thread* thread_;
   PageSpace* page_space_;
-  MarkerWorkList work_list_;
+  MarkingWorkList work_list_;
   MarkerWorkList deferred_work_list_;
   WeakPropertyPtr delayed_weak_properties_;
   uintptr_t marked_bytes_;
@@ -513,17 +690,19 @@ class ParallelMarkTask : public ThreadPool::Task {
  public:
   ParallelMarkTask(GCMarker* marker,
                    IsolateGroup* isolate_group,
-                   MarkingStack* marking_stack,
                    ThreadBarrier* barrier,
                    SyncMarkingVisitor* visitor,
                    RelaxedAtomic<uintptr_t>* num_busy)
       : marker_(marker),
         isolate_group_(isolate_group),
-        marking_stack_(marking_stack),
         barrier_(barrier),
         visitor_(visitor),
         num_busy_(num_busy) {}
 
+  virtual ThreadPool::Priority priority() const {
+    return ThreadPool::kHighPriority;
+  }
+
   virtual void Run() {
     bool result = Thread::EnterIsolateGroupAsHelper(
         isolate_group_, Thread::kMarkerTask, /*bypass_safepoint=*/true);
@@ -560,7 +739,7 @@ class ParallelMarkTask : public ThreadPool::Task {
           // Wait for some work to appear.
           // TODO(40695): Replace busy-waiting with a solution using Monitor,
           // and redraw the boundaries between stack/visitor/task as needed.
-          while (marking_stack_->IsEmpty() && num_busy_->load() > 0) {
+          while (marker_->IsMarkingWorkEmpty() && num_busy_->load() > 0) {
           }
 
           // If no tasks are busy, there will never be more work.
@@ -612,9 +791,23 @@ class ParallelMarkTask : public ThreadPool::Task {
       int64_t stop = OS::GetCurrentMonotonicMicros();
       visitor_->AddMicros(stop - start);
       if (FLAG_log_marker_tasks) {
-        THR_Print("Task marked %" Pd " bytes in %" Pd64 " micros.\n",
-                  visitor_->marked_bytes(), visitor_->marked_micros());
+        THR_Print("Task marked %" Pd " bytes in %" Pd64 " micros (%" Pd
+                  " steals).\n",
+                  visitor_->marked_bytes(), visitor_->marked_micros(),
+                  visitor_->steals());
+      }
+#if defined(SUPPORT_TIMELINE)
+      if (tbes.enabled()) {
+        tbes.SetNumArguments(3);
+        tbes.FormatArgument(0, "MarkedBytes", "%" Pd "",
+                            visitor_->marked_bytes());
+        tbes.FormatArgument(
+            1, "MarkedWordsPerMicro", "%" Pd64 "",
+            (visitor_->marked_bytes() >> kWordSizeLog2) /
+                Utils::Maximum<int64_t>(1, visitor_->marked_micros()));
+        tbes.FormatArgument(2, "Steals", "%" Pd "", visitor_->steals());
       }
+#endif  // defined(SUPPORT_TIMELINE)
       marker_->FinalizeResultsFrom(visitor_);
 
       delete visitor_;
@@ -624,7 +817,6 @@ class ParallelMarkTask : public ThreadPool::Task {
  private:
   GCMarker* marker_;
   IsolateGroup* isolate_group_;
-  MarkingStack* marking_stack_;
   ThreadBarrier* barrier_;
   SyncMarkingVisitor* visitor_;
   RelaxedAtomic<uintptr_t>* num_busy_;
@@ -648,6 +840,10 @@ class ConcurrentMarkTask : public ThreadPool::Task {
 #endif
   }
 
+  virtual ThreadPool::Priority priority() const {
+    return ThreadPool::kHighPriority;
+  }
+
   virtual void Run() {
     bool result = Thread::EnterIsolateGroupAsHelper(
         isolate_group_, Thread::kMarkerTask, /*bypass_safepoint=*/true);
@@ -724,12 +920,14 @@ GCMarker::GCMarker(IsolateGroup* isolate_group, Heap* heap)
       heap_(heap),
       marking_stack_(),
       visitors_(),
+      deques_(),
       marked_bytes_(0),
       marked_micros_(0) {
   visitors_ = new SyncMarkingVisitor*[FLAG_marker_tasks];
   for (intptr_t i = 0; i < FLAG_marker_tasks; i++) {
     visitors_[i] = NULL;
   }
+  deques_ = new MarkingDeque[FLAG_marker_tasks];
 }
 
 GCMarker::~GCMarker() {
@@ -743,6 +941,16 @@ GCMarker::~GCMarker() {
     }
   }
   delete[] visitors_;
+  delete[] deques_;
+}
+
+bool GCMarker::IsMarkingWorkEmpty() {
+  for (intptr_t i = 0; i < FLAG_marker_tasks; i++) {
+    if (!deques_[i].IsEmpty()) {
+      return false;
+    }
+  }
+  return marking_stack_.IsEmpty();
 }
 
 void GCMarker::StartConcurrentMark(PageSpace* page_space) {
@@ -766,8 +974,10 @@ void GCMarker::StartConcurrentMark(PageSpace* page_space) {
   ResetSlices();
   for (intptr_t i = 0; i < num_tasks; i++) {
     ASSERT(visitors_[i] == NULL);
-    visitors_[i] = new SyncMarkingVisitor(
-        isolate_group_, page_space, &marking_stack_, &deferred_marking_stack_);
+    visitors_[i] = new SyncMarkingVisitor(isolate_group_, page_space,
+                                          &marking_stack_,
+                                          &deferred_marking_stack_, deques_,
+                                          num_tasks, i);
 
     // Begin marking on a helper thread.
     bool result = Dart::thread_pool()->Run<ConcurrentMarkTask>(
@@ -821,20 +1031,19 @@ void GCMarker::MarkObjects(PageSpace* page_space) {
           visitor = visitors_[i];
           visitors_[i] = NULL;
         } else {
-          visitor =
-              new SyncMarkingVisitor(isolate_group_, page_space,
-                                     &marking_stack_, &deferred_marking_stack_);
+          visitor = new SyncMarkingVisitor(
+              isolate_group_, page_space, &marking_stack_,
+              &deferred_marking_stack_, deques_, num_tasks, i);
         }
         if (i < (num_tasks - 1)) {
           // Begin marking on a helper thread.
           bool result = Dart::thread_pool()->Run<ParallelMarkTask>(
-              this, isolate_group_, &marking_stack_, &barrier, visitor,
-              &num_busy);
+              this, isolate_group_, &barrier, visitor, &num_busy);
           ASSERT(result);
         } else {
           // Last worker is the main thread.
-          ParallelMarkTask task(this, isolate_group_, &marking_stack_, &barrier,
-                                visitor, &num_busy);
+          ParallelMarkTask task(this, isolate_group_, &barrier, visitor,
+                                &num_busy);
           task.RunEnteredIsolateGroup();
           barrier.Exit();
         }
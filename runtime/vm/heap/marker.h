@@ -56,6 +56,10 @@ class GCMarker {
   void ProcessRememberedSet(Thread* thread);
   void ProcessObjectIdTable(Thread* thread);
 
+  // Whether neither the shared marking stack nor any marker's deque has
+  // blocks left to take.
+  bool IsMarkingWorkEmpty();
+
   // Called by anyone: finalize and accumulate stats from 'visitor'.
   template <class MarkingVisitorType>
   void FinalizeResultsFrom(MarkingVisitorType* visitor);
@@ -65,6 +69,7 @@ class GCMarker {
   MarkingStack marking_stack_;
   MarkingStack deferred_marking_stack_;
   MarkingVisitorBase<true>** visitors_;
+  MarkingDeque* deques_;
 
   NewPage* new_page_;
   Monitor root_slices_monitor_;
@@ -42,14 +42,29 @@ DEFINE_FLAG(bool,
             false,
             "Print free list statistics after a GC");
 DEFINE_FLAG(bool, log_growth, false, "Log PageSpace growth policy decisions.");
+DEFINE_FLAG(int,
+            compactor_sparse_threshold,
+            100,
+            "Only compact pages whose live bytes at the last sweep were at "
+            "most this percentage of the page. Other pages are swept "
+            "concurrently instead.");
+
+DECLARE_FLAG(bool, force_evacuation);
 
 OldPage* OldPage::Allocate(intptr_t size_in_words,
                            PageType type,
                            const char* name) {
   const bool executable = type == kExecutable;
 
-  VirtualMemory* memory = VirtualMemory::AllocateAligned(
-      size_in_words << kWordSizeLog2, kOldPageSize, executable, name);
+  const intptr_t size = size_in_words << kWordSizeLog2;
+  VirtualMemory* memory = NULL;
+  if (FLAG_heap_huge_pages && !executable) {
+    memory = VirtualMemory::AllocateHugePageBacked(size, kOldPageSize);
+  }
+  if (memory == NULL) {
+    memory =
+        VirtualMemory::AllocateAligned(size, kOldPageSize, executable, name);
+  }
   if (memory == NULL) {
     return NULL;
   }
@@ -372,6 +387,9 @@ OldPage* PageSpace::AllocatePage(OldPage::PageType type, bool link) {
       (!heap_->is_vm_isolate())) {
     page->AllocateForwardingPage();
   }
+  // Count new pages as full until they are swept, so that the compactor does
+  // not mistake them for sparse pages.
+  page->set_used_in_bytes(page->object_end() - page->object_start());
   return page;
 }
 
@@ -865,6 +883,18 @@ void PageSpace::WriteProtect(bool read_only) {
   }
 }
 
+int64_t PageSpace::HugePageBackedInWords(const HugePageUsage& usage) const {
+  int64_t size = 0;
+  MutexLocker ml(&pages_lock_);
+  for (OldPage* page = pages_; page != nullptr; page = page->next()) {
+    size += usage.BackedSize(page->memory_->start(), page->memory_->end());
+  }
+  for (OldPage* page = large_pages_; page != nullptr; page = page->next()) {
+    size += usage.BackedSize(page->memory_->start(), page->memory_->end());
+  }
+  return size >> kWordSizeLog2;
+}
+
 #ifndef PRODUCT
 void PageSpace::PrintToJSONObject(JSONObject* object) const {
   auto isolate_group = IsolateGroup::Current();
@@ -877,6 +907,12 @@ void PageSpace::PrintToJSONObject(JSONObject* object) const {
   space.AddProperty64("used", UsedInWords() * kWordSize);
   space.AddProperty64("capacity", CapacityInWords() * kWordSize);
   space.AddProperty64("external", ExternalInWords() * kWordSize);
+  if (FLAG_heap_huge_pages) {
+    // Only read the OS's report when huge pages were asked for, as it is slow.
+    HugePageUsage usage;
+    space.AddProperty64("_hugePageBackedBytes",
+                        HugePageBackedInWords(usage) * kWordSize);
+  }
   space.AddProperty("time", MicrosecondsToSeconds(gc_time_micros()));
   if (collections() > 0) {
     int64_t run_time = isolate_group->UptimeMicros();
@@ -1241,13 +1277,12 @@ void PageSpace::CollectGarbageHelper(bool compact,
 
   if (compact) {
     SweepLarge();
-    Compact(thread);
-    set_phase(kDone);
+    Compact(thread, has_reservation);
   } else if (FLAG_concurrent_sweep && has_reservation) {
     ConcurrentSweep(isolate_group);
   } else {
     SweepLarge();
-    Sweep();
+    Sweep(pages_tail_);
     set_phase(kDone);
   }
 
@@ -1302,37 +1337,10 @@ void PageSpace::SweepLarge() {
   }
 }
 
-void PageSpace::Sweep() {
+void PageSpace::Sweep(OldPage* last) {
   TIMELINE_FUNCTION_GC_DURATION(Thread::Current(), "Sweep");
 
-  GCSweeper sweeper;
-
-  intptr_t shard = 0;
-  const intptr_t num_shards = Utils::Maximum(FLAG_scavenger_tasks, 1);
-  for (intptr_t i = 0; i < num_shards; i++) {
-    DataFreeList(i)->mutex()->Lock();
-  }
-
-  OldPage* prev_page = nullptr;
-  OldPage* page = pages_;
-  while (page != nullptr) {
-    OldPage* next_page = page->next();
-    ASSERT(page->type() == OldPage::kData);
-    shard = (shard + 1) % num_shards;
-    bool page_in_use =
-        sweeper.SweepPage(page, DataFreeList(shard), true /*is_locked*/);
-    if (page_in_use) {
-      prev_page = page;
-    } else {
-      FreePage(page, prev_page);
-    }
-    // Advance to the next page.
-    page = next_page;
-  }
-
-  for (intptr_t i = 0; i < num_shards; i++) {
-    DataFreeList(i)->mutex()->Unlock();
-  }
+  GCSweeper::SweepParallel(heap_->isolate_group(), pages_, last);
 
   if (FLAG_verify_after_gc) {
     OS::PrintErr("Verifying after sweeping...");
@@ -1344,19 +1352,87 @@ void PageSpace::Sweep() {
 void PageSpace::ConcurrentSweep(IsolateGroup* isolate_group) {
   // Start the concurrent sweeper task now.
   GCSweeper::SweepConcurrent(isolate_group, pages_, pages_tail_, large_pages_,
-                             large_pages_tail_, &freelists_[OldPage::kData]);
-}
+                             large_pages_tail_);
+}
+
+void PageSpace::Compact(Thread* thread, bool has_reservation) {
+  // Split the pages by the live bytes the sweeper last found on them. Only
+  // sparse pages are slid, which keeps the pause short when most of the heap
+  // is densely populated. Dense pages keep their objects in place and are
+  // swept after the pause like in mark-sweep.
+  OldPage* sparse_pages = nullptr;
+  OldPage* sparse_tail = nullptr;
+  OldPage* dense_pages = nullptr;
+  OldPage* dense_tail = nullptr;
+  {
+    MutexLocker ml(&pages_lock_);
+    const bool compact_all =
+        FLAG_force_evacuation || (FLAG_compactor_sparse_threshold >= 100);
+    OldPage* page = pages_;
+    while (page != nullptr) {
+      OldPage* next = page->next();
+      page->set_next(nullptr);
+      const intptr_t page_size = page->object_end() - page->object_start();
+      const bool is_sparse =
+          compact_all || (static_cast<intptr_t>(page->used_in_bytes()) * 100 <=
+                          page_size * FLAG_compactor_sparse_threshold);
+      OldPage** head = is_sparse ? &sparse_pages : &dense_pages;
+      OldPage** tail = is_sparse ? &sparse_tail : &dense_tail;
+      if (*head == nullptr) {
+        *head = page;
+      } else {
+        (*tail)->set_next(page);
+      }
+      *tail = page;
+      page = next;
+    }
+    pages_ = sparse_pages;
+    pages_tail_ = sparse_tail;
+  }
 
-void PageSpace::Compact(Thread* thread) {
-  thread->isolate_group()->set_compaction_in_progress(true);
-  GCCompactor compactor(thread, heap_);
-  compactor.Compact(pages_, &freelists_[OldPage::kData], &pages_lock_);
-  thread->isolate_group()->set_compaction_in_progress(false);
+  if (sparse_pages != nullptr) {
+    thread->isolate_group()->set_compaction_in_progress(true);
+    GCCompactor compactor(thread, heap_);
+    compactor.Compact(pages_, dense_pages, &freelists_[OldPage::kData],
+                      &pages_lock_);
+    thread->isolate_group()->set_compaction_in_progress(false);
 
-  if (FLAG_verify_after_gc) {
-    OS::PrintErr("Verifying after compacting...");
-    heap_->VerifyGC(kForbidMarked);
-    OS::PrintErr(" done.\n");
+    // The compacted pages are now (almost) full.
+    for (OldPage* page = pages_; page != nullptr; page = page->next()) {
+      page->set_used_in_bytes(page->object_end() - page->object_start());
+    }
+  }
+
+  if (dense_pages == nullptr) {
+    set_phase(kDone);
+    if (FLAG_verify_after_gc) {
+      OS::PrintErr("Verifying after compacting...");
+      heap_->VerifyGC(kForbidMarked);
+      OS::PrintErr(" done.\n");
+    }
+    return;
+  }
+
+  // Put the dense pages first: the sweepers free pages relative to the head
+  // of the page list, and the mutator appends new pages at the tail.
+  {
+    MutexLocker ml(&pages_lock_);
+    dense_tail->set_next(pages_);
+    if (pages_ == nullptr) {
+      pages_tail_ = dense_tail;
+    }
+    pages_ = dense_pages;
+  }
+  // Dead objects on the dense pages still point to where objects were before
+  // compaction, so the heap can only be verified once they are swept.
+  if (FLAG_concurrent_sweep && has_reservation && !FLAG_verify_after_gc) {
+    // Large pages were already swept.
+    GCSweeper::SweepConcurrent(heap_->isolate_group(), dense_pages, dense_tail,
+                               nullptr, nullptr);
+  } else {
+    // Verifies the whole heap when --verify_after_gc is given.
+    Sweep(dense_tail);
+    set_phase(kDone);
   }
 }
 
@@ -369,6 +369,9 @@ class PageSpace {
     }
     return size >> kWordSizeLog2;
   }
+  // An estimate of how much of the data pages is backed by transparent huge
+  // pages, see HugePageUsage::BackedSize.
+  int64_t HugePageBackedInWords(const HugePageUsage& usage) const;
 
   bool Contains(uword addr) const;
   bool ContainsUnsafe(uword addr) const;
@@ -559,9 +562,11 @@ class PageSpace {
                             int64_t pre_wait_for_sweepers,
                             int64_t pre_safe_point);
   void SweepLarge();
-  void Sweep();
+  // Sweeps the regular data pages from the start of the page list up to and
+  // including [last].
+  void Sweep(OldPage* last);
   void ConcurrentSweep(IsolateGroup* isolate_group);
-  void Compact(Thread* thread);
+  void Compact(Thread* thread, bool has_reservation);
 
   static intptr_t LargePageSizeInWordsFor(intptr_t size);
 
@@ -632,6 +637,7 @@ class PageSpace {
   friend class HeapSnapshotWriter;
   friend class PageSpaceController;
   friend class ConcurrentSweeperTask;
+  friend class SweepPagesState;
   friend class GCCompactor;
   friend class CompactorTask;
 
@@ -6,6 +6,7 @@
 #define RUNTIME_VM_HEAP_POINTER_BLOCK_H_
 
 #include "platform/assert.h"
+#include "platform/atomic.h"
 #include "vm/globals.h"
 #include "vm/os_thread.h"
 #include "vm/tagged_pointer.h"
@@ -247,6 +248,83 @@ class MarkingStack : public BlockStack<kMarkingStackBlockSize> {
 typedef MarkingStack::Block MarkingStackBlock;
 typedef BlockWorkList<MarkingStack> MarkerWorkList;
 
+// A bounded work-stealing deque of marking stack blocks (Chase-Lev). The
+// owning marker pushes and pops blocks at the bottom without locking, other
+// markers steal blocks from the top.
+class MarkingDeque {
+ public:
+  static const intptr_t kCapacity = 256;
+  static_assert((kCapacity & (kCapacity - 1)) == 0,
+                "kCapacity must be a power of two");
+
+  MarkingDeque() : top_(0), bottom_(0) {}
+  ~MarkingDeque() { ASSERT(IsEmpty()); }
+
+  // Owner only. Returns false if the deque is full.
+  bool Push(MarkingStackBlock* block) {
+    const intptr_t bottom = bottom_.load();
+    const intptr_t top = top_.load(std::memory_order_acquire);
+    if ((bottom - top) >= kCapacity) {
+      return false;
+    }
+    blocks_[bottom & (kCapacity - 1)].store(block);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom_.store(bottom + 1);
+    return true;
+  }
+
+  // Owner only. Returns nullptr if the deque is empty.
+  MarkingStackBlock* Pop() {
+    const intptr_t bottom = bottom_.load() - 1;
+    bottom_.store(bottom);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    intptr_t top = top_.load();
+    if (top > bottom) {
+      bottom_.store(bottom + 1);
+      return nullptr;
+    }
+    MarkingStackBlock* block = blocks_[bottom & (kCapacity - 1)].load();
+    if (top == bottom) {
+      // Last block: race against thieves for it.
+      if (!top_.compare_exchange_strong(top, top + 1,
+                                        std::memory_order_seq_cst)) {
+        block = nullptr;
+      }
+      bottom_.store(bottom + 1);
+    }
+    return block;
+  }
+
+  // Any thread. Returns nullptr if the deque is empty or if another thread
+  // took the block first.
+  MarkingStackBlock* Steal() {
+    intptr_t top = top_.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const intptr_t bottom = bottom_.load(std::memory_order_acquire);
+    if (top >= bottom) {
+      return nullptr;
+    }
+    MarkingStackBlock* block = blocks_[top & (kCapacity - 1)].load();
+    if (!top_.compare_exchange_strong(top, top + 1,
+                                      std::memory_order_seq_cst)) {
+      return nullptr;
+    }
+    return block;
+  }
+
+  bool IsEmpty() const {
+    return top_.load(std::memory_order_acquire) >=
+           bottom_.load(std::memory_order_acquire);
+  }
+
+ private:
+  RelaxedAtomic<intptr_t> top_;
+  RelaxedAtomic<intptr_t> bottom_;
+  RelaxedAtomic<MarkingStackBlock*> blocks_[kCapacity];
+
+  DISALLOW_COPY_AND_ASSIGN(MarkingDeque);
+};
+
 static const int kPromotionStackBlockSize = 64;
 class PromotionStack : public BlockStack<kPromotionStackBlockSize> {
  public:
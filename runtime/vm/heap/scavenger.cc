@@ -121,6 +121,16 @@ class ScavengerVisitorBase : public ObjectPointerVisitor {
         promoted_list_(promotion_stack),
         delayed_weak_properties_(WeakProperty::null()) {}
 
+  // Lets this visitor steal unscanned to-space pages from the other workers of
+  // a parallel scavenge.
+  void set_workers(ScavengerVisitorBase<parallel>** workers,
+                   intptr_t num_workers,
+                   intptr_t worker_index) {
+    workers_ = workers;
+    num_workers_ = num_workers;
+    worker_index_ = worker_index;
+  }
+
   virtual void VisitTypedDataViewPointers(TypedDataViewPtr view,
                                           ObjectPtr* first,
                                           ObjectPtr* last) {
@@ -213,6 +223,7 @@ class ScavengerVisitorBase : public ObjectPointerVisitor {
     thread_ = Thread::Current();
     page_space_->AcquireLock(freelist_);
 
+    WorkTimer timer(this);
     LongJumpScope jump;
     if (setjmp(*jump.Set()) == 0) {
       scavenger_->IterateRoots(this);
@@ -223,6 +234,7 @@ class ScavengerVisitorBase : public ObjectPointerVisitor {
   }
 
   void ProcessSurvivors() {
+    WorkTimer timer(this);
     LongJumpScope jump;
     if (setjmp(*jump.Set()) == 0) {
       // Iterate until all work has been drained.
@@ -237,6 +249,7 @@ class ScavengerVisitorBase : public ObjectPointerVisitor {
   }
 
   void ProcessAll() {
+    WorkTimer timer(this);
     LongJumpScope jump;
     if (setjmp(*jump.Set()) == 0) {
       do {
@@ -256,8 +269,27 @@ class ScavengerVisitorBase : public ObjectPointerVisitor {
 
   bool HasWork() {
     if (scavenger_->abort_) return false;
-    return (scan_ != tail_) || (scan_ != nullptr && !scan_->IsResolved()) ||
-           !promoted_list_.IsEmpty();
+    return (scan_ != nullptr && !scan_->IsResolved()) ||
+           (tail_ != nullptr && !tail_->IsResolved()) ||
+           (pending_pages_count_ > 0) || !promoted_list_.IsEmpty();
+  }
+
+  // Moves an unscanned to-space page of another worker into this worker's
+  // pending pages. Returns false if no other worker had a page to spare.
+  bool TryStealWork() {
+    ASSERT(parallel);
+    for (intptr_t i = 1; i < num_workers_; i++) {
+      ScavengerVisitorBase<parallel>* victim =
+          workers_[(worker_index_ + i) % num_workers_];
+      if (victim->pending_pages_count_ == 0) continue;
+      NewPage* page = victim->PopPendingPage();
+      if (page != nullptr) {
+        PushPendingPage(page);
+        stolen_pages_++;
+        return true;
+      }
+    }
+    return false;
   }
 
   void Finalize() {
@@ -266,9 +298,12 @@ class ScavengerVisitorBase : public ObjectPointerVisitor {
     } else {
       ASSERT(!HasWork());
 
+      ASSERT(pending_pages_.is_empty());
       for (NewPage* page = head_; page != nullptr; page = page->next()) {
         ASSERT(page->IsResolved());
         page->RecordSurvivors();
+        copied_in_words_ +=
+            (page->top_ - page->object_start()) >> kWordSizeLog2;
       }
 
       promoted_list_.Finalize();
@@ -282,7 +317,47 @@ class ScavengerVisitorBase : public ObjectPointerVisitor {
   NewPage* head() const { return head_; }
   NewPage* tail() const { return tail_; }
 
+  ScavengeWorkerStats stats() const {
+    ScavengeWorkerStats stats;
+    stats.work_micros = work_micros_;
+    stats.copied_in_words = copied_in_words_;
+    stats.promoted_in_words = bytes_promoted_ >> kWordSizeLog2;
+    stats.stolen_pages = stolen_pages_;
+    return stats;
+  }
+
  private:
+  // Accumulates the time this worker spends processing, as opposed to waiting
+  // for work or for the other workers.
+  class WorkTimer : public ValueObject {
+   public:
+    explicit WorkTimer(ScavengerVisitorBase<parallel>* visitor)
+        : visitor_(visitor), start_(OS::GetCurrentMonotonicMicros()) {}
+    ~WorkTimer() {
+      visitor_->work_micros_ += OS::GetCurrentMonotonicMicros() - start_;
+    }
+
+   private:
+    ScavengerVisitorBase<parallel>* visitor_;
+    int64_t start_;
+  };
+
+  void PushPendingPage(NewPage* page) {
+    MutexLocker ml(&pending_pages_lock_);
+    pending_pages_.Add(page);
+    pending_pages_count_ = pending_pages_.length();
+  }
+
+  NewPage* PopPendingPage() {
+    MutexLocker ml(&pending_pages_lock_);
+    if (pending_pages_.is_empty()) {
+      return nullptr;
+    }
+    NewPage* page = pending_pages_.RemoveLast();
+    pending_pages_count_ = pending_pages_.length();
+    return page;
+  }
+
   void UpdateStoreBuffer(ObjectPtr obj) {
     ASSERT(obj->IsHeapObject());
     // If the newly written object is not a new object, drop it immediately.
@@ -501,6 +576,20 @@ class ScavengerVisitorBase : public ObjectPointerVisitor {
   NewPage* tail_ = nullptr;  // Allocating from here.
   NewPage* scan_ = nullptr;  // Resolving from here.
 
+  // Pages that have been filled but not yet scanned, excluding tail_ and
+  // scan_. Any worker may take pages from here.
+  Mutex pending_pages_lock_;
+  MallocGrowableArray<NewPage*> pending_pages_;
+  RelaxedAtomic<intptr_t> pending_pages_count_ = {0};
+
+  ScavengerVisitorBase<parallel>** workers_ = nullptr;
+  intptr_t num_workers_ = 1;
+  intptr_t worker_index_ = 0;
+
+  int64_t work_micros_ = 0;
+  intptr_t copied_in_words_ = 0;
+  intptr_t stolen_pages_ = 0;
+
   DISALLOW_COPY_AND_ASSIGN(ScavengerVisitorBase);
 };
 
@@ -545,6 +634,10 @@ class ParallelScavengerTask : public ThreadPool::Task {
         visitor_(visitor),
         num_busy_(num_busy) {}
 
+  virtual ThreadPool::Priority priority() const {
+    return ThreadPool::kHighPriority;
+  }
+
   virtual void Run() {
     bool result = Thread::EnterIsolateGroupAsHelper(
         isolate_group_, Thread::kScavengerTask, /*bypass_safepoint=*/true);
@@ -573,10 +666,11 @@ class ParallelScavengerTask : public ThreadPool::Task {
         // then there will never be more work (NB: 1 is *before* decrement).
         if (num_busy_->fetch_sub(1u) == 1) break;
 
-        // Wait for some work to appear.
+        // Wait for some work to appear, or steal some from a busy worker.
         // TODO(iposva): Replace busy-waiting with a solution using Monitor,
         // and redraw the boundaries between stack/visitor/task as needed.
-        while (!visitor_->HasWork() && num_busy_->load() > 0) {
+        while (!visitor_->HasWork() && !visitor_->TryStealWork() &&
+               num_busy_->load() > 0) {
         }
 
         // If no tasks are busy, there will never be more work.
@@ -688,11 +782,16 @@ NewPage* NewPage::Allocate() {
     const intptr_t alignment = kNewPageSize;
     const bool is_executable = false;
     const char* const name = Heap::RegionName(Heap::kNew);
-    memory =
-        VirtualMemory::AllocateAligned(size, alignment, is_executable, name);
-  }
-  if (memory == nullptr) {
-    return nullptr;  // Out of memory.
+    if (FLAG_heap_huge_pages) {
+      memory = VirtualMemory::AllocateHugePageBacked(size, alignment);
+    }
+    if (memory == nullptr) {
+      memory =
+          VirtualMemory::AllocateAligned(size, alignment, is_executable, name);
+    }
+    if (memory == nullptr) {
+      return nullptr;  // Out of memory.
+    }
   }
 
 #if defined(DEBUG)
@@ -737,6 +836,26 @@ void NewPage::Deallocate() {
   delete memory;
 }
 
+void SemiSpace::Prefault(intptr_t size_in_words) {
+  const intptr_t num_pages =
+      Utils::Minimum(size_in_words / kNewPageSizeInWords, kPageCacheCapacity);
+  NewPage* pages[kPageCacheCapacity];
+  for (intptr_t i = 0; i < num_pages; i++) {
+    pages[i] = NewPage::Allocate();
+    if (pages[i] == nullptr) {
+      while (--i >= 0) {
+        pages[i]->Deallocate();
+      }
+      return;  // Out of memory.
+    }
+    pages[i]->Prefault();
+  }
+  // Allocate takes pages from the cache before mapping new ones.
+  for (intptr_t i = 0; i < num_pages; i++) {
+    pages[i]->Deallocate();
+  }
+}
+
 NewPage* SemiSpace::TryAllocatePageLocked(bool link) {
   if (capacity_in_words_ >= max_capacity_in_words_) {
     return nullptr;  // Full.
@@ -808,6 +927,12 @@ Scavenger::Scavenger(Heap* heap, intptr_t max_semi_capacity_in_words)
   const intptr_t initial_semi_capacity_in_words = Utils::Minimum(
       max_semi_capacity_in_words, FLAG_new_gen_semi_initial_size * MBInWords);
 
+  if (FLAG_new_gen_prefault) {
+    // Fault in the pages of the initial semi-space before the mutator needs
+    // them. Later growth is gradual, so those pages are faulted in on first
+    // use.
+    SemiSpace::Prefault(initial_semi_capacity_in_words);
+  }
   to_ = new SemiSpace(initial_semi_capacity_in_words);
   idle_scavenge_threshold_in_words_ = initial_semi_capacity_in_words;
 
@@ -1215,18 +1340,25 @@ void Scavenger::MournWeakHandles() {
 
 template <bool parallel>
 void ScavengerVisitorBase<parallel>::ProcessToSpace() {
-  while (scan_ != nullptr) {
-    uword resolved_top = scan_->resolved_top_;
-    while (resolved_top < scan_->top_) {
-      ObjectPtr raw_obj = UntaggedObject::FromAddr(resolved_top);
-      resolved_top += ProcessCopied(raw_obj);
+  for (;;) {
+    if (scan_ != nullptr) {
+      // If scan_ is tail_, processing may copy more objects into it, so top_
+      // must be reread.
+      uword resolved_top = scan_->resolved_top_;
+      while (resolved_top < scan_->top_) {
+        ObjectPtr raw_obj = UntaggedObject::FromAddr(resolved_top);
+        resolved_top += ProcessCopied(raw_obj);
+      }
+      scan_->resolved_top_ = resolved_top;
     }
-    scan_->resolved_top_ = resolved_top;
 
-    NewPage* next = scan_->next();
+    NewPage* next = PopPendingPage();
     if (next == nullptr) {
-      // Don't update scan_. More objects may yet be copied to this TLAB.
-      return;
+      if ((tail_ == nullptr) || tail_->IsResolved()) {
+        // Don't update scan_. More objects may yet be copied to the tail.
+        return;
+      }
+      next = tail_;
     }
     scan_ = next;
   }
@@ -1533,10 +1665,14 @@ uword ScavengerVisitorBase<parallel>::TryAllocateCopySlow(intptr_t size) {
   }
 
   if (head_ == nullptr) {
-    head_ = scan_ = page;
+    head_ = page;
   } else {
-    ASSERT(scan_ != nullptr);
     tail_->set_next(page);
+    // The old tail is now full. Unless this worker is scanning it already,
+    // publish it so that it can be scanned by an idle worker.
+    if ((tail_ != scan_) && !tail_->IsResolved()) {
+      PushPendingPage(tail_);
+    }
   }
   tail_ = page;
 
@@ -1636,6 +1772,8 @@ intptr_t Scavenger::SerialScavenge(SemiSpace* from) {
   visitor.Finalize();
 
   to_->AddList(visitor.head(), visitor.tail());
+  last_worker_stats_.Clear();
+  last_worker_stats_.Add(visitor.stats());
   return visitor.bytes_promoted();
 }
 
@@ -1653,6 +1791,9 @@ intptr_t Scavenger::ParallelScavenge(SemiSpace* from) {
     FreeList* freelist = heap_->old_space()->DataFreeList(i);
     visitors[i] = new ParallelScavengerVisitor(
         heap_->isolate_group(), this, from, freelist, &promotion_stack_);
+    visitors[i]->set_workers(visitors, num_tasks, i);
+  }
+  for (intptr_t i = 0; i < num_tasks; i++) {
     if (i < (num_tasks - 1)) {
       // Begin scavenging on a helper thread.
       bool result = Dart::thread_pool()->Run<ParallelScavengerTask>(
@@ -1667,9 +1808,11 @@ intptr_t Scavenger::ParallelScavenge(SemiSpace* from) {
     }
   }
 
+  last_worker_stats_.Clear();
   for (intptr_t i = 0; i < num_tasks; i++) {
     to_->AddList(visitors[i]->head(), visitors[i]->tail());
     bytes_promoted += visitors[i]->bytes_promoted();
+    last_worker_stats_.Add(visitors[i]->stats());
     delete visitors[i];
   }
 
@@ -1756,6 +1899,15 @@ void Scavenger::WriteProtect(bool read_only) {
   to_->WriteProtect(read_only);
 }
 
+int64_t Scavenger::HugePageBackedInWords(const HugePageUsage& usage) const {
+  MutexLocker ml(&space_lock_);
+  int64_t size = 0;
+  for (NewPage* page = to_->head(); page != nullptr; page = page->next()) {
+    size += usage.BackedSize(page->start(), page->end());
+  }
+  return size >> kWordSizeLog2;
+}
+
 #ifndef PRODUCT
 void Scavenger::PrintToJSONObject(JSONObject* object) const {
   auto isolate_group = IsolateGroup::Current();
@@ -1779,7 +1931,24 @@ void Scavenger::PrintToJSONObject(JSONObject* object) const {
   space.AddProperty64("used", UsedInWords() * kWordSize);
   space.AddProperty64("capacity", CapacityInWords() * kWordSize);
   space.AddProperty64("external", ExternalInWords() * kWordSize);
+  if (FLAG_heap_huge_pages) {
+    // Only read the OS's report when huge pages were asked for, as it is slow.
+    HugePageUsage usage;
+    space.AddProperty64("_hugePageBackedBytes",
+                        HugePageBackedInWords(usage) * kWordSize);
+  }
   space.AddProperty("time", MicrosecondsToSeconds(gc_time_micros()));
+  if (!last_worker_stats_.is_empty()) {
+    JSONArray workers(&space, "_lastScavengeWorkers");
+    for (intptr_t i = 0; i < last_worker_stats_.length(); i++) {
+      const ScavengeWorkerStats& stats = last_worker_stats_[i];
+      JSONObject worker(&workers);
+      worker.AddProperty64("workMicros", stats.work_micros);
+      worker.AddProperty64("copied", stats.copied_in_words * kWordSize);
+      worker.AddProperty64("promoted", stats.promoted_in_words * kWordSize);
+      worker.AddProperty64("stolenPages", stats.stolen_pages);
+    }
+  }
 }
 #endif  // !PRODUCT
 
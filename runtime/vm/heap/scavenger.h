@@ -6,6 +6,7 @@
 #define RUNTIME_VM_HEAP_SCAVENGER_H_
 
 #include "platform/assert.h"
+#include "platform/growable_array.h"
 #include "platform/utils.h"
 
 #include "vm/dart.h"
@@ -41,6 +42,7 @@ class NewPage {
   uword start() const { return memory_->start(); }
   uword end() const { return memory_->end(); }
   bool Contains(uword addr) const { return memory_->Contains(addr); }
+  void Prefault() { memory_->Prefault(); }
   void WriteProtect(bool read_only) {
     memory_->Protect(read_only ? VirtualMemory::kReadOnly
                                : VirtualMemory::kReadWrite);
@@ -170,6 +172,10 @@ class SemiSpace {
   static void Cleanup();
   static intptr_t CachedSize();
 
+  // Allocates the pages for a semi-space of the given size and faults them in,
+  // leaving them in the page cache for the next allocations.
+  static void Prefault(intptr_t size_in_words);
+
   explicit SemiSpace(intptr_t max_capacity_in_words);
   ~SemiSpace();
 
@@ -196,6 +202,14 @@ class SemiSpace {
   NewPage* tail_ = nullptr;
 };
 
+// The work done by a single scavenger worker.
+struct ScavengeWorkerStats {
+  int64_t work_micros = 0;
+  intptr_t copied_in_words = 0;
+  intptr_t promoted_in_words = 0;
+  intptr_t stolen_pages = 0;
+};
+
 // Statistics for a particular scavenge.
 class ScavengeStats {
  public:
@@ -286,6 +300,7 @@ class Scavenger {
   }
   int64_t CapacityInWords() const { return to_->max_capacity_in_words(); }
   int64_t ExternalInWords() const { return external_size_ >> kWordSizeLog2; }
+  int64_t HugePageBackedInWords(const HugePageUsage& usage) const;
   SpaceUsage GetCurrentUsage() const {
     SpaceUsage usage;
     usage.used_in_words = UsedInWords();
@@ -432,6 +447,7 @@ class Scavenger {
   intptr_t collections_;
   static const int kStatsHistoryCapacity = 4;
   RingBuffer<ScavengeStats, kStatsHistoryCapacity> stats_history_;
+  MallocGrowableArray<ScavengeWorkerStats> last_worker_stats_;
 
   intptr_t scavenge_words_per_micro_;
   intptr_t idle_scavenge_threshold_in_words_;
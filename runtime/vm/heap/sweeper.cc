@@ -5,11 +5,13 @@
 #include "vm/heap/sweeper.h"
 
 #include "vm/globals.h"
+#include "vm/flags.h"
 #include "vm/heap/freelist.h"
 #include "vm/heap/heap.h"
 #include "vm/heap/pages.h"
 #include "vm/heap/safepoint.h"
 #include "vm/lockers.h"
+#include "vm/thread_barrier.h"
 #include "vm/thread_pool.h"
 #include "vm/timeline.h"
 
@@ -107,97 +109,203 @@ intptr_t GCSweeper::SweepLargePage(OldPage* page) {
   return words_to_end;
 }
 
+// The data pages swept by one group of sweeper tasks. The tasks claim
+// batches of consecutive pages and sweep them into a private freelist, which
+// is spliced into one of the shared data freelists once the batch is done.
+// Empty pages are only freed after all tasks are done, because unlinking a
+// page writes to its predecessor, which might belong to another task's batch.
+class SweepPagesState {
+ public:
+  static constexpr intptr_t kPagesPerBatch = 8;
+
+  SweepPagesState(PageSpace* old_space, OldPage* first, OldPage* last)
+      : old_space_(old_space), pages_(nullptr), num_pages_(0) {
+    if (first != nullptr) {
+      // Don't access last->next(), which would be a race with the mutator
+      // allocating new pages.
+      for (OldPage* page = first;; page = page->next()) {
+        num_pages_++;
+        if (page == last) break;
+      }
+      pages_ = new OldPage*[num_pages_];
+      OldPage* page = first;
+      for (intptr_t i = 0; i < num_pages_; i++) {
+        pages_[i] = page;
+        if (page != last) page = page->next();
+      }
+    }
+    const intptr_t num_batches =
+        Utils::RoundUp(num_pages_, kPagesPerBatch) / kPagesPerBatch;
+    num_tasks_ = Utils::Minimum<intptr_t>(
+        Utils::Maximum<intptr_t>(FLAG_sweeper_tasks, 1),
+        Utils::Maximum<intptr_t>(num_batches, 1));
+    num_running_.store(num_tasks_);
+  }
+
+  ~SweepPagesState() { delete[] pages_; }
+
+  intptr_t num_tasks() const { return num_tasks_; }
+
+  // Sweeps batches of pages until none are left. Returns true if the caller
+  // was the last task to finish.
+  bool SweepBatches(bool notify) {
+    GCSweeper sweeper;
+    FreeList freelist;
+    const intptr_t num_shards = Utils::Maximum(FLAG_scavenger_tasks, 1);
+    while (true) {
+      const intptr_t start = next_page_.fetch_add(kPagesPerBatch);
+      if (start >= num_pages_) break;
+      const intptr_t end = Utils::Minimum(start + kPagesPerBatch, num_pages_);
+      {
+        MutexLocker ml(freelist.mutex());
+        for (intptr_t i = start; i < end; i++) {
+          ASSERT(pages_[i]->type() == OldPage::kData);
+          sweeper.SweepPage(pages_[i], &freelist, true /*is_locked*/);
+        }
+      }
+      const intptr_t shard = next_shard_.fetch_add(1) % num_shards;
+      old_space_->DataFreeList(shard)->MergeFrom(&freelist);
+      if (notify) {
+        // Notify the mutator thread that we have added elements to the free
+        // list.
+        MonitorLocker ml(old_space_->tasks_lock());
+        ml.Notify();
+      }
+    }
+    // The acquire-release decrement makes the sweeping done by this task
+    // visible to the last task, which frees the empty pages.
+    return num_running_.fetch_sub(1) == 1;
+  }
+
+  void FreeEmptyPages() {
+    OldPage* prev_page = nullptr;
+    for (intptr_t i = 0; i < num_pages_; i++) {
+      OldPage* page = pages_[i];
+      if (page->used_in_bytes() == 0) {
+        old_space_->FreePage(page, prev_page);
+      } else {
+        prev_page = page;
+      }
+    }
+  }
+
+ private:
+  PageSpace* old_space_;
+  OldPage** pages_;
+  intptr_t num_pages_;
+  intptr_t num_tasks_;
+  RelaxedAtomic<intptr_t> next_page_ = {0};
+  RelaxedAtomic<intptr_t> next_shard_ = {0};
+  AcqRelAtomic<intptr_t> num_running_ = {0};
+
+  DISALLOW_COPY_AND_ASSIGN(SweepPagesState);
+};
+
+class ParallelSweeperTask : public ThreadPool::Task {
+ public:
+  ParallelSweeperTask(IsolateGroup* isolate_group,
+                      ThreadBarrier* barrier,
+                      SweepPagesState* state)
+      : isolate_group_(isolate_group), barrier_(barrier), state_(state) {}
+
+  virtual ThreadPool::Priority priority() const {
+    return ThreadPool::kHighPriority;
+  }
+
+  virtual void Run() {
+    bool result = Thread::EnterIsolateGroupAsHelper(
+        isolate_group_, Thread::kSweeperTask, /*bypass_safepoint=*/true);
+    ASSERT(result);
+
+    RunEnteredIsolateGroup();
+
+    Thread::ExitIsolateGroupAsHelper(/*bypass_safepoint=*/true);
+
+    // This task is done. Notify the original thread.
+    barrier_->Exit();
+  }
+
+  void RunEnteredIsolateGroup() {
+    TIMELINE_FUNCTION_GC_DURATION(Thread::Current(), "ParallelSweep");
+    state_->SweepBatches(/*notify=*/false);
+  }
+
+ private:
+  IsolateGroup* isolate_group_;
+  ThreadBarrier* barrier_;
+  SweepPagesState* state_;
+
+  DISALLOW_COPY_AND_ASSIGN(ParallelSweeperTask);
+};
+
+void GCSweeper::SweepParallel(IsolateGroup* isolate_group,
+                              OldPage* first,
+                              OldPage* last) {
+  Heap* heap = isolate_group->heap();
+  SweepPagesState state(heap->old_space(), first, last);
+  const intptr_t num_tasks = state.num_tasks();
+  {
+    ThreadBarrier barrier(num_tasks, heap->barrier(), heap->barrier_done());
+    for (intptr_t i = 0; i < num_tasks; i++) {
+      if (i < (num_tasks - 1)) {
+        // Begin sweeping on a helper thread.
+        bool result = Dart::thread_pool()->Run<ParallelSweeperTask>(
+            isolate_group, &barrier, &state);
+        ASSERT(result);
+      } else {
+        // Last worker is the main thread.
+        ParallelSweeperTask task(isolate_group, &barrier, &state);
+        task.RunEnteredIsolateGroup();
+        barrier.Exit();
+      }
+    }
+  }
+  state.FreeEmptyPages();
+}
+
 class ConcurrentSweeperTask : public ThreadPool::Task {
  public:
   ConcurrentSweeperTask(IsolateGroup* isolate_group,
                         PageSpace* old_space,
-                        OldPage* first,
-                        OldPage* last,
+                        SweepPagesState* state,
+                        bool sweep_large,
                         OldPage* large_first,
                         OldPage* large_last)
       : task_isolate_group_(isolate_group),
         old_space_(old_space),
-        first_(first),
-        last_(last),
+        state_(state),
+        sweep_large_(sweep_large),
         large_first_(large_first),
         large_last_(large_last) {
     ASSERT(task_isolate_group_ != NULL);
-    ASSERT(first_ != NULL);
     ASSERT(old_space_ != NULL);
-    ASSERT(last_ != NULL);
-    MonitorLocker ml(old_space_->tasks_lock());
-    old_space_->set_tasks(old_space_->tasks() + 1);
-    old_space_->set_phase(PageSpace::kSweepingLarge);
+    ASSERT(state_ != NULL);
+  }
+
+  virtual ThreadPool::Priority priority() const {
+    return ThreadPool::kHighPriority;
   }
 
   virtual void Run() {
     bool result = Thread::EnterIsolateGroupAsHelper(
         task_isolate_group_, Thread::kSweeperTask, /*bypass_safepoint=*/true);
     ASSERT(result);
+    bool is_last = false;
     {
       Thread* thread = Thread::Current();
       ASSERT(thread->BypassSafepoints());  // Or we should be checking in.
       TIMELINE_FUNCTION_GC_DURATION(thread, "ConcurrentSweep");
-      GCSweeper sweeper;
-
-      OldPage* page = large_first_;
-      OldPage* prev_page = NULL;
-      while (page != NULL) {
-        OldPage* next_page;
-        if (page == large_last_) {
-          // Don't access page->next(), which would be a race with mutator
-          // allocating new pages.
-          next_page = NULL;
-        } else {
-          next_page = page->next();
-        }
-        ASSERT(page->type() == OldPage::kData);
-        const intptr_t words_to_end = sweeper.SweepLargePage(page);
-        if (words_to_end == 0) {
-          old_space_->FreeLargePage(page, prev_page);
-        } else {
-          old_space_->TruncateLargePage(page, words_to_end << kWordSizeLog2);
-          prev_page = page;
-        }
-        page = next_page;
-      }
 
-      {
-        MonitorLocker ml(old_space_->tasks_lock());
-        ASSERT(old_space_->phase() == PageSpace::kSweepingLarge);
-        old_space_->set_phase(PageSpace::kSweepingRegular);
-        ml.NotifyAll();
+      // One task sweeps the large pages while the others start on the data
+      // pages.
+      if (sweep_large_) {
+        SweepLargePages();
       }
 
-      intptr_t shard = 0;
-      const intptr_t num_shards = Utils::Maximum(FLAG_scavenger_tasks, 1);
-      page = first_;
-      prev_page = NULL;
-      while (page != NULL) {
-        OldPage* next_page;
-        if (page == last_) {
-          // Don't access page->next(), which would be a race with mutator
-          // allocating new pages.
-          next_page = NULL;
-        } else {
-          next_page = page->next();
-        }
-        ASSERT(page->type() == OldPage::kData);
-        shard = (shard + 1) % num_shards;
-        bool page_in_use =
-            sweeper.SweepPage(page, old_space_->DataFreeList(shard), false);
-        if (page_in_use) {
-          prev_page = page;
-        } else {
-          old_space_->FreePage(page, prev_page);
-        }
-        {
-          // Notify the mutator thread that we have added elements to the free
-          // list or that more capacity is available.
-          MonitorLocker ml(old_space_->tasks_lock());
-          ml.Notify();
-        }
-        page = next_page;
+      is_last = state_->SweepBatches(/*notify=*/true);
+      if (is_last) {
+        state_->FreeEmptyPages();
+        delete state_;
       }
     }
     // Exit isolate cleanly *before* notifying it, to avoid shutdown race.
@@ -206,17 +314,49 @@ class ConcurrentSweeperTask : public ThreadPool::Task {
     {
       MonitorLocker ml(old_space_->tasks_lock());
       old_space_->set_tasks(old_space_->tasks() - 1);
-      ASSERT(old_space_->phase() == PageSpace::kSweepingRegular);
-      old_space_->set_phase(PageSpace::kDone);
+      if (is_last) {
+        ASSERT(old_space_->phase() == PageSpace::kSweepingRegular);
+        old_space_->set_phase(PageSpace::kDone);
+      }
       ml.NotifyAll();
     }
   }
 
  private:
+  void SweepLargePages() {
+    GCSweeper sweeper;
+    OldPage* page = large_first_;
+    OldPage* prev_page = NULL;
+    while (page != NULL) {
+      OldPage* next_page;
+      if (page == large_last_) {
+        // Don't access page->next(), which would be a race with mutator
+        // allocating new pages.
+        next_page = NULL;
+      } else {
+        next_page = page->next();
+      }
+      ASSERT(page->type() == OldPage::kData);
+      const intptr_t words_to_end = sweeper.SweepLargePage(page);
+      if (words_to_end == 0) {
+        old_space_->FreeLargePage(page, prev_page);
+      } else {
+        old_space_->TruncateLargePage(page, words_to_end << kWordSizeLog2);
+        prev_page = page;
+      }
+      page = next_page;
+    }
+
+    MonitorLocker ml(old_space_->tasks_lock());
+    ASSERT(old_space_->phase() == PageSpace::kSweepingLarge);
+    old_space_->set_phase(PageSpace::kSweepingRegular);
+    ml.NotifyAll();
+  }
+
   IsolateGroup* task_isolate_group_;
   PageSpace* old_space_;
-  OldPage* first_;
-  OldPage* last_;
+  SweepPagesState* state_;
+  bool sweep_large_;
   OldPage* large_first_;
   OldPage* large_last_;
 };
@@ -225,12 +365,27 @@ void GCSweeper::SweepConcurrent(IsolateGroup* isolate_group,
                                 OldPage* first,
                                 OldPage* last,
                                 OldPage* large_first,
-                                OldPage* large_last,
-                                FreeList* freelist) {
-  bool result = Dart::thread_pool()->Run<ConcurrentSweeperTask>(
-      isolate_group, isolate_group->heap()->old_space(), first, last,
-      large_first, large_last);
-  ASSERT(result);
+                                OldPage* large_last) {
+  ASSERT(first != NULL);
+  ASSERT(last != NULL);
+  PageSpace* old_space = isolate_group->heap()->old_space();
+  // Deleted by the last task to finish.
+  SweepPagesState* state = new SweepPagesState(old_space, first, last);
+  const intptr_t num_tasks = state->num_tasks();
+  {
+    // Bulk increase task count before starting any task, instead of
+    // incrementing as each task is started, to prevent a task which
+    // races ahead from falsely believing it was the last task to complete.
+    MonitorLocker ml(old_space->tasks_lock());
+    old_space->set_tasks(old_space->tasks() + num_tasks);
+    old_space->set_phase(PageSpace::kSweepingLarge);
+  }
+  for (intptr_t i = 0; i < num_tasks; i++) {
+    bool result = Dart::thread_pool()->Run<ConcurrentSweeperTask>(
+        isolate_group, old_space, state, /*sweep_large=*/i == 0, large_first,
+        large_last);
+    ASSERT(result);
+  }
 }
 
 }  // namespace dart
@@ -34,13 +34,19 @@ class GCSweeper {
   // last marked object.
   intptr_t SweepLargePage(OldPage* page);
 
+  // Sweep the regular sized data pages between first and last inclusive,
+  // splitting the pages between up to FLAG_sweeper_tasks tasks. The calling
+  // thread is one of them, and the pages are swept when this returns.
+  static void SweepParallel(IsolateGroup* isolate_group,
+                            OldPage* first,
+                            OldPage* last);
+
   // Sweep the regular sized data pages between first and last inclusive.
   static void SweepConcurrent(IsolateGroup* isolate_group,
                               OldPage* first,
                               OldPage* last,
                               OldPage* large_first,
-                              OldPage* large_last,
-                              FreeList* freelist);
+                              OldPage* large_last);
 };
 
 }  // namespace dart
@@ -31,6 +31,7 @@
 #include "vm/lockers.h"
 #include "vm/log.h"
 #include "vm/message_handler.h"
+#include "vm/message_snapshot.h"
 #include "vm/object.h"
 #include "vm/object_id_ring.h"
 #include "vm/object_store.h"
@@ -882,10 +883,8 @@ NoOOBMessageScope::~NoOOBMessageScope() {
 }
 
 Bequest::~Bequest() {
-  IsolateGroup* isolate_group = IsolateGroup::Current();
-  CHECK_ISOLATE_GROUP(isolate_group);
-  NoSafepointScope no_safepoint_scope;
-  ApiState* state = isolate_group->api_state();
+  ASSERT(isolate_group_ != nullptr);
+  ApiState* state = isolate_group_->api_state();
   ASSERT(state != nullptr);
   state->FreePersistentHandle(handle_);
 }
@@ -1350,6 +1349,8 @@ MessageHandler::MessageStatus IsolateMessageHandler::HandleMessage(
     PersistentHandle* handle = bequest->handle();
     const Object& obj = Object::Handle(zone, handle->ptr());
     msg_obj = obj.ptr();
+  } else if (message->IsClustered()) {
+    msg_obj = ReadClusteredMessage(thread, message.get());
   } else {
     MessageSnapshotReader reader(message.get(), thread);
     msg_obj = reader.ReadObject();
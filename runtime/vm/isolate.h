@@ -949,16 +949,25 @@ class IsolateGroup : public IntrusiveDListEntry<IsolateGroup> {
 
 // When an isolate sends-and-exits this class represent things that it passed
 // to the beneficiary.
+//
+// The handle is freed in the isolate group that allocated it, since a bequest
+// may be deleted on a thread that is not part of that group, e.g. when its
+// message is dropped.
 class Bequest {
  public:
-  Bequest(PersistentHandle* handle, Dart_Port beneficiary)
-      : handle_(handle), beneficiary_(beneficiary) {}
+  Bequest(IsolateGroup* isolate_group,
+          PersistentHandle* handle,
+          Dart_Port beneficiary)
+      : isolate_group_(isolate_group),
+        handle_(handle),
+        beneficiary_(beneficiary) {}
   ~Bequest();
 
   PersistentHandle* handle() { return handle_; }
   Dart_Port beneficiary() { return beneficiary_; }
 
  private:
+  IsolateGroup* isolate_group_;
   PersistentHandle* handle_;
   Dart_Port beneficiary_;
 };
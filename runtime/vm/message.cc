@@ -105,7 +105,7 @@ const char* Message::PriorityAsString(Priority priority) {
   }
 }
 
-MessageQueue::MessageQueue() {
+MessageQueue::MessageQueue() : concurrently_enqueued_(nullptr) {
   head_ = NULL;
   tail_ = NULL;
 }
@@ -160,6 +160,42 @@ void MessageQueue::Enqueue(std::unique_ptr<Message> msg0, bool before_events) {
   }
 }
 
+bool MessageQueue::EnqueueConcurrently(std::unique_ptr<Message> msg0) {
+  Message* msg = msg0.release();
+
+  // Make sure messages are not reused.
+  ASSERT(msg->next_ == NULL);
+  Message* head = concurrently_enqueued_.load(std::memory_order_relaxed);
+  do {
+    msg->next_ = head;
+  } while (!concurrently_enqueued_.compare_exchange_weak(
+      head, msg, std::memory_order_release, std::memory_order_relaxed));
+  return head == nullptr;
+}
+
+void MessageQueue::CollectConcurrentlyEnqueued() {
+  Message* newest = concurrently_enqueued_.exchange(nullptr);
+  if (newest == nullptr) {
+    return;
+  }
+  // Reverse the list to restore the order in which the messages were
+  // enqueued.
+  Message* oldest = nullptr;
+  Message* cur = newest;
+  while (cur != nullptr) {
+    Message* next = cur->next_;
+    cur->next_ = oldest;
+    oldest = cur;
+    cur = next;
+  }
+  if (head_ == nullptr) {
+    head_ = oldest;
+  } else {
+    tail_->next_ = oldest;
+  }
+  tail_ = newest;
+}
+
 std::unique_ptr<Message> MessageQueue::Dequeue() {
   Message* result = head_;
   if (result != nullptr) {
@@ -176,7 +212,41 @@ std::unique_ptr<Message> MessageQueue::Dequeue() {
   return nullptr;
 }
 
+void MessageQueue::DequeueBatch(MessageQueue* batch, intptr_t max_length) {
+  ASSERT(batch->IsEmpty());
+  ASSERT(max_length > 0);
+  if (head_ == nullptr) {
+    return;
+  }
+  Message* last = head_;
+  for (intptr_t i = 1; (i < max_length) && (last->next_ != nullptr); i++) {
+    last = last->next_;
+  }
+  batch->head_ = head_;
+  batch->tail_ = last;
+  head_ = last->next_;
+  last->next_ = nullptr;
+  if (head_ == nullptr) {
+    tail_ = nullptr;
+  }
+}
+
+void MessageQueue::PrependBatch(MessageQueue* batch) {
+  if (batch->head_ == nullptr) {
+    return;
+  }
+  if (head_ == nullptr) {
+    tail_ = batch->tail_;
+  } else {
+    batch->tail_->next_ = head_;
+  }
+  head_ = batch->head_;
+  batch->head_ = nullptr;
+  batch->tail_ = nullptr;
+}
+
 void MessageQueue::Clear() {
+  CollectConcurrentlyEnqueued();
   std::unique_ptr<Message> cur(head_);
   head_ = nullptr;
   tail_ = nullptr;
@@ -9,6 +9,7 @@
 #include <utility>
 
 #include "platform/assert.h"
+#include "platform/atomic.h"
 #include "vm/allocation.h"
 #include "vm/finalizable_data.h"
 #include "vm/globals.h"
@@ -116,6 +117,13 @@ class Message {
   bool IsRaw() const { return snapshot_length_ == 0; }
   // A message sent from sendAndExit.
   bool IsBequest() const { return snapshot_length_ == -1; }
+  // A snapshot message written in the clustered format (see
+  // message_snapshot.h) rather than by MessageWriter.
+  bool IsClustered() const { return is_clustered_; }
+  void set_is_clustered(bool value) {
+    ASSERT(IsSnapshot());
+    is_clustered_ = value;
+  }
 
   bool RedirectToDeliveryFailurePort();
 
@@ -147,6 +155,7 @@ class Message {
   intptr_t snapshot_length_;
   MessageFinalizableData* finalizable_data_;
   Priority priority_;
+  bool is_clustered_ = false;
 
   DISALLOW_COPY_AND_ASSIGN(Message);
 };
@@ -159,12 +168,33 @@ class MessageQueue {
 
   void Enqueue(std::unique_ptr<Message> msg, bool before_events);
 
+  // Adds [msg] to the tail of the queue. Unlike the other methods, this does
+  // not need to be synchronized with anything, so many threads can enqueue
+  // without taking a lock. The message only becomes visible to the other
+  // methods after the next call of CollectConcurrentlyEnqueued.
+  //
+  // Returns true if no other concurrently enqueued message was waiting to be
+  // collected. Only the thread which enqueued such a first message needs to
+  // make sure that the consumer eventually calls CollectConcurrentlyEnqueued.
+  bool EnqueueConcurrently(std::unique_ptr<Message> msg);
+
+  // Moves the messages added by EnqueueConcurrently to the tail of the queue,
+  // in the order in which they were enqueued.
+  void CollectConcurrentlyEnqueued();
+
   // Gets the next message from the message queue or NULL if no
   // message is available.  This function will not block.
   std::unique_ptr<Message> Dequeue();
 
   bool IsEmpty() { return head_ == NULL; }
 
+  // Moves up to [max_length] messages from the head of this queue to the
+  // empty queue [batch].
+  void DequeueBatch(MessageQueue* batch, intptr_t max_length);
+
+  // Moves all messages of [batch] in front of the messages of this queue.
+  void PrependBatch(MessageQueue* batch);
+
   // Clear all messages from the message queue.
   void Clear();
 
@@ -196,6 +226,8 @@ class MessageQueue {
  private:
   Message* head_;
   Message* tail_;
+  // The messages added by EnqueueConcurrently, newest first.
+  AcqRelAtomic<Message*> concurrently_enqueued_;
 
   DISALLOW_COPY_AND_ASSIGN(MessageQueue);
 };
@@ -20,6 +20,15 @@ namespace dart {
 
 DECLARE_FLAG(bool, trace_service_pause_events);
 
+DEFINE_FLAG(int,
+            message_handler_time_budget_micros,
+            0,
+            "Yield the thread to other tasks after handling messages for this "
+            "long, 0 means no limit.");
+
+// The number of normal messages dequeued at once.
+static const intptr_t kMessageBatchLength = 32;
+
 class MessageHandlerTask : public ThreadPool::Task {
  public:
   explicit MessageHandlerTask(MessageHandler* handler) : handler_(handler) {
@@ -57,6 +66,9 @@ const char* MessageHandler::MessageStatusString(MessageStatus status) {
 MessageHandler::MessageHandler()
     : queue_(new MessageQueue()),
       oob_queue_(new MessageQueue()),
+      batch_(new MessageQueue()),
+      oob_pending_(false),
+      time_budget_exceeded_(false),
       oob_message_handling_allowed_(true),
       paused_for_messages_(false),
       live_ports_(0),
@@ -76,13 +88,16 @@ MessageHandler::MessageHandler()
       callback_data_(0) {
   ASSERT(queue_ != NULL);
   ASSERT(oob_queue_ != NULL);
+  ASSERT(batch_ != NULL);
 }
 
 MessageHandler::~MessageHandler() {
   delete queue_;
   delete oob_queue_;
+  delete batch_;
   queue_ = NULL;
   oob_queue_ = NULL;
+  batch_ = NULL;
   pool_ = NULL;
 }
 
@@ -124,71 +139,116 @@ void MessageHandler::Run(ThreadPool* pool,
 
 void MessageHandler::PostMessage(std::unique_ptr<Message> message,
                                  bool before_events) {
-  Message::Priority saved_priority;
-
-  {
-    MonitorLocker ml(&monitor_);
-    if (FLAG_trace_isolates) {
-      Isolate* source_isolate = Isolate::Current();
-      if (source_isolate != nullptr) {
-        OS::PrintErr(
-            "[>] Posting message:\n"
-            "\tlen:        %" Pd "\n\tsource:     (%" Pd64
-            ") %s\n\tdest:       %s\n"
-            "\tdest_port:  %" Pd64 "\n",
-            message->Size(), static_cast<int64_t>(source_isolate->main_port()),
-            source_isolate->name(), name(), message->dest_port());
-      } else {
-        OS::PrintErr(
-            "[>] Posting message:\n"
-            "\tlen:        %" Pd
-            "\n\tsource:     <native code>\n"
-            "\tdest:       %s\n"
-            "\tdest_port:  %" Pd64 "\n",
-            message->Size(), name(), message->dest_port());
-      }
+  if (FLAG_trace_isolates) {
+    Isolate* source_isolate = Isolate::Current();
+    if (source_isolate != nullptr) {
+      OS::PrintErr(
+          "[>] Posting message:\n"
+          "\tlen:        %" Pd "\n\tsource:     (%" Pd64
+          ") %s\n\tdest:       %s\n"
+          "\tdest_port:  %" Pd64 "\n",
+          message->Size(), static_cast<int64_t>(source_isolate->main_port()),
+          source_isolate->name(), name(), message->dest_port());
+    } else {
+      OS::PrintErr(
+          "[>] Posting message:\n"
+          "\tlen:        %" Pd
+          "\n\tsource:     <native code>\n"
+          "\tdest:       %s\n"
+          "\tdest_port:  %" Pd64 "\n",
+          message->Size(), name(), message->dest_port());
     }
+  }
 
-    saved_priority = message->priority();
+  const Message::Priority saved_priority = message->priority();
+  if (!message->IsOOB() && !before_events) {
+    // Normal messages are enqueued without the monitor. Only the poster of
+    // the first message since the queue_ was last collected needs to wake up
+    // the handler, which then also sees any later messages.
+    if (queue_->EnqueueConcurrently(std::move(message))) {
+      MonitorLocker ml(&monitor_);
+      NotifyMessagesLocked(&ml);
+    }
+  } else {
+    MonitorLocker ml(&monitor_);
     if (message->IsOOB()) {
       oob_queue_->Enqueue(std::move(message), before_events);
+      oob_pending_ = true;
     } else {
+      queue_->CollectConcurrentlyEnqueued();
       queue_->Enqueue(std::move(message), before_events);
     }
-    if (paused_for_messages_) {
-      ml.Notify();
-    }
-
-    if (pool_ != nullptr && !task_running_) {
-      ASSERT(!delete_me_);
-      task_running_ = true;
-      const bool launched_successfully = pool_->Run<MessageHandlerTask>(this);
-      ASSERT(launched_successfully);
-    }
+    NotifyMessagesLocked(&ml);
   }
 
   // Invoke any custom message notification.
   MessageNotify(saved_priority);
 }
 
+void MessageHandler::NotifyMessagesLocked(MonitorLocker* ml) {
+  if (paused_for_messages_) {
+    ml->Notify();
+  }
+
+  if (pool_ != nullptr && !task_running_) {
+    ASSERT(!delete_me_);
+    task_running_ = true;
+    const bool launched_successfully = pool_->Run<MessageHandlerTask>(this);
+    ASSERT(launched_successfully);
+  }
+}
+
 std::unique_ptr<Message> MessageHandler::DequeueMessage(
-    Message::Priority min_priority) {
+    Message::Priority min_priority,
+    bool use_batch) {
   // TODO(turnidge): Add assert that monitor_ is held here.
   std::unique_ptr<Message> message = oob_queue_->Dequeue();
-  if ((message == nullptr) && (min_priority < Message::kOOBPriority)) {
-    message = queue_->Dequeue();
+  if (message != nullptr) {
+    oob_pending_ = !oob_queue_->IsEmpty();
+    // Messages posted while handling the OOB message, e.g. by pausing the
+    // isolate, need to be ordered relative to the batched messages.
+    ReturnBatchLocked();
+    return message;
+  }
+  oob_pending_ = false;
+  if (min_priority < Message::kOOBPriority) {
+    queue_->CollectConcurrentlyEnqueued();
+    if (use_batch && batch_->IsEmpty()) {
+      queue_->DequeueBatch(batch_, kMessageBatchLength);
+    }
+    message = batch_->Dequeue();
+    if (message == nullptr) {
+      message = queue_->Dequeue();
+    }
   }
   return message;
 }
 
+std::unique_ptr<Message> MessageHandler::DequeueBatchedMessage(
+    int64_t deadline) {
+  if (batch_->IsEmpty() || oob_pending_) {
+    return nullptr;
+  }
+  if ((deadline != 0) && (OS::GetCurrentMonotonicMicros() >= deadline)) {
+    return nullptr;
+  }
+  return batch_->Dequeue();
+}
+
+void MessageHandler::ReturnBatchLocked() {
+  queue_->PrependBatch(batch_);
+}
+
 void MessageHandler::ClearOOBQueue() {
   oob_queue_->Clear();
+  oob_pending_ = false;
 }
 
 MessageHandler::MessageStatus MessageHandler::HandleMessages(
     MonitorLocker* ml,
     bool allow_normal_messages,
-    bool allow_multiple_normal_messages) {
+    bool allow_multiple_normal_messages,
+    bool may_yield) {
   ASSERT(monitor_.IsOwnedByCurrentThread());
 
   // Scheduling of the mutator thread during the isolate start can cause this
@@ -205,80 +265,116 @@ MessageHandler::MessageStatus MessageHandler::HandleMessages(
   auto idle_time_handler =
       isolate() != nullptr ? isolate()->group()->idle_time_handler() : nullptr;
 
+  // Put back messages batched by an enclosing call, e.g. one that is handling
+  // the message which paused the isolate, so that they are seen in order.
+  ReturnBatchLocked();
+
+  // Normal messages are dequeued in batches, so that the monitor is not
+  // acquired for every message, unless only one of them may be handled.
+  const bool use_batch = allow_multiple_normal_messages;
+  const int64_t deadline =
+      (may_yield && (FLAG_message_handler_time_budget_micros > 0))
+          ? OS::GetCurrentMonotonicMicros() +
+                FLAG_message_handler_time_budget_micros
+          : 0;
+  time_budget_exceeded_ = false;
+
   MessageStatus max_status = kOK;
+  MessageStatus status = kOK;
   Message::Priority min_priority =
       ((allow_normal_messages && !paused()) ? Message::kNormalPriority
                                             : Message::kOOBPriority);
-  std::unique_ptr<Message> message = DequeueMessage(min_priority);
+  std::unique_ptr<Message> message = DequeueMessage(min_priority, use_batch);
   while (message != nullptr) {
-    intptr_t message_len = message->Size();
-    if (FLAG_trace_isolates) {
-      OS::PrintErr(
-          "[<] Handling message:\n"
-          "\tlen:        %" Pd
-          "\n"
-          "\thandler:    %s\n"
-          "\tport:       %" Pd64 "\n",
-          message_len, name(), message->dest_port());
-    }
-
-    // Release the monitor_ temporarily while we handle the message.
+    // Release the monitor_ temporarily while we handle the message and the
+    // batched messages following it.
     // The monitor was acquired in MessageHandler::TaskCallback().
     ml->Exit();
-    Message::Priority saved_priority = message->priority();
-    Dart_Port saved_dest_port = message->dest_port();
-    MessageStatus status = kOK;
-    {
-      DisableIdleTimerScope disable_idle_timer(idle_time_handler);
-      status = HandleMessage(std::move(message));
-    }
-    if (status > max_status) {
-      max_status = status;
+    while (message != nullptr) {
+      intptr_t message_len = message->Size();
+      if (FLAG_trace_isolates) {
+        OS::PrintErr(
+            "[<] Handling message:\n"
+            "\tlen:        %" Pd
+            "\n"
+            "\thandler:    %s\n"
+            "\tport:       %" Pd64 "\n",
+            message_len, name(), message->dest_port());
+      }
+
+      Message::Priority saved_priority = message->priority();
+      Dart_Port saved_dest_port = message->dest_port();
+      {
+        DisableIdleTimerScope disable_idle_timer(idle_time_handler);
+        status = HandleMessage(std::move(message));
+      }
+      if (status > max_status) {
+        max_status = status;
+      }
+      if (FLAG_trace_isolates) {
+        OS::PrintErr(
+            "[.] Message handled (%s):\n"
+            "\tlen:        %" Pd
+            "\n"
+            "\thandler:    %s\n"
+            "\tport:       %" Pd64 "\n",
+            MessageStatusString(status), message_len, name(),
+            saved_dest_port);
+      }
+      // If we are shutting down, do not process any more messages.
+      if (status == kShutdown) {
+        break;
+      }
+
+      // Remember time since the last message. Don't consider OOB messages so
+      // using Observatory doesn't trigger additional idle tasks.
+      if ((FLAG_idle_timeout_micros != 0) &&
+          (saved_priority == Message::kNormalPriority)) {
+        if (idle_time_handler != nullptr) {
+          idle_time_handler->UpdateStartIdleTime();
+        }
+      }
+
+      // Some callers want to process only one normal message and then quit.
+      // At the same time it is OK to process multiple OOB messages.
+      if ((saved_priority == Message::kNormalPriority) &&
+          !allow_multiple_normal_messages) {
+        // We processed one normal message.  Allow no more.
+        allow_normal_messages = false;
+      }
+
+      // Reevaluate the minimum allowable priority.  The paused state
+      // may have changed as part of handling the message.  We may also
+      // have encountered an error during message processing.
+      //
+      // Even if we encounter an error, we still process pending OOB
+      // messages so that we don't lose the message notification.
+      min_priority =
+          (((max_status == kOK) && allow_normal_messages && !paused())
+               ? Message::kNormalPriority
+               : Message::kOOBPriority);
+      if (min_priority == Message::kNormalPriority) {
+        message = DequeueBatchedMessage(deadline);
+      }
     }
     ml->Enter();
-    if (FLAG_trace_isolates) {
-      OS::PrintErr(
-          "[.] Message handled (%s):\n"
-          "\tlen:        %" Pd
-          "\n"
-          "\thandler:    %s\n"
-          "\tport:       %" Pd64 "\n",
-          MessageStatusString(status), message_len, name(), saved_dest_port);
-    }
     // If we are shutting down, do not process any more messages.
     if (status == kShutdown) {
       ClearOOBQueue();
       break;
     }
-
-    // Remember time since the last message. Don't consider OOB messages so
-    // using Observatory doesn't trigger additional idle tasks.
-    if ((FLAG_idle_timeout_micros != 0) &&
-        (saved_priority == Message::kNormalPriority)) {
-      if (idle_time_handler != nullptr) {
-        idle_time_handler->UpdateStartIdleTime();
-      }
-    }
-
-    // Some callers want to process only one normal message and then quit. At
-    // the same time it is OK to process multiple OOB messages.
-    if ((saved_priority == Message::kNormalPriority) &&
-        !allow_multiple_normal_messages) {
-      // We processed one normal message.  Allow no more.
-      allow_normal_messages = false;
+    queue_->CollectConcurrentlyEnqueued();
+    if ((deadline != 0) && (min_priority == Message::kNormalPriority) &&
+        !oob_pending_ && (!batch_->IsEmpty() || !queue_->IsEmpty()) &&
+        (OS::GetCurrentMonotonicMicros() >= deadline)) {
+      // Let the caller yield to other tasks before handling the remaining
+      // messages.
+      time_budget_exceeded_ = true;
+      break;
     }
-
-    // Reevaluate the minimum allowable priority.  The paused state
-    // may have changed as part of handling the message.  We may also
-    // have encountered an error during message processing.
-    //
-    // Even if we encounter an error, we still process pending OOB
-    // messages so that we don't lose the message notification.
-    min_priority = (((max_status == kOK) && allow_normal_messages && !paused())
-                        ? Message::kNormalPriority
-                        : Message::kOOBPriority);
-    message = DequeueMessage(min_priority);
+    message = DequeueMessage(min_priority, use_batch);
   }
+  ReturnBatchLocked();
   return max_status;
 }
 
@@ -303,6 +399,8 @@ MessageHandler::MessageStatus MessageHandler::PauseAndHandleAllMessages(
   CheckAccess();
 #endif
   paused_for_messages_ = true;
+  ReturnBatchLocked();
+  queue_->CollectConcurrentlyEnqueued();
   while (queue_->IsEmpty() && oob_queue_->IsEmpty()) {
     Monitor::WaitResult wr;
     {
@@ -316,6 +414,7 @@ MessageHandler::MessageStatus MessageHandler::PauseAndHandleAllMessages(
     if (wr == Monitor::kTimedOut) {
       break;
     }
+    queue_->CollectConcurrentlyEnqueued();
     if (queue_->IsEmpty()) {
       // There are only OOB messages. Handle them and then continue waiting for
       // normal messages unless there is an error.
@@ -324,6 +423,7 @@ MessageHandler::MessageStatus MessageHandler::PauseAndHandleAllMessages(
         paused_for_messages_ = false;
         return status;
       }
+      queue_->CollectConcurrentlyEnqueued();
     }
   }
   paused_for_messages_ = false;
@@ -373,6 +473,7 @@ bool MessageHandler::HasOOBMessages() {
 
 bool MessageHandler::HasMessages() {
   MonitorLocker ml(&monitor_);
+  queue_->CollectConcurrentlyEnqueued();
   return !queue_->IsEmpty();
 }
 
@@ -440,10 +541,21 @@ void MessageHandler::TaskCallback() {
 
       // Handle any pending messages for this message handler.
       if (status != kShutdown) {
-        status = HandleMessages(&ml, (status == kOK), true);
+        status = HandleMessages(&ml, (status == kOK), true,
+                                /*may_yield=*/true);
       }
     }
 
+    if ((status == kOK) && time_budget_exceeded_ && HasLivePorts()) {
+      // Let other tasks run on this thread before handling the remaining
+      // messages. [task_running_] stays set, so that PostMessage does not
+      // start another task meanwhile.
+      time_budget_exceeded_ = false;
+      const bool launched_successfully = pool_->Run<MessageHandlerTask>(this);
+      ASSERT(launched_successfully);
+      return;
+    }
+
     // The isolate exits when it encounters an error or when it no
     // longer has live ports.
     if (status != kOK || !HasLivePorts()) {
@@ -641,6 +753,7 @@ MessageHandler::AcquiredQueues::AcquiredQueues(MessageHandler* handler)
     : handler_(handler), ml_(&handler->monitor_) {
   ASSERT(handler != NULL);
   handler_->oob_message_handling_allowed_ = false;
+  handler_->queue_->CollectConcurrentlyEnqueued();
 }
 
 MessageHandler::AcquiredQueues::~AcquiredQueues() {
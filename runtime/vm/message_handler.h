@@ -7,6 +7,7 @@
 
 #include <memory>
 
+#include "platform/atomic.h"
 #include "vm/isolate.h"
 #include "vm/lockers.h"
 #include "vm/message.h"
@@ -235,18 +236,51 @@ class MessageHandler {
 
   // Dequeue the next message.  Prefer messages from the oob_queue_ to
   // messages from the queue_.
-  std::unique_ptr<Message> DequeueMessage(Message::Priority min_priority);
+  //
+  // If [use_batch] is true, normal messages are moved from the queue_ to the
+  // batch_ several at a time, so that they can be dequeued with
+  // DequeueBatchedMessage without holding the monitor.
+  std::unique_ptr<Message> DequeueMessage(Message::Priority min_priority,
+                                          bool use_batch = false);
+
+  // Dequeue the next message of the batch_ without holding the monitor.
+  // Returns nullptr if the batch_ is empty, if an OOB message is waiting or if
+  // the [deadline] has passed.
+  std::unique_ptr<Message> DequeueBatchedMessage(int64_t deadline);
+
+  // Puts the messages of the batch_ back in front of the queue_.
+  void ReturnBatchLocked();
+
+  // Wakes up the thread handling messages, or starts a task to handle them.
+  void NotifyMessagesLocked(MonitorLocker* ml);
 
   void ClearOOBQueue();
 
   // Handles any pending messages.
+  //
+  // If [may_yield] is true, stops handling normal messages once
+  // --message_handler_time_budget_micros has been used up. The caller is then
+  // expected to reschedule this handler.
   MessageStatus HandleMessages(MonitorLocker* ml,
                                bool allow_normal_messages,
-                               bool allow_multiple_normal_messages);
+                               bool allow_multiple_normal_messages,
+                               bool may_yield = false);
 
   Monitor monitor_;  // Protects all fields in MessageHandler.
+  // Normal messages are also enqueued without holding the monitor, see
+  // MessageQueue::EnqueueConcurrently.
   MessageQueue* queue_;
   MessageQueue* oob_queue_;
+  // Normal messages taken from the queue_ by the thread handling messages.
+  // Only accessed by that thread, and only non-empty while it is handling
+  // messages.
+  MessageQueue* batch_;
+  // Whether the oob_queue_ may be non-empty. Read without holding the monitor
+  // between batched messages.
+  RelaxedAtomic<bool> oob_pending_;
+  // Whether the last call of HandleMessages stopped because its time budget
+  // was used up.
+  bool time_budget_exceeded_;
   // This flag is not thread safe and can only reliably be accessed on a single
   // thread.
   bool oob_message_handling_allowed_;
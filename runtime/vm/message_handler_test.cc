@@ -10,6 +10,8 @@
 
 namespace dart {
 
+DECLARE_FLAG(int, message_handler_time_budget_micros);
+
 class MessageHandlerTestPeer {
  public:
   explicit MessageHandlerTestPeer(MessageHandler* handler)
@@ -24,7 +26,10 @@ class MessageHandlerTestPeer {
   void increment_live_ports() { handler_->increment_live_ports(); }
   void decrement_live_ports() { handler_->decrement_live_ports(); }
 
-  MessageQueue* queue() const { return handler_->queue_; }
+  MessageQueue* queue() const {
+    handler_->queue_->CollectConcurrentlyEnqueued();
+    return handler_->queue_;
+  }
   MessageQueue* oob_queue() const { return handler_->oob_queue_; }
 
  private:
@@ -409,4 +414,52 @@ VM_UNIT_TEST_CASE(MessageHandler_Run) {
   OSThread::Join(info.join_id);
 }
 
+VM_UNIT_TEST_CASE(MessageHandler_RunWithTimeBudget) {
+  // Yield after every batch of messages.
+  const int saved_budget = FLAG_message_handler_time_budget_micros;
+  FLAG_message_handler_time_budget_micros = 1;
+  {
+    TestMessageHandler handler;
+    ThreadPool pool;
+    MessageHandlerTestPeer handler_peer(&handler);
+    handler_peer.increment_live_ports();
+
+    const int kMessageCount = 200;
+    Dart_Port ports[kMessageCount];
+    for (int i = 0; i < kMessageCount; i++) {
+      ports[i] = PortMap::CreatePort(&handler);
+      handler_peer.PostMessage(
+          BlankMessage(ports[i], Message::kNormalPriority));
+    }
+    handler.Run(&pool, TestStartFunction, TestEndFunction,
+                reinterpret_cast<uword>(&handler));
+
+    // All messages are handled in order, even though the handler yields.
+    {
+      MonitorLocker ml(handler.monitor());
+      while (handler.message_count() < kMessageCount) {
+        ml.Wait();
+      }
+      Dart_Port* handler_ports = handler.port_buffer();
+      for (int i = 0; i < kMessageCount; i++) {
+        EXPECT_EQ(ports[i], handler_ports[i]);
+      }
+      EXPECT(handler.start_called());
+      EXPECT(!handler.end_called());
+    }
+
+    // Stop the handler.
+    handler_peer.decrement_live_ports();
+    handler_peer.PostMessage(BlankMessage(ports[0], Message::kNormalPriority));
+    {
+      MonitorLocker ml(handler.monitor());
+      while (!handler.end_called()) {
+        ml.Wait();
+      }
+      EXPECT_EQ(kMessageCount + 1, handler.message_count());
+    }
+  }
+  FLAG_message_handler_time_budget_micros = saved_budget;
+}
+
 }  // namespace dart
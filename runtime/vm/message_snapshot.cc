@@ -0,0 +1,934 @@
+// Copyright (c) 2021, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/message_snapshot.h"
+
+#include "platform/assert.h"
+#include "vm/datastream.h"
+#include "vm/dart_entry.h"
+#include "vm/growable_array.h"
+#include "vm/heap/weak_table.h"
+#include "vm/longjump.h"
+#include "vm/object.h"
+#include "vm/object_store.h"
+#include "vm/symbols.h"
+#include "vm/thread.h"
+
+namespace dart {
+
+// Objects both sides of the message agree on without them being written. They
+// get the first references, in this order.
+#define MESSAGE_PREDEFINED_TYPE_ARGUMENTS(V)                                   \
+  V(type_argument_int)                                                         \
+  V(type_argument_legacy_int)                                                  \
+  V(type_argument_non_nullable_int)                                            \
+  V(type_argument_double)                                                      \
+  V(type_argument_legacy_double)                                               \
+  V(type_argument_non_nullable_double)                                         \
+  V(type_argument_string)                                                      \
+  V(type_argument_legacy_string)                                               \
+  V(type_argument_non_nullable_string)                                         \
+  V(type_argument_string_dynamic)                                              \
+  V(type_argument_legacy_string_dynamic)                                       \
+  V(type_argument_non_nullable_string_dynamic)                                 \
+  V(type_argument_string_string)                                               \
+  V(type_argument_legacy_string_legacy_string)                                 \
+  V(type_argument_non_nullable_string_non_nullable_string)
+
+static void AddBaseObjects(Thread* thread, GrowableArray<ObjectPtr>* objects) {
+  ObjectStore* object_store = thread->isolate_group()->object_store();
+  objects->Add(Object::null());
+  objects->Add(Bool::True().ptr());
+  objects->Add(Bool::False().ptr());
+  objects->Add(Object::empty_array().ptr());
+#define ADD_TYPE_ARGUMENTS(name) objects->Add(object_store->name());
+  MESSAGE_PREDEFINED_TYPE_ARGUMENTS(ADD_TYPE_ARGUMENTS)
+#undef ADD_TYPE_ARGUMENTS
+}
+
+// Reference 0 is never used so that a zero WeakTable entry can mean "not
+// seen yet".
+static const intptr_t kFirstReference = 1;
+
+// Objects still waiting for a reference in the serializer's identity table.
+static const intptr_t kUnallocatedReference = -1;
+
+enum MessageClusterKind {
+  kMintCluster,
+  kDoubleCluster,
+  kOneByteStringCluster,
+  kTwoByteStringCluster,
+  kTypedDataCluster,
+  kArrayCluster,
+  kImmutableArrayCluster,
+  kGrowableObjectArrayCluster,
+  kLinkedHashMapCluster,
+  kNumMessageClusters,
+};
+
+class MessageSerializer;
+class MessageDeserializer;
+
+class MessageSerializationCluster : public ZoneAllocated {
+ public:
+  explicit MessageSerializationCluster(MessageClusterKind kind)
+      : kind_(kind), objects_() {}
+  virtual ~MessageSerializationCluster() {}
+
+  MessageClusterKind kind() const { return kind_; }
+  intptr_t num_objects() const { return objects_.length(); }
+
+  // Add [object] to the cluster and push its outgoing references.
+  virtual void Trace(MessageSerializer* s, ObjectPtr object) = 0;
+
+  // Write the information needed to allocate the cluster's objects, assigning
+  // each of them a reference in order. Leaf objects are written in full here.
+  virtual void WriteAlloc(MessageSerializer* s) = 0;
+
+  // Write the references held by the cluster's objects.
+  virtual void WriteFill(MessageSerializer* s) {}
+
+ protected:
+  const MessageClusterKind kind_;
+  GrowableArray<ObjectPtr> objects_;
+};
+
+class MessageDeserializationCluster : public ZoneAllocated {
+ public:
+  MessageDeserializationCluster() : start_index_(0), stop_index_(0) {}
+  virtual ~MessageDeserializationCluster() {}
+
+  // Allocate memory for all objects in the cluster and write their addresses
+  // into the ref array. Leaf objects are fully read here.
+  virtual void ReadAlloc(MessageDeserializer* d) = 0;
+
+  // Initialize the cluster's objects' references.
+  virtual void ReadFill(MessageDeserializer* d) {}
+
+ protected:
+  // The range of the ref array that belongs to this cluster.
+  intptr_t start_index_;
+  intptr_t stop_index_;
+};
+
+class MessageSerializer : public ValueObject {
+ public:
+  explicit MessageSerializer(Thread* thread);
+
+  // Collects the objects reachable from [root] into clusters. Returns false if
+  // any of them cannot be written in this format.
+  bool Trace(ObjectPtr root);
+  void Serialize(ObjectPtr root);
+
+  uint8_t* Steal(intptr_t* length) { return stream_.Steal(length); }
+
+  Zone* zone() const { return zone_; }
+
+  void Push(ObjectPtr object);
+  void AssignRef(ObjectPtr object) {
+    ASSERT(refs_.GetValueExclusive(object) == kUnallocatedReference);
+    refs_.SetValueExclusive(object, next_ref_++);
+  }
+
+  template <typename T>
+  void Write(T value) {
+    stream_.Write<T>(value);
+  }
+  void WriteUnsigned(intptr_t value) { stream_.WriteUnsigned(value); }
+  void WriteBytes(const void* addr, intptr_t len) {
+    stream_.WriteBytes(addr, len);
+  }
+  void Align(intptr_t alignment) { stream_.Align(alignment); }
+  // Smis are written inline with the low bit set, everything else as its
+  // reference shifted left by one.
+  void WriteRef(ObjectPtr object) {
+    if (!object->IsHeapObject()) {
+      const uint64_t value = Smi::Value(static_cast<SmiPtr>(object));
+      stream_.Write<int64_t>(static_cast<int64_t>(value << 1) | 1);
+      return;
+    }
+    const intptr_t ref = refs_.GetValueExclusive(object);
+    ASSERT(ref >= kFirstReference);
+    stream_.Write<int64_t>(ref * 2);
+  }
+
+ private:
+  MessageSerializationCluster* ClusterFor(ObjectPtr object);
+
+  Thread* const thread_;
+  Zone* const zone_;
+  MallocWriteStream stream_;
+  WeakTable refs_;
+  GrowableArray<ObjectPtr> stack_;
+  MessageSerializationCluster* clusters_[kNumMessageClusters];
+  intptr_t num_base_objects_;
+  intptr_t num_objects_;
+  intptr_t next_ref_;
+  bool unsupported_;
+
+  DISALLOW_COPY_AND_ASSIGN(MessageSerializer);
+};
+
+class MessageDeserializer : public ValueObject {
+ public:
+  MessageDeserializer(Thread* thread, Message* message);
+
+  ObjectPtr Deserialize();
+
+  Thread* thread() const { return thread_; }
+  Zone* zone() const { return zone_; }
+
+  template <typename T>
+  T Read() {
+    return stream_.Read<T>();
+  }
+  intptr_t ReadUnsigned() { return stream_.ReadUnsigned(); }
+  void ReadBytes(void* addr, intptr_t len) {
+    stream_.ReadBytes(reinterpret_cast<uint8_t*>(addr), len);
+  }
+  const uint8_t* CurrentBufferAddress() const {
+    return stream_.AddressOfCurrentPosition();
+  }
+  void Advance(intptr_t len) { stream_.Advance(len); }
+  void Align(intptr_t alignment) { stream_.Align(alignment); }
+
+  intptr_t next_index() const { return next_ref_; }
+  void AssignRef(ObjectPtr object) {
+    object_ = object;
+    refs_.SetAt(next_ref_++, object_);
+  }
+  ObjectPtr Ref(intptr_t index) const { return refs_.At(index); }
+  ObjectPtr ReadRef() {
+    const int64_t value = stream_.Read<int64_t>();
+    if ((value & 1) != 0) {
+      return Smi::New(value >> 1);
+    }
+    return refs_.At(value >> 1);
+  }
+
+  void EnqueueRehashingOfMap(const LinkedHashMap& map) {
+    if (maps_to_rehash_.IsNull()) {
+      maps_to_rehash_ = GrowableObjectArray::New();
+    }
+    maps_to_rehash_.Add(map);
+  }
+
+ private:
+  MessageDeserializationCluster* ReadCluster();
+  ObjectPtr RunDelayedRehashingOfMaps();
+
+  Thread* const thread_;
+  Zone* const zone_;
+  ReadStream stream_;
+  Array& refs_;
+  Object& object_;
+  GrowableObjectArray& maps_to_rehash_;
+  intptr_t next_ref_;
+
+  DISALLOW_COPY_AND_ASSIGN(MessageDeserializer);
+};
+
+class MintMessageSerializationCluster : public MessageSerializationCluster {
+ public:
+  MintMessageSerializationCluster()
+      : MessageSerializationCluster(kMintCluster) {}
+
+  void Trace(MessageSerializer* s, ObjectPtr object) { objects_.Add(object); }
+
+  void WriteAlloc(MessageSerializer* s) {
+    Integer& integer = Integer::Handle(s->zone());
+    const intptr_t count = objects_.length();
+    s->WriteUnsigned(count);
+    for (intptr_t i = 0; i < count; i++) {
+      ObjectPtr object = objects_[i];
+      s->AssignRef(object);
+      integer ^= object;
+      s->Write<int64_t>(integer.AsInt64Value());
+    }
+  }
+};
+
+class MintMessageDeserializationCluster : public MessageDeserializationCluster {
+ public:
+  void ReadAlloc(MessageDeserializer* d) {
+    start_index_ = d->next_index();
+    const intptr_t count = d->ReadUnsigned();
+    for (intptr_t i = 0; i < count; i++) {
+      d->AssignRef(Integer::New(d->Read<int64_t>()));
+    }
+    stop_index_ = d->next_index();
+  }
+};
+
+class DoubleMessageSerializationCluster : public MessageSerializationCluster {
+ public:
+  DoubleMessageSerializationCluster()
+      : MessageSerializationCluster(kDoubleCluster) {}
+
+  void Trace(MessageSerializer* s, ObjectPtr object) { objects_.Add(object); }
+
+  void WriteAlloc(MessageSerializer* s) {
+    Double& dbl = Double::Handle(s->zone());
+    const intptr_t count = objects_.length();
+    s->WriteUnsigned(count);
+    for (intptr_t i = 0; i < count; i++) {
+      ObjectPtr object = objects_[i];
+      s->AssignRef(object);
+      dbl ^= object;
+      const double value = dbl.value();
+      s->WriteBytes(&value, sizeof(value));
+    }
+  }
+};
+
+class DoubleMessageDeserializationCluster
+    : public MessageDeserializationCluster {
+ public:
+  void ReadAlloc(MessageDeserializer* d) {
+    start_index_ = d->next_index();
+    const intptr_t count = d->ReadUnsigned();
+    for (intptr_t i = 0; i < count; i++) {
+      double value;
+      d->ReadBytes(&value, sizeof(value));
+      d->AssignRef(Double::New(value));
+    }
+    stop_index_ = d->next_index();
+  }
+};
+
+// Canonical strings are recreated as symbols by the reader. Strings carry no
+// references, so they are read completely in the allocation section.
+class OneByteStringMessageSerializationCluster
+    : public MessageSerializationCluster {
+ public:
+  OneByteStringMessageSerializationCluster()
+      : MessageSerializationCluster(kOneByteStringCluster) {}
+
+  void Trace(MessageSerializer* s, ObjectPtr object) { objects_.Add(object); }
+
+  void WriteAlloc(MessageSerializer* s) {
+    String& str = String::Handle(s->zone());
+    const intptr_t count = objects_.length();
+    s->WriteUnsigned(count);
+    for (intptr_t i = 0; i < count; i++) {
+      ObjectPtr object = objects_[i];
+      s->AssignRef(object);
+      str ^= object;
+      const intptr_t length = str.Length();
+      s->WriteUnsigned((length << 1) | (str.IsCanonical() ? 1 : 0));
+      s->WriteBytes(OneByteString::DataStart(str), length);
+    }
+  }
+};
+
+class OneByteStringMessageDeserializationCluster
+    : public MessageDeserializationCluster {
+ public:
+  void ReadAlloc(MessageDeserializer* d) {
+    String& str = String::Handle(d->zone());
+    start_index_ = d->next_index();
+    const intptr_t count = d->ReadUnsigned();
+    for (intptr_t i = 0; i < count; i++) {
+      const intptr_t encoded = d->ReadUnsigned();
+      const intptr_t length = encoded >> 1;
+      const uint8_t* characters = d->CurrentBufferAddress();
+      if ((encoded & 1) != 0) {
+        str = Symbols::FromLatin1(d->thread(), characters, length);
+      } else {
+        str = OneByteString::New(characters, length, Heap::kNew);
+      }
+      d->Advance(length);
+      d->AssignRef(str.ptr());
+    }
+    stop_index_ = d->next_index();
+  }
+};
+
+class TwoByteStringMessageSerializationCluster
+    : public MessageSerializationCluster {
+ public:
+  TwoByteStringMessageSerializationCluster()
+      : MessageSerializationCluster(kTwoByteStringCluster) {}
+
+  void Trace(MessageSerializer* s, ObjectPtr object) { objects_.Add(object); }
+
+  void WriteAlloc(MessageSerializer* s) {
+    String& str = String::Handle(s->zone());
+    const intptr_t count = objects_.length();
+    s->WriteUnsigned(count);
+    for (intptr_t i = 0; i < count; i++) {
+      ObjectPtr object = objects_[i];
+      s->AssignRef(object);
+      str ^= object;
+      const intptr_t length = str.Length();
+      s->WriteUnsigned((length << 1) | (str.IsCanonical() ? 1 : 0));
+      // Keep the characters aligned so the reader can use them in place.
+      s->Align(sizeof(uint16_t));
+      s->WriteBytes(TwoByteString::DataStart(str), length * sizeof(uint16_t));
+    }
+  }
+};
+
+class TwoByteStringMessageDeserializationCluster
+    : public MessageDeserializationCluster {
+ public:
+  void ReadAlloc(MessageDeserializer* d) {
+    String& str = String::Handle(d->zone());
+    start_index_ = d->next_index();
+    const intptr_t count = d->ReadUnsigned();
+    for (intptr_t i = 0; i < count; i++) {
+      const intptr_t encoded = d->ReadUnsigned();
+      const intptr_t length = encoded >> 1;
+      d->Align(sizeof(uint16_t));
+      const uint16_t* characters =
+          reinterpret_cast<const uint16_t*>(d->CurrentBufferAddress());
+      if ((encoded & 1) != 0) {
+        str = Symbols::FromUTF16(d->thread(), characters, length);
+      } else {
+        str = TwoByteString::New(characters, length, Heap::kNew);
+      }
+      d->Advance(length * sizeof(uint16_t));
+      d->AssignRef(str.ptr());
+    }
+    stop_index_ = d->next_index();
+  }
+};
+
+// Internal typed data of any element type. Views and external typed data are
+// not supported.
+class TypedDataMessageSerializationCluster
+    : public MessageSerializationCluster {
+ public:
+  TypedDataMessageSerializationCluster()
+      : MessageSerializationCluster(kTypedDataCluster) {}
+
+  void Trace(MessageSerializer* s, ObjectPtr object) { objects_.Add(object); }
+
+  void WriteAlloc(MessageSerializer* s) {
+    TypedData& data = TypedData::Handle(s->zone());
+    const intptr_t count = objects_.length();
+    s->WriteUnsigned(count);
+    for (intptr_t i = 0; i < count; i++) {
+      ObjectPtr object = objects_[i];
+      s->AssignRef(object);
+      data ^= object;
+      s->WriteUnsigned(data.GetClassId());
+      s->WriteUnsigned(data.Length());
+      s->WriteBytes(data.DataAddr(0), data.LengthInBytes());
+    }
+  }
+};
+
+class TypedDataMessageDeserializationCluster
+    : public MessageDeserializationCluster {
+ public:
+  void ReadAlloc(MessageDeserializer* d) {
+    TypedData& data = TypedData::Handle(d->zone());
+    start_index_ = d->next_index();
+    const intptr_t count = d->ReadUnsigned();
+    for (intptr_t i = 0; i < count; i++) {
+      const intptr_t cid = d->ReadUnsigned();
+      const intptr_t length = d->ReadUnsigned();
+      data = TypedData::New(cid, length);
+      {
+        NoSafepointScope no_safepoint;
+        d->ReadBytes(data.DataAddr(0), data.LengthInBytes());
+      }
+      d->AssignRef(data.ptr());
+    }
+    stop_index_ = d->next_index();
+  }
+};
+
+class ArrayMessageSerializationCluster : public MessageSerializationCluster {
+ public:
+  explicit ArrayMessageSerializationCluster(MessageClusterKind kind)
+      : MessageSerializationCluster(kind) {}
+
+  void Trace(MessageSerializer* s, ObjectPtr object) {
+    objects_.Add(object);
+    ArrayPtr array = static_cast<ArrayPtr>(object);
+    s->Push(array->untag()->type_arguments());
+    const intptr_t length = Smi::Value(array->untag()->length());
+    for (intptr_t i = 0; i < length; i++) {
+      s->Push(array->untag()->element(i));
+    }
+  }
+
+  void WriteAlloc(MessageSerializer* s) {
+    const intptr_t count = objects_.length();
+    s->WriteUnsigned(count);
+    for (intptr_t i = 0; i < count; i++) {
+      ArrayPtr array = static_cast<ArrayPtr>(objects_[i]);
+      s->AssignRef(array);
+      s->WriteUnsigned(Smi::Value(array->untag()->length()));
+    }
+  }
+
+  void WriteFill(MessageSerializer* s) {
+    const intptr_t count = objects_.length();
+    for (intptr_t i = 0; i < count; i++) {
+      ArrayPtr array = static_cast<ArrayPtr>(objects_[i]);
+      s->WriteRef(array->untag()->type_arguments());
+      const intptr_t length = Smi::Value(array->untag()->length());
+      for (intptr_t j = 0; j < length; j++) {
+        s->WriteRef(array->untag()->element(j));
+      }
+    }
+  }
+};
+
+class ArrayMessageDeserializationCluster
+    : public MessageDeserializationCluster {
+ public:
+  explicit ArrayMessageDeserializationCluster(bool is_immutable)
+      : is_immutable_(is_immutable) {}
+
+  void ReadAlloc(MessageDeserializer* d) {
+    start_index_ = d->next_index();
+    const intptr_t count = d->ReadUnsigned();
+    for (intptr_t i = 0; i < count; i++) {
+      const intptr_t length = d->ReadUnsigned();
+      d->AssignRef(is_immutable_ ? ImmutableArray::New(length)
+                                 : Array::New(length));
+    }
+    stop_index_ = d->next_index();
+  }
+
+  void ReadFill(MessageDeserializer* d) {
+    Array& array = Array::Handle(d->zone());
+    TypeArguments& type_arguments = TypeArguments::Handle(d->zone());
+    Object& element = Object::Handle(d->zone());
+    for (intptr_t id = start_index_; id < stop_index_; id++) {
+      array ^= d->Ref(id);
+      type_arguments ^= d->ReadRef();
+      array.SetTypeArguments(type_arguments);
+      const intptr_t length = array.Length();
+      for (intptr_t j = 0; j < length; j++) {
+        element = d->ReadRef();
+        array.SetAt(j, element);
+      }
+    }
+  }
+
+ private:
+  const bool is_immutable_;
+};
+
+class GrowableObjectArrayMessageSerializationCluster
+    : public MessageSerializationCluster {
+ public:
+  GrowableObjectArrayMessageSerializationCluster()
+      : MessageSerializationCluster(kGrowableObjectArrayCluster) {}
+
+  void Trace(MessageSerializer* s, ObjectPtr object) {
+    objects_.Add(object);
+    GrowableObjectArrayPtr array = static_cast<GrowableObjectArrayPtr>(object);
+    s->Push(array->untag()->type_arguments());
+    s->Push(array->untag()->data());
+  }
+
+  void WriteAlloc(MessageSerializer* s) {
+    const intptr_t count = objects_.length();
+    s->WriteUnsigned(count);
+    for (intptr_t i = 0; i < count; i++) {
+      s->AssignRef(objects_[i]);
+    }
+  }
+
+  void WriteFill(MessageSerializer* s) {
+    const intptr_t count = objects_.length();
+    for (intptr_t i = 0; i < count; i++) {
+      GrowableObjectArrayPtr array =
+          static_cast<GrowableObjectArrayPtr>(objects_[i]);
+      s->WriteRef(array->untag()->type_arguments());
+      s->WriteUnsigned(Smi::Value(array->untag()->length()));
+      s->WriteRef(array->untag()->data());
+    }
+  }
+};
+
+class GrowableObjectArrayMessageDeserializationCluster
+    : public MessageDeserializationCluster {
+ public:
+  void ReadAlloc(MessageDeserializer* d) {
+    start_index_ = d->next_index();
+    const intptr_t count = d->ReadUnsigned();
+    for (intptr_t i = 0; i < count; i++) {
+      d->AssignRef(GrowableObjectArray::New(Object::empty_array()));
+    }
+    stop_index_ = d->next_index();
+  }
+
+  void ReadFill(MessageDeserializer* d) {
+    GrowableObjectArray& array = GrowableObjectArray::Handle(d->zone());
+    TypeArguments& type_arguments = TypeArguments::Handle(d->zone());
+    Array& data = Array::Handle(d->zone());
+    for (intptr_t id = start_index_; id < stop_index_; id++) {
+      array ^= d->Ref(id);
+      type_arguments ^= d->ReadRef();
+      array.SetTypeArguments(type_arguments);
+      const intptr_t length = d->ReadUnsigned();
+      data ^= d->ReadRef();
+      array.SetData(data);
+      array.SetLength(length);
+    }
+  }
+};
+
+// Only the live key/value pairs are written. As with MessageSnapshotReader,
+// the index is rebuilt by rehashing the maps after all objects are filled in,
+// since keys may have user-defined hash codes.
+class LinkedHashMapMessageSerializationCluster
+    : public MessageSerializationCluster {
+ public:
+  LinkedHashMapMessageSerializationCluster()
+      : MessageSerializationCluster(kLinkedHashMapCluster) {}
+
+  void Trace(MessageSerializer* s, ObjectPtr object) {
+    objects_.Add(object);
+    LinkedHashMapPtr map = static_cast<LinkedHashMapPtr>(object);
+    s->Push(map->untag()->type_arguments());
+    ArrayPtr data = map->untag()->data();
+    const intptr_t used_data = Smi::Value(map->untag()->used_data());
+    for (intptr_t i = 0; i < used_data; i += 2) {
+      ObjectPtr key = data->untag()->element(i);
+      if (key == data) {
+        continue;  // Deleted.
+      }
+      s->Push(key);
+      s->Push(data->untag()->element(i + 1));
+    }
+  }
+
+  void WriteAlloc(MessageSerializer* s) {
+    const intptr_t count = objects_.length();
+    s->WriteUnsigned(count);
+    for (intptr_t i = 0; i < count; i++) {
+      s->AssignRef(objects_[i]);
+    }
+  }
+
+  void WriteFill(MessageSerializer* s) {
+    const intptr_t count = objects_.length();
+    for (intptr_t i = 0; i < count; i++) {
+      LinkedHashMapPtr map = static_cast<LinkedHashMapPtr>(objects_[i]);
+      s->WriteRef(map->untag()->type_arguments());
+      ArrayPtr data = map->untag()->data();
+      const intptr_t used_data = Smi::Value(map->untag()->used_data());
+      const intptr_t deleted_keys = Smi::Value(map->untag()->deleted_keys());
+      s->WriteUnsigned((used_data >> 1) - deleted_keys);
+      for (intptr_t j = 0; j < used_data; j += 2) {
+        ObjectPtr key = data->untag()->element(j);
+        if (key == data) {
+          continue;
+        }
+        s->WriteRef(key);
+        s->WriteRef(data->untag()->element(j + 1));
+      }
+    }
+  }
+};
+
+class LinkedHashMapMessageDeserializationCluster
+    : public MessageDeserializationCluster {
+ public:
+  void ReadAlloc(MessageDeserializer* d) {
+    start_index_ = d->next_index();
+    const intptr_t count = d->ReadUnsigned();
+    for (intptr_t i = 0; i < count; i++) {
+      d->AssignRef(LinkedHashMap::NewUninitialized());
+    }
+    stop_index_ = d->next_index();
+  }
+
+  void ReadFill(MessageDeserializer* d) {
+    LinkedHashMap& map = LinkedHashMap::Handle(d->zone());
+    TypeArguments& type_arguments = TypeArguments::Handle(d->zone());
+    Array& data = Array::Handle(d->zone());
+    Object& element = Object::Handle(d->zone());
+    for (intptr_t id = start_index_; id < stop_index_; id++) {
+      map ^= d->Ref(id);
+      type_arguments ^= d->ReadRef();
+      map.SetTypeArguments(type_arguments);
+      const intptr_t used_data = d->ReadUnsigned() << 1;
+      map.SetUsedData(used_data);
+      const intptr_t data_size = Utils::Maximum(
+          Utils::RoundUpToPowerOfTwo(used_data),
+          static_cast<uintptr_t>(LinkedHashMap::kInitialIndexSize));
+      data = Array::New(data_size);
+      map.SetData(data);
+      map.SetDeletedKeys(0);
+      // The index is rebuilt by the rehash below.
+      map.SetHashMask(0);
+      for (intptr_t j = 0; j < used_data; j++) {
+        element = d->ReadRef();
+        data.SetAt(j, element);
+      }
+      d->EnqueueRehashingOfMap(map);
+    }
+  }
+};
+
+MessageSerializer::MessageSerializer(Thread* thread)
+    : thread_(thread),
+      zone_(thread->zone()),
+      stream_(1 * KB),
+      refs_(),
+      stack_(),
+      num_base_objects_(0),
+      num_objects_(0),
+      next_ref_(kFirstReference),
+      unsupported_(false) {
+  for (intptr_t i = 0; i < kNumMessageClusters; i++) {
+    clusters_[i] = nullptr;
+  }
+}
+
+MessageSerializationCluster* MessageSerializer::ClusterFor(ObjectPtr object) {
+  const intptr_t cid = object->GetClassId();
+  MessageClusterKind kind;
+  if (cid == kMintCid) {
+    kind = kMintCluster;
+  } else if (cid == kDoubleCid) {
+    kind = kDoubleCluster;
+  } else if (cid == kOneByteStringCid) {
+    kind = kOneByteStringCluster;
+  } else if (cid == kTwoByteStringCid) {
+    kind = kTwoByteStringCluster;
+  } else if (object->untag()->IsCanonical()) {
+    // Constants other than numbers and strings would need to be canonicalized
+    // again by the reader.
+    return nullptr;
+  } else if (IsTypedDataClassId(cid)) {
+    kind = kTypedDataCluster;
+  } else if (cid == kArrayCid) {
+    kind = kArrayCluster;
+  } else if (cid == kImmutableArrayCid) {
+    kind = kImmutableArrayCluster;
+  } else if (cid == kGrowableObjectArrayCid) {
+    kind = kGrowableObjectArrayCluster;
+  } else if (cid == kLinkedHashMapCid) {
+    kind = kLinkedHashMapCluster;
+  } else {
+    return nullptr;
+  }
+  if (clusters_[kind] == nullptr) {
+    switch (kind) {
+      case kMintCluster:
+        clusters_[kind] = new (zone_) MintMessageSerializationCluster();
+        break;
+      case kDoubleCluster:
+        clusters_[kind] = new (zone_) DoubleMessageSerializationCluster();
+        break;
+      case kOneByteStringCluster:
+        clusters_[kind] =
+            new (zone_) OneByteStringMessageSerializationCluster();
+        break;
+      case kTwoByteStringCluster:
+        clusters_[kind] =
+            new (zone_) TwoByteStringMessageSerializationCluster();
+        break;
+      case kTypedDataCluster:
+        clusters_[kind] = new (zone_) TypedDataMessageSerializationCluster();
+        break;
+      case kArrayCluster:
+      case kImmutableArrayCluster:
+        clusters_[kind] = new (zone_) ArrayMessageSerializationCluster(kind);
+        break;
+      case kGrowableObjectArrayCluster:
+        clusters_[kind] =
+            new (zone_) GrowableObjectArrayMessageSerializationCluster();
+        break;
+      case kLinkedHashMapCluster:
+        clusters_[kind] =
+            new (zone_) LinkedHashMapMessageSerializationCluster();
+        break;
+      default:
+        UNREACHABLE();
+    }
+  }
+  return clusters_[kind];
+}
+
+void MessageSerializer::Push(ObjectPtr object) {
+  if (!object->IsHeapObject()) {
+    return;
+  }
+  if (refs_.GetValueExclusive(object) != 0) {
+    return;  // Already traced or a base object.
+  }
+  refs_.SetValueExclusive(object, kUnallocatedReference);
+  stack_.Add(object);
+}
+
+bool MessageSerializer::Trace(ObjectPtr root) {
+  ASSERT(thread_->no_safepoint_scope_depth() > 0);
+  GrowableArray<ObjectPtr> base_objects;
+  AddBaseObjects(thread_, &base_objects);
+  for (intptr_t i = 0; i < base_objects.length(); i++) {
+    refs_.SetValueExclusive(base_objects[i], kFirstReference + i);
+  }
+  num_base_objects_ = base_objects.length();
+  next_ref_ = kFirstReference + num_base_objects_;
+
+  Push(root);
+  while (!stack_.is_empty()) {
+    ObjectPtr object = stack_.RemoveLast();
+    MessageSerializationCluster* cluster = ClusterFor(object);
+    if (cluster == nullptr) {
+      unsupported_ = true;
+      return false;
+    }
+    cluster->Trace(this, object);
+    num_objects_++;
+  }
+  return true;
+}
+
+void MessageSerializer::Serialize(ObjectPtr root) {
+  ASSERT(!unsupported_);
+  intptr_t num_clusters = 0;
+  for (intptr_t i = 0; i < kNumMessageClusters; i++) {
+    if (clusters_[i] != nullptr) {
+      num_clusters++;
+    }
+  }
+  WriteUnsigned(num_objects_);
+  WriteUnsigned(num_clusters);
+  // Leaf clusters come first in the enum, so when the deserializer allocates
+  // arrays and maps their elements already exist.
+  for (intptr_t i = 0; i < kNumMessageClusters; i++) {
+    MessageSerializationCluster* cluster = clusters_[i];
+    if (cluster != nullptr) {
+      WriteUnsigned(cluster->kind());
+      cluster->WriteAlloc(this);
+    }
+  }
+  ASSERT(next_ref_ == kFirstReference + num_base_objects_ + num_objects_);
+  for (intptr_t i = 0; i < kNumMessageClusters; i++) {
+    if (clusters_[i] != nullptr) {
+      clusters_[i]->WriteFill(this);
+    }
+  }
+  WriteRef(root);
+}
+
+MessageDeserializer::MessageDeserializer(Thread* thread, Message* message)
+    : thread_(thread),
+      zone_(thread->zone()),
+      stream_(message->snapshot(), message->snapshot_length()),
+      refs_(Array::Handle(zone_)),
+      object_(Object::Handle(zone_)),
+      maps_to_rehash_(GrowableObjectArray::Handle(zone_)),
+      next_ref_(kFirstReference) {
+  ASSERT(message->IsClustered());
+}
+
+MessageDeserializationCluster* MessageDeserializer::ReadCluster() {
+  const intptr_t kind = ReadUnsigned();
+  switch (kind) {
+    case kMintCluster:
+      return new (zone_) MintMessageDeserializationCluster();
+    case kDoubleCluster:
+      return new (zone_) DoubleMessageDeserializationCluster();
+    case kOneByteStringCluster:
+      return new (zone_) OneByteStringMessageDeserializationCluster();
+    case kTwoByteStringCluster:
+      return new (zone_) TwoByteStringMessageDeserializationCluster();
+    case kTypedDataCluster:
+      return new (zone_) TypedDataMessageDeserializationCluster();
+    case kArrayCluster:
+      return new (zone_) ArrayMessageDeserializationCluster(false);
+    case kImmutableArrayCluster:
+      return new (zone_) ArrayMessageDeserializationCluster(true);
+    case kGrowableObjectArrayCluster:
+      return new (zone_) GrowableObjectArrayMessageDeserializationCluster();
+    case kLinkedHashMapCluster:
+      return new (zone_) LinkedHashMapMessageDeserializationCluster();
+  }
+  UNREACHABLE();
+  return nullptr;
+}
+
+ObjectPtr MessageDeserializer::RunDelayedRehashingOfMaps() {
+  if (maps_to_rehash_.IsNull()) {
+    return Object::null();
+  }
+  const Library& collections_lib =
+      Library::Handle(zone_, Library::CollectionLibrary());
+  const Function& rehashing_function = Function::Handle(
+      zone_,
+      collections_lib.LookupFunctionAllowPrivate(Symbols::_rehashObjects()));
+  ASSERT(!rehashing_function.IsNull());
+
+  const Array& arguments = Array::Handle(zone_, Array::New(1));
+  arguments.SetAt(0, maps_to_rehash_);
+  return DartEntry::InvokeFunction(rehashing_function, arguments);
+}
+
+ObjectPtr MessageDeserializer::Deserialize() {
+  // Setup for long jump in case there is an exception while reading.
+  LongJumpScope jump;
+  if (setjmp(*jump.Set()) == 0) {
+    GrowableArray<ObjectPtr> base_objects;
+    AddBaseObjects(thread_, &base_objects);
+    const intptr_t num_objects = ReadUnsigned();
+    refs_ = Array::New(kFirstReference + base_objects.length() + num_objects);
+    for (intptr_t i = 0; i < base_objects.length(); i++) {
+      AssignRef(base_objects[i]);
+    }
+
+    const intptr_t num_clusters = ReadUnsigned();
+    MessageDeserializationCluster** clusters =
+        zone_->Alloc<MessageDeserializationCluster*>(num_clusters);
+    for (intptr_t i = 0; i < num_clusters; i++) {
+      clusters[i] = ReadCluster();
+      clusters[i]->ReadAlloc(this);
+    }
+    ASSERT(next_ref_ == refs_.Length());
+    for (intptr_t i = 0; i < num_clusters; i++) {
+      clusters[i]->ReadFill(this);
+    }
+    const Object& root = Object::Handle(zone_, ReadRef());
+    ASSERT(stream_.PendingBytes() == 0);
+
+    const Object& ok = Object::Handle(zone_, RunDelayedRehashingOfMaps());
+    if (!ok.IsNull()) {
+      return ok.ptr();
+    }
+    return root.ptr();
+  } else {
+    // An error occurred while reading, return the error object.
+    return thread_->StealStickyError();
+  }
+}
+
+std::unique_ptr<Message> WriteClusteredMessage(Thread* thread,
+                                               const Object& obj,
+                                               Dart_Port dest_port,
+                                               Message::Priority priority) {
+  MessageSerializer serializer(thread);
+  {
+    // The identity table is keyed by address.
+    NoSafepointScope no_safepoint;
+    if (!serializer.Trace(obj.ptr())) {
+      return nullptr;
+    }
+    serializer.Serialize(obj.ptr());
+  }
+  intptr_t size;
+  uint8_t* buffer = serializer.Steal(&size);
+  std::unique_ptr<Message> message = Message::New(
+      dest_port, buffer, size, /*finalizable_data=*/nullptr, priority);
+  message->set_is_clustered(true);
+  return message;
+}
+
+ObjectPtr ReadClusteredMessage(Thread* thread, Message* message) {
+  MessageDeserializer deserializer(thread, message);
+  return deserializer.Deserialize();
+}
+
+}  // namespace dart
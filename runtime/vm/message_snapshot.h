@@ -0,0 +1,42 @@
+// Copyright (c) 2021, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef RUNTIME_VM_MESSAGE_SNAPSHOT_H_
+#define RUNTIME_VM_MESSAGE_SNAPSHOT_H_
+
+#include <memory>
+
+#include "vm/globals.h"
+#include "vm/message.h"
+#include "vm/tagged_pointer.h"
+
+namespace dart {
+
+class Object;
+class Thread;
+
+// A clustered encoding for messages sent between isolates of the same group.
+//
+// Like the full snapshot format (see clustered_snapshot.h), objects are
+// grouped by class and written in two sections: the first describes how to
+// allocate the objects and the second how to fill in their references. The
+// reader therefore never needs to track partially read objects, which avoids
+// the per-object back reference bookkeeping of MessageSnapshotReader.
+//
+// Only a subset of classes common in messages is supported (strings, numbers,
+// lists, maps and internal typed data). WriteClusteredMessage returns nullptr
+// if the object graph contains anything else, in which case the caller should
+// fall back to MessageWriter.
+std::unique_ptr<Message> WriteClusteredMessage(Thread* thread,
+                                               const Object& obj,
+                                               Dart_Port dest_port,
+                                               Message::Priority priority);
+
+// Reads a message written by WriteClusteredMessage. Returns an error object if
+// the message could not be read.
+ObjectPtr ReadClusteredMessage(Thread* thread, Message* message);
+
+}  // namespace dart
+
+#endif  // RUNTIME_VM_MESSAGE_SNAPSHOT_H_
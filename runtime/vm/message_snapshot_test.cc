@@ -0,0 +1,126 @@
+// Copyright (c) 2021, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "platform/assert.h"
+#include "vm/dart_api_impl.h"
+#include "vm/message.h"
+#include "vm/message_snapshot.h"
+#include "vm/object.h"
+#include "vm/symbols.h"
+#include "vm/unit_test.h"
+
+namespace dart {
+
+static ObjectPtr RoundTrip(Thread* thread, const Object& obj) {
+  std::unique_ptr<Message> message =
+      WriteClusteredMessage(thread, obj, ILLEGAL_PORT, Message::kNormalPriority);
+  EXPECT(message != nullptr);
+  EXPECT(message->IsClustered());
+  return ReadClusteredMessage(thread, message.get());
+}
+
+ISOLATE_UNIT_TEST_CASE(ClusteredMessage_Leaves) {
+  const Array& array = Array::Handle(Array::New(7));
+  array.SetAt(0, Smi::Handle(Smi::New(-42)));
+  array.SetAt(1, Integer::Handle(Integer::New(kMaxInt64)));
+  array.SetAt(2, Double::Handle(Double::New(3.5)));
+  array.SetAt(3, String::Handle(String::New("one byte")));
+  array.SetAt(4, String::Handle(String::New("two byte \xE4\xB8\xAD")));
+  array.SetAt(5, Symbols::Dot());
+  TypedData& bytes =
+      TypedData::Handle(TypedData::New(kTypedDataInt32ArrayCid, 3));
+  bytes.SetInt32(0, -1);
+  bytes.SetInt32(4, 2);
+  bytes.SetInt32(8, 3);
+  array.SetAt(6, bytes);
+
+  Array& result = Array::Handle();
+  result ^= RoundTrip(thread, array);
+  EXPECT_EQ(7, result.Length());
+  EXPECT_EQ(-42, Smi::Value(Smi::RawCast(result.At(0))));
+  EXPECT_EQ(kMaxInt64, Integer::Handle(Integer::RawCast(result.At(1)))
+                           .AsInt64Value());
+  EXPECT_EQ(3.5, Double::Handle(Double::RawCast(result.At(2))).value());
+  String& str = String::Handle();
+  str ^= result.At(3);
+  EXPECT(str.Equals("one byte"));
+  EXPECT(!str.IsCanonical());
+  str ^= result.At(4);
+  EXPECT(str.Equals(String::Handle(String::RawCast(array.At(4)))));
+  EXPECT(str.IsTwoByteString());
+  EXPECT_EQ(Symbols::Dot().ptr(), result.At(5));
+  bytes ^= result.At(6);
+  EXPECT_EQ(3, bytes.Length());
+  EXPECT_EQ(-1, bytes.GetInt32(0));
+  EXPECT_EQ(3, bytes.GetInt32(8));
+}
+
+ISOLATE_UNIT_TEST_CASE(ClusteredMessage_SharedAndCyclic) {
+  const Array& outer = Array::Handle(Array::New(3));
+  const Array& inner = Array::Handle(Array::New(1));
+  const GrowableObjectArray& list =
+      GrowableObjectArray::Handle(GrowableObjectArray::New());
+  inner.SetAt(0, outer);
+  list.Add(inner);
+  list.Add(Smi::Handle(Smi::New(1)));
+  outer.SetAt(0, inner);
+  outer.SetAt(1, inner);
+  outer.SetAt(2, list);
+
+  Array& result = Array::Handle();
+  result ^= RoundTrip(thread, outer);
+  EXPECT_EQ(3, result.Length());
+  EXPECT_EQ(result.At(0), result.At(1));
+  Array& result_inner = Array::Handle();
+  result_inner ^= result.At(0);
+  EXPECT_EQ(result.ptr(), result_inner.At(0));
+  GrowableObjectArray& result_list = GrowableObjectArray::Handle();
+  result_list ^= result.At(2);
+  EXPECT_EQ(2, result_list.Length());
+  EXPECT_EQ(result_inner.ptr(), result_list.At(0));
+}
+
+ISOLATE_UNIT_TEST_CASE(ClusteredMessage_Unsupported) {
+  // Objects of other classes make the caller fall back to MessageWriter.
+  const Array& array = Array::Handle(Array::New(1));
+  array.SetAt(0, Object::Handle(Library::CoreLibrary()));
+  std::unique_ptr<Message> message = WriteClusteredMessage(
+      thread, array, ILLEGAL_PORT, Message::kNormalPriority);
+  EXPECT(message == nullptr);
+}
+
+TEST_CASE(ClusteredMessage_Map) {
+  const char* kScript =
+      "getMap() {\n"
+      "  final map = <String, dynamic>{'a': 1, 'b': 2.5, 'c': [1, 2]};\n"
+      "  map.remove('b');\n"
+      "  map['d'] = map;\n"
+      "  return map;\n"
+      "}\n"
+      "checkMap(Map m) =>\n"
+      "    m.length == 3 && m['a'] == 1 && m['c'][1] == 2 &&\n"
+      "    identical(m['d'], m) && !m.containsKey('b');\n";
+  Dart_Handle lib = TestCase::LoadTestScript(kScript, NULL);
+  Dart_Handle map = Dart_Invoke(lib, NewString("getMap"), 0, NULL);
+  EXPECT_VALID(map);
+
+  Dart_Handle copy;
+  {
+    TransitionNativeToVM transition(thread);
+    const Object& obj = Object::Handle(Api::UnwrapHandle(map));
+    const Object& result = Object::Handle(RoundTrip(thread, obj));
+    EXPECT(result.IsLinkedHashMap());
+    EXPECT(result.ptr() != obj.ptr());
+    copy = Api::NewHandle(thread, result.ptr());
+  }
+  Dart_Handle args[] = {copy};
+  Dart_Handle result = Dart_Invoke(lib, NewString("checkMap"), 1, args);
+  EXPECT_VALID(result);
+  EXPECT(Dart_IsBoolean(result));
+  bool value = false;
+  EXPECT_VALID(Dart_BooleanValue(result, &value));
+  EXPECT(value);
+}
+
+}  // namespace dart
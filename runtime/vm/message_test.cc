@@ -4,6 +4,8 @@
 
 #include "vm/message.h"
 #include "platform/assert.h"
+#include "vm/lockers.h"
+#include "vm/object.h"
 #include "vm/unit_test.h"
 
 namespace dart {
@@ -140,4 +142,124 @@ TEST_CASE(MessageQueue_Clear) {
   EXPECT(queue.IsEmpty());
 }
 
+TEST_CASE(MessageQueue_Batch) {
+  MessageQueue queue;
+  MessageQueue batch;
+  const char* str = "msg";
+  for (Dart_Port port = 1; port <= 5; port++) {
+    queue.Enqueue(Message::New(port, AllocMsg(str), strlen(str) + 1, nullptr,
+                               Message::kNormalPriority),
+                  false);
+  }
+
+  queue.DequeueBatch(&batch, 3);
+  EXPECT_EQ(3, batch.Length());
+  EXPECT_EQ(2, queue.Length());
+  std::unique_ptr<Message> msg = batch.Dequeue();
+  EXPECT_EQ(1, msg->dest_port());
+
+  // Returned messages keep their order.
+  queue.PrependBatch(&batch);
+  EXPECT(batch.IsEmpty());
+  EXPECT_EQ(4, queue.Length());
+  for (Dart_Port port = 2; port <= 5; port++) {
+    msg = queue.Dequeue();
+    EXPECT_EQ(port, msg->dest_port());
+  }
+  EXPECT(queue.IsEmpty());
+
+  // Batches can be larger than the queue and returned to an empty queue.
+  queue.Enqueue(Message::New(6, AllocMsg(str), strlen(str) + 1, nullptr,
+                             Message::kNormalPriority),
+                false);
+  queue.DequeueBatch(&batch, 3);
+  EXPECT_EQ(1, batch.Length());
+  EXPECT(queue.IsEmpty());
+  queue.PrependBatch(&batch);
+  queue.Enqueue(Message::New(7, AllocMsg(str), strlen(str) + 1, nullptr,
+                             Message::kNormalPriority),
+                false);
+  EXPECT_EQ(2, queue.Length());
+  msg = queue.Dequeue();
+  EXPECT_EQ(6, msg->dest_port());
+  msg = queue.Dequeue();
+  EXPECT_EQ(7, msg->dest_port());
+  EXPECT(queue.IsEmpty());
+}
+
+struct ConcurrentEnqueueInfo {
+  MessageQueue* queue;
+  Dart_Port port;
+  intptr_t count;
+  Monitor* monitor;
+  intptr_t* done;
+  ThreadJoinId join_id;
+};
+
+static void EnqueueMessages(uword param) {
+  auto info = reinterpret_cast<ConcurrentEnqueueInfo*>(param);
+  for (intptr_t i = 0; i < info->count; i++) {
+    info->queue->EnqueueConcurrently(
+        Message::New(info->port, Smi::New(i), Message::kNormalPriority));
+  }
+  MonitorLocker ml(info->monitor);
+  info->join_id = OSThread::GetCurrentThreadJoinId(OSThread::Current());
+  (*info->done)++;
+  ml.Notify();
+}
+
+TEST_CASE(MessageQueue_EnqueueConcurrently) {
+  MessageQueue queue;
+  const char* str = "msg";
+  queue.Enqueue(Message::New(1, AllocMsg(str), strlen(str) + 1, nullptr,
+                             Message::kNormalPriority),
+                false);
+  EXPECT(queue.EnqueueConcurrently(
+      Message::New(2, Smi::New(0), Message::kNormalPriority)));
+  EXPECT(!queue.EnqueueConcurrently(
+      Message::New(3, Smi::New(0), Message::kNormalPriority)));
+  // Concurrently enqueued messages are only visible once collected.
+  EXPECT_EQ(1, queue.Length());
+  queue.CollectConcurrentlyEnqueued();
+  EXPECT_EQ(3, queue.Length());
+  for (Dart_Port port = 1; port <= 3; port++) {
+    std::unique_ptr<Message> msg = queue.Dequeue();
+    EXPECT_EQ(port, msg->dest_port());
+  }
+  EXPECT(queue.IsEmpty());
+
+  // Messages from many threads keep the order of each thread.
+  const intptr_t kNumThreads = 4;
+  const intptr_t kMessagesPerThread = 10000;
+  Monitor monitor;
+  intptr_t done = 0;
+  ConcurrentEnqueueInfo infos[kNumThreads];
+  for (intptr_t i = 0; i < kNumThreads; i++) {
+    infos[i] = {&queue, i + 1, kMessagesPerThread, &monitor, &done,
+                OSThread::kInvalidThreadJoinId};
+    OSThread::Start("EnqueueMessages", EnqueueMessages,
+                    reinterpret_cast<uword>(&infos[i]));
+  }
+  intptr_t next[kNumThreads] = {};
+  intptr_t received = 0;
+  bool all_done = false;
+  while (!all_done) {
+    {
+      MonitorLocker ml(&monitor);
+      all_done = (done == kNumThreads);
+    }
+    queue.CollectConcurrentlyEnqueued();
+    while (std::unique_ptr<Message> msg = queue.Dequeue()) {
+      const intptr_t thread = msg->dest_port() - 1;
+      EXPECT_EQ(next[thread], Smi::Value(Smi::RawCast(msg->raw_obj())));
+      next[thread]++;
+      received++;
+    }
+  }
+  EXPECT_EQ(kNumThreads * kMessagesPerThread, received);
+  for (intptr_t i = 0; i < kNumThreads; i++) {
+    OSThread::Join(infos[i].join_id);
+  }
+}
+
 }  // namespace dart
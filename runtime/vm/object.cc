@@ -7316,6 +7316,20 @@ void Function::SetFfiCallbackId(int32_t value) const {
   FfiTrampolineData::Cast(obj).set_callback_id(value);
 }
 
+bool Function::FfiIsLeaf() const {
+  ASSERT(IsFfiTrampoline());
+  const Object& obj = Object::Handle(data());
+  ASSERT(!obj.IsNull());
+  return FfiTrampolineData::Cast(obj).is_leaf();
+}
+
+void Function::SetFfiIsLeaf(bool is_leaf) const {
+  ASSERT(IsFfiTrampoline());
+  const Object& obj = Object::Handle(data());
+  ASSERT(!obj.IsNull());
+  FfiTrampolineData::Cast(obj).set_is_leaf(is_leaf);
+}
+
 FunctionPtr Function::FfiCallbackTarget() const {
   ASSERT(IsFfiTrampoline());
   const Object& obj = Object::Handle(data());
@@ -10092,6 +10106,10 @@ void FfiTrampolineData::set_callback_id(int32_t callback_id) const {
   StoreNonPointer(&untag()->callback_id_, callback_id);
 }
 
+void FfiTrampolineData::set_is_leaf(bool is_leaf) const {
+  StoreNonPointer(&untag()->is_leaf_, is_leaf);
+}
+
 void FfiTrampolineData::set_callback_exceptional_return(
     const Instance& value) const {
   untag()->set_callback_exceptional_return(value.ptr());
@@ -10104,6 +10122,7 @@ FfiTrampolineDataPtr FfiTrampolineData::New() {
                                    Heap::kOld, /*compressed*/ true);
   FfiTrampolineDataPtr data = static_cast<FfiTrampolineDataPtr>(raw);
   data->untag()->callback_id_ = 0;
+  data->untag()->is_leaf_ = false;
   return data;
 }
 
@@ -22287,6 +22306,20 @@ bool String::Equals(const String& str,
     return false;  // Lengths don't match.
   }
 
+  // Strings with the same representation are compared with memcmp, which is
+  // vectorized on most platforms.
+  if (IsOneByteString() && str.IsOneByteString()) {
+    NoSafepointScope no_safepoint;
+    return memcmp(OneByteString::DataStart(*this),
+                  OneByteString::DataStart(str) + begin_index, len) == 0;
+  }
+  if (IsTwoByteString() && str.IsTwoByteString()) {
+    NoSafepointScope no_safepoint;
+    return memcmp(TwoByteString::DataStart(*this),
+                  TwoByteString::DataStart(str) + begin_index,
+                  len * sizeof(uint16_t)) == 0;
+  }
+
   for (intptr_t i = 0; i < len; i++) {
     if (CharAt(i) != str.CharAt(begin_index + i)) {
       return false;
@@ -22422,6 +22455,67 @@ bool String::EndsWith(const String& other) const {
   return true;
 }
 
+intptr_t String::IndexOfCodeUnit(uint16_t code_unit, intptr_t start) const {
+  const intptr_t len = Length();
+  ASSERT((start >= 0) && (start <= len));
+  if (IsOneByteString()) {
+    if (code_unit > 0xFF) {
+      return -1;
+    }
+    NoSafepointScope no_safepoint;
+    const uint8_t* data = OneByteString::DataStart(*this);
+    const void* found = memchr(data + start, code_unit, len - start);
+    return (found == nullptr) ? -1 : static_cast<const uint8_t*>(found) - data;
+  }
+  for (intptr_t i = start; i < len; i++) {
+    if (CharAt(i) == code_unit) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+intptr_t String::IndexOf(const String& pattern, intptr_t start) const {
+  const intptr_t len = Length();
+  const intptr_t pattern_len = pattern.Length();
+  ASSERT((start >= 0) && (start <= len));
+  if (pattern_len == 0) {
+    return start;
+  }
+  const intptr_t max_index = len - pattern_len;
+  if (IsOneByteString() && pattern.IsOneByteString()) {
+    // Find candidates for the first character with memchr and check them
+    // with memcmp, both of which are vectorized on most platforms.
+    NoSafepointScope no_safepoint;
+    const uint8_t* data = OneByteString::DataStart(*this);
+    const uint8_t* pattern_data = OneByteString::DataStart(pattern);
+    intptr_t i = start;
+    while (i <= max_index) {
+      const void* found = memchr(data + i, pattern_data[0], max_index - i + 1);
+      if (found == nullptr) {
+        return -1;
+      }
+      i = static_cast<const uint8_t*>(found) - data;
+      if (memcmp(data + i + 1, pattern_data + 1, pattern_len - 1) == 0) {
+        return i;
+      }
+      i++;
+    }
+    return -1;
+  }
+  const uint16_t first = pattern.CharAt(0);
+  for (intptr_t i = start; i <= max_index; i++) {
+    i = IndexOfCodeUnit(first, i);
+    if ((i < 0) || (i > max_index)) {
+      return -1;
+    }
+    if (pattern.Equals(*this, i, pattern_len)) {
+      return i;
+    }
+  }
+  return -1;
+}
+
 InstancePtr String::CanonicalizeLocked(Thread* thread) const {
   if (IsCanonical()) {
     return this->ptr();
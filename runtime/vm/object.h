@@ -2491,6 +2491,13 @@ class Function : public Object {
   // Can only be called on FFI trampolines.
   void SetFfiCallbackId(int32_t value) const;
 
+  // Can only be called on FFI trampolines.
+  // Whether the native call stays in generated code (see FfiCallInstr).
+  bool FfiIsLeaf() const;
+
+  // Can only be called on FFI trampolines.
+  void SetFfiIsLeaf(bool is_leaf) const;
+
   // Can only be called on FFI trampolines.
   // Null for Dart -> native calls.
   FunctionPtr FfiCallbackTarget() const;
@@ -3826,6 +3833,9 @@ class FfiTrampolineData : public Object {
   int32_t callback_id() const { return untag()->callback_id_; }
   void set_callback_id(int32_t value) const;
 
+  bool is_leaf() const { return untag()->is_leaf_; }
+  void set_is_leaf(bool value) const;
+
   static FfiTrampolineDataPtr New();
 
   FINAL_HEAP_OBJECT_IMPLEMENTATION(FfiTrampolineData, Object);
@@ -8896,6 +8906,11 @@ class String : public Instance {
   static bool StartsWith(StringPtr str, StringPtr prefix);
   bool EndsWith(const String& other) const;
 
+  // Returns the index of the first occurrence of 'pattern' (or of
+  // 'code_unit') at or after 'start', or -1 if there is none.
+  intptr_t IndexOf(const String& pattern, intptr_t start) const;
+  intptr_t IndexOfCodeUnit(uint16_t code_unit, intptr_t start) const;
+
   // Strings are canonicalized using the symbol table.
   // Caller must hold IsolateGroup::constant_canonicalization_mutex_.
   virtual InstancePtr CanonicalizeLocked(Thread* thread) const;
@@ -9260,6 +9275,7 @@ class OneByteString : public AllStatic {
   friend class Class;
   friend class ExternalOneByteString;
   friend class ImageWriter;
+  friend class OneByteStringMessageSerializationCluster;
   friend class SnapshotReader;
   friend class String;
   friend class StringHasher;
@@ -9385,6 +9401,7 @@ class TwoByteString : public AllStatic {
   friend class String;
   friend class StringHasher;
   friend class Symbols;
+  friend class TwoByteStringMessageSerializationCluster;
 };
 
 class ExternalOneByteString : public AllStatic {
@@ -10641,6 +10658,7 @@ class LinkedHashMap : public Instance {
 
   friend class Class;
   friend class LinkedHashMapDeserializationCluster;
+  friend class LinkedHashMapMessageDeserializationCluster;
 };
 
 class Closure : public Instance {
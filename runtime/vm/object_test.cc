@@ -1638,6 +1638,40 @@ ISOLATE_UNIT_TEST_CASE(StringEqualsUTF32) {
   EXPECT(!th_str.Equals(chars, 3));
 }
 
+ISOLATE_UNIT_TEST_CASE(StringIndexOf) {
+  const String& one = String::Handle(
+      String::New("GET /index.html 200 GET /favicon.ico 404 GET /a 200"));
+  EXPECT(one.IsOneByteString());
+  EXPECT_EQ(0, one.IndexOf(String::Handle(String::New("GET")), 0));
+  EXPECT_EQ(20, one.IndexOf(String::Handle(String::New("GET")), 1));
+  EXPECT_EQ(37, one.IndexOf(String::Handle(String::New("404")), 0));
+  EXPECT_EQ(-1, one.IndexOf(String::Handle(String::New("500")), 0));
+  EXPECT_EQ(-1, one.IndexOf(String::Handle(String::New("200 GET /b")), 0));
+  EXPECT_EQ(5, one.IndexOf(String::Handle(String::New("")), 5));
+  EXPECT_EQ(4, one.IndexOfCodeUnit('/', 0));
+  EXPECT_EQ(24, one.IndexOfCodeUnit('/', 5));
+  EXPECT_EQ(-1, one.IndexOfCodeUnit(0x5D0, 0));
+
+  const String& two = String::Handle(
+      String::New("abc \xD7\x90\xD7\x91 abc \xD7\x90\xD7\x91\xD7\x92"));
+  EXPECT(two.IsTwoByteString());
+  EXPECT_EQ(4, two.IndexOf(String::Handle(String::New("\xD7\x90\xD7\x91")),
+                           0));
+  EXPECT_EQ(11, two.IndexOf(String::Handle(String::New("\xD7\x90\xD7\x91")),
+                            5));
+  EXPECT_EQ(7, two.IndexOf(String::Handle(String::New("abc")), 1));
+  EXPECT_EQ(-1, two.IndexOf(String::Handle(String::New("abcd")), 0));
+  EXPECT_EQ(13, two.IndexOfCodeUnit(0x5D2, 0));
+
+  // Equality of strings with the same representation uses memcmp.
+  const String& one_copy = String::Handle(String::New(
+      "GET /index.html 200 GET /favicon.ico 404 GET /a 200"));
+  EXPECT(one.Equals(one_copy));
+  const String& one_diff = String::Handle(String::New(
+      "GET /index.html 200 GET /favicon.ico 404 GET /a 201"));
+  EXPECT(!one.Equals(one_diff));
+}
+
 static void NoopFinalizer(void* isolate_callback_data, void* peer) {}
 
 ISOLATE_UNIT_TEST_CASE(ExternalOneByteString) {
@@ -10,6 +10,7 @@
 #include "vm/log.h"
 #include "vm/thread_interrupter.h"
 #include "vm/timeline.h"
+#include "vm/zone.h"
 
 namespace dart {
 
@@ -77,6 +78,7 @@ OSThread::~OSThread() {
     FATAL("Thread exited without calling Dart_ExitIsolate");
   }
   RemoveThreadFromList(this);
+  Zone::ReleaseSegmentCache(this);
   delete log_;
   log_ = NULL;
 #if defined(SUPPORT_TIMELINE)
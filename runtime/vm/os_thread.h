@@ -39,6 +39,7 @@ class Log;
 class Mutex;
 class ThreadState;
 class TimelineEventBlock;
+class ZoneSegmentCache;
 
 class Mutex {
  public:
@@ -157,6 +158,13 @@ class OSThread : public BaseThread {
   void EnableThreadInterrupts();
   bool ThreadInterruptsEnabled();
 
+  // Zone segments released on this thread, kept for reuse by later zones
+  // without going through the global segment cache. See zone.cc.
+  ZoneSegmentCache* zone_segment_cache() const { return zone_segment_cache_; }
+  void set_zone_segment_cache(ZoneSegmentCache* cache) {
+    zone_segment_cache_ = cache;
+  }
+
   // The currently executing thread, or NULL if not yet initialized.
   static OSThread* TryCurrent() {
     BaseThread* thread = GetCurrentTLS();
@@ -299,6 +307,8 @@ class OSThread : public BaseThread {
   // started by a ThreadPool it will be nullptr. This TLS value is not
   // protected and should only be read/written by the OSThread itself.
   void* owning_thread_pool_worker_ = nullptr;
+  // Only accessed by the thread itself, or when it is destroyed.
+  ZoneSegmentCache* zone_segment_cache_ = nullptr;
 
   // thread_list_lock_ cannot have a static lifetime because the order in which
   // destructors run is undefined. At the moment this lock cannot be deleted
@@ -17,7 +17,7 @@
 namespace dart {
 
 Mutex* PortMap::mutex_ = NULL;
-PortSet<PortMap::Entry>* PortMap::ports_ = NULL;
+PortMap::Shard* PortMap::shards_ = NULL;
 MessageHandler* PortMap::deleted_entry_ = reinterpret_cast<MessageHandler*>(1);
 Random* PortMap::prng_ = NULL;
 
@@ -59,18 +59,26 @@ Dart_Port PortMap::AllocatePort() {
     }
 
     ASSERT(!static_cast<ObjectPtr>(static_cast<uword>(result))->IsWellFormed());
-  } while (ports_->Contains(result));
+
+    // Ports are only added while holding [mutex_], so the port stays unused
+    // until the caller adds it.
+    Shard* shard = ShardOf(result);
+    MutexLocker ml(&shard->mutex);
+    if (!shard->ports.Contains(result)) {
+      break;
+    }
+  } while (true);
 
   ASSERT(result != 0);
-  ASSERT(!ports_->Contains(result));
   return result;
 }
 
 void PortMap::SetPortState(Dart_Port port, PortState state) {
-  MutexLocker ml(mutex_);
+  Shard* shard = ShardOf(port);
+  MutexLocker ml(&shard->mutex);
 
-  auto it = ports_->TryLookup(port);
-  ASSERT(it != ports_->end());
+  auto it = shard->ports.TryLookup(port);
+  ASSERT(it != shard->ports.end());
 
   Entry& entry = *it;
   PortState old_state = entry.state;
@@ -109,7 +117,11 @@ Dart_Port PortMap::CreatePort(MessageHandler* handler) {
   entry.port = port;
   entry.handler = handler;
   entry.state = kNewPort;
-  ports_->Insert(entry);
+  {
+    Shard* shard = ShardOf(port);
+    MutexLocker shard_locker(&shard->mutex);
+    shard->ports.Insert(entry);
+  }
 
   if (FLAG_trace_isolates) {
     OS::PrintErr(
@@ -126,8 +138,10 @@ bool PortMap::ClosePort(Dart_Port port) {
   MessageHandler* handler = NULL;
   {
     MutexLocker ml(mutex_);
-    auto it = ports_->TryLookup(port);
-    if (it == ports_->end()) {
+    Shard* shard = ShardOf(port);
+    MutexLocker shard_locker(&shard->mutex);
+    auto it = shard->ports.TryLookup(port);
+    if (it == shard->ports.end()) {
       return false;
     }
     Entry entry = *it;
@@ -145,7 +159,7 @@ bool PortMap::ClosePort(Dart_Port port) {
     // Delete the port entry before releasing the lock to avoid holding the lock
     // while flushing the messages below.
     it.Delete();
-    ports_->Rebalance();
+    shard->ports.Rebalance();
 
     // The MessageHandler::ports_ is only accessed by [PortMap], it is guarded
     // by the [PortMap::mutex_] we already hold.
@@ -169,8 +183,10 @@ void PortMap::ClosePorts(MessageHandler* handler) {
     // by the [PortMap::mutex_] we already hold.
     for (auto isolate_it = handler->ports_.begin();
          isolate_it != handler->ports_.end(); ++isolate_it) {
-      auto it = ports_->TryLookup((*isolate_it).port);
-      ASSERT(it != ports_->end());
+      Shard* shard = ShardOf((*isolate_it).port);
+      MutexLocker shard_locker(&shard->mutex);
+      auto it = shard->ports.TryLookup((*isolate_it).port);
+      ASSERT(it != shard->ports.end());
       Entry entry = *it;
       ASSERT(entry.port == (*isolate_it).port);
       ASSERT(entry.handler == handler);
@@ -178,19 +194,21 @@ void PortMap::ClosePorts(MessageHandler* handler) {
         handler->decrement_live_ports();
       }
       it.Delete();
+      shard->ports.Rebalance();
       isolate_it.Delete();
     }
     ASSERT(handler->ports_.IsEmpty());
-    ports_->Rebalance();
   }
   handler->CloseAllPorts();
 }
 
 bool PortMap::PostMessage(std::unique_ptr<Message> message,
                           bool before_events) {
-  MutexLocker ml(mutex_);
-  auto it = ports_->TryLookup(message->dest_port());
-  if (it == ports_->end()) {
+  // Holding the lock keeps the handler from being deleted while posting.
+  Shard* shard = ShardOf(message->dest_port());
+  MutexLocker ml(&shard->mutex);
+  auto it = shard->ports.TryLookup(message->dest_port());
+  if (it == shard->ports.end()) {
     // Ownership of external data remains with the poster.
     message->DropFinalizers();
     return false;
@@ -202,9 +220,10 @@ bool PortMap::PostMessage(std::unique_ptr<Message> message,
 }
 
 bool PortMap::IsLocalPort(Dart_Port id) {
-  MutexLocker ml(mutex_);
-  auto it = ports_->TryLookup(id);
-  if (it == ports_->end()) {
+  Shard* shard = ShardOf(id);
+  MutexLocker ml(&shard->mutex);
+  auto it = shard->ports.TryLookup(id);
+  if (it == shard->ports.end()) {
     // Port does not exist.
     return false;
   }
@@ -215,9 +234,10 @@ bool PortMap::IsLocalPort(Dart_Port id) {
 }
 
 bool PortMap::IsLivePort(Dart_Port id) {
-  MutexLocker ml(mutex_);
-  auto it = ports_->TryLookup(id);
-  if (it == ports_->end()) {
+  Shard* shard = ShardOf(id);
+  MutexLocker ml(&shard->mutex);
+  auto it = shard->ports.TryLookup(id);
+  if (it == shard->ports.end()) {
     // Port does not exist.
     return false;
   }
@@ -227,9 +247,10 @@ bool PortMap::IsLivePort(Dart_Port id) {
 }
 
 Isolate* PortMap::GetIsolate(Dart_Port id) {
-  MutexLocker ml(mutex_);
-  auto it = ports_->TryLookup(id);
-  if (it == ports_->end()) {
+  Shard* shard = ShardOf(id);
+  MutexLocker ml(&shard->mutex);
+  auto it = shard->ports.TryLookup(id);
+  if (it == shard->ports.end()) {
     // Port does not exist.
     return nullptr;
   }
@@ -240,14 +261,17 @@ Isolate* PortMap::GetIsolate(Dart_Port id) {
 
 bool PortMap::IsReceiverInThisIsolateGroup(Dart_Port receiver,
                                            IsolateGroup* group) {
-  MutexLocker ml(mutex_);
-  auto it = ports_->TryLookup(receiver);
-  if (it == ports_->end()) return false;
-  return (*it).handler->isolate()->group() == group;
+  Shard* shard = ShardOf(receiver);
+  MutexLocker ml(&shard->mutex);
+  auto it = shard->ports.TryLookup(receiver);
+  if (it == shard->ports.end()) return false;
+  // Native ports are not owned by any isolate.
+  Isolate* isolate = (*it).handler->isolate();
+  return (isolate != nullptr) && (isolate->group() == group);
 }
 
 void PortMap::Init() {
-  // TODO(bkonyi): don't keep ports_ after Dart_Cleanup.
+  // TODO(bkonyi): don't keep shards_ after Dart_Cleanup.
   if (mutex_ == NULL) {
     mutex_ = new Mutex();
   }
@@ -255,30 +279,42 @@ void PortMap::Init() {
   if (prng_ == nullptr) {
     prng_ = new Random();
   }
-  if (ports_ == nullptr) {
-    ports_ = new PortSet<Entry>();
+  if (shards_ == nullptr) {
+    shards_ = new Shard[kNumShards];
   }
 }
 
 void PortMap::Cleanup() {
-  ASSERT(ports_ != nullptr);
+  ASSERT(shards_ != nullptr);
   ASSERT(prng_ != NULL);
-  for (auto it = ports_->begin(); it != ports_->end(); ++it) {
-    const auto& entry = *it;
-    ASSERT(entry.handler != nullptr);
-    if (entry.state == kLivePort) {
-      entry.handler->decrement_live_ports();
+  for (intptr_t i = 0; i < kNumShards; i++) {
+    PortSet<Entry>* ports = &shards_[i].ports;
+    for (auto it = ports->begin(); it != ports->end(); ++it) {
+      const auto& entry = *it;
+      ASSERT(entry.handler != nullptr);
+      if (entry.state == kLivePort) {
+        entry.handler->decrement_live_ports();
+      }
+      delete entry.handler;
+      it.Delete();
     }
-    delete entry.handler;
-    it.Delete();
+    ports->Rebalance();
   }
-  ports_->Rebalance();
 
   delete prng_;
   prng_ = NULL;
   // TODO(bkonyi): find out why deleting map_ sometimes causes crashes.
-  // delete ports_;
-  // ports_ = nullptr;
+  // delete shards_;
+  // shards_ = nullptr;
+}
+
+PortMap::PortState PortMap::StateLocked(Dart_Port port) {
+  ASSERT(mutex_->IsOwnedByCurrentThread());
+  Shard* shard = ShardOf(port);
+  MutexLocker ml(&shard->mutex);
+  auto it = shard->ports.TryLookup(port);
+  ASSERT(it != shard->ports.end());
+  return (*it).state;
 }
 
 void PortMap::PrintPortsForMessageHandler(MessageHandler* handler,
@@ -290,15 +326,14 @@ void PortMap::PrintPortsForMessageHandler(MessageHandler* handler,
   {
     JSONArray ports(&jsobj, "ports");
     SafepointMutexLocker ml(mutex_);
-    for (auto& entry : *ports_) {
-      if (entry.handler == handler) {
-        if (entry.state == kLivePort) {
-          JSONObject port(&ports);
-          port.AddProperty("type", "_Port");
-          port.AddPropertyF("name", "Isolate Port (%" Pd64 ")", entry.port);
-          msg_handler = DartLibraryCalls::LookupHandler(entry.port);
-          port.AddProperty("handler", msg_handler);
-        }
+    for (auto& isolate_entry : handler->ports_) {
+      if (StateLocked(isolate_entry.port) == kLivePort) {
+        JSONObject port(&ports);
+        port.AddProperty("type", "_Port");
+        port.AddPropertyF("name", "Isolate Port (%" Pd64 ")",
+                          isolate_entry.port);
+        msg_handler = DartLibraryCalls::LookupHandler(isolate_entry.port);
+        port.AddProperty("handler", msg_handler);
       }
     }
   }
@@ -308,13 +343,11 @@ void PortMap::PrintPortsForMessageHandler(MessageHandler* handler,
 void PortMap::DebugDumpForMessageHandler(MessageHandler* handler) {
   SafepointMutexLocker ml(mutex_);
   Object& msg_handler = Object::Handle();
-  for (auto& entry : *ports_) {
-    if (entry.handler == handler) {
-      if (entry.state == kLivePort) {
-        OS::PrintErr("Live Port = %" Pd64 "\n", entry.port);
-        msg_handler = DartLibraryCalls::LookupHandler(entry.port);
-        OS::PrintErr("Handler = %s\n", msg_handler.ToCString());
-      }
+  for (auto& isolate_entry : handler->ports_) {
+    if (StateLocked(isolate_entry.port) == kLivePort) {
+      OS::PrintErr("Live Port = %" Pd64 "\n", isolate_entry.port);
+      msg_handler = DartLibraryCalls::LookupHandler(isolate_entry.port);
+      OS::PrintErr("Handler = %s\n", msg_handler.ToCString());
     }
   }
 }
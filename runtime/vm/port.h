@@ -11,6 +11,7 @@
 #include "vm/allocation.h"
 #include "vm/globals.h"
 #include "vm/json_stream.h"
+#include "vm/os_thread.h"
 #include "vm/port_set.h"
 #include "vm/random.h"
 
@@ -19,7 +20,6 @@ namespace dart {
 class Isolate;
 class Message;
 class MessageHandler;
-class Mutex;
 class PortMapTestPeer;
 
 class PortMap : public AllStatic {
@@ -84,15 +84,34 @@ class PortMap : public AllStatic {
     PortState state;
   };
 
+  // The ports are split into shards, so that messages sent to ports of
+  // different shards do not contend for the same lock.
+  struct Shard {
+    // Lock protecting access to [ports]. Acquired after [PortMap::mutex_].
+    Mutex mutex;
+    PortSet<Entry> ports;
+  };
+
+  static const intptr_t kNumShards = 64;
+
+  static Shard* ShardOf(Dart_Port port) {
+    // The low bits of port ids are used by the hashing in [PortSet].
+    return &shards_[(port >> 32) % kNumShards];
+  }
+
   static const char* PortStateString(PortState state);
 
   // Allocate a new unique port.
   static Dart_Port AllocatePort();
 
-  // Lock protecting access to the port map.
+  // The state of an existing port. Requires holding [mutex_].
+  static PortState StateLocked(Dart_Port port);
+
+  // Lock protecting the allocation of ports and [MessageHandler::ports_].
+  // Ports are only added to and removed from the shards while holding it.
   static Mutex* mutex_;
 
-  static PortSet<Entry>* ports_;
+  static Shard* shards_;
   static MessageHandler* deleted_entry_;
 
   static Random* prng_;
@@ -15,15 +15,17 @@ namespace dart {
 class PortMapTestPeer {
  public:
   static bool IsActivePort(Dart_Port port) {
-    MutexLocker ml(PortMap::mutex_);
-    auto it = PortMap::ports_->TryLookup(port);
-    return it != PortMap::ports_->end();
+    PortMap::Shard* shard = PortMap::ShardOf(port);
+    MutexLocker ml(&shard->mutex);
+    auto it = shard->ports.TryLookup(port);
+    return it != shard->ports.end();
   }
 
   static bool IsLivePort(Dart_Port port) {
-    MutexLocker ml(PortMap::mutex_);
-    auto it = PortMap::ports_->TryLookup(port);
-    if (it == PortMap::ports_->end()) {
+    PortMap::Shard* shard = PortMap::ShardOf(port);
+    MutexLocker ml(&shard->mutex);
+    auto it = shard->ports.TryLookup(port);
+    if (it == shard->ports.end()) {
       return false;
     }
     return (*it).state == PortMap::kLivePort;
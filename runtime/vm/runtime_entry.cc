@@ -3508,6 +3508,10 @@ static Thread* GetThreadForNativeCallback(uword callback_id,
   if (!thread->IsMutatorThread()) {
     FATAL("Native callbacks must be invoked on the mutator thread.");
   }
+  // Leaf calls do not leave generated code, see FfiCallInstr.
+  if (thread->execution_state() != Thread::kThreadInNative) {
+    FATAL("Cannot invoke native callback from a leaf call.");
+  }
 
   // Set the execution state to VM while waiting for the safepoint to end.
   // This isn't strictly necessary but enables tests to check that we're not
@@ -30,6 +30,7 @@
 #include "vm/malloc_hooks.h"
 #include "vm/message.h"
 #include "vm/message_handler.h"
+#include "vm/message_snapshot.h"
 #include "vm/native_arguments.h"
 #include "vm/native_entry.h"
 #include "vm/native_symbol.h"
@@ -48,6 +49,7 @@
 #include "vm/source_report.h"
 #include "vm/stack_frame.h"
 #include "vm/symbols.h"
+#include "vm/thread_pool.h"
 #include "vm/timeline.h"
 #include "vm/version.h"
 
@@ -2026,6 +2028,8 @@ static ObjectPtr LookupHeapObjectMessage(Thread* thread,
   }
   if (message->IsRaw()) {
     return message->raw_obj();
+  } else if (message->IsClustered()) {
+    return ReadClusteredMessage(thread, message);
   } else {
     MessageSnapshotReader reader(message, thread);
     return reader.ReadObject();
@@ -4719,6 +4723,10 @@ void Service::PrintJSONForVM(JSONStream* js, bool ref) {
   jsobj.AddPropertyTimeMillis(
       "startTime", OS::GetCurrentTimeMillis() - Dart::UptimeMillis());
   MallocHooks::PrintToJSONObject(&jsobj);
+  {
+    JSONObject jspool(&jsobj, "_threadPool");
+    Dart::thread_pool()->PrintToJSONObject(&jspool);
+  }
   PrintJSONForEmbedderInformation(&jsobj);
   // Construct the isolate and isolate_groups list.
   {
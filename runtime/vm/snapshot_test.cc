@@ -22,6 +22,8 @@
 
 namespace dart {
 
+DECLARE_FLAG(int, deserialization_tasks);
+
 // Check if serialized and deserialized objects are equal.
 static bool Equals(const Object& expected, const Object& actual) {
   if (expected.IsNull()) {
@@ -691,7 +693,7 @@ ISOLATE_UNIT_TEST_CASE(SerializeEmptyByteArray) {
   CheckEncodeDecodeMessage(root);
 }
 
-VM_UNIT_TEST_CASE(FullSnapshot) {
+static void TestFullSnapshot() {
   // clang-format off
   auto kScriptChars = Utils::CStringUniquePtr(
       OS::SCreate(
@@ -778,6 +780,15 @@ VM_UNIT_TEST_CASE(FullSnapshot) {
   free(isolate_snapshot_data_buffer);
 }
 
+VM_UNIT_TEST_CASE(FullSnapshot) {
+  TestFullSnapshot();
+}
+
+VM_UNIT_TEST_CASE(FullSnapshotParallelFill) {
+  SetFlagScope<int> sfs(&FLAG_deserialization_tasks, 4);
+  TestFullSnapshot();
+}
+
 // Helper function to call a top level Dart function and serialize the result.
 static std::unique_ptr<Message> GetSerialized(Dart_Handle lib,
                                               const char* dart_function) {
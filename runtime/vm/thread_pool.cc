@@ -6,6 +6,7 @@
 
 #include "vm/dart.h"
 #include "vm/flags.h"
+#include "vm/json_stream.h"
 #include "vm/lockers.h"
 
 namespace dart {
@@ -120,6 +121,7 @@ void ThreadPool::MarkCurrentWorkerAsBlocked() {
         new_worker = new Worker(this);
         idle_workers_.Append(new_worker);
         count_idle_++;
+        workers_created_++;
       }
     }
   }
@@ -149,11 +151,10 @@ void ThreadPool::WorkerLoop(Worker* worker) {
   while (true) {
     MonitorLocker ml(&pool_monitor_);
 
-    if (!tasks_.IsEmpty()) {
+    if (pending_tasks_ > 0) {
       IdleToRunningLocked(worker);
-      while (!tasks_.IsEmpty()) {
-        std::unique_ptr<Task> task(tasks_.RemoveFirst());
-        pending_tasks_--;
+      while (pending_tasks_ > 0) {
+        std::unique_ptr<Task> task(TakeTaskLocked());
         MonitorLeaveScope mls(&ml);
         task->Run();
         ASSERT(Isolate::Current() == nullptr);
@@ -163,9 +164,9 @@ void ThreadPool::WorkerLoop(Worker* worker) {
     }
 
     if (running_workers_.IsEmpty()) {
-      ASSERT(tasks_.IsEmpty());
+      ASSERT(pending_tasks_ == 0);
       OnEnterIdleLocked(&ml);
-      if (!tasks_.IsEmpty()) {
+      if (pending_tasks_ > 0) {
         continue;
       }
     }
@@ -183,7 +184,7 @@ void ThreadPool::WorkerLoop(Worker* worker) {
       const auto result = ml.WaitMicros(ComputeTimeout(idle_start));
 
       // We have to drain all pending tasks.
-      if (!tasks_.IsEmpty()) break;
+      if (pending_tasks_ > 0) break;
 
       if (shutting_down_ || result == Monitor::kTimedOut) {
         done = true;
@@ -204,6 +205,19 @@ void ThreadPool::WorkerLoop(Worker* worker) {
   JoinDeadWorkersLocked(&dead_workers_to_join);
 }
 
+ThreadPool::Task* ThreadPool::TakeTaskLocked() {
+  ASSERT(pending_tasks_ > 0);
+  for (intptr_t i = 0; i < kNumPriorities; i++) {
+    if (!tasks_[i].IsEmpty()) {
+      pending_tasks_--;
+      tasks_run_[i]++;
+      return tasks_[i].RemoveFirst();
+    }
+  }
+  UNREACHABLE();
+  return nullptr;
+}
+
 void ThreadPool::IdleToRunningLocked(Worker* worker) {
   ASSERT(idle_workers_.ContainsForDebugging(worker));
   idle_workers_.Remove(worker);
@@ -213,7 +227,7 @@ void ThreadPool::IdleToRunningLocked(Worker* worker) {
 }
 
 void ThreadPool::RunningToIdleLocked(Worker* worker) {
-  ASSERT(tasks_.IsEmpty());
+  ASSERT(pending_tasks_ == 0);
 
   ASSERT(running_workers_.ContainsForDebugging(worker));
   running_workers_.Remove(worker);
@@ -223,7 +237,7 @@ void ThreadPool::RunningToIdleLocked(Worker* worker) {
 }
 
 void ThreadPool::IdleToDeadLocked(Worker* worker) {
-  ASSERT(tasks_.IsEmpty());
+  ASSERT(pending_tasks_ == 0);
 
   ASSERT(idle_workers_.ContainsForDebugging(worker));
   idle_workers_.Remove(worker);
@@ -262,9 +276,14 @@ void ThreadPool::JoinDeadWorkersLocked(WorkerList* dead_workers_to_join) {
 ThreadPool::Worker* ThreadPool::ScheduleTaskLocked(MonitorLocker* ml,
                                                    std::unique_ptr<Task> task) {
   // Enqueue the new task.
-  tasks_.Append(task.release());
+  const Priority priority = task->priority();
+  ASSERT(priority >= kHighPriority && priority < kNumPriorities);
+  tasks_[priority].Append(task.release());
   pending_tasks_++;
   ASSERT(pending_tasks_ >= 1);
+  if (pending_tasks_ > max_pending_tasks_) {
+    max_pending_tasks_ = pending_tasks_;
+  }
 
   // Notify existing idle worker (if available).
   if (count_idle_ >= pending_tasks_) {
@@ -274,8 +293,10 @@ ThreadPool::Worker* ThreadPool::ScheduleTaskLocked(MonitorLocker* ml,
   }
 
   // If we have maxed out the number of threads running, we will not start a
-  // new one.
-  if (max_pool_size_ > 0 && (count_idle_ + count_running_) >= max_pool_size_) {
+  // new one. High priority tasks are exempt, since the threads filling the
+  // pool might be waiting for them.
+  if (max_pool_size_ > 0 && (count_idle_ + count_running_) >= max_pool_size_ &&
+      priority != kHighPriority) {
     if (!idle_workers_.IsEmpty()) {
       ml->Notify();
     }
@@ -286,9 +307,25 @@ ThreadPool::Worker* ThreadPool::ScheduleTaskLocked(MonitorLocker* ml,
   auto new_worker = new Worker(this);
   idle_workers_.Append(new_worker);
   count_idle_++;
+  workers_created_++;
   return new_worker;
 }
 
+#ifndef PRODUCT
+void ThreadPool::PrintToJSONObject(JSONObject* jsobj) {
+  MonitorLocker ml(&pool_monitor_);
+  jsobj->AddProperty64("maxWorkers", max_pool_size_);
+  jsobj->AddProperty64("runningWorkers", count_running_);
+  jsobj->AddProperty64("idleWorkers", count_idle_);
+  jsobj->AddProperty64("workersCreated", workers_created_);
+  jsobj->AddProperty64("pendingTasks", pending_tasks_);
+  jsobj->AddProperty64("maxPendingTasks", max_pending_tasks_);
+  jsobj->AddProperty64("highPriorityTasksRun", tasks_run_[kHighPriority]);
+  jsobj->AddProperty64("normalPriorityTasksRun", tasks_run_[kNormalPriority]);
+  jsobj->AddProperty64("lowPriorityTasksRun", tasks_run_[kLowPriority]);
+}
+#endif  // !PRODUCT
+
 ThreadPool::Worker::Worker(ThreadPool* pool)
     : pool_(pool), join_id_(OSThread::kInvalidThreadJoinId) {}
 
@@ -15,10 +15,23 @@
 
 namespace dart {
 
+class JSONObject;
 class MonitorLocker;
 
 class ThreadPool {
  public:
+  // The order in which queued tasks are picked up by workers. Tasks of the
+  // same priority run in the order they were queued.
+  enum Priority {
+    // Tasks other threads are blocked on, e.g. helpers of a GC.
+    kHighPriority,
+    kNormalPriority,
+    // Tasks which can be delayed without blocking anybody, e.g. background
+    // compilation.
+    kLowPriority,
+    kNumPriorities,
+  };
+
   // Subclasses of Task are able to run on a ThreadPool.
   class Task : public IntrusiveDListEntry<Task> {
    protected:
@@ -30,6 +43,9 @@ class ThreadPool {
     // Override this to provide task-specific behavior.
     virtual void Run() = 0;
 
+    // Override this to run ahead of or behind other queued tasks.
+    virtual Priority priority() const { return kNormalPriority; }
+
    private:
     DISALLOW_COPY_AND_ASSIGN(Task);
   };
@@ -65,6 +81,14 @@ class ThreadPool {
   uint64_t workers_started() const { return count_idle_ + count_running_; }
   // Exposed for unit test in thread_pool_test.cc
   uint64_t workers_stopped() const { return count_dead_; }
+  // Exposed for unit test in thread_pool_test.cc
+  uint64_t tasks_run(Priority priority) const {
+    return tasks_run_[priority];
+  }
+
+#ifndef PRODUCT
+  void PrintToJSONObject(JSONObject* jsobj);
+#endif  // !PRODUCT
 
  private:
   class Worker : public IntrusiveDListEntry<Worker> {
@@ -102,7 +126,7 @@ class ThreadPool {
   bool ShuttingDownLocked() { return shutting_down_; }
 
   // Whether new tasks are ready to be run.
-  bool TasksWaitingToRunLocked() { return !tasks_.IsEmpty(); }
+  bool TasksWaitingToRunLocked() { return pending_tasks_ > 0; }
 
  private:
   using TaskList = IntrusiveDList<Task>;
@@ -111,6 +135,9 @@ class ThreadPool {
   bool RunImpl(std::unique_ptr<Task> task);
   void WorkerLoop(Worker* worker);
 
+  // Removes the oldest task of the highest priority from the queue.
+  Task* TakeTaskLocked();
+
   Worker* ScheduleTaskLocked(MonitorLocker* ml, std::unique_ptr<Task> task);
 
   void IdleToRunningLocked(Worker* worker);
@@ -128,7 +155,12 @@ class ThreadPool {
   WorkerList idle_workers_;
   WorkerList dead_workers_;
   uint64_t pending_tasks_ = 0;
-  TaskList tasks_;
+  TaskList tasks_[kNumPriorities];
+
+  // Statistics.
+  uint64_t tasks_run_[kNumPriorities] = {};
+  uint64_t max_pending_tasks_ = 0;
+  uint64_t workers_created_ = 0;
 
   Monitor exit_monitor_;
   std::atomic<bool> all_workers_dead_;
@@ -206,6 +206,60 @@ THREAD_POOL_UNIT_TEST_CASE(ThreadPool_WorkerTimeout) {
   FLAG_worker_timeout_millis = saved_timeout;
 }
 
+class PriorityTestTask : public ThreadPool::Task {
+ public:
+  PriorityTestTask(Monitor* sync,
+                   ThreadPool::Priority priority,
+                   MallocGrowableArray<ThreadPool::Priority>* order)
+      : sync_(sync), priority_(priority), order_(order) {}
+
+  virtual ThreadPool::Priority priority() const { return priority_; }
+
+  virtual void Run() {
+    MonitorLocker ml(sync_);
+    order_->Add(priority_);
+    // The worker blocked in TestTask waits on the same monitor.
+    ml.NotifyAll();
+  }
+
+ private:
+  Monitor* sync_;
+  ThreadPool::Priority priority_;
+  MallocGrowableArray<ThreadPool::Priority>* order_;
+};
+
+THREAD_POOL_UNIT_TEST_CASE(ThreadPool_Priority) {
+  // Queued tasks run by priority. High priority tasks do not wait for a
+  // worker of a full pool to become available.
+  ThreadPool thread_pool(1);
+  Monitor sync;
+  bool done = true;
+  MallocGrowableArray<ThreadPool::Priority> order;
+  thread_pool.Run<TestTask>(&sync, &done);
+  thread_pool.Run<PriorityTestTask>(&sync, ThreadPool::kLowPriority, &order);
+  thread_pool.Run<PriorityTestTask>(&sync, ThreadPool::kNormalPriority,
+                                    &order);
+  thread_pool.Run<PriorityTestTask>(&sync, ThreadPool::kHighPriority, &order);
+  {
+    // The worker is still blocked by the first task.
+    MonitorLocker ml(&sync);
+    while (order.length() < 3) {
+      ml.Wait();
+    }
+    done = false;
+    ml.NotifyAll();
+    while (!done) {
+      ml.Wait();
+    }
+  }
+  EXPECT_EQ(ThreadPool::kHighPriority, order[0]);
+  EXPECT_EQ(ThreadPool::kNormalPriority, order[1]);
+  EXPECT_EQ(ThreadPool::kLowPriority, order[2]);
+  EXPECT_EQ(1U, thread_pool.tasks_run(ThreadPool::kHighPriority));
+  EXPECT_EQ(2U, thread_pool.tasks_run(ThreadPool::kNormalPriority));
+  EXPECT_EQ(1U, thread_pool.tasks_run(ThreadPool::kLowPriority));
+}
+
 class SpawnTask : public ThreadPool::Task {
  public:
   SpawnTask(ThreadPool* pool, Monitor* sync, int todo, int total, int* done)
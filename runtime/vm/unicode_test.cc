@@ -1090,4 +1090,45 @@ ISOLATE_UNIT_TEST_CASE(Utf8Decode) {
   }
 }
 
+ISOLATE_UNIT_TEST_CASE(Utf8DecodeAsciiRuns) {
+  // Long runs of ASCII are handled a word at a time, check that the runs and
+  // the characters around them are decoded correctly.
+  const char* src =
+      "0123456789abcdefghij\xC3\xA9klmnopqrstuvwxyz\xE2\x82\xAC"
+      "ABCDEFGHIJKLMNOP\xF0\x9F\x98\x80QRS";
+  const uint8_t* utf8 = reinterpret_cast<const uint8_t*>(src);
+  const intptr_t utf8_len = strlen(src);
+  EXPECT(Utf8::IsValid(utf8, utf8_len));
+
+  Utf8::Type type;
+  const intptr_t len = Utf8::CodeUnitCount(utf8, utf8_len, &type);
+  EXPECT_EQ(Utf8::kSupplementary, type);
+  EXPECT_EQ(20 + 1 + 16 + 1 + 16 + 2 + 3, len);
+
+  uint16_t dst[64];
+  EXPECT(Utf8::DecodeToUTF16(utf8, utf8_len, dst, len));
+  EXPECT_EQ('0', dst[0]);
+  EXPECT_EQ('j', dst[19]);
+  EXPECT_EQ(0xE9, dst[20]);
+  EXPECT_EQ('k', dst[21]);
+  EXPECT_EQ(0x20AC, dst[37]);
+  EXPECT_EQ('P', dst[53]);
+  EXPECT_EQ(0xD83D, dst[54]);
+  EXPECT_EQ(0xDE00, dst[55]);
+  EXPECT_EQ('S', dst[58]);
+  // The output buffer is too short.
+  EXPECT(!Utf8::DecodeToUTF16(utf8, utf8_len, dst, 10));
+
+  uint8_t latin1[32];
+  const char* latin1_src = "0123456789abcdefghij\xC3\xA9klm";
+  EXPECT(Utf8::DecodeToLatin1(reinterpret_cast<const uint8_t*>(latin1_src),
+                              strlen(latin1_src), latin1, 24));
+  EXPECT(!memcmp("0123456789abcdefghij\xE9klm", latin1, 24));
+
+  // An invalid byte after a long run of ASCII.
+  const char* invalid = "0123456789abcdefghij\x80";
+  EXPECT(!Utf8::IsValid(reinterpret_cast<const uint8_t*>(invalid),
+                        strlen(invalid)));
+}
+
 }  // namespace dart
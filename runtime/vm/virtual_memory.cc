@@ -17,8 +17,8 @@ bool VirtualMemory::InSamePage(uword address0, uword address1) {
 void VirtualMemory::Truncate(intptr_t new_size) {
   ASSERT(Utils::IsAligned(new_size, PageSize()));
   ASSERT(new_size <= size());
-  if (reserved_.size() ==
-      region_.size()) {  // Don't create holes in reservation.
+  // Don't create holes in reservation or in a shared huge page chunk.
+  if (reserved_.size() == region_.size() && huge_page_chunk_ == nullptr) {
     if (FreeSubSegment(reinterpret_cast<void*>(start() + new_size),
                        size() - new_size)) {
       reserved_.set_size(new_size);
@@ -32,6 +32,15 @@ void VirtualMemory::Truncate(intptr_t new_size) {
   alias_.Subregion(alias_, 0, new_size);
 }
 
+void VirtualMemory::Prefault() {
+  // Writing one word per page forces the OS to commit it. The segment may
+  // already hold data, so write back what is there.
+  for (uword page = start(); page < end(); page += PageSize()) {
+    volatile uword* word = reinterpret_cast<volatile uword*>(page);
+    *word = *word;
+  }
+}
+
 VirtualMemory* VirtualMemory::ForImagePage(void* pointer, uword size) {
   // Memory for precompilated instructions was allocated by the embedder, so
   // create a VirtualMemory without allocating.
@@ -43,4 +52,29 @@ VirtualMemory* VirtualMemory::ForImagePage(void* pointer, uword size) {
   return memory;
 }
 
+intptr_t HugePageUsage::BackedSize(uword start, uword end) const {
+  // Find the first mapping that ends after start.
+  intptr_t lo = 0;
+  intptr_t hi = mappings_.length();
+  while (lo < hi) {
+    const intptr_t mid = lo + (hi - lo) / 2;
+    if (mappings_[mid].end <= start) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  double size = 0;
+  for (intptr_t i = lo; i < mappings_.length() && mappings_[i].start < end;
+       i++) {
+    const Mapping& mapping = mappings_[i];
+    if (mapping.huge_page_bytes == 0) continue;
+    const uword overlap = Utils::Minimum(end, mapping.end) -
+                          Utils::Maximum(start, mapping.start);
+    size += static_cast<double>(mapping.huge_page_bytes) * overlap /
+            (mapping.end - mapping.start);
+  }
+  return static_cast<intptr_t>(size);
+}
+
 }  // namespace dart
@@ -5,6 +5,7 @@
 #ifndef RUNTIME_VM_VIRTUAL_MEMORY_H_
 #define RUNTIME_VM_VIRTUAL_MEMORY_H_
 
+#include "platform/growable_array.h"
 #include "platform/utils.h"
 #include "vm/flags.h"
 #include "vm/globals.h"
@@ -12,6 +13,8 @@
 
 namespace dart {
 
+class HugePageChunk;
+
 class VirtualMemory {
  public:
   enum Protection {
@@ -58,6 +61,16 @@ class VirtualMemory {
                                         bool is_executable,
                                         const char* name);
 
+  // Reserves and commits a non-executable segment that the OS has been
+  // advised to back with transparent huge pages. The OS can only use a huge
+  // page for a huge-page-aligned range of a single mapping, so segments that
+  // are smaller than a huge page are carved from shared huge-page-sized
+  // chunks. Returns NULL if huge pages are not supported or the segment cannot
+  // be allocated, in which case the caller should fall back to
+  // AllocateAligned.
+  static VirtualMemory* AllocateHugePageBacked(intptr_t size,
+                                               intptr_t alignment);
+
   // Returns the cached page size. Use only if Init() has been called.
   static intptr_t PageSize() {
     ASSERT(page_size_ != 0);
@@ -69,6 +82,10 @@ class VirtualMemory {
   // Truncate this virtual memory segment.
   void Truncate(intptr_t new_size);
 
+  // Commits physical memory for the whole segment now instead of on first
+  // access.
+  void Prefault();
+
   // False for a part of a snapshot added directly to the Dart heap, which
   // belongs to the embedder and must not be deallocated or have its
   // protection status changed by the VM.
@@ -111,11 +128,39 @@ class VirtualMemory {
   // Its size might disagree with region_ due to Truncate.
   MemoryRegion reserved_;
 
+  // The chunk this segment was carved from by AllocateHugePageBacked, if any.
+  HugePageChunk* huge_page_chunk_ = nullptr;
+
   static uword page_size_;
 
   DISALLOW_IMPLICIT_CONSTRUCTORS(VirtualMemory);
 };
 
+// A snapshot of how much of each mapping of the process is backed by
+// transparent huge pages, as reported by the OS. Empty where the OS does not
+// report it.
+class HugePageUsage {
+ public:
+  HugePageUsage();
+
+  // An estimate of how many bytes of [start, end) are backed by huge pages.
+  // The OS only reports the total for each mapping, which is assumed to be
+  // spread evenly over the mapping.
+  intptr_t BackedSize(uword start, uword end) const;
+
+ private:
+  struct Mapping {
+    uword start;
+    uword end;
+    intptr_t huge_page_bytes;
+  };
+
+  // Sorted by address.
+  MallocGrowableArray<Mapping> mappings_;
+
+  DISALLOW_COPY_AND_ASSIGN(HugePageUsage);
+};
+
 }  // namespace dart
 
 #endif  // RUNTIME_VM_VIRTUAL_MEMORY_H_
@@ -238,6 +238,14 @@ bool VirtualMemory::FreeSubSegment(void* address, intptr_t size) {
   return true;
 }
 
+VirtualMemory* VirtualMemory::AllocateHugePageBacked(intptr_t size,
+                                                     intptr_t alignment) {
+  // Zircon decides on its own whether to use large pages for a VMO.
+  return nullptr;
+}
+
+HugePageUsage::HugePageUsage() {}
+
 void VirtualMemory::Protect(void* address, intptr_t size, Protection mode) {
 #if defined(DEBUG)
   Thread* thread = Thread::Current();
@@ -66,6 +66,110 @@ static void* GenericMapAligned(int prot,
   return reinterpret_cast<void*>(aligned_base);
 }
 
+#if defined(MADV_HUGEPAGE) && !defined(DART_COMPRESSED_POINTERS)
+// The size of a transparent huge page, 0 if the OS does not use them or -1 if
+// not yet known.
+static intptr_t huge_page_size = -1;
+
+// A mapping of one huge page that is handed out in equally sized slices, so
+// that segments smaller than a huge page can share one.
+class HugePageChunk {
+ public:
+  static constexpr intptr_t kMaxSlices = 64;
+
+  HugePageChunk(uword start, intptr_t slice_size)
+      : start_(start), slice_size_(slice_size), next_(nullptr) {
+    const intptr_t num_slices = huge_page_size / slice_size;
+    ASSERT(num_slices > 1 && num_slices <= kMaxSlices);
+    all_free_ = (num_slices == kMaxSlices)
+                    ? ~static_cast<uint64_t>(0)
+                    : (static_cast<uint64_t>(1) << num_slices) - 1;
+    free_ = all_free_;
+  }
+
+  uword start() const { return start_; }
+  intptr_t slice_size() const { return slice_size_; }
+  bool IsFull() const { return free_ == 0; }
+  bool IsEmpty() const { return free_ == all_free_; }
+
+  HugePageChunk* next() const { return next_; }
+  void set_next(HugePageChunk* next) { next_ = next; }
+
+  uword AllocateSlice() {
+    ASSERT(!IsFull());
+    const intptr_t index = Utils::CountTrailingZeros64(free_);
+    free_ &= ~(static_cast<uint64_t>(1) << index);
+    return start_ + index * slice_size_;
+  }
+
+  void FreeSlice(uword address) {
+    const intptr_t index = (address - start_) / slice_size_;
+    ASSERT((free_ & (static_cast<uint64_t>(1) << index)) == 0);
+    free_ |= static_cast<uint64_t>(1) << index;
+  }
+
+ private:
+  uword start_;
+  intptr_t slice_size_;
+  uint64_t all_free_;
+  uint64_t free_;  // A bit per slice.
+  HugePageChunk* next_;
+
+  DISALLOW_COPY_AND_ASSIGN(HugePageChunk);
+};
+
+static Mutex* huge_page_chunks_mutex = nullptr;
+static HugePageChunk* huge_page_chunks = nullptr;
+
+static intptr_t ReadHugePageSize() {
+  // Advising huge pages is pointless if the OS never uses them.
+  FILE* fp = fopen("/sys/kernel/mm/transparent_hugepage/enabled", "r");
+  if (fp == nullptr) {
+    return 0;
+  }
+  char mode[128];
+  const bool never = (fgets(mode, sizeof(mode), fp) == nullptr) ||
+                     (strstr(mode, "[never]") != nullptr);
+  fclose(fp);
+  if (never) {
+    LOG_INFO("Transparent huge pages are disabled.\n");
+    return 0;
+  }
+  intptr_t size = 2 * MB;
+  fp = fopen("/sys/kernel/mm/transparent_hugepage/hpage_pmd_size", "r");
+  if (fp != nullptr) {
+    long pmd_size = 0;  // NOLINT
+    if (fscanf(fp, "%ld", &pmd_size) == 1 && pmd_size > 0) {
+      size = pmd_size;
+    }
+    fclose(fp);
+  }
+  ASSERT(Utils::IsPowerOfTwo(size));
+  return size;
+}
+
+// Maps an anonymous region of [size] bytes aligned to [alignment] and advises
+// the OS to back it with huge pages. Unlike AllocateAligned, this does not use
+// a memfd, because the OS does not back shared memory with transparent huge
+// pages unless configured to.
+static void* MapHugePageBacked(intptr_t size, intptr_t alignment) {
+  const intptr_t page_size = VirtualMemory::PageSize();
+  void* address = GenericMapAligned(PROT_READ | PROT_WRITE, size, alignment,
+                                    size + alignment - page_size,
+                                    MAP_PRIVATE | MAP_ANONYMOUS);
+  if (address == nullptr) {
+    return nullptr;
+  }
+  if (madvise(address, size, MADV_HUGEPAGE) != 0) {
+    LOG_INFO("madvise(%p, 0x%" Px ", MADV_HUGEPAGE) failed\n", address, size);
+    const uword start = reinterpret_cast<uword>(address);
+    unmap(start, start + size);
+    return nullptr;
+  }
+  return address;
+}
+#endif  // defined(MADV_HUGEPAGE) && !defined(DART_COMPRESSED_POINTERS)
+
 intptr_t VirtualMemory::CalculatePageSize() {
   const intptr_t page_size = getpagesize();
   ASSERT(page_size != 0);
@@ -87,6 +191,13 @@ void VirtualMemory::Init() {
       FATAL2("Failed to reserve region for compressed heap: %d (%s)", error,
              Utils::StrError(error, error_buf, kBufferSize));
     }
+#if defined(MADV_HUGEPAGE)
+    if (FLAG_heap_huge_pages) {
+      // All heap pages are carved from this reservation, so the OS can back
+      // runs of adjacent pages with huge pages once it has been advised to.
+      madvise(address, kCompressedHeapSize, MADV_HUGEPAGE);
+    }
+#endif  // defined(MADV_HUGEPAGE)
     VirtualMemoryCompressedHeap::Init(address);
   }
 #endif  // defined(DART_COMPRESSED_POINTERS)
@@ -98,6 +209,10 @@ void VirtualMemory::Init() {
 
   page_size_ = CalculatePageSize();
 
+#if defined(MADV_HUGEPAGE) && !defined(DART_COMPRESSED_POINTERS)
+  huge_page_chunks_mutex = new Mutex(NOT_IN_PRODUCT("huge_page_chunks_mutex"));
+#endif
+
 #if defined(DUAL_MAPPING_SUPPORTED)
 // Perf is Linux-specific and the flags aren't defined in Product.
 #if defined(TARGET_OS_LINUX) && !defined(PRODUCT)
@@ -344,7 +459,82 @@ VirtualMemory* VirtualMemory::AllocateAligned(intptr_t size,
   return new VirtualMemory(region, region);
 }
 
+VirtualMemory* VirtualMemory::AllocateHugePageBacked(intptr_t size,
+                                                     intptr_t alignment) {
+  ASSERT(Utils::IsAligned(size, PageSize()));
+  ASSERT(Utils::IsPowerOfTwo(alignment));
+  ASSERT(Utils::IsAligned(alignment, PageSize()));
+#if defined(MADV_HUGEPAGE) && !defined(DART_COMPRESSED_POINTERS)
+  MutexLocker ml(huge_page_chunks_mutex);
+  if (huge_page_size < 0) {
+    huge_page_size = ReadHugePageSize();
+  }
+  if (huge_page_size == 0) {
+    return nullptr;
+  }
+  if (size >= huge_page_size) {
+    void* address =
+        MapHugePageBacked(size, Utils::Maximum(alignment, huge_page_size));
+    if (address == nullptr) {
+      return nullptr;
+    }
+    MemoryRegion region(address, size);
+    return new VirtualMemory(region, region);
+  }
+
+  // Slices are aligned to their size within the chunk.
+  if (!Utils::IsPowerOfTwo(size) || (alignment > size) ||
+      (huge_page_size / size > HugePageChunk::kMaxSlices)) {
+    return nullptr;
+  }
+  HugePageChunk* chunk = huge_page_chunks;
+  while (chunk != nullptr &&
+         (chunk->slice_size() != size || chunk->IsFull())) {
+    chunk = chunk->next();
+  }
+  if (chunk == nullptr) {
+    void* address = MapHugePageBacked(huge_page_size, huge_page_size);
+    if (address == nullptr) {
+      return nullptr;
+    }
+    chunk = new HugePageChunk(reinterpret_cast<uword>(address), size);
+    chunk->set_next(huge_page_chunks);
+    huge_page_chunks = chunk;
+  }
+  MemoryRegion region(reinterpret_cast<void*>(chunk->AllocateSlice()), size);
+  VirtualMemory* memory = new VirtualMemory(region, region);
+  memory->huge_page_chunk_ = chunk;
+  return memory;
+#else
+  // With compressed pointers, the whole heap reservation is advised in Init.
+  return nullptr;
+#endif  // defined(MADV_HUGEPAGE) && !defined(DART_COMPRESSED_POINTERS)
+}
+
 VirtualMemory::~VirtualMemory() {
+#if defined(MADV_HUGEPAGE) && !defined(DART_COMPRESSED_POINTERS)
+  if (huge_page_chunk_ != nullptr) {
+    // Give the memory back before the slice can be handed out again.
+    madvise(reserved_.pointer(), reserved_.size(), MADV_DONTNEED);
+    MutexLocker ml(huge_page_chunks_mutex);
+    HugePageChunk* chunk = huge_page_chunk_;
+    chunk->FreeSlice(reserved_.start());
+    if (chunk->IsEmpty()) {
+      if (huge_page_chunks == chunk) {
+        huge_page_chunks = chunk->next();
+      } else {
+        HugePageChunk* previous = huge_page_chunks;
+        while (previous->next() != chunk) {
+          previous = previous->next();
+        }
+        previous->set_next(chunk->next());
+      }
+      unmap(chunk->start(), chunk->start() + huge_page_size);
+      delete chunk;
+    }
+    return;
+  }
+#endif  // defined(MADV_HUGEPAGE) && !defined(DART_COMPRESSED_POINTERS)
 #if defined(DART_COMPRESSED_POINTERS)
   if (VirtualMemoryCompressedHeap::Contains(reserved_.pointer())) {
     madvise(reserved_.pointer(), reserved_.size(), MADV_DONTNEED);
@@ -373,6 +563,35 @@ bool VirtualMemory::FreeSubSegment(void* address, intptr_t size) {
   return true;
 }
 
+HugePageUsage::HugePageUsage() {
+#if defined(HOST_OS_LINUX) || defined(HOST_OS_ANDROID)
+  FILE* fp = fopen("/proc/self/smaps", "r");
+  if (fp == nullptr) {
+    return;
+  }
+  // Each mapping starts with a line "start-end perms offset dev inode path",
+  // followed by lines "Field: value kB".
+  char line[4096];
+  while (fgets(line, sizeof(line), fp) != nullptr) {
+    char* rest;
+    const uword start = strtoull(line, &rest, 16);
+    if (rest != line && *rest == '-') {
+      const uword end = strtoull(rest + 1, &rest, 16);
+      mappings_.Add({start, end, 0});
+      continue;
+    }
+    if (mappings_.is_empty()) continue;
+    // Private anonymous memory and memfds respectively.
+    long kb = 0;  // NOLINT
+    if (sscanf(line, "AnonHugePages: %ld kB", &kb) == 1 ||
+        sscanf(line, "ShmemPmdMapped: %ld kB", &kb) == 1) {
+      mappings_.Last().huge_page_bytes += kb * KB;
+    }
+  }
+  fclose(fp);
+#endif  // defined(HOST_OS_LINUX) || defined(HOST_OS_ANDROID)
+}
+
 void VirtualMemory::Protect(void* address, intptr_t size, Protection mode) {
 #if defined(DEBUG)
   Thread* thread = Thread::Current();
@@ -70,6 +70,65 @@ VM_UNIT_TEST_CASE(AllocateAlignedVirtualMemory) {
   }
 }
 
+VM_UNIT_TEST_CASE(HugePageBackedVirtualMemory) {
+  const intptr_t kSliceSize = 512 * KB;
+  VirtualMemory* first =
+      VirtualMemory::AllocateHugePageBacked(kSliceSize, kSliceSize);
+  if (first == NULL) {
+    return;  // Transparent huge pages are not available.
+  }
+  VirtualMemory* second =
+      VirtualMemory::AllocateHugePageBacked(kSliceSize, kSliceSize);
+  EXPECT(second != NULL);
+  EXPECT(Utils::IsAligned(first->start(), kSliceSize));
+  EXPECT(Utils::IsAligned(second->start(), kSliceSize));
+  EXPECT_EQ(kSliceSize, first->size());
+  EXPECT(first->start() != second->start());
+
+  char* buf = reinterpret_cast<char*>(first->address());
+  EXPECT(IsZero(buf, buf + kSliceSize));
+  memset(buf, 'x', kSliceSize);
+  const uword start = first->start();
+  delete first;
+  // The freed slice is reused and handed out cleared.
+  VirtualMemory* third =
+      VirtualMemory::AllocateHugePageBacked(kSliceSize, kSliceSize);
+  EXPECT(third != NULL);
+  EXPECT_EQ(start, third->start());
+  buf = reinterpret_cast<char*>(third->address());
+  EXPECT(IsZero(buf, buf + kSliceSize));
+
+  HugePageUsage usage;
+  EXPECT(usage.BackedSize(third->start(), third->end()) <= kSliceSize);
+  delete second;
+  delete third;
+
+  // Segments of at least a huge page get a mapping of their own.
+  const intptr_t kLargeSize = 4 * MB;
+  VirtualMemory* large =
+      VirtualMemory::AllocateHugePageBacked(kLargeSize, kSliceSize);
+  EXPECT(large != NULL);
+  EXPECT_EQ(kLargeSize, large->size());
+  large->Truncate(kLargeSize / 2);
+  EXPECT_EQ(kLargeSize / 2, large->size());
+  delete large;
+}
+
+VM_UNIT_TEST_CASE(PrefaultVirtualMemory) {
+  const intptr_t kVirtualMemoryBlockSize = 4 * MB;
+  VirtualMemory* vm = VirtualMemory::AllocateAligned(
+      kVirtualMemoryBlockSize, kVirtualMemoryBlockSize, false, "test");
+  EXPECT(vm != NULL);
+
+  char* buf = reinterpret_cast<char*>(vm->address());
+  buf[0] = 'x';
+  vm->Prefault();
+  EXPECT_EQ('x', buf[0]);
+  EXPECT(IsZero(buf + 1, buf + vm->size()));
+
+  delete vm;
+}
+
 VM_UNIT_TEST_CASE(FreeVirtualMemory) {
   // Reservations should always be handed back to OS upon destruction.
   const intptr_t kVirtualMemoryBlockSize = 10 * MB;
@@ -154,6 +154,15 @@ bool VirtualMemory::FreeSubSegment(void* address, intptr_t size) {
   return true;
 }
 
+VirtualMemory* VirtualMemory::AllocateHugePageBacked(intptr_t size,
+                                                     intptr_t alignment) {
+  // Large pages on Windows must be requested with MEM_LARGE_PAGES and need the
+  // SeLockMemoryPrivilege. They are not transparent, so they are not used.
+  return nullptr;
+}
+
+HugePageUsage::HugePageUsage() {}
+
 void VirtualMemory::Protect(void* address, intptr_t size, Protection mode) {
 #if defined(DEBUG)
   Thread* thread = Thread::Current();
@@ -53,37 +53,196 @@ class Zone::Segment {
 // malloc to allocate segments, we allocate directly from mmap/zx_vmo_create/
 // VirtualAlloc, and cache a small number of the normal sized segments.
 static constexpr intptr_t kSegmentCacheCapacity = 16;  // 1 MB of Segments
-static Mutex* segment_cache_mutex = nullptr;
+// The mutex outlives the VM, because OSThreads may release their segment
+// caches concurrently with or after Zone::Cleanup.
+static Mutex* segment_cache_mutex =
+    new Mutex(NOT_IN_PRODUCT("segment_cache_mutex"));
+static bool segment_cache_enabled = false;
 static VirtualMemory* segment_cache[kSegmentCacheCapacity] = {nullptr};
 static intptr_t segment_cache_size = 0;
 
+// Returns true if `memory` was added to the global segment cache.
+static bool AddToGlobalSegmentCache(VirtualMemory* memory) {
+  MutexLocker ml(segment_cache_mutex);
+  ASSERT(segment_cache_size >= 0);
+  ASSERT(segment_cache_size <= kSegmentCacheCapacity);
+  if (segment_cache_enabled && segment_cache_size < kSegmentCacheCapacity) {
+    segment_cache[segment_cache_size++] = memory;
+    return true;
+  }
+  return false;
+}
+
+// Larger segments are cached by size class. A segment is kept in the class of
+// the largest power of two not above its size, and is handed out for requests
+// that round up to that power of two. A reused segment is therefore less than
+// four times the requested size. The classes cover 128 KB to 2 MB, which
+// includes the first geometric growth step of a zone, and hold at most 4 MB
+// in total.
+static constexpr intptr_t kMinLargeSegmentCacheShift = 17;  // 128 KB
+static constexpr intptr_t kMaxLargeSegmentCacheShift = 21;  // 2 MB
+static constexpr intptr_t kLargeSegmentCacheClasses =
+    kMaxLargeSegmentCacheShift - kMinLargeSegmentCacheShift + 1;
+static constexpr intptr_t kLargeSegmentCacheClassCapacity = 2;
+static constexpr intptr_t kLargeSegmentCacheMaxBytes = 4 * MB;
+static VirtualMemory* large_segment_cache[kLargeSegmentCacheClasses]
+                                         [kLargeSegmentCacheClassCapacity] = {};
+static intptr_t large_segment_cache_size[kLargeSegmentCacheClasses] = {0};
+static intptr_t large_segment_cache_bytes = 0;
+
+// Returns nullptr if no cached segment of at least `size` bytes is found.
+static VirtualMemory* RemoveFromLargeSegmentCache(intptr_t size) {
+  const intptr_t shift = Utils::BitLength(size - 1);
+  if (shift < kMinLargeSegmentCacheShift ||
+      shift > kMaxLargeSegmentCacheShift) {
+    return nullptr;
+  }
+  const intptr_t index = shift - kMinLargeSegmentCacheShift;
+  MutexLocker ml(segment_cache_mutex);
+  if (large_segment_cache_size[index] == 0) {
+    return nullptr;
+  }
+  VirtualMemory* memory =
+      large_segment_cache[index][--large_segment_cache_size[index]];
+  large_segment_cache_bytes -= memory->size();
+  ASSERT(memory->size() >= size);
+  return memory;
+}
+
+// Returns true if `memory` was added to the large segment cache.
+static bool AddToLargeSegmentCache(VirtualMemory* memory) {
+  const intptr_t size = memory->size();
+  const intptr_t shift = Utils::BitLength(size) - 1;
+  if (shift < kMinLargeSegmentCacheShift ||
+      shift > kMaxLargeSegmentCacheShift) {
+    return false;
+  }
+  const intptr_t index = shift - kMinLargeSegmentCacheShift;
+  MutexLocker ml(segment_cache_mutex);
+  if (!segment_cache_enabled ||
+      large_segment_cache_size[index] == kLargeSegmentCacheClassCapacity ||
+      large_segment_cache_bytes + size > kLargeSegmentCacheMaxBytes) {
+    return false;
+  }
+  large_segment_cache[index][large_segment_cache_size[index]++] = memory;
+  large_segment_cache_bytes += size;
+  return true;
+}
+
+// A per-thread cache in front of the global segment cache. Zones are
+// created and destroyed at a high rate by compiler, GC and mutator threads,
+// and this avoids taking segment_cache_mutex for most of them.
+class ZoneSegmentCache {
+ public:
+  ZoneSegmentCache() : size_(0) {}
+
+  // Returns nullptr if the cache is empty.
+  VirtualMemory* Remove() {
+    if (size_ == 0) {
+      return nullptr;
+    }
+    return segments_[--size_];
+  }
+
+  // Returns false if the cache is full.
+  bool Add(VirtualMemory* memory) {
+    if (size_ == kCapacity) {
+      return false;
+    }
+    segments_[size_++] = memory;
+    return true;
+  }
+
+ private:
+  // Bounds the memory held by an idle thread to 256 KB.
+  static constexpr intptr_t kCapacity = 4;
+
+  VirtualMemory* segments_[kCapacity];
+  intptr_t size_;
+
+  DISALLOW_COPY_AND_ASSIGN(ZoneSegmentCache);
+};
+
+// The segment cache of the current thread, or nullptr if the current thread
+// is not known to the VM.
+static ZoneSegmentCache* CurrentSegmentCache() {
+  OSThread* os_thread = OSThread::TryCurrent();
+  if (os_thread == nullptr) {
+    return nullptr;
+  }
+  ZoneSegmentCache* cache = os_thread->zone_segment_cache();
+  if (cache == nullptr) {
+    cache = new ZoneSegmentCache();
+    os_thread->set_zone_segment_cache(cache);
+  }
+  return cache;
+}
+
 void Zone::Init() {
-  ASSERT(segment_cache_mutex == nullptr);
-  segment_cache_mutex = new Mutex(NOT_IN_PRODUCT("segment_cache_mutex"));
+  MutexLocker ml(segment_cache_mutex);
+  ASSERT(!segment_cache_enabled);
+  segment_cache_enabled = true;
 }
 
 void Zone::Cleanup() {
-  {
-    MutexLocker ml(segment_cache_mutex);
-    ASSERT(segment_cache_size >= 0);
-    ASSERT(segment_cache_size <= kSegmentCacheCapacity);
-    while (segment_cache_size > 0) {
-      delete segment_cache[--segment_cache_size];
+  OSThread* os_thread = OSThread::TryCurrent();
+  if (os_thread != nullptr) {
+    ReleaseSegmentCache(os_thread);
+  }
+  MutexLocker ml(segment_cache_mutex);
+  ASSERT(segment_cache_size >= 0);
+  ASSERT(segment_cache_size <= kSegmentCacheCapacity);
+  while (segment_cache_size > 0) {
+    delete segment_cache[--segment_cache_size];
+  }
+  for (intptr_t i = 0; i < kLargeSegmentCacheClasses; i++) {
+    while (large_segment_cache_size[i] > 0) {
+      delete large_segment_cache[i][--large_segment_cache_size[i]];
     }
   }
-  delete segment_cache_mutex;
-  segment_cache_mutex = nullptr;
+  large_segment_cache_bytes = 0;
+  segment_cache_enabled = false;
+}
+
+void Zone::ReleaseSegmentCache(OSThread* thread) {
+  ZoneSegmentCache* cache = thread->zone_segment_cache();
+  if (cache == nullptr) {
+    return;
+  }
+  thread->set_zone_segment_cache(nullptr);
+  VirtualMemory* memory;
+  while ((memory = cache->Remove()) != nullptr) {
+    // The thread may outlive the VM, in which case the global cache is
+    // disabled and the segment is freed.
+    if (!AddToGlobalSegmentCache(memory)) {
+      total_size_.fetch_sub(kSegmentSize);
+      delete memory;
+    }
+  }
+  delete cache;
 }
 
 Zone::Segment* Zone::Segment::New(intptr_t size, Zone::Segment* next) {
   size = Utils::RoundUp(size, VirtualMemory::PageSize());
   VirtualMemory* memory = nullptr;
   if (size == kSegmentSize) {
-    MutexLocker ml(segment_cache_mutex);
-    ASSERT(segment_cache_size >= 0);
-    ASSERT(segment_cache_size <= kSegmentCacheCapacity);
-    if (segment_cache_size > 0) {
-      memory = segment_cache[--segment_cache_size];
+    ZoneSegmentCache* cache = CurrentSegmentCache();
+    if (cache != nullptr) {
+      memory = cache->Remove();
+    }
+    if (memory == nullptr) {
+      MutexLocker ml(segment_cache_mutex);
+      ASSERT(segment_cache_size >= 0);
+      ASSERT(segment_cache_size <= kSegmentCacheCapacity);
+      if (segment_cache_size > 0) {
+        memory = segment_cache[--segment_cache_size];
+      }
+    }
+  } else if (size > kSegmentSize) {
+    memory = RemoveFromLargeSegmentCache(size);
+    if (memory != nullptr) {
+      // Use all of the cached segment, which may be larger than requested.
+      size = memory->size();
     }
   }
   if (memory == nullptr) {
@@ -110,6 +269,7 @@ Zone::Segment* Zone::Segment::New(intptr_t size, Zone::Segment* next) {
 }
 
 void Zone::Segment::DeleteSegmentList(Segment* head) {
+  ZoneSegmentCache* cache = nullptr;
   Segment* current = head;
   while (current != NULL) {
     intptr_t size = current->size();
@@ -123,11 +283,15 @@ void Zone::Segment::DeleteSegmentList(Segment* head) {
     LSAN_UNREGISTER_ROOT_REGION(current, sizeof(*current));
 
     if (size == kSegmentSize) {
-      MutexLocker ml(segment_cache_mutex);
-      ASSERT(segment_cache_size >= 0);
-      ASSERT(segment_cache_size <= kSegmentCacheCapacity);
-      if (segment_cache_size < kSegmentCacheCapacity) {
-        segment_cache[segment_cache_size++] = memory;
+      if (cache == nullptr) {
+        cache = CurrentSegmentCache();
+      }
+      if ((cache != nullptr && cache->Add(memory)) ||
+          AddToGlobalSegmentCache(memory)) {
+        memory = nullptr;
+      }
+    } else if (size > kSegmentSize) {
+      if (AddToLargeSegmentCache(memory)) {
         memory = nullptr;
       }
     }
@@ -88,6 +88,10 @@ class Zone {
   static void Init();
   static void Cleanup();
 
+  // Returns the segments cached by `thread` to the global segment cache.
+  // Called when the OSThread is destroyed.
+  static void ReleaseSegmentCache(OSThread* thread);
+
   static intptr_t Size() { return total_size_; }
 
  private:
@@ -223,6 +223,26 @@ TEST_CASE(StressMallocDirectly) {
 #endif  // !defined(PRODUCT)
 }
 
+ISOLATE_UNIT_TEST_CASE(ZoneLargeSegmentReuse) {
+  // Sizes on both sides of the cached size classes, so that cached segments
+  // are handed out for requests smaller than the segment.
+  const intptr_t kLargeSizes[] = {65 * KB, 100 * KB,  128 * KB, 200 * KB,
+                                  1 * MB,  1536 * KB, 2 * MB,   3 * MB};
+  const intptr_t start_size = Zone::Size();
+  for (intptr_t i = 0; i < 100; i++) {
+    StackZone stack_zone(Thread::Current());
+    Zone* zone = stack_zone.GetZone();
+    const intptr_t size = kLargeSizes[i % ARRAY_SIZE(kLargeSizes)];
+    uint8_t* buffer = zone->Alloc<uint8_t>(size);
+    memset(buffer, i, size);
+    uint8_t* other = zone->Alloc<uint8_t>(kLargeSizes[i % 3]);
+    memset(other, i, kLargeSizes[i % 3]);
+    EXPECT_EQ(static_cast<uint8_t>(i), buffer[size - 1]);
+  }
+  // Only a bounded amount of memory is kept in the segment caches.
+  EXPECT_LE(Zone::Size(), start_size + 6 * MB);
+}
+
 ISOLATE_UNIT_TEST_CASE(StressMallocThroughZones) {
 #if !defined(PRODUCT)
   int64_t start_rss = Service::CurrentRSS();
@@ -433,6 +433,11 @@ class _NativeSocket extends _NativeSocketNativeWrapper with _ServiceObject {
   static const listInterfacesMessage = 1;
   static const reverseLookupMessage = 2;
 
+  // Messages posted by io_uring to the event port.
+  // Keep in sync with IOUring::SocketMessage in io_uring_linux.h.
+  static const int uringReceivedMessage = 0;
+  static const int uringSentMessage = 1;
+
   // Protocol flags.
   static const int protocolIPv4 = 1 << 0;
   static const int protocolIPv6 = 1 << 1;
@@ -487,6 +492,19 @@ class _NativeSocket extends _NativeSocketNativeWrapper with _ServiceObject {
   bool writeEventIssued = false;
   bool writeAvailable = false;
 
+  // Whether this TCP socket uses io_uring. If so, data is received into a
+  // queue by the ring instead of being read after read events, and the part
+  // of a write that did not fit into the socket buffer is sent by the ring.
+  bool _uringChecked = false;
+  bool _uring = false;
+  bool _uringReads = false;
+  bool _uringReceivePending = false;
+  final Queue<Uint8List> _uringReceived = Queue<Uint8List>();
+  // While a send is pending, write events are ignored, and closing and
+  // shutting down writes are deferred, as the ring uses the file descriptor.
+  bool _uringSendPending = false;
+  bool _uringShutdownWritePending = false;
+
   // The owner object is the object that the Socket is being used by, e.g.
   // a HttpServer, a WebSocket connection, a process pipe, etc.
   Object? owner;
@@ -1010,7 +1028,9 @@ class _NativeSocket extends _NativeSocketNativeWrapper with _ServiceObject {
     if (isClosing || isClosed) return null;
     try {
       Uint8List? list;
-      if (count != null) {
+      if (_uringReads) {
+        list = _uringRead(count);
+      } else if (count != null) {
         list = nativeRead(count);
         available = nativeAvailable();
       } else {
@@ -1044,6 +1064,51 @@ class _NativeSocket extends _NativeSocketNativeWrapper with _ServiceObject {
     }
   }
 
+  // Takes up to [count] bytes, or all of them, from the data received by
+  // the ring, and starts receiving again once all of it has been taken.
+  Uint8List? _uringRead(int? count) {
+    if (_uringReceived.isEmpty) return null;
+    Uint8List list;
+    if ((count == null || count >= available) && _uringReceived.length == 1) {
+      list = _uringReceived.removeFirst();
+    } else {
+      int remaining = count ?? available;
+      BytesBuilder builder = BytesBuilder(copy: false);
+      while (remaining > 0 && _uringReceived.isNotEmpty) {
+        Uint8List chunk = _uringReceived.removeFirst();
+        if (chunk.length > remaining) {
+          _uringReceived.addFirst(Uint8List.sublistView(chunk, remaining));
+          chunk = Uint8List.sublistView(chunk, 0, remaining);
+        }
+        builder.add(chunk);
+        remaining -= chunk.length;
+      }
+      list = builder.takeBytes();
+    }
+    available -= list.length;
+    if (_uringReceived.isEmpty) _uringReceive();
+    return list;
+  }
+
+  void _uringReceive() {
+    if (_uringReceivePending || isClosing || isClosed || isClosedRead) return;
+    connectToEventHandler();
+    if (nativeUringReceive(eventPort!.sendPort)) {
+      _uringReceivePending = true;
+    } else {
+      // Fall back to reading after read events.
+      _uringReads = false;
+      if (flagsSent) sendToEventHandler(eventMask());
+    }
+  }
+
+  void _uringCancelReceive() {
+    if (_uringReceivePending) {
+      _uringReceivePending = false;
+      nativeUringCancelReceive();
+    }
+  }
+
   Datagram? receive() {
     if (isClosing || isClosed) return null;
     try {
@@ -1078,6 +1143,10 @@ class _NativeSocket extends _NativeSocketNativeWrapper with _ServiceObject {
     }
     if (isClosing || isClosed) return 0;
     if (bytes == 0) return 0;
+    if (_uringSendPending) {
+      writeAvailable = false;
+      return 0;
+    }
     try {
       _BufferAndStart bufferAndStart =
           _ensureFastAndSerializableByteData(buffer, offset, offset + bytes);
@@ -1094,6 +1163,15 @@ class _NativeSocket extends _NativeSocketNativeWrapper with _ServiceObject {
       // know if we'll receive an event. It's better to just retry.
       if (result >= 0 && result < bytes) {
         writeAvailable = false;
+        // Hand the rest to the ring instead of waiting for a write event.
+        connectToEventHandler();
+        if (_uring &&
+            nativeUringSend(bufferAndStart.buffer,
+                bufferAndStart.start + result, bytes - result,
+                eventPort!.sendPort)) {
+          _uringSendPending = true;
+          result = bytes;
+        }
       }
       // Negate the result, as stated above.
       if (result < 0) result = -result;
@@ -1105,6 +1183,33 @@ class _NativeSocket extends _NativeSocketNativeWrapper with _ServiceObject {
     }
   }
 
+  // Sends up to [length] bytes of [file] from [position] without reading them
+  // into Dart. Returns the number of bytes sent, or a negative number if the
+  // rest of the file cannot be sent this way.
+  int sendFile(_RandomAccessFileOps file, int position, int length) {
+    if (isClosing || isClosed) return 0;
+    if (length == 0) return 0;
+    if (_uringSendPending) {
+      writeAvailable = false;
+      return 0;
+    }
+    try {
+      int result = nativeSendFile(file, position, length);
+      if (result >= 0 && result < length) {
+        writeAvailable = false;
+      }
+      if (result > 0 && !const bool.fromEnvironment("dart.vm.product")) {
+        _SocketProfile.collectStatistic(
+            nativeGetSocketId(), _SocketProfileType.writeBytes, result);
+      }
+      return result;
+    } catch (e) {
+      StackTrace st = StackTrace.current;
+      scheduleMicrotask(() => reportError(e, st, "Write failed"));
+      return 0;
+    }
+  }
+
   int send(List<int> buffer, int offset, int bytes, InternetAddress address,
       int port) {
     _throwOnBadPort(port);
@@ -1230,10 +1335,17 @@ class _NativeSocket extends _NativeSocketNativeWrapper with _ServiceObject {
   void multiplex(Object eventsObj) {
     // TODO(paulberry): when issue #31305 is fixed, we should be able to simply
     // declare `events` as a `covariant int` parameter.
+    if (eventsObj is List) {
+      _uringMultiplex(eventsObj);
+      return;
+    }
     int events = eventsObj as int;
     for (int i = firstEvent; i <= lastEvent; i++) {
       if (((events & (1 << i)) != 0)) {
         if ((i == closedEvent || i == readEvent) && isClosedRead) continue;
+        // The end of the stream is received by the ring as well.
+        if ((i == closedEvent || i == readEvent) && _uringReads) continue;
+        if (i == writeEvent && _uringSendPending) continue;
         if (isClosing && i != destroyedEvent) continue;
         if (i == closedEvent && !isListening && !isClosing && !isClosed) {
           isClosedRead = true;
@@ -1289,6 +1401,46 @@ class _NativeSocket extends _NativeSocketNativeWrapper with _ServiceObject {
     }
   }
 
+  // Handles the completions posted by the ring. They are not event handler
+  // events, so no tokens are returned for them.
+  void _uringMultiplex(List message) {
+    var payload = message[1];
+    if (message[0] == uringReceivedMessage) {
+      _uringReceivePending = false;
+      if (isClosing || isClosed || isClosedRead) return;
+      if (payload is Uint8List) {
+        _uringReceived.add(payload);
+        available += payload.length;
+      } else if (payload == null) {
+        isClosedRead = true;
+      } else {
+        reportError(OSError(payload[1], payload[0]), null, "Read failed");
+        return;
+      }
+      issueReadEvent();
+    } else {
+      assert(message[0] == uringSentMessage);
+      _uringSendPending = false;
+      if (isClosed) return;
+      if (isClosing) {
+        // Send the close command deferred by close().
+        _EventHandler._sendData(this, eventPort!.sendPort,
+            (typeFlags & typeTypeMask) | (1 << closeCommand));
+        return;
+      }
+      if (payload != null) {
+        reportError(OSError(payload[1], payload[0]), null, "Write failed");
+        return;
+      }
+      if (_uringShutdownWritePending) {
+        _uringShutdownWritePending = false;
+        sendToEventHandler(1 << shutdownWriteCommand);
+      }
+      writeAvailable = true;
+      issueWriteEvent(delayed: false);
+    }
+  }
+
   void returnTokens(int tokenBatchSize) {
     if (!isClosing && !isClosed) {
       assert(eventPort != null);
@@ -1314,18 +1466,38 @@ class _NativeSocket extends _NativeSocketNativeWrapper with _ServiceObject {
     sendWriteEvents = write;
     if (read) issueReadEvent();
     if (write) issueWriteEvent();
+    // Sockets switch to the ring once they are read from, so that connecting
+    // sockets keep reporting connection errors through the event handler.
+    if (read && !_uringChecked && !isClosing) {
+      _uringChecked = true;
+      if (isTcp &&
+          !isListening &&
+          !isClosedRead &&
+          available == 0 &&
+          nativeUringAvailable()) {
+        _uring = true;
+        _uringReads = true;
+        if (flagsSent) sendToEventHandler(eventMask());
+        _uringReceive();
+      }
+    }
     if (!flagsSent && !isClosing) {
       flagsSent = true;
-      int flags = 1 << setEventMaskCommand;
-      if (!isClosedRead) flags |= 1 << readEvent;
-      if (!isClosedWrite) flags |= 1 << writeEvent;
-      sendToEventHandler(flags);
+      sendToEventHandler(eventMask());
     }
   }
 
+  int eventMask() {
+    int flags = 1 << setEventMaskCommand;
+    if (!isClosedRead && !_uringReads) flags |= 1 << readEvent;
+    if (!isClosedWrite) flags |= 1 << writeEvent;
+    return flags;
+  }
+
   Future close() {
     if (!isClosing && !isClosed) {
-      sendToEventHandler(1 << closeCommand);
+      _uringCancelReceive();
+      if (!_uringSendPending) sendToEventHandler(1 << closeCommand);
       isClosing = true;
     }
     return closeCompleter.future;
@@ -1353,6 +1525,8 @@ class _NativeSocket extends _NativeSocketNativeWrapper with _ServiceObject {
     if (!isClosing && !isClosed) {
       if (closedReadEventSent) {
         close();
+      } else if (_uringSendPending) {
+        _uringShutdownWritePending = true;
       } else {
         sendToEventHandler(1 << shutdownWriteCommand);
       }
@@ -1362,6 +1536,7 @@ class _NativeSocket extends _NativeSocketNativeWrapper with _ServiceObject {
 
   void shutdownRead() {
     if (!isClosing && !isClosed) {
+      _uringCancelReceive();
       if (isClosedWrite) {
         close();
       } else {
@@ -1508,9 +1683,16 @@ class _NativeSocket extends _NativeSocketNativeWrapper with _ServiceObject {
   int nativeAvailable() native "Socket_Available";
   bool nativeAvailableDatagram() native "Socket_AvailableDatagram";
   Uint8List? nativeRead(int len) native "Socket_Read";
+  static bool nativeUringAvailable() native "Socket_UringAvailable";
+  bool nativeUringReceive(SendPort port) native "Socket_UringReceive";
+  bool nativeUringSend(List<int> buffer, int offset, int bytes, SendPort port)
+      native "Socket_UringSend";
+  void nativeUringCancelReceive() native "Socket_UringCancelReceive";
   Datagram? nativeRecvFrom() native "Socket_RecvFrom";
   int nativeWrite(List<int> buffer, int offset, int bytes)
       native "Socket_WriteList";
+  int nativeSendFile(_RandomAccessFileOps file, int position, int length)
+      native "Socket_SendFile";
   int nativeSendTo(List<int> buffer, int offset, int bytes, Uint8List address,
       int port) native "Socket_SendTo";
   nativeCreateConnect(Uint8List addr, int port, int scope_id)
@@ -1742,6 +1924,9 @@ class _RawSocket extends Stream<RawSocketEvent> implements RawSocket {
   int write(List<int> buffer, [int offset = 0, int? count]) =>
       _socket.write(buffer, offset, count);
 
+  int _sendFile(_RandomAccessFile file, int position, int length) =>
+      _socket.sendFile(file._ops, position, length);
+
   Future<RawSocket> close() => _socket.close().then<RawSocket>((_) {
         if (!const bool.fromEnvironment("dart.vm.product")) {
           _SocketProfile.collectStatistic(
@@ -1883,40 +2068,100 @@ class _SocketStreamConsumer extends StreamConsumer<List<int>> {
   bool paused = false;
   Completer<Socket>? streamCompleter;
 
+  // When adding the contents of a file, the file is sent directly from the
+  // file descriptor, see [_addFile].
+  String? filePath;
+  RandomAccessFile? file;
+  int filePosition = 0;
+  int fileEnd = 0;
+  int? fileRequestedEnd;
+  bool fileLengthPending = false;
+
   _SocketStreamConsumer(this.socket);
 
   Future<Socket> addStream(Stream<List<int>> stream) {
     socket._ensureRawSocketSubscription();
     final completer = streamCompleter = new Completer<Socket>();
     if (socket._raw != null) {
-      subscription = stream.listen((data) {
-        assert(!paused);
-        assert(buffer == null);
-        buffer = data;
-        offset = 0;
-        try {
-          write();
-        } catch (e) {
-          socket.destroy();
-          stop();
-          done(e);
-        }
-      }, onError: (error, [stackTrace]) {
-        socket.destroy();
-        done(error, stackTrace);
-      }, onDone: () {
-        done();
-      }, cancelOnError: true);
+      // A bad range is left to the stream, which reports it as an error.
+      final end = stream is _FileStream ? stream._end : null;
+      if (stream is _FileStream &&
+          stream._path != null &&
+          stream._position >= 0 &&
+          (end == null || end >= stream._position) &&
+          socket._raw is _RawSocket) {
+        _addFile(stream._path!, stream._position, stream._end);
+      } else {
+        _listen(stream);
+      }
     }
     return completer.future;
   }
 
+  void _listen(Stream<List<int>> stream) {
+    subscription = stream.listen((data) {
+      assert(!paused);
+      assert(buffer == null);
+      buffer = data;
+      offset = 0;
+      try {
+        write();
+      } catch (e) {
+        socket.destroy();
+        stop();
+        done(e);
+      }
+    }, onError: (error, [stackTrace]) {
+      socket.destroy();
+      done(error, stackTrace);
+    }, onDone: () {
+      done();
+    }, cancelOnError: true);
+  }
+
+  // Sends the bytes from [start] to [end] of the file at [path] without
+  // reading them into Dart. Falls back to streaming the file if the platform
+  // or the file does not support that.
+  //
+  // Like the file stream, this sends up to the end of the file as it is when
+  // the last byte is sent, so bytes appended while sending are included.
+  void _addFile(String path, int start, int? end) {
+    filePath = path;
+    fileRequestedEnd = end;
+    new File(path).open().then((opened) {
+      return opened.length().then((length) {
+        if (filePath == null) {
+          // Stopped while opening the file.
+          _closeFile(opened);
+          return;
+        }
+        if (opened is! _RandomAccessFile) {
+          _closeFile(opened);
+          filePath = null;
+          _listen(new _FileStream(path, start, end));
+          return;
+        }
+        file = opened;
+        filePosition = start;
+        fileEnd = (end == null || end > length) ? length : end;
+        writeFile();
+      });
+    }).catchError((error, stackTrace) {
+      socket.destroy();
+      done(error, stackTrace);
+    });
+  }
+
   Future<Socket> close() {
     socket._consumerDone();
     return new Future.value(socket);
   }
 
   void write() {
+    if (file != null) {
+      writeFile();
+      return;
+    }
     final sub = subscription;
     if (sub == null) return;
     // Write as much as possible.
@@ -1937,6 +2182,64 @@ class _SocketStreamConsumer extends StreamConsumer<List<int>> {
     }
   }
 
+  void writeFile() {
+    if (fileLengthPending) return;
+    final opened = file as _RandomAccessFile;
+    // Sending a chunk can block on reading the file, so send one chunk per
+    // write event rather than as much as possible.
+    if (filePosition < fileEnd) {
+      int sent = socket._sendFile(opened, filePosition, fileEnd - filePosition);
+      if (sent < 0) {
+        // Not supported here, or the file got shorter. Stream the rest.
+        final path = filePath!;
+        file = null;
+        filePath = null;
+        _closeFile(opened);
+        _listen(new _FileStream(path, filePosition, fileRequestedEnd));
+        return;
+      }
+      filePosition += sent;
+      if (filePosition < fileEnd) {
+        socket._enableWriteEvent();
+        return;
+      }
+    }
+    final end = fileRequestedEnd;
+    if (end == null || end > fileEnd) {
+      // The file may have grown since its length was read.
+      fileLengthPending = true;
+      opened.length().then((length) {
+        fileLengthPending = false;
+        if (file != opened) return; // Stopped.
+        final newEnd = (end == null || end > length) ? length : end;
+        if (newEnd > fileEnd) {
+          fileEnd = newEnd;
+          writeFile();
+        } else {
+          _finishFile(opened);
+        }
+      }, onError: (error, stackTrace) {
+        fileLengthPending = false;
+        if (file != opened) return;
+        stop();
+        socket.destroy();
+        done(error, stackTrace);
+      });
+      return;
+    }
+    _finishFile(opened);
+  }
+
+  void _finishFile(RandomAccessFile opened) {
+    file = null;
+    filePath = null;
+    opened.close().then((_) => done(), onError: done);
+  }
+
+  static void _closeFile(RandomAccessFile file) {
+    file.close().then((_) {}, onError: (_) {});
+  }
+
   void done([error, stackTrace]) {
     final completer = streamCompleter;
     if (completer != null) {
@@ -1950,6 +2253,13 @@ class _SocketStreamConsumer extends StreamConsumer<List<int>> {
   }
 
   void stop() {
+    final opened = file;
+    filePath = null;
+    if (opened != null) {
+      file = null;
+      _closeFile(opened);
+      socket._disableWriteEvent();
+    }
     final sub = subscription;
     if (sub == null) return;
     sub.cancel();
@@ -2178,6 +2488,14 @@ class _Socket extends Stream<Uint8List> implements Socket {
     return 0;
   }
 
+  int _sendFile(_RandomAccessFile file, int position, int length) {
+    final raw = _raw;
+    if (raw is _RawSocket) {
+      return raw._sendFile(file, position, length);
+    }
+    return 0;
+  }
+
   void _enableWriteEvent() {
     _raw?.writeEventsEnabled = true;
   }
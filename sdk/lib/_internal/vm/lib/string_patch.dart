@@ -348,7 +348,9 @@ abstract class _StringBase implements String {
     if (pattern is String) {
       String other = pattern;
       int maxIndex = this.length - other.length;
-      // TODO: Use an efficient string search (e.g. BMH).
+      if (maxIndex - start >= _nativeIndexOfThreshold) {
+        return _indexOf(other, start);
+      }
       for (int index = start; index <= maxIndex; index++) {
         if (_substringMatches(index, other)) {
           return index;
@@ -364,6 +366,12 @@ abstract class _StringBase implements String {
     return -1;
   }
 
+  // Searches longer than this are done by the runtime, which can compare
+  // many characters at once.
+  static const int _nativeIndexOfThreshold = 32;
+
+  int _indexOf(String pattern, int start) native "String_indexOf";
+
   int lastIndexOf(Pattern pattern, [int? start]) {
     if (start == null) {
       start = this.length;
@@ -45,6 +45,10 @@ class DynamicLibrary {
 /// Methods which cannot be invoked dynamically.
 extension DynamicLibraryExtension on DynamicLibrary {
   /// Helper that combines lookup and cast to a Dart function.
+  ///
+  /// [isLeaf] specifies whether the function is a leaf function, see
+  /// [NativeFunctionPointer.asFunction].
   external F lookupFunction<T extends Function, F extends Function>(
-      String symbolName);
+      String symbolName,
+      {bool isLeaf = false});
 }
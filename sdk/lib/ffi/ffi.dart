@@ -124,7 +124,16 @@ extension NativeFunctionPointer<NF extends Function>
     on Pointer<NativeFunction<NF>> {
   /// Convert to Dart function, automatically marshalling the arguments
   /// and return value.
-  external DF asFunction<@DartRepresentationOf("NF") DF extends Function>();
+  ///
+  /// [isLeaf] specifies whether the function is a leaf function.
+  /// A leaf function must not run Dart code or call back into the Dart VM.
+  /// Leaf calls are faster than non-leaf calls, because the VM does not
+  /// transition out of Dart code for them. In exchange, the garbage collector
+  /// and other isolates of the group have to wait until the call returns, so
+  /// leaf functions should be short. A leaf function cannot take or return a
+  /// [Handle].
+  external DF asFunction<@DartRepresentationOf("NF") DF extends Function>(
+      {bool isLeaf = false});
 }
 
 //
@@ -0,0 +1,94 @@
+// Copyright (c) 2021, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+//
+// Dart test program for testing dart:ffi leaf calls.
+//
+// VMOptions=
+// VMOptions=--deterministic --optimization-counter-threshold=10
+// VMOptions=--write-protect-code --no-dual-map-code
+// SharedObjects=ffi_test_functions
+
+import 'dart:ffi';
+
+import 'package:ffi/ffi.dart';
+import 'package:expect/expect.dart';
+
+import 'dylib_utils.dart';
+
+final DynamicLibrary ffiTestFunctions =
+    dlopenPlatformSpecific("ffi_test_functions");
+
+void main() {
+  for (int i = 0; i < 100; ++i) {
+    testLeafCallFromLookup();
+    testLeafCallFromAsFunction();
+    testLeafCallDouble();
+    testLeafCallManyInts();
+    testLeafCallPointer();
+    testLeafAndNonLeafCall();
+  }
+}
+
+typedef NativeBinaryOp = Int32 Function(Int32, Int32);
+typedef BinaryOp = int Function(int, int);
+
+void testLeafCallFromLookup() {
+  final sumPlus42 = ffiTestFunctions
+      .lookupFunction<NativeBinaryOp, BinaryOp>("SumPlus42", isLeaf: true);
+  Expect.equals(49 + 42, sumPlus42(3, 17 + 29));
+}
+
+void testLeafCallFromAsFunction() {
+  final times3 = ffiTestFunctions
+      .lookup<NativeFunction<IntPtr Function(IntPtr)>>("Times3")
+      .asFunction<int Function(int)>(isLeaf: true);
+  Expect.equals(3 * 1337, times3(1337));
+  Expect.equals(-3, times3(-1));
+}
+
+void testLeafCallDouble() {
+  final times1_337Double = ffiTestFunctions.lookupFunction<
+      Double Function(Double),
+      double Function(double)>("Times1_337Double", isLeaf: true);
+  Expect.approxEquals(2.0 * 1.337, times1_337Double(2.0));
+}
+
+typedef NativeDecenaryOp = IntPtr Function(IntPtr, IntPtr, IntPtr, IntPtr,
+    IntPtr, IntPtr, IntPtr, IntPtr, IntPtr, IntPtr);
+typedef DecenaryOp = int Function(
+    int, int, int, int, int, int, int, int, int, int);
+
+void testLeafCallManyInts() {
+  final sumManyInts = ffiTestFunctions
+      .lookupFunction<NativeDecenaryOp, DecenaryOp>("SumManyInts",
+          isLeaf: true);
+  Expect.equals(55, sumManyInts(1, 2, 3, 4, 5, 6, 7, 8, 9, 10));
+}
+
+typedef Int64PointerUnOp = Pointer<Int64> Function(Pointer<Int64>);
+
+void testLeafCallPointer() {
+  final assign1337Index1 = ffiTestFunctions
+      .lookupFunction<Int64PointerUnOp, Int64PointerUnOp>("Assign1337Index1",
+          isLeaf: true);
+  final Pointer<Int64> p = calloc(2);
+  p.value = 42;
+  p[1] = 1000;
+  final Pointer<Int64> result = assign1337Index1(p);
+  Expect.equals(1337, result.value);
+  Expect.equals(1337, p[1]);
+  Expect.equals(p.elementAt(1).address, result.address);
+  calloc.free(p);
+}
+
+// Leaf and non-leaf calls of the same function use different trampolines.
+void testLeafAndNonLeafCall() {
+  final pointer =
+      ffiTestFunctions.lookup<NativeFunction<NativeBinaryOp>>("SumPlus42");
+  final leaf = pointer.asFunction<BinaryOp>(isLeaf: true);
+  final nonLeaf = pointer.asFunction<BinaryOp>();
+  for (int i = 0; i < 10; i++) {
+    Expect.equals(leaf(i, i), nonLeaf(i, i));
+  }
+}
@@ -60,6 +60,12 @@ void main() {
   testSizeOfNativeType();
   testElementAtGeneric();
   testElementAtNativeType();
+  testLookupFunctionIsLeafMustBeConst();
+  testAsFunctionIsLeafMustBeConst();
+  testLookupFunctionTakesHandle();
+  testLookupFunctionReturnsHandle();
+  testAsFunctionTakesHandle();
+  testAsFunctionReturnsHandle();
 }
 
 typedef Int8UnOp = Int8 Function(Int8);
@@ -759,3 +765,47 @@ class TestStruct1606Packed extends Struct {
   external Array<TestStruct1604> //# 1606: compile-time error
       nestedLooselyPacked; //# 1606: compile-time error
 }
+
+void testLookupFunctionIsLeafMustBeConst() {
+  bool notAConst = false;
+  testLibrary.lookupFunction<Int8UnOp, IntUnOp>(//# 1700: compile-time error
+      "DoesNotExist", //# 1700: compile-time error
+      isLeaf: notAConst); //# 1700: compile-time error
+}
+
+void testAsFunctionIsLeafMustBeConst() {
+  bool notAConst = false;
+  Pointer<NativeFunction<Int8UnOp>> p = Pointer.fromAddress(1337);
+  IntUnOp f = p.asFunction(isLeaf: notAConst); //# 1701: compile-time error
+}
+
+void testLookupFunctionTakesHandle() {
+  testLibrary.lookupFunction< //# 1702: compile-time error
+      Void Function(Handle), //# 1702: compile-time error
+      void Function(Object)>("DoesNotExist", //# 1702: compile-time error
+      isLeaf: true); //# 1702: compile-time error
+}
+
+void testLookupFunctionReturnsHandle() {
+  testLibrary.lookupFunction< //# 1703: compile-time error
+      Handle Function(), //# 1703: compile-time error
+      Object Function()>("DoesNotExist", //# 1703: compile-time error
+      isLeaf: true); //# 1703: compile-time error
+}
+
+void testAsFunctionTakesHandle() {
+  final Pointer< //# 1704: compile-time error
+          NativeFunction< //# 1704: compile-time error
+              Void Function(Handle)>> //# 1704: compile-time error
+      pointer = Pointer.fromAddress(1234); //# 1704: compile-time error
+  pointer.asFunction< //# 1704: compile-time error
+      void Function(Object)>(isLeaf: true); //# 1704: compile-time error
+}
+
+void testAsFunctionReturnsHandle() {
+  final Pointer< //# 1705: compile-time error
+          NativeFunction<Handle Function()>> //# 1705: compile-time error
+      pointer = Pointer.fromAddress(1234); //# 1705: compile-time error
+  pointer.asFunction< //# 1705: compile-time error
+      Object Function()>(isLeaf: true); //# 1705: compile-time error
+}
@@ -3,6 +3,9 @@
 // BSD-style license that can be found in the LICENSE file.
 //
 // Dart test program for testing file I/O.
+//
+// VMOptions=
+// VMOptions=--use-io-uring
 
 import 'dart:async';
 import 'dart:io';
@@ -0,0 +1,39 @@
+// Copyright (c) 2021, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+//
+// Test that the executable is looked up on the PATH passed in [environment],
+// not on the PATH of this process.
+
+import "dart:io";
+
+import "package:async_helper/async_helper.dart";
+import "package:expect/expect.dart";
+
+main() async {
+  if (Platform.isWindows) return;
+  asyncStart();
+  var temp = Directory.systemTemp.createTempSync("process_path_only");
+  try {
+    var tool = new File("${temp.path}/dart_process_path_test_tool");
+    tool.writeAsStringSync("#!/bin/sh\necho found\n");
+    Expect.equals(0, Process.runSync("chmod", ["+x", tool.path]).exitCode);
+
+    for (var includeParentEnvironment in [false, true]) {
+      var result = await Process.run("dart_process_path_test_tool", [],
+          environment: {"PATH": temp.path},
+          includeParentEnvironment: includeParentEnvironment);
+      Expect.equals(0, result.exitCode);
+      Expect.equals("found\n", result.stdout);
+    }
+
+    // Not found on the PATH of this process.
+    try {
+      await Process.run("dart_process_path_test_tool", []);
+      Expect.fail("Found an executable that is not on the PATH");
+    } on ProcessException catch (_) {}
+  } finally {
+    temp.deleteSync(recursive: true);
+  }
+  asyncEnd();
+}
@@ -8,6 +8,7 @@
 // VMOptions=--short_socket_read
 // VMOptions=--short_socket_write
 // VMOptions=--short_socket_read --short_socket_write
+// VMOptions=--io-event-handler-threads=4
 
 import "package:expect/expect.dart";
 import 'dart:async';
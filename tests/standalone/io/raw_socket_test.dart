@@ -6,6 +6,7 @@
 // VMOptions=--short_socket_read
 // VMOptions=--short_socket_write
 // VMOptions=--short_socket_read --short_socket_write
+// VMOptions=--use-io-uring
 
 import "dart:async";
 import "dart:io";
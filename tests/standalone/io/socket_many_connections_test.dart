@@ -4,6 +4,7 @@
 
 // VMOptions=--enable-isolate-groups --experimental-enable-isolate-groups-jit
 // VMOptions=--no-enable-isolate-groups
+// VMOptions=--io-event-handler-threads=4
 //
 // Test creating a large number of socket connections.
 library ServerTest;
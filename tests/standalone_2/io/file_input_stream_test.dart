@@ -6,6 +6,9 @@
 // OtherResources=readuntil_test.dat
 // OtherResources=readline_test1.dat
 // OtherResources=readline_test2.dat
+//
+// VMOptions=
+// VMOptions=--use-io-uring
 
 import "dart:convert";
 import "dart:io";
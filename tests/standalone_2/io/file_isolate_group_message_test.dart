@@ -0,0 +1,85 @@
+// Copyright (c) 2021, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+//
+// VMOptions=--enable-isolate-groups --experimental-enable-isolate-groups-jit
+// VMOptions=--no-enable-isolate-groups
+//
+// Tests asynchronous file I/O, which talks to the native IOService port, in
+// isolates that exchange messages in the clustered format used within an
+// isolate group.
+
+import "dart:async";
+import "dart:io";
+import "dart:isolate";
+import "dart:typed_data";
+
+import "package:async_helper/async_helper.dart";
+import "package:expect/expect.dart";
+
+const int fileSize = 100000;
+
+Uint8List contents() {
+  var bytes = new Uint8List(fileSize);
+  for (int i = 0; i < bytes.length; i++) {
+    bytes[i] = (i * 13) & 0xFF;
+  }
+  return bytes;
+}
+
+Future<Map<String, dynamic>> readFile(String path) async {
+  var file = new File(path);
+  var chunks = <List<int>>[];
+  await for (var chunk in file.openRead()) {
+    chunks.add(chunk);
+  }
+  var opened = await file.open();
+  await opened.setPosition(10);
+  var middle = await opened.read(20);
+  await opened.close();
+  return <String, dynamic>{
+    'length': await file.length(),
+    'bytes': await file.readAsBytes(),
+    'chunks': chunks,
+    'middle': middle,
+    'exists': await file.exists(),
+  };
+}
+
+Future reader(List args) async {
+  String path = args[0];
+  SendPort replyPort = args[1];
+  replyPort.send(await readFile(path));
+}
+
+void checkResult(Uint8List expected, Map<String, dynamic> result) {
+  Expect.equals(fileSize, result['length']);
+  Expect.listEquals(expected, result['bytes']);
+  Expect.listEquals(
+      expected, (result['chunks'] as List).expand((c) => c).toList());
+  Expect.listEquals(expected.sublist(10, 30), result['middle']);
+  Expect.isTrue(result['exists']);
+}
+
+Future testFileIO(Directory temp) async {
+  var expected = contents();
+  var path = "${temp.path}/data";
+  await new File(path).writeAsBytes(expected);
+
+  checkResult(expected, await readFile(path));
+
+  var port = new ReceivePort();
+  await Isolate.spawn(reader, [path, port.sendPort]);
+  checkResult(expected, await port.first);
+}
+
+main() async {
+  asyncStart();
+  var temp = await Directory.systemTemp.createTemp("file_isolate_group");
+  try {
+    await testFileIO(temp);
+  } finally {
+    await temp.delete(recursive: true);
+  }
+  asyncEnd();
+}
@@ -0,0 +1,110 @@
+// Copyright (c) 2021, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+//
+// Tests that adding the contents of a file to a socket sends exactly the
+// requested range of the file, reports a bad range, and stops at the end of a
+// file that is truncated while it is being sent.
+
+import "dart:async";
+import "dart:io";
+import "dart:typed_data";
+
+import "package:async_helper/async_helper.dart";
+import "package:expect/expect.dart";
+
+const int fileSize = 3 * 1024 * 1024 + 17;
+
+Future<List<int>> sendFile(File file, [int start, int end]) async {
+  var server = await ServerSocket.bind("127.0.0.1", 0);
+  var received = server.first.then((socket) async {
+    var builder = new BytesBuilder(copy: false);
+    await for (var data in socket) {
+      builder.add(data);
+    }
+    return builder.takeBytes();
+  });
+  var client = await Socket.connect("127.0.0.1", server.port);
+  await client.addStream(file.openRead(start, end));
+  await client.close();
+  var result = await received;
+  await server.close();
+  return result;
+}
+
+// Truncates [file] to [length] bytes while it is being sent. Returns what was
+// received, which is a prefix of the original contents.
+Future<List<int>> sendTruncatedFile(File file, int length) async {
+  var server = await ServerSocket.bind("127.0.0.1", 0);
+  var accepted = server.first;
+  var client = await Socket.connect("127.0.0.1", server.port);
+  // Nothing is read yet, so the send stops once the socket buffers are full.
+  var sent = client.addStream(file.openRead());
+  await new Future.delayed(const Duration(milliseconds: 50));
+  var opened = await file.open(mode: FileMode.append);
+  await opened.truncate(length);
+  await opened.close();
+  var socket = await accepted;
+  var received = socket.fold<BytesBuilder>(new BytesBuilder(copy: false),
+      (builder, data) => builder..add(data));
+  await sent;
+  await client.close();
+  var result = (await received).takeBytes();
+  await server.close();
+  return result;
+}
+
+Future testBadRange(File file) async {
+  var server = await ServerSocket.bind("127.0.0.1", 0);
+  server.listen((socket) => socket.listen((_) {}, onError: (_) {}));
+  var client = await Socket.connect("127.0.0.1", server.port);
+  try {
+    await client.addStream(file.openRead(2000, 1000));
+    Expect.fail("Expected a RangeError");
+  } on RangeError catch (e) {
+    Expect.isTrue(e.toString().contains("Bad end position"));
+  }
+  client.destroy();
+  await server.close();
+}
+
+void expectRange(Uint8List expected, List<int> actual, int start, int end) {
+  Expect.equals(end - start, actual.length);
+  for (int i = 0; i < actual.length; i++) {
+    if (expected[start + i] != actual[i]) {
+      Expect.fail("Mismatch at ${start + i}");
+    }
+  }
+}
+
+Future testAddFileStream(Directory temp) async {
+  var bytes = new Uint8List(fileSize);
+  for (int i = 0; i < bytes.length; i++) {
+    bytes[i] = (i * 7) & 0xFF;
+  }
+  var file = new File("${temp.path}/data");
+  file.writeAsBytesSync(bytes);
+
+  expectRange(bytes, await sendFile(file), 0, fileSize);
+  expectRange(bytes, await sendFile(file, 1000, 2000000), 1000, 2000000);
+  expectRange(bytes, await sendFile(file, 5, fileSize + 100), 5, fileSize);
+  expectRange(bytes, await sendFile(file, fileSize), fileSize, fileSize);
+  await testBadRange(file);
+
+  const truncatedSize = 1000 * 1000;
+  var received = await sendTruncatedFile(file, truncatedSize);
+  Expect.isTrue(received.length >= truncatedSize);
+  Expect.isTrue(received.length <= fileSize);
+  expectRange(bytes, received, 0, received.length);
+}
+
+main() async {
+  asyncStart();
+  var temp = Directory.systemTemp.createTempSync("socket_add_file_stream");
+  try {
+    await testAddFileStream(temp);
+  } finally {
+    temp.deleteSync(recursive: true);
+  }
+  asyncEnd();
+}